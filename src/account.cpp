@@ -27,6 +27,7 @@
 #include <QtCore/QString>
 #include <QtCore/QMimeData>
 #include <QtCore/QItemSelectionModel>
+#include <QtCore/QCryptographicHash>
 
 //Ring daemon
 #include <account_const.h>
@@ -46,6 +47,7 @@
 #include "private/account_p.h"
 #include "private/accountmodel_p.h"
 #include "private/contactmethod_p.h"
+#include "private/phonedirectorymodel_p.h"
 #include "credentialmodel.h"
 #include "ciphermodel.h"
 #include "protocolmodel.h"
@@ -55,6 +57,7 @@
 #include "person.h"
 #include "profilemodel.h"
 #include "pendingcontactrequestmodel.h"
+#include "tracing.h"
 #include "private/pendingcontactrequestmodel_p.h"
 #include "accountstatusmodel.h"
 #include "codecmodel.h"
@@ -130,71 +133,159 @@ Account::Account():ItemBase(&AccountModel::instance()),d_ptr(new AccountPrivate(
 ///Build an account from it'id
 Account* AccountPrivate::buildExistingAccountFromId(const QByteArray& _accountId)
 {
-//    qDebug() << "Building an account from id: " << _accountId;
-   Account* a = new Account();
-   a->d_ptr->m_AccountId = _accountId;
-   a->d_ptr->setObjectName(_accountId);
-   a->d_ptr->m_RemoteEnabledState = true;
-
-   a->performAction(Account::EditAction::RELOAD);
-
-   //If a placeholder exist for this account, upgrade it
-   if (auto place_holder = AccountModel::instance().findPlaceHolder(_accountId))
-       place_holder->d_ptr->merge(a);
-
-   //Load the pending trust requests
-   if (a->protocol() == Account::Protocol::RING) {
-      const VectorMapStringString& pending_tr {ConfigurationManager::instance().getTrustRequests(a->id())};
-      for (const auto& tr_info : pending_tr) {
-         auto payload = tr_info[DRing::Account::TrustRequest::PAYLOAD].toUtf8();
-         auto ringID = tr_info[DRing::Account::TrustRequest::FROM];
-         auto timeReceived = tr_info[DRing::Account::TrustRequest::RECEIVED].toInt();
-
-         auto contactRequest = new ContactRequest(a, ringID, timeReceived, payload);
-         a->pendingContactRequestModel()->d_ptr->addRequest(contactRequest);
-         AccountModel::instance().incomingContactRequestModel();
-         AccountModel::instance().d_ptr->m_pPendingIncomingRequests->d_ptr->addRequest(contactRequest);
-      }
+   const auto accounts = buildExistingAccountsFromIds({_accountId});
+
+   return accounts.isEmpty() ? nullptr : accounts.first();
+} //buildExistingAccountFromId
+
+/**
+ * Build many accounts at once.
+ *
+ * Loading each account requires many daemon queries. When done one account
+ * at a time, each of them is a blocking round trip and startup time is
+ * dominated by the IPC latency. Here, all queries of a phase are sent before
+ * the first reply is read. When using DBus, this allows the daemon to process
+ * them while the previous replies are being parsed.
+ *
+ * The ContactMethods are then inserted in the PhoneDirectoryModel as a single
+ * batch.
+ */
+QVector<Account*> AccountPrivate::buildExistingAccountsFromIds(const QList<QByteArray>& ids)
+{
+   QVector<Account*> ret;
+
+   if (ids.isEmpty())
+      return ret;
+
+   ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
+   PresenceManagerInterface&      presenceManager      = PresenceManager::instance();
+
+   Tracing::Span s("account", "AccountPrivate::buildExistingAccountsFromIds");
+
+   // Phase 1: Fetch the details of all accounts
+   typedef decltype(configurationManager.getAccountDetails({})) DetailsReply;
+
+   QVector<DetailsReply> detailsReplies, volatileReplies;
+   detailsReplies .reserve(ids.size());
+   volatileReplies.reserve(ids.size());
+
+   for (const auto& id : qAsConst(ids)) {
+      detailsReplies  << configurationManager.getAccountDetails        (id);
+      volatileReplies << configurationManager.getVolatileAccountDetails(id);
    }
 
-   // Connects the account to the signal of the model.
-   connect(a->pendingContactRequestModel() , &PendingContactRequestModel::requestAccepted, a, [a] (ContactRequest* r) {
-      emit a->contactRequestAccepted(r);
-   });
+   QVector<BootstrapData> bootstrap(ids.size());
 
+   for (int i = 0; i < ids.size(); i++) {
+      bootstrap[i].details         = detailsReplies [i];
+      bootstrap[i].volatileDetails = volatileReplies[i];
+   }
 
-   if (a->protocol() == Account::Protocol::RING) {
+   Tracing::instant("account", "Account details fetched");
 
-      // Load the contacts associated from the daemon and create the cms.
-      const QVector<QMap<QString, QString>> account_contacts = ConfigurationManager::instance()
-         .getContacts(a->id().data());
+   // Phase 2: Create the accounts from the prefetched details
+   ret.reserve(ids.size());
 
-      for (const auto& contact_info : qAsConst(account_contacts)) {
-         auto cm = PhoneDirectoryModel::instance().getNumber(contact_info[QStringLiteral("id")], a);
-         cm->d_ptr->m_ConfirmationStatus = contact_info["confirmed"] == QStringLiteral("true") ?
-            ContactMethod::ConfirmationStatus::CONFIRMED :
-            ContactMethod::ConfirmationStatus::PENDING;
-      }
+   for (int i = 0; i < ids.size(); i++) {
+      Account* a = new Account();
+      a->d_ptr->m_AccountId = ids[i];
+      a->d_ptr->setObjectName(ids[i]);
+      a->d_ptr->m_RemoteEnabledState = true;
+
+      a->d_ptr->m_pBootstrap = &bootstrap[i];
+      a->performAction(Account::EditAction::RELOAD);
+      a->d_ptr->m_pBootstrap = nullptr;
+
+      //If a placeholder exist for this account, upgrade it
+      if (auto place_holder = AccountModel::instance().findPlaceHolder(ids[i]))
+         place_holder->d_ptr->merge(a);
+
+      // Connects the account to the signal of the model.
+      connect(a->pendingContactRequestModel() , &PendingContactRequestModel::requestAccepted, a, [a] (ContactRequest* r) {
+         emit a->contactRequestAccepted(r);
+      });
+
+      ret << a;
    }
 
-   //Load the tracked buddies
-   const VectorMapStringString subscriptions = PresenceManager::instance().getSubscriptions(a->id());
-   foreach(auto subscription, subscriptions){
-       ContactMethod* tracked_buddy = PhoneDirectoryModel::instance().getNumber(subscription[DRing::Presence::BUDDY_KEY], a);
-       bool tracked_buddy_present = subscription[DRing::Presence::STATUS_KEY].compare(DRing::Presence::ONLINE_KEY) == 0;
-       tracked_buddy->setTracked(true);
-       tracked_buddy->d_ptr->setPresent(tracked_buddy_present);
+   Tracing::instant("account", "Accounts created");
+
+   // Phase 3: Fetch the trust requests, contacts and tracked buddies
+   typedef decltype(configurationManager.getContacts({})) VectorReply;
+   typedef decltype(presenceManager.getSubscriptions({})) SubscriptionsReply;
+
+   QVector<VectorReply> trustReplies, contactReplies;
+   QVector<SubscriptionsReply> subscriptionReplies;
+
+   trustReplies       .reserve(ret.size());
+   contactReplies     .reserve(ret.size());
+   subscriptionReplies.reserve(ret.size());
+
+   for (Account* a : qAsConst(ret)) {
+      if (a->protocol() == Account::Protocol::RING) {
+         trustReplies   << configurationManager.getTrustRequests(a->id());
+         contactReplies << configurationManager.getContacts     (a->id());
+      }
+      subscriptionReplies << presenceManager.getSubscriptions(a->id());
    }
 
-    const QString currentUri = a->d_ptr->buildUri();
+   Tracing::instant("account", "Account contacts queried");
 
-    a->d_ptr->m_pAccountNumber = PhoneDirectoryModel::instance().getNumber(currentUri, a);
-    Q_ASSERT(a->d_ptr->m_pAccountNumber->uri() != '@');
+   // Phase 4: Create the ContactMethods
+   auto& directory = PhoneDirectoryModel::instance();
+   directory.d_ptr->beginBatch();
 
-    a->d_ptr->m_pAccountNumber->d_ptr->setType(ContactMethod::Type::ACCOUNT);
+   for (int i = 0, ring = 0; i < ret.size(); i++) {
+      Account* a = ret[i];
 
-   return a;
-} //buildExistingAccountFromId
+      if (a->protocol() == Account::Protocol::RING) {
+         //Load the pending trust requests
+         const VectorMapStringString pending_tr = trustReplies[ring];
+         for (const auto& tr_info : pending_tr) {
+            auto payload = tr_info[DRing::Account::TrustRequest::PAYLOAD].toUtf8();
+            auto ringID = tr_info[DRing::Account::TrustRequest::FROM];
+            auto timeReceived = tr_info[DRing::Account::TrustRequest::RECEIVED].toInt();
+
+            auto contactRequest = new ContactRequest(a, ringID, timeReceived, payload);
+            a->pendingContactRequestModel()->d_ptr->addRequest(contactRequest);
+            AccountModel::instance().incomingContactRequestModel();
+            AccountModel::instance().d_ptr->m_pPendingIncomingRequests->d_ptr->addRequest(contactRequest);
+         }
+
+         // Load the contacts associated from the daemon and create the cms.
+         const VectorMapStringString account_contacts = contactReplies[ring];
+
+         for (const auto& contact_info : qAsConst(account_contacts)) {
+            auto cm = directory.getNumber(contact_info[QStringLiteral("id")], a);
+            cm->d_ptr->m_ConfirmationStatus = contact_info["confirmed"] == QStringLiteral("true") ?
+               ContactMethod::ConfirmationStatus::CONFIRMED :
+               ContactMethod::ConfirmationStatus::PENDING;
+         }
+
+         ring++;
+      }
+
+      //Load the tracked buddies
+      const VectorMapStringString subscriptions = subscriptionReplies[i];
+      for (const auto& subscription : qAsConst(subscriptions)) {
+         ContactMethod* tracked_buddy = directory.getNumber(subscription[DRing::Presence::BUDDY_KEY], a);
+         bool tracked_buddy_present = subscription[DRing::Presence::STATUS_KEY].compare(DRing::Presence::ONLINE_KEY) == 0;
+         tracked_buddy->setTracked(true);
+         tracked_buddy->d_ptr->setPresent(tracked_buddy_present);
+      }
+
+      const QString currentUri = a->d_ptr->buildUri();
+
+      a->d_ptr->m_pAccountNumber = directory.getNumber(currentUri, a);
+      Q_ASSERT(a->d_ptr->m_pAccountNumber->uri() != '@');
+
+      a->d_ptr->m_pAccountNumber->d_ptr->setType(ContactMethod::Type::ACCOUNT);
+   }
+
+   directory.d_ptr->endBatch();
+
+   return ret;
+} //buildExistingAccountsFromIds
 
 ///Build an account from it's name / alias
 Account* AccountPrivate::buildNewAccountFromAlias(Account::Protocol proto, const QString& alias)
@@ -209,8 +300,8 @@ Account* AccountPrivate::buildNewAccountFromAlias(Account::Protocol proto, const
    ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
    Account* a = new Account();
    a->setProtocol(proto);
-   a->d_ptr->m_hAccountDetails.clear();
-   a->d_ptr->m_hAccountDetails[DRing::Account::ConfProperties::ENABLED] = QLatin1String("false");
+   a->d_ptr->m_Details.clear();
+   a->d_ptr->m_Details.setValue(AccountDetails::Key::ENABLED, QLatin1String("false"));
    a->d_ptr->m_pAccountNumber = nullptr;
 
    MapStringString tmp;
@@ -224,11 +315,8 @@ Account* AccountPrivate::buildNewAccountFromAlias(Account::Protocol proto, const
       case Account::Protocol::COUNT__:
          break;
    }
-   QMutableMapIterator<QString, QString> iter(tmp);
-   while (iter.hasNext()) {
-      iter.next();
-      a->d_ptr->m_hAccountDetails[iter.key()] = iter.value();
-   }
+   for (auto iter = tmp.constBegin(); iter != tmp.constEnd(); ++iter)
+      a->d_ptr->m_Details.setValue(iter.key(), iter.value());
 
    if (proto == Account::Protocol::RING)
    {
@@ -238,10 +326,10 @@ Account* AccountPrivate::buildNewAccountFromAlias(Account::Protocol proto, const
    }
    else
    {
-       a->setHostname(a->d_ptr->m_hAccountDetails[DRing::Account::ConfProperties::HOSTNAME]);
+       a->setHostname(a->d_ptr->m_Details.value(AccountDetails::Key::HOSTNAME));
    }
 
-   a->d_ptr->setAccountProperty(DRing::Account::ConfProperties::ALIAS,alias);
+   a->d_ptr->setAccountProperty(AccountDetails::Key::ALIAS,alias);
    a->d_ptr->m_RemoteEnabledState = a->isEnabled();
    //a->setObjectName(a->id());
 
@@ -286,16 +374,16 @@ void AccountPrivate::slotUpdateCertificate()
    if (cert) {
       switch (cert->type()) {
          case Certificate::Type::AUTHORITY:
-            if (accountDetail(DRing::Account::ConfProperties::TLS::CA_LIST_FILE) != cert->path())
-               setAccountProperty(DRing::Account::ConfProperties::TLS::CA_LIST_FILE, cert->path());
+            if (accountDetail(AccountDetails::Key::TLS_CA_LIST_FILE) != cert->path())
+               setAccountProperty(AccountDetails::Key::TLS_CA_LIST_FILE, cert->path());
             break;
          case Certificate::Type::USER:
-            if (accountDetail(DRing::Account::ConfProperties::TLS::CERTIFICATE_FILE) != cert->path())
-               setAccountProperty(DRing::Account::ConfProperties::TLS::CERTIFICATE_FILE, cert->path());
+            if (accountDetail(AccountDetails::Key::TLS_CERTIFICATE_FILE) != cert->path())
+               setAccountProperty(AccountDetails::Key::TLS_CERTIFICATE_FILE, cert->path());
             break;
          case Certificate::Type::PRIVATE_KEY:
-            if (accountDetail(DRing::Account::ConfProperties::TLS::PRIVATE_KEY_FILE) != cert->path())
-               setAccountProperty(DRing::Account::ConfProperties::TLS::PRIVATE_KEY_FILE, cert->path());
+            if (accountDetail(AccountDetails::Key::TLS_PRIVATE_KEY_FILE) != cert->path())
+               setAccountProperty(AccountDetails::Key::TLS_PRIVATE_KEY_FILE, cert->path());
             break;
          case Certificate::Type::NONE:
          case Certificate::Type::CALL:
@@ -336,13 +424,13 @@ const QByteArray Account::id() const
 ///Get the device ID
 QString Account::deviceId() const
 {
-    return d_ptr->accountDetail(DRing::Account::ConfProperties::RING_DEVICE_ID);
+    return d_ptr->accountDetail(AccountDetails::Key::RING_DEVICE_ID);
 }
 
 ///Get current state
 const QString Account::toHumanStateName() const
 {
-   const QString s = d_ptr->m_hAccountDetails[DRing::Account::ConfProperties::Registration::STATUS];
+   const QString s = d_ptr->m_Details.value(AccountDetails::Key::REGISTRATION_STATUS);
 
                                                  //: Account state
    static const QString ready                  = tr("Ready"                    );
@@ -407,38 +495,56 @@ const QString Account::toHumanStateName() const
 }
 
 ///Get an account detail
-QString AccountPrivate::accountDetail(const QString& param) const
+QString AccountPrivate::accountDetail(AccountDetails::Key key) const
 {
-   if (!m_hAccountDetails.size()) {
+   if (m_Details.isEmpty()) {
       qDebug() << "The account details is not set";
       return QString(); //May crash, but better than crashing now
    }
-   if (m_hAccountDetails.find(param) != m_hAccountDetails.end()) {
-      return m_hAccountDetails[param];
-   }
-   else if (m_hAccountDetails.count() > 0) {
-      if (param == DRing::Account::ConfProperties::ENABLED) //If an account is invalid, at least does not try to register it
+
+   if (m_Details.contains(key))
+      return m_Details.value(key);
+
+   switch(key) {
+      case AccountDetails::Key::ENABLED: //If an account is invalid, at least does not try to register it
          return AccountPrivate::RegistrationEnabled::NO;
-      if (param == DRing::Account::ConfProperties::Registration::STATUS) { //If an account is new, then it is unregistered
+      case AccountDetails::Key::REGISTRATION_STATUS: //If an account is new, then it is unregistered
          return DRing::Account::States::UNREGISTERED;
-      }
-      static QHash<QString,bool> alreadyWarned;
-      if (!alreadyWarned[param]) {
-         alreadyWarned[param] = true;
-         qDebug() << "Account parameter \"" << param << "\" not found";
-      }
-      return QString();
+      default:
+         break;
    }
-   else {
-      qDebug() << "Account details not found, there is " << m_hAccountDetails.count() << " details available";
-      return QString();
+
+   static std::bitset<static_cast<int>(AccountDetails::Key::COUNT__)> alreadyWarned;
+   if (!alreadyWarned[static_cast<int>(key)]) {
+      alreadyWarned[static_cast<int>(key)] = true;
+      qDebug() << "Account parameter \"" << AccountDetails::name(key) << "\" not found";
    }
+
+   return QString();
 } //accountDetail
 
+///Get a boolean account detail without parsing the string
+bool AccountPrivate::accountDetailBool(AccountDetails::Key key) const
+{
+   if (m_Details.contains(key))
+      return m_Details.boolValue(key);
+
+   return accountDetail(key) IS_TRUE;
+}
+
+///Get a numeric account detail without parsing the string
+int AccountPrivate::accountDetailInt(AccountDetails::Key key) const
+{
+   if (m_Details.contains(key))
+      return m_Details.intValue(key);
+
+   return accountDetail(key).toInt();
+}
+
 ///Get the alias
 const QString Account::alias() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ALIAS);
+   return d_ptr->accountDetail(AccountDetails::Key::ALIAS);
 }
 
 ///Return the model index of this item
@@ -575,8 +681,8 @@ RingDeviceModel* Account::ringDeviceModel() const
     if (!d_ptr->m_pRingDeviceModel)
         d_ptr->m_pRingDeviceModel = new RingDeviceModel(
             const_cast<Account*>(this),
-            d_ptr->accountDetail(DRing::Account::ConfProperties::RING_DEVICE_ID  ),
-            d_ptr->accountDetail(DRing::Account::ConfProperties::RING_DEVICE_NAME)
+            d_ptr->accountDetail(AccountDetails::Key::RING_DEVICE_ID  ),
+            d_ptr->accountDetail(AccountDetails::Key::RING_DEVICE_NAME)
         );
 
     return d_ptr->m_pRingDeviceModel;
@@ -586,7 +692,7 @@ Calendar* Account::calendar() const
 {
     if (!d_ptr->m_pCalendar) {
         d_ptr->m_pCalendar = EventModel::instance().addCollection<Calendar, Account*>(
-            const_cast<Account*>(this), LoadOptions::FORCE_ENABLED
+            const_cast<Account*>(this), static_cast<LoadOptions>(LoadOptions::FORCE_ENABLED | LoadOptions::ASYNC)
         );
     }
 
@@ -715,7 +821,7 @@ void Account::setAlias(const QString& detail)
    }
 
    const bool accChanged = detail != alias();
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::ALIAS,detail);
+   d_ptr->setAccountProperty(AccountDetails::Key::ALIAS,detail);
 
    if (accChanged)
       emit aliasChanged(detail);
@@ -730,13 +836,13 @@ QString Account::hostname() const
 ///Return if the account is enabled
 bool Account::isEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ENABLED) IS_TRUE;
+   return d_ptr->accountDetailBool(AccountDetails::Key::ENABLED);
 }
 
 ///Return if the account should auto answer
 bool Account::isAutoAnswer() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::AUTOANSWER) IS_TRUE;
+   return d_ptr->accountDetailBool(AccountDetails::Key::AUTOANSWER);
 }
 
 //Return if the accounts needs to migrate
@@ -750,14 +856,14 @@ bool Account::needsMigration() const
 ///Return the account user name
 QString Account::username() const
 {
-   auto ret = d_ptr->accountDetail(DRing::Account::ConfProperties::USERNAME);
+   auto ret = d_ptr->accountDetail(AccountDetails::Key::USERNAME);
 
    // The username (ringId) can take a while to be available, keep trying
    if (ret.isEmpty() && protocol() == Account::Protocol::RING && editState() == Account::EditState::READY) {
        ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
        const QMap<QString,QString> aDetails = configurationManager.getAccountDetails(id());
        ret = aDetails[DRing::Account::ConfProperties::USERNAME];
-       d_ptr->m_hAccountDetails[DRing::Account::ConfProperties::USERNAME] = ret;
+       d_ptr->m_Details.setRemoteValue(AccountDetails::Key::USERNAME, ret);
    }
 
    return ret;
@@ -774,19 +880,19 @@ QString Account::registeredName() const
 ///Return the account mailbox address
 QString Account::mailbox() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::MAILBOX);
+   return d_ptr->accountDetail(AccountDetails::Key::MAILBOX);
 }
 
 ///Return the account mailbox address
 QString Account::proxy() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ROUTE);
+   return d_ptr->accountDetail(AccountDetails::Key::ROUTE);
 }
 
 ///Return the name service URL
 QString Account::nameServiceURL() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::RingNS::URI);
+   return d_ptr->accountDetail(AccountDetails::Key::RINGNS_URI);
 }
 
 QString Account::password() const
@@ -808,68 +914,68 @@ QString Account::password() const
 ///Return the account security fallback
 bool Account::isSrtpRtpFallback() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::SRTP::RTP_FALLBACK) IS_TRUE;
+   return d_ptr->accountDetailBool(AccountDetails::Key::SRTP_RTP_FALLBACK);
 }
 
 //Return if SRTP is enabled or not
 bool Account::isSrtpEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::SRTP::ENABLED) IS_TRUE;
+   return d_ptr->accountDetailBool(AccountDetails::Key::SRTP_ENABLED);
 }
 
 ///Return if the account is using a STUN server
 bool Account::isSipStunEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::STUN::ENABLED) IS_TRUE;
+   return d_ptr->accountDetailBool(AccountDetails::Key::STUN_ENABLED);
 }
 
 ///Return the account STUN server
 QString Account::sipStunServer() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::STUN::SERVER);
+   return d_ptr->accountDetail(AccountDetails::Key::STUN_SERVER);
 }
 
 ///Return when the account expire (require renewal)
 int Account::registrationExpire() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Registration::EXPIRE).toInt();
+   return d_ptr->accountDetailInt(AccountDetails::Key::REGISTRATION_EXPIRE);
 }
 
 ///Return if the published address is the same as the local one
 bool Account::isPublishedSameAsLocal() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::PUBLISHED_SAMEAS_LOCAL) IS_TRUE;
+   return d_ptr->accountDetailBool(AccountDetails::Key::PUBLISHED_SAMEAS_LOCAL);
 }
 
 ///Return the account published address
 QString Account::publishedAddress() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::PUBLISHED_ADDRESS);
+   return d_ptr->accountDetail(AccountDetails::Key::PUBLISHED_ADDRESS);
 }
 
 ///Return the account published port
 int Account::publishedPort() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::PUBLISHED_PORT).toUInt();
+   return d_ptr->accountDetailInt(AccountDetails::Key::PUBLISHED_PORT);
 }
 
 ///Return the account tls password
 QString Account::tlsPassword() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::PASSWORD);
+   return d_ptr->accountDetail(AccountDetails::Key::TLS_PASSWORD);
 }
 
 ///Return the account TLS port
 int Account::bootstrapPort() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::DHT::PORT).toInt();
+   return d_ptr->accountDetailInt(AccountDetails::Key::DHT_PORT);
 }
 
 ///Return the account TLS certificate authority list file
 Certificate* Account::tlsCaListCertificate() const
 {
    if (!d_ptr->m_pCaCert) {
-      const QString& path = d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::CA_LIST_FILE);
+      const QString& path = d_ptr->accountDetail(AccountDetails::Key::TLS_CA_LIST_FILE);
       if (path.isEmpty())
          return nullptr;
       d_ptr->m_pCaCert = CertificateModel::instance().getCertificateFromPath(path,Certificate::Type::AUTHORITY);
@@ -882,7 +988,7 @@ Certificate* Account::tlsCaListCertificate() const
 Certificate* Account::tlsCertificate() const
 {
    if (!d_ptr->m_pTlsCert) {
-      const QString& path = d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::CERTIFICATE_FILE);
+      const QString& path = d_ptr->accountDetail(AccountDetails::Key::TLS_CERTIFICATE_FILE);
       if (path.isEmpty())
          return nullptr;
       d_ptr->m_pTlsCert = CertificateModel::instance().getCertificateFromPath(path,Certificate::Type::USER);
@@ -900,49 +1006,49 @@ QString Account::tlsPrivateKey() const
 ///Return the account TLS server name
 QString Account::tlsServerName() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::SERVER_NAME);
+   return d_ptr->accountDetail(AccountDetails::Key::TLS_SERVER_NAME);
 }
 
 ///Return the account negotiation timeout in seconds
 int Account::tlsNegotiationTimeoutSec() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::NEGOTIATION_TIMEOUT_SEC).toInt();
+   return d_ptr->accountDetailInt(AccountDetails::Key::TLS_NEGOTIATION_TIMEOUT_SEC);
 }
 
 ///Return the account TLS verify server
 bool Account::isTlsVerifyServer() const
 {
-   return (d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::VERIFY_SERVER) IS_TRUE);
+   return (d_ptr->accountDetailBool(AccountDetails::Key::TLS_VERIFY_SERVER));
 }
 
 ///Return the account TLS verify client
 bool Account::isTlsVerifyClient() const
 {
-   return (d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::VERIFY_CLIENT) IS_TRUE);
+   return (d_ptr->accountDetailBool(AccountDetails::Key::TLS_VERIFY_CLIENT));
 }
 
 ///Return if it is required for the peer to have a certificate
 bool Account::isTlsRequireClientCertificate() const
 {
-   return (d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::REQUIRE_CLIENT_CERTIFICATE) IS_TRUE);
+   return (d_ptr->accountDetailBool(AccountDetails::Key::TLS_REQUIRE_CLIENT_CERTIFICATE));
 }
 
 ///Return the account TLS security is enabled
 bool Account::isTlsEnabled() const
 {
-   return protocol() == Account::Protocol::RING || (d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::ENABLED) IS_TRUE);
+   return protocol() == Account::Protocol::RING || (d_ptr->accountDetailBool(AccountDetails::Key::TLS_ENABLED));
 }
 
 ///Return if the ringtone are enabled
 bool Account::isRingtoneEnabled() const
 {
-   return (d_ptr->accountDetail(DRing::Account::ConfProperties::Ringtone::ENABLED) IS_TRUE);
+   return (d_ptr->accountDetailBool(AccountDetails::Key::RINGTONE_ENABLED));
 }
 
 ///Return the account ringtone path
 QString Account::ringtonePath() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Ringtone::PATH);
+   return d_ptr->accountDetail(AccountDetails::Key::RINGTONE_PATH);
 }
 
 ///Return the last error message received
@@ -976,11 +1082,11 @@ int Account::localPort() const
    switch (protocol()) {
       case Account::Protocol::SIP:
          if (isTlsEnabled())
-            return d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::LISTENER_PORT).toInt();
+            return d_ptr->accountDetailInt(AccountDetails::Key::TLS_LISTENER_PORT);
          else
-            return d_ptr->accountDetail(DRing::Account::ConfProperties::LOCAL_PORT).toInt();
+            return d_ptr->accountDetailInt(AccountDetails::Key::LOCAL_PORT);
       case Account::Protocol::RING:
-         return d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::LISTENER_PORT).toInt();
+         return d_ptr->accountDetailInt(AccountDetails::Key::TLS_LISTENER_PORT);
       case Account::Protocol::COUNT__:
          break;
    };
@@ -1010,7 +1116,7 @@ Account::Protocol Account::protocol() const
 {
    // Changing an account protocol is not supported
    if (d_ptr->m_Protocol == Account::Protocol::COUNT__) {
-      const QString str = d_ptr->accountDetail(DRing::Account::ConfProperties::TYPE);
+      const QString str = d_ptr->accountDetail(AccountDetails::Key::TYPE);
 
       if (str.isEmpty() || str == DRing::Account::ProtocolNames::SIP)
          d_ptr->m_Protocol = Account::Protocol::SIP;
@@ -1059,7 +1165,7 @@ ContactMethod* Account::contactMethod() const
 ///Return the DTMF type
 DtmfType Account::DTMFType() const
 {
-   QString type = d_ptr->accountDetail(DRing::Account::ConfProperties::DTMF_TYPE);
+   QString type = d_ptr->accountDetail(AccountDetails::Key::DTMF_TYPE);
    return (type == QLatin1String("overrtp") || type.isEmpty())? DtmfType::OverRtp:DtmfType::OverSip;
 }
 
@@ -1075,12 +1181,12 @@ QString Account::presenceMessage() const
 
 bool Account::supportPresencePublish() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Presence::SUPPORT_PUBLISH) IS_TRUE;
+   return d_ptr->accountDetailBool(AccountDetails::Key::PRESENCE_SUPPORT_PUBLISH);
 }
 
 bool Account::supportPresenceSubscribe() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Presence::SUPPORT_SUBSCRIBE) IS_TRUE;
+   return d_ptr->accountDetailBool(AccountDetails::Key::PRESENCE_SUPPORT_SUBSCRIBE);
 }
 
 bool Account::canCall() const
@@ -1096,47 +1202,47 @@ bool Account::canVideoCall() const
 
 bool Account::presenceEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Presence::ENABLED) IS_TRUE;
+   return d_ptr->accountDetailBool(AccountDetails::Key::PRESENCE_ENABLED);
 }
 
 bool Account::isVideoEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Video::ENABLED) IS_TRUE;
+   return d_ptr->accountDetailBool(AccountDetails::Key::VIDEO_ENABLED);
 }
 
 int Account::videoPortMax() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Video::PORT_MAX).toInt();
+   return d_ptr->accountDetailInt(AccountDetails::Key::VIDEO_PORT_MAX);
 }
 
 int Account::videoPortMin() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Video::PORT_MIN).toInt();
+   return d_ptr->accountDetailInt(AccountDetails::Key::VIDEO_PORT_MIN);
 }
 
 int Account::audioPortMin() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Audio::PORT_MIN).toInt();
+   return d_ptr->accountDetailInt(AccountDetails::Key::AUDIO_PORT_MIN);
 }
 
 int Account::audioPortMax() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Audio::PORT_MAX).toInt();
+   return d_ptr->accountDetailInt(AccountDetails::Key::AUDIO_PORT_MAX);
 }
 
 bool Account::isUpnpEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::UPNP_ENABLED) IS_TRUE;
+   return d_ptr->accountDetailBool(AccountDetails::Key::UPNP_ENABLED);
 }
 
 bool Account::hasCustomUserAgent() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::HAS_CUSTOM_USER_AGENT) IS_TRUE;
+   return d_ptr->accountDetailBool(AccountDetails::Key::HAS_CUSTOM_USER_AGENT);
 }
 
 QString Account::userAgent() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::USER_AGENT);
+   return d_ptr->accountDetail(AccountDetails::Key::USER_AGENT);
 }
 
 bool Account::useDefaultPort() const
@@ -1146,27 +1252,27 @@ bool Account::useDefaultPort() const
 
 bool Account::isTurnEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::ENABLED) IS_TRUE;
+   return d_ptr->accountDetailBool(AccountDetails::Key::TURN_ENABLED);
 }
 
 QString Account::turnServer() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER);
+   return d_ptr->accountDetail(AccountDetails::Key::TURN_SERVER);
 }
 
 QString Account::turnServerUsername() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER_UNAME);
+   return d_ptr->accountDetail(AccountDetails::Key::TURN_SERVER_UNAME);
 }
 
 QString Account::turnServerPassword() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER_PWD);
+   return d_ptr->accountDetail(AccountDetails::Key::TURN_SERVER_PWD);
 }
 
 QString Account::turnServerRealm() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER_REALM);
+   return d_ptr->accountDetail(AccountDetails::Key::TURN_SERVER_REALM);
 }
 
 bool Account::hasProxy() const
@@ -1176,22 +1282,22 @@ bool Account::hasProxy() const
 
 QString Account::displayName() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::DISPLAYNAME);
+   return d_ptr->accountDetail(AccountDetails::Key::DISPLAYNAME);
 }
 
 QString Account::archivePassword() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ARCHIVE_PASSWORD);
+   return d_ptr->accountDetail(AccountDetails::Key::ARCHIVE_PASSWORD);
 }
 
 QString Account::archivePin() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ARCHIVE_PIN);
+   return d_ptr->accountDetail(AccountDetails::Key::ARCHIVE_PIN);
 }
 
 bool Account::allowIncomingFromUnknown() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::DHT::PUBLIC_IN_CALLS) IS_TRUE;
+   return d_ptr->accountDetailBool(AccountDetails::Key::DHT_PUBLIC_IN_CALLS);
 }
 
 bool Account::allowIncomingFromHistory() const
@@ -1199,7 +1305,7 @@ bool Account::allowIncomingFromHistory() const
    if (protocol() != Account::Protocol::RING)
       return false;
 
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ALLOW_CERT_FROM_HISTORY) IS_TRUE;
+   return d_ptr->accountDetailBool(AccountDetails::Key::ALLOW_CERT_FROM_HISTORY);
 }
 
 bool Account::allowIncomingFromContact() const
@@ -1207,12 +1313,12 @@ bool Account::allowIncomingFromContact() const
    if (protocol() != Account::Protocol::RING)
       return false;
 
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ALLOW_CERT_FROM_CONTACT) IS_TRUE;
+   return d_ptr->accountDetailBool(AccountDetails::Key::ALLOW_CERT_FROM_CONTACT);
 }
 
 int Account::activeCallLimit() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ACTIVE_CALL_LIMIT).toInt();
+   return d_ptr->accountDetailInt(AccountDetails::Key::ACTIVE_CALL_LIMIT);
 }
 
 bool Account::hasActiveCallLimit() const
@@ -1543,32 +1649,31 @@ uint Account::internalId() const
  ****************************************************************************/
 
 ///Set account details
-void AccountPrivate::setAccountProperties(const QHash<QString,QString>& m)
+void AccountPrivate::setAccountProperties(const MapStringString& m)
 {
-   m_hAccountDetails.clear();
-   m_hAccountDetails = m;
+   m_Details.load(m);
    m_HostName = m[DRing::Account::ConfProperties::HOSTNAME];
 }
 
 ///Set a specific detail
-bool AccountPrivate::setAccountProperty(const QString& param, const QString& val)
+bool AccountPrivate::setAccountProperty(AccountDetails::Key key, const QString& val)
 {
-   const QString buf = m_hAccountDetails[param];
+   const QString buf = m_Details.value(key);
    const bool accChanged = buf != val;
    //Status can be changed regardless of the EditState
    //TODO make this more generic for volatile properties
-   if (param == DRing::Account::ConfProperties::Registration::STATUS) {
-      m_hAccountDetails[param] = val;
+   if (key == AccountDetails::Key::REGISTRATION_STATUS) {
+      m_Details.setRemoteValue(key, val);
       if (accChanged) {
          emit q_ptr->changed(q_ptr);
-         emit q_ptr->propertyChanged(q_ptr,param,val,buf);
+         emit q_ptr->propertyChanged(q_ptr,AccountDetails::name(key),val,buf);
       }
    }
    else if (accChanged) {
 
-      m_hAccountDetails[param] = val;
+      m_Details.setValue(key, val);
       emit q_ptr->changed(q_ptr);
-      emit q_ptr->propertyChanged(q_ptr,param,val,buf);
+      emit q_ptr->propertyChanged(q_ptr,AccountDetails::name(key),val,buf);
 
       q_ptr->performAction(Account::EditAction::MODIFY);
    }
@@ -1599,10 +1704,10 @@ void Account::setProtocol(Account::Protocol proto)
    //TODO prevent this if the protocol has been saved
    switch (proto) {
       case Account::Protocol::SIP:
-         d_ptr->setAccountProperty(DRing::Account::ConfProperties::TYPE ,DRing::Account::ProtocolNames::SIP );
+         d_ptr->setAccountProperty(AccountDetails::Key::TYPE ,DRing::Account::ProtocolNames::SIP );
          break;
       case Account::Protocol::RING:
-         d_ptr->setAccountProperty(DRing::Account::ConfProperties::TYPE ,DRing::Account::ProtocolNames::RING);
+         d_ptr->setAccountProperty(AccountDetails::Key::TYPE ,DRing::Account::ProtocolNames::RING);
          break;
       case Account::Protocol::COUNT__:
          break;
@@ -1618,7 +1723,7 @@ void Account::setHostname(const QString& detail)
       {
           bootstrapModel() << BootstrapModel::EditAction::RELOAD;
       }
-      d_ptr->setAccountProperty(DRing::Account::ConfProperties::HOSTNAME, detail);
+      d_ptr->setAccountProperty(AccountDetails::Key::HOSTNAME, detail);
    }
 }
 
@@ -1660,7 +1765,7 @@ bool Account::createProfile()
 ///Set the account username, everything is valid, some might be rejected by the PBX server
 void Account::setUsername(const QString& detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::USERNAME, detail);
+   d_ptr->setAccountProperty(AccountDetails::Key::USERNAME, detail);
    switch (protocol()) {
       case Account::Protocol::RING:
       case Account::Protocol::COUNT__:
@@ -1682,19 +1787,19 @@ void Account::setUsername(const QString& detail)
 ///Set the account mailbox, usually a number, but can be anything
 void Account::setMailbox(const QString& detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::MAILBOX, detail);
+   d_ptr->setAccountProperty(AccountDetails::Key::MAILBOX, detail);
 }
 
 ///Set the account mailbox, usually a number, but can be anything
 void Account::setProxy(const QString& detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::ROUTE, detail);
+   d_ptr->setAccountProperty(AccountDetails::Key::ROUTE, detail);
 }
 
 //Set the name service URL
 void Account::setNameServiceURL(const QString& detail)
 {
-    d_ptr->setAccountProperty(DRing::Account::ConfProperties::RingNS::URI, detail);
+    d_ptr->setAccountProperty(AccountDetails::Key::RINGNS_URI, detail);
 }
 
 ///Set the main credential password
@@ -1727,7 +1832,7 @@ void Account::setTlsPassword(const QString& detail)
    if (!cert)
       return;
    cert->setPrivateKeyPassword(detail);
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::TLS::PASSWORD, detail);
+   d_ptr->setAccountProperty(AccountDetails::Key::TLS_PASSWORD, detail);
    d_ptr->regenSecurityValidation();
 }
 
@@ -1753,7 +1858,7 @@ void Account::setTlsPrivateKey(const QString& path)
         return;
 
     cert->setPrivateKeyPath(path);
-    d_ptr->setAccountProperty(DRing::Account::ConfProperties::TLS::PRIVATE_KEY_FILE, cert?path:QString());
+    d_ptr->setAccountProperty(AccountDetails::Key::TLS_PRIVATE_KEY_FILE, cert?path:QString());
     d_ptr->regenSecurityValidation();
 }
 
@@ -1769,7 +1874,7 @@ void Account::setTlsCaListCertificate(Certificate* cert)
    allowCertificate(cert);
 
    d_ptr->m_pCaCert = cert;
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::TLS::CA_LIST_FILE, cert?cert->path():QString());
+   d_ptr->setAccountProperty(AccountDetails::Key::TLS_CA_LIST_FILE, cert?cert->path():QString());
    d_ptr->regenSecurityValidation();
 
    if (d_ptr->m_cTlsCaCert)
@@ -1790,33 +1895,33 @@ void Account::setTlsCertificate(Certificate* cert)
    cert->setRequirePrivateKey(true);
 
    d_ptr->m_pTlsCert = cert;
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::TLS::CERTIFICATE_FILE, cert?cert->path():QString());
+   d_ptr->setAccountProperty(AccountDetails::Key::TLS_CERTIFICATE_FILE, cert?cert->path():QString());
    d_ptr->regenSecurityValidation();
 }
 
 ///Set the TLS server
 void Account::setTlsServerName(const QString& detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::TLS::SERVER_NAME, detail);
+   d_ptr->setAccountProperty(AccountDetails::Key::TLS_SERVER_NAME, detail);
    d_ptr->regenSecurityValidation();
 }
 
 ///Set the stun server
 void Account::setSipStunServer(const QString& detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::STUN::SERVER, detail);
+   d_ptr->setAccountProperty(AccountDetails::Key::STUN_SERVER, detail);
 }
 
 ///Set the published address
 void Account::setPublishedAddress(const QString& detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::PUBLISHED_ADDRESS, detail);
+   d_ptr->setAccountProperty(AccountDetails::Key::PUBLISHED_ADDRESS, detail);
 }
 
 ///Set the ringtone path, it have to be a valid absolute path
 void Account::setRingtonePath(const QString& detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::Ringtone::PATH, detail);
+   d_ptr->setAccountProperty(AccountDetails::Key::RINGTONE_PATH, detail);
 }
 
 ///Set the number of voice mails
@@ -1828,13 +1933,13 @@ void Account::setVoiceMailCount(int count)
 ///Set the account timeout, it will be renegotiated when that timeout occur
 void Account::setRegistrationExpire(int detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::Registration::EXPIRE, QString::number(detail));
+   d_ptr->setAccountProperty(AccountDetails::Key::REGISTRATION_EXPIRE, QString::number(detail));
 }
 
 ///Set TLS negotiation timeout in second
 void Account::setTlsNegotiationTimeoutSec(int detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::TLS::NEGOTIATION_TIMEOUT_SEC, QString::number(detail));
+   d_ptr->setAccountProperty(AccountDetails::Key::TLS_NEGOTIATION_TIMEOUT_SEC, QString::number(detail));
    d_ptr->regenSecurityValidation();
 }
 
@@ -1844,12 +1949,12 @@ void Account::setLocalPort(unsigned short detail)
    switch (protocol()) {
       case Account::Protocol::SIP:
          if (isTlsEnabled())
-            d_ptr->setAccountProperty(DRing::Account::ConfProperties::TLS::LISTENER_PORT, QString::number(detail));
+            d_ptr->setAccountProperty(AccountDetails::Key::TLS_LISTENER_PORT, QString::number(detail));
          else
-            d_ptr->setAccountProperty(DRing::Account::ConfProperties::LOCAL_PORT, QString::number(detail));
+            d_ptr->setAccountProperty(AccountDetails::Key::LOCAL_PORT, QString::number(detail));
          break;
       case Account::Protocol::RING:
-         d_ptr->setAccountProperty(DRing::Account::ConfProperties::TLS::LISTENER_PORT, QString::number(detail));
+         d_ptr->setAccountProperty(AccountDetails::Key::TLS_LISTENER_PORT, QString::number(detail));
          break;
       case Account::Protocol::COUNT__:
          break;
@@ -1859,70 +1964,70 @@ void Account::setLocalPort(unsigned short detail)
 ///Set the TLS listener port (0-2^16)
 void Account::setBootstrapPort(unsigned short detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::DHT::PORT, QString::number(detail));
+   d_ptr->setAccountProperty(AccountDetails::Key::DHT_PORT, QString::number(detail));
 }
 
 ///Set the published port (0-2^16)
 void Account::setPublishedPort(unsigned short detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::PUBLISHED_PORT, QString::number(detail));
+   d_ptr->setAccountProperty(AccountDetails::Key::PUBLISHED_PORT, QString::number(detail));
 }
 
 ///Set if the account is enabled or not
 void Account::setEnabled(bool detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::ENABLED, (detail)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::ENABLED, (detail)TO_BOOL);
 }
 
 ///Set if the account should auto answer
 void Account::setAutoAnswer(bool detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::AUTOANSWER, (detail)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::AUTOANSWER, (detail)TO_BOOL);
 }
 
 ///Set the TLS verification server
 void Account::setTlsVerifyServer(bool detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::TLS::VERIFY_SERVER, (detail)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::TLS_VERIFY_SERVER, (detail)TO_BOOL);
    d_ptr->regenSecurityValidation();
 }
 
 ///Set the TLS verification client
 void Account::setTlsVerifyClient(bool detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::TLS::VERIFY_CLIENT, (detail)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::TLS_VERIFY_CLIENT, (detail)TO_BOOL);
    d_ptr->regenSecurityValidation();
 }
 
 ///Set if the peer need to be providing a certificate
 void Account::setTlsRequireClientCertificate(bool detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::TLS::REQUIRE_CLIENT_CERTIFICATE ,(detail)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::TLS_REQUIRE_CLIENT_CERTIFICATE ,(detail)TO_BOOL);
    d_ptr->regenSecurityValidation();
 }
 
 ///Set if the security settings are enabled
 void Account::setTlsEnabled(bool detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::TLS::ENABLED ,(detail)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::TLS_ENABLED ,(detail)TO_BOOL);
    d_ptr->regenSecurityValidation();
 }
 
 void Account::setSrtpRtpFallback(bool detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::SRTP::RTP_FALLBACK, (detail)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::SRTP_RTP_FALLBACK, (detail)TO_BOOL);
    d_ptr->regenSecurityValidation();
 }
 
 void Account::setSrtpEnabled(bool detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::SRTP::ENABLED, (detail)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::SRTP_ENABLED, (detail)TO_BOOL);
    d_ptr->regenSecurityValidation();
 }
 
 void Account::setSipStunEnabled(bool detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::STUN::ENABLED, (detail)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::STUN_ENABLED, (detail)TO_BOOL);
 }
 
 /**
@@ -1932,13 +2037,13 @@ void Account::setSipStunEnabled(bool detail)
  */
 void Account::setPublishedSameAsLocal(bool detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::PUBLISHED_SAMEAS_LOCAL, (detail)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::PUBLISHED_SAMEAS_LOCAL, (detail)TO_BOOL);
 }
 
 ///Set if custom ringtone are enabled
 void Account::setRingtoneEnabled(bool detail)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::Ringtone::ENABLED, (detail)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::RINGTONE_ENABLED, (detail)TO_BOOL);
 }
 
 /**
@@ -1949,14 +2054,14 @@ void Account::setRingtoneEnabled(bool detail)
  */
 void Account::setPresenceEnabled(bool enable)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::Presence::ENABLED, (enable)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::PRESENCE_ENABLED, (enable)TO_BOOL);
    emit presenceEnabledChanged(enable);
 }
 
 ///Use video by default when available
 void Account::setVideoEnabled(bool enable)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::Video::ENABLED, (enable)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::VIDEO_ENABLED, (enable)TO_BOOL);
    emit canVideoCallChanged(canVideoCall());
 }
 
@@ -1966,7 +2071,7 @@ void Account::setVideoEnabled(bool enable)
  */
 void Account::setAudioPortMax(int port )
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::Audio::PORT_MAX, QString::number(port));
+   d_ptr->setAccountProperty(AccountDetails::Key::AUDIO_PORT_MAX, QString::number(port));
 }
 
 /**Set the minimum audio port
@@ -1975,7 +2080,7 @@ void Account::setAudioPortMax(int port )
  */
 void Account::setAudioPortMin(int port )
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::Audio::PORT_MIN, QString::number(port));
+   d_ptr->setAccountProperty(AccountDetails::Key::AUDIO_PORT_MIN, QString::number(port));
 }
 
 /**Set the maximum video port
@@ -1984,7 +2089,7 @@ void Account::setAudioPortMin(int port )
  */
 void Account::setVideoPortMax(int port )
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::Video::PORT_MAX, QString::number(port));
+   d_ptr->setAccountProperty(AccountDetails::Key::VIDEO_PORT_MAX, QString::number(port));
 }
 
 /**Set the minimum video port
@@ -1993,17 +2098,17 @@ void Account::setVideoPortMax(int port )
  */
 void Account::setVideoPortMin(int port )
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::Video::PORT_MIN, QString::number(port));
+   d_ptr->setAccountProperty(AccountDetails::Key::VIDEO_PORT_MIN, QString::number(port));
 }
 
 void Account::setUpnpEnabled(bool enable)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::UPNP_ENABLED, (enable)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::UPNP_ENABLED, (enable)TO_BOOL);
 }
 
 void Account::setHasCustomUserAgent(bool enable)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::HAS_CUSTOM_USER_AGENT, (enable)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::HAS_CUSTOM_USER_AGENT, (enable)TO_BOOL);
 }
 
 ///TODO implement the "use default" logic correctly
@@ -2012,7 +2117,7 @@ void Account::setHasCustomUserAgent(bool enable)
  */
 void Account::setUserAgent(const QString& agent)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::USER_AGENT, agent);
+   d_ptr->setAccountProperty(AccountDetails::Key::USER_AGENT, agent);
 }
 
 void Account::setUseDefaultPort(bool value)
@@ -2034,47 +2139,47 @@ void Account::setUseDefaultPort(bool value)
 
 void Account::setTurnEnabled(bool value)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::TURN::ENABLED, (value)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::TURN_ENABLED, (value)TO_BOOL);
 }
 
 void Account::setTurnServer(const QString& value)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::TURN::SERVER, value);
+   d_ptr->setAccountProperty(AccountDetails::Key::TURN_SERVER, value);
 }
 
 void Account::setTurnServerUsername(const QString& value)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::TURN::SERVER_UNAME, value);
+   d_ptr->setAccountProperty(AccountDetails::Key::TURN_SERVER_UNAME, value);
 }
 
 void Account::setTurnServerPassword(const QString& value)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::TURN::SERVER_PWD, value);
+   d_ptr->setAccountProperty(AccountDetails::Key::TURN_SERVER_PWD, value);
 }
 
 void Account::setTurnServerRealm(const QString& value)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::TURN::SERVER_REALM, value);
+   d_ptr->setAccountProperty(AccountDetails::Key::TURN_SERVER_REALM, value);
 }
 
 void Account::setDisplayName(const QString& value)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::DISPLAYNAME, value);
+   d_ptr->setAccountProperty(AccountDetails::Key::DISPLAYNAME, value);
 }
 
 void Account::setArchivePassword(const QString& value)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::ARCHIVE_PASSWORD, value);
+   d_ptr->setAccountProperty(AccountDetails::Key::ARCHIVE_PASSWORD, value);
 }
 
 void Account::setArchivePin(const QString& value)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::ARCHIVE_PIN, value);
+   d_ptr->setAccountProperty(AccountDetails::Key::ARCHIVE_PIN, value);
 }
 
 void Account::setAllowIncomingFromUnknown(bool value)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::DHT::PUBLIC_IN_CALLS, (value)TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::DHT_PUBLIC_IN_CALLS, (value)TO_BOOL);
 }
 
 void Account::setAllowIncomingFromHistory(bool value)
@@ -2082,7 +2187,7 @@ void Account::setAllowIncomingFromHistory(bool value)
    if (protocol() != Account::Protocol::RING)
       return;
 
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::ALLOW_CERT_FROM_HISTORY, value TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::ALLOW_CERT_FROM_HISTORY, value TO_BOOL);
    performAction(Account::EditAction::MODIFY);
 }
 
@@ -2091,13 +2196,13 @@ void Account::setAllowIncomingFromContact(bool value)
    if (protocol() != Account::Protocol::RING)
       return;
 
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::ALLOW_CERT_FROM_CONTACT, value TO_BOOL);
+   d_ptr->setAccountProperty(AccountDetails::Key::ALLOW_CERT_FROM_CONTACT, value TO_BOOL);
    performAction(Account::EditAction::MODIFY);
 }
 
 void Account::setActiveCallLimit(int value )
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::ACTIVE_CALL_LIMIT, QString::number(value));
+   d_ptr->setAccountProperty(AccountDetails::Key::ACTIVE_CALL_LIMIT, QString::number(value));
 }
 
 void Account::setHasActiveCallLimit(bool value )
@@ -2111,7 +2216,7 @@ void Account::setHasActiveCallLimit(bool value )
 ///Set the DTMF type
 void Account::setDTMFType(DtmfType type)
 {
-   d_ptr->setAccountProperty(DRing::Account::ConfProperties::DTMF_TYPE,(type==OverRtp)?"overrtp":"oversip");
+   d_ptr->setAccountProperty(AccountDetails::Key::DTMF_TYPE,(type==OverRtp)?"overrtp":"oversip");
 }
 
 void Account::setProfile(Person* p)
@@ -2545,6 +2650,83 @@ QString AccountPrivate::buildUri()
     return currentUri;
 }
 
+/**
+ * SIP messages need to be very small ( < 2kB ) not to hit some hardcoded
+ * buffer size in the PJ_SIP. As profile photo tend to hover around 10kB,
+ * the profile need to be sent in parts and re-assembled. To do this, the
+ * most simple way is to add MIME type metadata intended for the peer. Of
+ * course, this is an ugly hack is while vCard is a standard, using it
+ * like this is not. Therefore we use the proprietary PROFILE_VCF MIME.
+ *
+ * The chunks are only rebuilt when the profile changes. The version is the
+ * vCard hash and is also used as the reassembly id so the peer (and the
+ * ContactMethod) can tell a new profile from a re-sent one.
+ */
+const AccountPrivate::ProfilePayload& AccountPrivate::profilePayload()
+{
+    // In bytes, the limit is about the SIP message size
+    static constexpr const int CHUNK_SIZE = 1000;
+
+    auto profile = q_ptr->profile();
+
+    if (profile != m_ProfilePayload.profile) {
+        QObject::disconnect(m_ProfilePayload.connection);
+        m_ProfilePayload = {};
+        m_ProfilePayload.profile = profile;
+
+        if (profile)
+            m_ProfilePayload.connection = QObject::connect(profile, &Person::changed, q_ptr, [this]() {
+                m_ProfilePayload.isDirty = true;
+            });
+    }
+
+    if ((!profile) || !m_ProfilePayload.isDirty)
+        return m_ProfilePayload;
+
+    m_ProfilePayload.isDirty = false;
+
+    const QByteArray vCard   = profile->toVCard();
+    const QByteArray version = QCryptographicHash::hash(
+        vCard, QCryptographicHash::Sha1
+    ).toHex();
+
+    if (version == m_ProfilePayload.version)
+        return m_ProfilePayload;
+
+    const QString key = QString::fromLatin1(version.left(16));
+
+    // Split once, without cutting an UTF-8 sequence in half
+    QVector<QString> parts;
+    for (int pos = 0; pos < vCard.size();) {
+        int len = std::min(CHUNK_SIZE, vCard.size() - pos);
+
+        while (pos + len < vCard.size() && len > 1 && (vCard[pos + len] & 0xC0) == 0x80)
+            --len;
+
+        parts << QString::fromUtf8(vCard.constData() + pos, len);
+        pos += len;
+    }
+
+    m_ProfilePayload.version = version;
+    m_ProfilePayload.chunks.clear();
+    m_ProfilePayload.chunks.reserve(parts.size());
+
+    const QString total = QString::number(parts.size());
+
+    for (int i = 0; i < parts.size(); i++) {
+        QMap<QString, QString> chunk;
+        chunk[QStringLiteral("%1; id=%2,part=%3,of=%4")
+               .arg( RingMimes::PROFILE_VCF )
+               .arg( key                    )
+               .arg( QString::number( i+1 ) )
+               .arg( total                  )
+            ] = parts[i];
+        m_ProfilePayload.chunks << chunk;
+    }
+
+    return m_ProfilePayload;
+}
+
 /**Update the account
  * @return if the state changed
  */
@@ -2557,7 +2739,7 @@ bool AccountPrivate::updateState()
       const Account::RegistrationState cst = q_ptr->registrationState();
       const Account::RegistrationState st  = Account::fromDaemonName(status);
 
-      setAccountProperty(DRing::Account::ConfProperties::Registration::STATUS, status); //Update -internal- object state
+      setAccountProperty(AccountDetails::Key::REGISTRATION_STATUS, status); //Update -internal- object state
       m_RegistrationState = st;
 
       if (st != cst) {
@@ -2582,20 +2764,14 @@ void AccountPrivate::save()
    ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
 
    // Sync the device name
-   if (q_ptr->ringDevice() && q_ptr->ringDevice()->name() != accountDetail(DRing::Account::ConfProperties::RING_DEVICE_NAME))
+   if (q_ptr->ringDevice() && q_ptr->ringDevice()->name() != accountDetail(AccountDetails::Key::RING_DEVICE_NAME))
       setAccountProperty(
-         DRing::Account::ConfProperties::RING_DEVICE_NAME,
+         AccountDetails::Key::RING_DEVICE_NAME,
          q_ptr->ringDevice()->name()
       );
 
    if (q_ptr->isNew()) {
-      MapStringString details;
-      QMutableHashIterator<QString,QString> iter(m_hAccountDetails);
-
-      while (iter.hasNext()) {
-         iter.next();
-         details[iter.key()] = iter.value();
-      }
+      const MapStringString details = m_Details.toMap();
 
       //Clear the password
       q_ptr->setArchivePassword(QLatin1String(""));
@@ -2607,14 +2783,13 @@ void AccountPrivate::save()
       setId(currentId.toLatin1());
    } //New account
    else { //Existing account
-      MapStringString tmp;
-      QMutableHashIterator<QString,QString> iter(m_hAccountDetails);
-
-      while (iter.hasNext()) {
-         iter.next();
-         tmp[iter.key()] = iter.value();
+      // The daemon replaces all details with the map, so it has to be
+      // complete. Skip the round trip when nothing changed.
+      if (m_Details.isDirty()) {
+         configurationManager.setAccountDetails(q_ptr->id(), m_Details.toMap());
+         m_Details.clearDirty();
       }
-      configurationManager.setAccountDetails(q_ptr->id(), tmp);
+
       if (m_RemoteEnabledState != q_ptr->isEnabled()) {
          m_RemoteEnabledState = q_ptr->isEnabled();
          emit q_ptr->enabled(m_RemoteEnabledState);
@@ -2651,31 +2826,28 @@ void AccountPrivate::reload()
           return;
       }
 
-      if (m_hAccountDetails.size())
+      if (!m_Details.isEmpty())
          qDebug() << "Reloading" << q_ptr->id() << q_ptr->alias();
 
       ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
-      QMap<QString,QString> aDetails = configurationManager.getAccountDetails(q_ptr->id());
+
+      // When bootstrapping, the details are already fetched
+      QMap<QString,QString> aDetails = m_pBootstrap ?
+         m_pBootstrap->details : configurationManager.getAccountDetails(q_ptr->id());
 
       if (!aDetails.count()) {
          qDebug() << "Account not found";
       }
       else {
-         m_hAccountDetails.clear();
-         //In case not all elements match, it is better to do a "merge"
-         QMutableMapIterator<QString, QString> iter(aDetails);
-         while (iter.hasNext()) {
-            iter.next();
-            m_hAccountDetails[iter.key()] = iter.value();
-         }
+         m_Details.load(aDetails);
 
          //Manually re-set elements that need extra business logic or caching
-         q_ptr->setHostname(m_hAccountDetails[DRing::Account::ConfProperties::HOSTNAME]);
+         q_ptr->setHostname(m_Details.value(AccountDetails::Key::HOSTNAME));
 
-         const QString ca  (m_hAccountDetails[DRing::Account::ConfProperties::TLS::CA_LIST_FILE    ]);
-         const QString cert(m_hAccountDetails[DRing::Account::ConfProperties::TLS::CERTIFICATE_FILE]);
-         const QString key (m_hAccountDetails[DRing::Account::ConfProperties::TLS::PRIVATE_KEY_FILE]);
-         const QString pass(m_hAccountDetails[DRing::Account::ConfProperties::TLS::PASSWORD]);
+         const QString ca  (m_Details.value(AccountDetails::Key::TLS_CA_LIST_FILE));
+         const QString cert(m_Details.value(AccountDetails::Key::TLS_CERTIFICATE_FILE));
+         const QString key (m_Details.value(AccountDetails::Key::TLS_PRIVATE_KEY_FILE));
+         const QString pass(m_Details.value(AccountDetails::Key::TLS_PASSWORD));
 
          if (!ca.isEmpty())
             q_ptr->setTlsCaListCertificate(ca);
@@ -2726,10 +2898,15 @@ void AccountPrivate::reload()
 
       emit q_ptr->changed(q_ptr);
 
+      //The details were replaced without propertyChanged, evaluate everything
+      regenSecurityValidation();
+
       //The registration state is cached, update that cache
       updateState();
 
-      AccountModel::instance().d_ptr->slotVolatileAccountDetailsChange(q_ptr->id(),configurationManager.getVolatileAccountDetails(q_ptr->id()));
+      AccountModel::instance().d_ptr->slotVolatileAccountDetailsChange(q_ptr->id(), m_pBootstrap ?
+         m_pBootstrap->volatileDetails : configurationManager.getVolatileAccountDetails(q_ptr->id())
+      );
 
       m_ReloadLock.unlock();
    }
@@ -2835,10 +3012,12 @@ void AccountPrivate::outdate() {
    changeState(Account::EditState::OUTDATED);
 }
 
+/// The changed properties were already reported by propertyChanged(), this
+/// only makes sure the evaluation happens
 void AccountPrivate::regenSecurityValidation()
 {
    if (m_pSecurityEvaluationModel) {
-      m_pSecurityEvaluationModel->d_ptr->update();
+      m_pSecurityEvaluationModel->d_ptr->update(SecurityEvaluationModelPrivate::Input::ALL);
    }
 }
 
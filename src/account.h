@@ -95,6 +95,7 @@ class LIB_EXPORT Account : public ItemBase {
    friend class NetworkInterfaceModelPrivate;
    friend class CipherModel;
    friend class CipherModelPrivate;
+   friend class CallPrivate;
 
    using ContactMethods = QVector<ContactMethod*>;
 
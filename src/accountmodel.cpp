@@ -55,6 +55,9 @@
 #include "private/vcardutils.h"
 #include "phonedirectorymodel.h"
 #include "bannedcontactmodel.h"
+#include "collectionloader.h"
+#include "tracing.h"
+#include "libcard/calendar.h"
 
 QHash<QByteArray,AccountPlaceHolder*> AccountModelPrivate::m_hsPlaceHolder;
 
@@ -70,8 +73,14 @@ AccountModel::AccountModel()
 void AccountModelPrivate::init()
 {
     InstanceManager::instance(); // Make sure the daemon is running before calling updateAccounts()
+
+    // The calendars reference the accounts
+    CollectionLoader::addDependency<Calendar>("accounts");
+
     q_ptr->updateAccounts();
 
+    CollectionLoader::instance().setReady("accounts");
+
     CallManagerInterface& callManager = CallManager::instance();
     ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
 
@@ -317,6 +326,7 @@ void AccountModelPrivate::connectAccount(Account* acc)
 ///Account status changed
 void AccountModelPrivate::slotDaemonAccountChanged(const QString& account, const QString& registration_state, unsigned code, const QString& status)
 {
+   TRACE_SCOPE("daemon", "AccountModelPrivate::slotDaemonAccountChanged");
    Q_UNUSED(registration_state);
    Account* a = q_ptr->getById(account.toLatin1());
 
@@ -335,19 +345,29 @@ void AccountModelPrivate::slotDaemonAccountChanged(const QString& account, const
    if (!a) {
       qDebug() << "received account changed for non existing account" << account;
       const QStringList accountIds = configurationManager.getAccountList();
+
+      QList<QByteArray> newIds;
+      QVector<int> positions;
       for (int i = 0; i < accountIds.size(); ++i) {
          if ((!q_ptr->getById(accountIds[i].toLatin1())) && m_lDeletedAccounts.indexOf(accountIds[i]) == -1) {
-            Account* acc = AccountPrivate::buildExistingAccountFromId(accountIds[i].toLatin1());
             qDebug() << "building missing account" << accountIds[i];
-            insertAccount(acc,i);
-            connectAccount(acc);
+            newIds    << accountIds[i].toLatin1();
+            positions << i;
+         }
+      }
 
-            emit q_ptr->accountAdded(acc);
+      // Build all missing accounts at once to pipeline the daemon queries
+      const auto accounts = AccountPrivate::buildExistingAccountsFromIds(newIds);
 
-            if (!acc->isIp2ip())
-               enableProtocol(acc->protocol());
+      for (int j = 0; j < accounts.size(); ++j) {
+         Account* acc = accounts[j];
+         insertAccount(acc,positions[j]);
+         connectAccount(acc);
 
-         }
+         emit q_ptr->accountAdded(acc);
+
+         if (!acc->isIp2ip())
+            enableProtocol(acc->protocol());
       }
 
       // remove any accounts that are not found in the daemon and which are marked to be REMOVED
@@ -425,6 +445,7 @@ void AccountModelPrivate::slotAccountChanged(Account* a)
 ///When a new voice mail is available
 void AccountModelPrivate::slotVoiceMailNotify(const QString &accountID, int count)
 {
+   TRACE_SCOPE("daemon", "AccountModelPrivate::slotVoiceMailNotify");
    Account* a = q_ptr->getById(accountID.toLatin1());
    if (a) {
       a->setVoiceMailCount(count);
@@ -442,6 +463,7 @@ void AccountModelPrivate::slotAccountPresenceEnabledChanged(bool state)
 ///Emitted when some runtime details changes
 void AccountModelPrivate::slotVolatileAccountDetailsChange(const QString& accountId, const MapStringString& details)
 {
+   TRACE_SCOPE("daemon", "AccountModelPrivate::slotVolatileAccountDetailsChange");
    if (auto a = q_ptr->getById(accountId.toLatin1())) {
       const int     transportCode = details[DRing::Account::VolatileProperties::Transport::STATE_CODE].toInt();
       const QString transportDesc = details[DRing::Account::VolatileProperties::Transport::STATE_DESC];
@@ -453,7 +475,7 @@ void AccountModelPrivate::slotVolatileAccountDetailsChange(const QString& accoun
       a->d_ptr->setLastTransportMessage(transportDesc);
 
       const Account::RegistrationState state = Account::fromDaemonName(
-          a->d_ptr->accountDetail(DRing::Account::ConfProperties::Registration::STATUS)
+          a->d_ptr->accountDetail(AccountDetails::Key::REGISTRATION_STATUS)
       );
 
       a->d_ptr->setRegistrationState(state);
@@ -465,6 +487,7 @@ void AccountModelPrivate::slotVolatileAccountDetailsChange(const QString& accoun
 ///Known Ring devices have changed
 void AccountModelPrivate::slotKownDevicesChanged(const QString& accountId, const MapStringString& accountDevices)
 {
+   TRACE_SCOPE("daemon", "AccountModelPrivate::slotKownDevicesChanged");
    qDebug() << "Known devices changed" << accountId;
 
    Account* a = q_ptr->getById(accountId.toLatin1());
@@ -480,6 +503,7 @@ void AccountModelPrivate::slotKownDevicesChanged(const QString& accountId, const
 ///Export on Ring ended
 void AccountModelPrivate::slotExportOnRingEnded(const QString& accountId, int status, const QString& pin)
 {
+   TRACE_SCOPE("daemon", "AccountModelPrivate::slotExportOnRingEnded");
    qDebug() << "Export on ring ended" << accountId;
 
    Account* a = q_ptr->getById(accountId.toLatin1());
@@ -494,6 +518,7 @@ void AccountModelPrivate::slotExportOnRingEnded(const QString& accountId, int st
 
 void AccountModelPrivate::slotDeviceRevocationEnded(const QString& accountId, const QString& deviceId, int status)
 {
+    TRACE_SCOPE("daemon", "AccountModelPrivate::slotDeviceRevocationEnded");
     Account* a = q_ptr->getById(accountId.toLatin1());
 
     if (!a) {
@@ -508,6 +533,7 @@ void AccountModelPrivate::slotDeviceRevocationEnded(const QString& accountId, co
 void
 AccountModelPrivate::slotMigrationEnded(const QString& accountId, const QString& result)
 {
+    TRACE_SCOPE("daemon", "AccountModelPrivate::slotMigrationEnded");
     Account* a = q_ptr->getById(accountId.toLatin1());
 
     Account::MigrationEndedStatus status;
@@ -531,6 +557,7 @@ AccountModelPrivate::slotMigrationEnded(const QString& accountId, const QString&
 void
 AccountModelPrivate::slotContactRemoved(const QString &accountID, const QString &uri, bool banned)
 {
+    TRACE_SCOPE("daemon", "AccountModelPrivate::slotContactRemoved");
     if (not banned)
         return;
 
@@ -580,18 +607,29 @@ void AccountModel::update()
    }
    //ask for the list of accounts ids to the configurationManager
    const QStringList accountIds = configurationManager.getAccountList();
+
+   QList<QByteArray> newIds;
+   QVector<int> positions;
    for (int i = 0; i < accountIds.size(); ++i) {
       if (d_ptr->m_lDeletedAccounts.indexOf(accountIds[i]) == -1) {
-         Account* a = AccountPrivate::buildExistingAccountFromId(accountIds[i].toLatin1());
-         d_ptr->insertAccount(a,i);
-         emit dataChanged(index(i,0),index(size()-1,0));
-         d_ptr->connectAccount(a);
+         newIds    << accountIds[i].toLatin1();
+         positions << i;
+      }
+   }
 
-         emit accountAdded(a);
+   const auto accounts = AccountPrivate::buildExistingAccountsFromIds(newIds);
 
-         if (!a->isIp2ip())
-            d_ptr->enableProtocol(a->protocol());
-      }
+   for (int j = 0; j < accounts.size(); ++j) {
+      const int i = positions[j];
+      Account* a = accounts[j];
+      d_ptr->insertAccount(a,i);
+      emit dataChanged(index(i,0),index(size()-1,0));
+      d_ptr->connectAccount(a);
+
+      emit accountAdded(a);
+
+      if (!a->isIp2ip())
+         d_ptr->enableProtocol(a->protocol());
    }
 
    d_ptr->slotAvailabilityStatusChanged();
@@ -601,6 +639,7 @@ void AccountModel::update()
 ///Update accounts
 void AccountModel::updateAccounts()
 {
+   TRACE_SCOPE("daemon", "AccountModel::updateAccounts");
    qDebug() << "Updating all accounts";
    ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
    QStringList accountIds = configurationManager.getAccountList();
@@ -613,22 +652,27 @@ void AccountModel::updateAccounts()
    }
 
    //m_lAccounts.clear();
+   QList<QByteArray> newIds;
    for (int i = 0; i < accountIds.size(); ++i) {
       Account* acc = getById(accountIds[i].toLatin1());
-      if (!acc) {
-         Account* a = AccountPrivate::buildExistingAccountFromId(accountIds[i].toLatin1());
-         d_ptr->insertAccount(a,d_ptr->m_lAccounts.size());
-         d_ptr->connectAccount(a);
-         emit dataChanged(index(size()-1,0),index(size()-1,0));
+      if (!acc)
+         newIds << accountIds[i].toLatin1();
+      else
+         acc->performAction(Account::EditAction::RELOAD);
+   }
 
-         if (!a->isIp2ip())
-            d_ptr->enableProtocol(a->protocol());
+   // Build all new accounts at once to pipeline the daemon queries
+   const auto accounts = AccountPrivate::buildExistingAccountsFromIds(newIds);
 
-         emit accountAdded(a);
-      }
-      else {
-         acc->performAction(Account::EditAction::RELOAD);
-      }
+   for (Account* a : qAsConst(accounts)) {
+      d_ptr->insertAccount(a,d_ptr->m_lAccounts.size());
+      d_ptr->connectAccount(a);
+      emit dataChanged(index(size()-1,0),index(size()-1,0));
+
+      if (!a->isIp2ip())
+         d_ptr->enableProtocol(a->protocol());
+
+      emit accountAdded(a);
    }
    emit accountListUpdated();
 } //updateAccounts
@@ -832,6 +876,7 @@ AccountModel::EditState AccountModel::editState() const
 ///Called when codec bitrate changes
 void AccountModelPrivate::slotMediaParametersChanged(const QString& accountId)
 {
+   TRACE_SCOPE("daemon", "AccountModelPrivate::slotMediaParametersChanged");
    Account* a = q_ptr->getById(accountId.toLatin1());
    if (a) {
       if (auto codecModel = a->codecModel()) {
@@ -889,6 +934,8 @@ int AccountModel::size() const
 ///Get data from the model
 QVariant AccountModel::data ( const QModelIndex& idx, int role) const
 {
+   Tracing::Span s("model", "AccountModel::data");
+
    if (!idx.isValid() || idx.row() < 0 || idx.row() >= rowCount())
       return QVariant();
 
@@ -28,6 +28,7 @@
 #include "managermodel.h"
 #include "outputdevicemodel.h"
 #include "inputdevicemodel.h"
+#include "tracing.h"
 
 namespace Audio {
 class SettingsPrivate final : public QObject
@@ -244,6 +245,7 @@ bool Audio::Settings::areDTMFMuted() const
 ///Called when the volume change for external reasons
 void Audio::SettingsPrivate::slotVolumeChanged(const QString& str, double volume)
 {
+   TRACE_SCOPE("daemon", "Audio::SettingsPrivate::slotVolumeChanged");
    if (str == Audio::Settings::DeviceKey::CAPTURE)
       emit q_ptr->captureVolumeChanged(static_cast<int>(volume*100));
    else if (str == Audio::Settings::DeviceKey::PLAYBACK)
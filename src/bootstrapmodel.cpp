@@ -119,7 +119,7 @@ void BootstrapModelPrivate::save()
    }
 
    m_pAccount->d_ptr->setAccountProperty(
-       DRing::Account::ConfProperties::HOSTNAME, ret
+       AccountDetails::Key::HOSTNAME, ret
    );
 
    m_EditState = BootstrapModel::EditState::READY;
@@ -60,6 +60,7 @@
 #include "personmodel.h"
 #include "namedirectory.h"
 #include "accountstatusmodel.h"
+#include "private/account_p.h"
 #include "private/contactmethod_p.h"
 
 #include "media/audio.h"
@@ -1756,6 +1757,8 @@ void CallPrivate::hangUp()
       qDebug() << "Error: Invalid call, the daemon may have crashed";
       changeCurrentState(Call::State::OVER);
    }
+   else
+      confirmProfileSent();
    if (m_pTimer)
       m_pTimer->stop();
 }
@@ -1792,44 +1795,49 @@ void CallPrivate::abort()
  * If he doesn't then an "unsupported media" error will be
  * sent by the peer.
  *
- * @todo Do not try to re-send profiles to that CM (save in history?)
+ * The profile is only sent again to a ContactMethod when it changed since
+ * the last time it was sent during this session.
+ *
+ * @see AccountPrivate::profilePayload for the chunking.
+ * @see confirmProfileSent
  */
 void CallPrivate::sendProfile()
 {
-    auto profile = m_LegacyFields.m_Account->profile();
+    const auto& payload = m_LegacyFields.m_Account->d_ptr->profilePayload();
+
+    if (payload.chunks.isEmpty())
+        return;
+
+    auto cm = q_ptr->peerContactMethod();
 
-    if (not profile)
+    if (cm && cm->d_ptr->m_SentProfileVersion == payload.version)
         return;
 
-    /*
-     * SIP messages need to be very small ( < 2kB ) not to hit some hardcoded
-     * buffer size in the PJ_SIP. As profile photo tend to hover around 10kB,
-     * the profile need to be sent in parts and re-assembled. To do this, the
-     * most simple way is to add MIME type metadata intended for the peer. Of
-     * course, this is an ugly hack is while vCard is a standard, using it
-     * like this is not. Therefore we use the proprietary PROFILE_VCF MIME.
-     */
     auto t = mediaFactory<Media::Text>(Media::Media::Direction::OUT);
-    auto vCard = profile->toVCard();
-
-    qsrand(time(nullptr));
-    const auto& key = QString::number(qrand());
-
-    int i = 0;
-    int total = vCard.size()/1000 + (vCard.size()%1000?1:0);
-    while (vCard.size()) {
-        QMap<QString, QString> chunk;
-        chunk[QStringLiteral("%1; id=%2,part=%3,of=%4")
-               .arg( RingMimes::PROFILE_VCF     )
-               .arg( key                        )
-               .arg( QString::number( i+1   ) )
-               .arg( QString::number( total )   )
-            ] = vCard.left(1000);
-        vCard = vCard.remove(0, 1000);
-        ++i;
+
+    if (!t)
+        return;
+
+    for (const auto& chunk : qAsConst(payload.chunks))
         t->send(chunk);
-    }
 
+    m_PendingProfile = payload.version;
+}
+
+/**
+ * The in-call messages have no delivery report. They are sent over the call
+ * session, so a call which ends normally (rather than failing) is the best
+ * available proof the profile was received.
+ */
+void CallPrivate::confirmProfileSent()
+{
+    if (m_PendingProfile.isEmpty())
+        return;
+
+    if (auto cm = q_ptr->peerContactMethod())
+        cm->d_ptr->m_SentProfileVersion = m_PendingProfile;
+
+    m_PendingProfile.clear();
 }
 
 ///Cancel this call
@@ -2105,6 +2113,7 @@ void CallPrivate::stop()
    time_t curTime;
    ::time(&curTime);
    m_LegacyFields.m_pStopTimeStamp = curTime;
+   confirmProfileSent();
 }
 
 ///Handle error instead of crashing
@@ -25,6 +25,7 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QMimeData>
 #include <QtCore/QItemSelectionModel>
+#include <QtCore/QSet>
 
 //Ring library
 #include "call.h"
@@ -62,6 +63,7 @@
 
 //Private
 #include "private/call_p.h"
+#include "tracing.h"
 
 //Define
 ///InternalStruct: internal representation of a call
@@ -71,6 +73,10 @@ struct InternalStruct {
     QList<InternalStruct*> m_lChildren{         };
     bool                   conference { false   };
     InternalStruct*        m_pParent  { nullptr };
+
+    // The bucket of CallModelPrivate::m_lByLifeCycle holding this call
+    Call::LifeCycleState   m_LifeCycle{ Call::LifeCycleState::FINISHED };
+    bool                   m_IsIndexed{ false   };
 };
 
 class CallModelPrivate final : public QObject
@@ -94,11 +100,21 @@ public:
     UserActionModel*                       m_pUserActionModel  {nullptr};
     int                                    m_AutoCleanDelay    {   0   };
 
+    /*
+     * Indexes kept up to date as the calls change. They avoid walking the
+     * whole call tree (or asking the daemon) to answer the frequent queries
+     * such as conferencePossible() or hasDialingCall().
+     */
+    QVector<InternalStruct*> m_lConferences; /*!< The active conferences, in creation order */
+    QSet<InternalStruct*>    m_lByLifeCycle[static_cast<int>(Call::LifeCycleState::COUNT__)]; /*!< The active (non conference) calls */
 
     //Helpers
-    bool isPartOf        ( const QModelIndex& confIdx, Call* call );
-    void removeConference( Call* conf                             );
-    void removeInternal  ( InternalStruct* internal               );
+    bool isPartOf            ( const QModelIndex& confIdx, Call* call );
+    void removeConference    ( Call* conf                             );
+    void removeInternal      ( InternalStruct* internal               );
+    void detachFromConference( InternalStruct* internal               );
+    void indexLifeCycle      ( InternalStruct* internal               );
+    void unindexLifeCycle    ( InternalStruct* internal               );
 
     static QStringList getCallList();
 
@@ -352,7 +368,7 @@ CallList CallModel::getActiveConferences()
     const QStringList confListS = CallManager::instance().getConferenceList();
 
     for (const QString& confId : qAsConst(confListS)) {
-        InternalStruct* internalS = d_ptr->m_shDringId[confId];
+        InternalStruct* internalS = d_ptr->m_shDringId.value(confId);
         if (!internalS) {
             qDebug() << "Warning: Conference not found, creating it, this should not happen";
             Call* conf = d_ptr->addConference(confId);
@@ -375,22 +391,23 @@ bool CallModel::conferencePossible() const
     if (rowCount() < 2)
         return false;
 
+    if (hasConference())
+        return true;
+
+    // Without conferences, all calls are top level, so this stops early
     int compatible = 0;
 
-    for (const InternalStruct* s : qAsConst(d_ptr->m_lInternalModel)) {
-        if (s->m_lChildren.size())
+    for (const InternalStruct* s : qAsConst(d_ptr->m_lByLifeCycle[static_cast<int>(Call::LifeCycleState::PROGRESS)])) {
+        if ((!s->m_pParent) && ++compatible >= 2)
             return true;
-
-        compatible += s->call_real->lifeCycleState() == Call::LifeCycleState::PROGRESS ?
-            1 : 0;
     }
 
-    return compatible >= 2;
+    return false;
 }
 
 bool CallModel::hasConference() const
 {
-   for (const InternalStruct* s : qAsConst(d_ptr->m_lInternalModel)) {
+   for (const InternalStruct* s : qAsConst(d_ptr->m_lConferences)) {
       if (s->m_lChildren.size())
          return true;
    }
@@ -401,7 +418,10 @@ QList<Call*> CallModel::getConferenceParticipants(Call* conf) const
 {
     QList<Call*> participantCallList;
 
-    const auto internalConf = d_ptr->m_shInternalMapping[conf];
+    const auto internalConf = d_ptr->m_shInternalMapping.value(conf);
+
+    if (!internalConf)
+        return participantCallList;
 
     for (const auto s : qAsConst(internalConf->m_lChildren))
         participantCallList << s->call_real;
@@ -547,6 +567,13 @@ Call* CallModelPrivate::addCall2(Call* call, Call* parentCall)
 
    //If the call is already finished, there is no point to track it here
    if (call->lifeCycleState() != Call::LifeCycleState::FINISHED) {
+      indexLifeCycle(aNewStruct);
+      connect(call, &Call::lifeCycleStateChanged, this, [this, aNewStruct]() {
+         // Removed calls are not indexed anymore, but can still emit signals
+         if (aNewStruct->m_IsIndexed)
+            indexLifeCycle(aNewStruct);
+      });
+
       emit q_ptr->callAdded(call,parentCall);
       const QModelIndex idx = q_ptr->index(m_lInternalModel.size()-1,0,{});
       emit q_ptr->dataChanged(idx, idx);
@@ -611,13 +638,7 @@ bool CallModel::supportsDTMF() const
 
 bool CallModel::hasDialingCall() const
 {
-    // Only top level calls can be dialing, no need to be recursive
-    for (const auto i : qAsConst(d_ptr->m_lInternalModel)) {
-        if (i->call_real->lifeCycleState() == Call::LifeCycleState::CREATION)
-            return true;
-    }
-
-    return false;
+    return !d_ptr->m_lByLifeCycle[static_cast<int>(Call::LifeCycleState::CREATION)].isEmpty();
 }
 
 ///Return the current or create a new dialing call from peer ContactMethod
@@ -633,10 +654,10 @@ Call* CallModel::dialingCall(const QString& peerName, Account* account, Call* pa
 {
    //Having multiple dialing calls could be supported, but for now we decided not to
    //handle this corner case as it will create issues of its own
-   foreach (Call* call, getActiveCalls()) {
-      if (call->lifeCycleState() == Call::LifeCycleState::CREATION)
-         return call;
-   }
+   const auto& dialing = d_ptr->m_lByLifeCycle[static_cast<int>(Call::LifeCycleState::CREATION)];
+
+   if (!dialing.isEmpty())
+      return (*dialing.constBegin())->call_real;
 
    return d_ptr->addCall2(CallPrivate::buildDialingCall(peerName, account, parent));
 }  //dialingCall
@@ -730,6 +751,57 @@ void CallModelPrivate::removeInternal(InternalStruct* internal)
    q_ptr->endRemoveRows();
 }
 
+///Remove a participant from its conference, it is *not* added back to the top level
+void CallModelPrivate::detachFromConference(InternalStruct* internal)
+{
+   InternalStruct* conf = internal->m_pParent;
+
+   if (!conf)
+      return;
+
+   internal->m_pParent = nullptr;
+
+   const int row = conf->m_lChildren.indexOf(internal);
+
+   if (row == -1)
+      return;
+
+   const int confRow = m_lInternalModel.indexOf(conf);
+
+   // The conference is no longer in the model, there is no row to remove
+   if (confRow == -1) {
+      conf->m_lChildren.removeAt(row);
+      return;
+   }
+
+   q_ptr->beginRemoveRows(q_ptr->index(confRow, 0, {}), row, row);
+   conf->m_lChildren.removeAt(row);
+   q_ptr->endRemoveRows();
+}
+
+///Move the call to the index bucket matching its current life cycle state
+void CallModelPrivate::indexLifeCycle(InternalStruct* internal)
+{
+   if (internal->conference)
+      return;
+
+   unindexLifeCycle(internal);
+
+   internal->m_LifeCycle = internal->call_real->lifeCycleState();
+   internal->m_IsIndexed = true;
+
+   m_lByLifeCycle[static_cast<int>(internal->m_LifeCycle)].insert(internal);
+}
+
+void CallModelPrivate::unindexLifeCycle(InternalStruct* internal)
+{
+   if (!internal->m_IsIndexed)
+      return;
+
+   m_lByLifeCycle[static_cast<int>(internal->m_LifeCycle)].remove(internal);
+   internal->m_IsIndexed = false;
+}
+
 /**
  * LibRingClient doesn't [need to] handle INACTIVE calls
  * This method make sure they never get into the system.
@@ -765,6 +837,8 @@ void CallModelPrivate::removeCall(Call* call, bool noEmit)
 
    if (internal != nullptr) {
       removeInternal(internal);
+      unindexLifeCycle(internal);
+      m_lConferences.removeOne(internal);
       //NOTE Do not free the memory, it can still be used elsewhere or in modelindexes
    }
 
@@ -772,6 +846,7 @@ void CallModelPrivate::removeCall(Call* call, bool noEmit)
    if (internal->m_lChildren.size()) {
       for (auto child : qAsConst(internal->m_lChildren)) {
          if (child->call_real->state() != Call::State::OVER && child->call_real->state() != Call::State::ERROR) {
+            child->m_pParent = nullptr;
             q_ptr->beginInsertRows({},m_lInternalModel.size(),m_lInternalModel.size());
             m_lInternalModel << child;
             q_ptr->endInsertRows();
@@ -784,7 +859,13 @@ void CallModelPrivate::removeCall(Call* call, bool noEmit)
    call->setProperty("dropState",0);
 
    //The daemon often fail to emit the right signal, cleanup manually
-   for (auto topLevel : qAsConst(m_lInternalModel)) {
+   //removeConference() mutates the index and can recurse, iterate a copy
+   //and skip the conferences already removed
+   const auto conferences = m_lConferences;
+   for (auto topLevel : conferences) {
+      if (!m_lConferences.contains(topLevel))
+         continue;
+
       if (topLevel->call_real->type() == Call::Type::CONFERENCE &&
          (!topLevel->m_lChildren.size()
             //HACK Make a simple validation to prevent ERROR->ERROR->ERROR state loop for conferences
@@ -802,21 +883,23 @@ QModelIndex CallModel::getIndex(Call* call) const
     if (!call)
         return {};
 
-    const auto internal = d_ptr->m_shInternalMapping[call];
+    const auto internal = d_ptr->m_shInternalMapping.value(call);
 
-    int idx = d_ptr->m_lInternalModel.indexOf(internal);
+    if (!internal)
+        return {};
 
-    if (idx != -1) {
-        return index(idx,0);
-    }
+    // Participants are only searched in their own conference
+    if (const auto conf = internal->m_pParent) {
+        const int confRow = d_ptr->m_lInternalModel.indexOf(conf);
+        const int idx     = conf->m_lChildren.indexOf(internal);
 
-    for (InternalStruct* str : qAsConst(d_ptr->m_lInternalModel)) {
-        idx = str->m_lChildren.indexOf(internal);
-        if (idx != -1)
-            return index(idx,0,index(d_ptr->m_lInternalModel.indexOf(str),0));
+        if (confRow != -1 && idx != -1)
+            return index(idx, 0, index(confRow, 0));
     }
 
-    return {};
+    const int idx = d_ptr->m_lInternalModel.indexOf(internal);
+
+    return idx == -1 ? QModelIndex() : index(idx, 0);
 }
 
 ///Transfer "toTransfer" to "target" and wait to see it it succeeded
@@ -882,6 +965,7 @@ Call* CallModelPrivate::addConference(const QString& confID)
 
     m_shInternalMapping[newConf]  = aNewStruct;
     m_shDringId[confID] = aNewStruct;
+    m_lConferences << aNewStruct;
     q_ptr->beginInsertRows({},m_lInternalModel.size(),m_lInternalModel.size());
     m_lInternalModel << aNewStruct;
     q_ptr->endInsertRows();
@@ -894,8 +978,8 @@ Call* CallModelPrivate::addConference(const QString& confID)
 
         InternalStruct* callInt = m_shDringId[callId];
 
-        if (callInt->m_pParent && callInt->m_pParent != aNewStruct)
-            callInt->m_pParent->m_lChildren.removeAll(callInt);
+        if (callInt->m_pParent != aNewStruct)
+            detachFromConference(callInt);
 
         removeInternal(callInt);
         callInt->m_pParent = aNewStruct;
@@ -1106,6 +1190,8 @@ bool CallModel::setData( const QModelIndex& idx, const QVariant &value, int role
 ///Get information relative to the index
 QVariant CallModel::data( const QModelIndex& idx, int role) const
 {
+   Tracing::Span s("model", "CallModel::data");
+
    if (!idx.isValid())
       return {};
 
@@ -1262,17 +1348,16 @@ QMimeData* CallModel::mimeData(const QModelIndexList& indexes) const
    return new QMimeData();
 }
 
-bool CallModelPrivate::isPartOf(const QModelIndex& confIdx, Call* call) //FIXME broken code
+///If `call` is the item at `confIdx` or one of its participants
+bool CallModelPrivate::isPartOf(const QModelIndex& confIdx, Call* call)
 {
-   if (!confIdx.isValid() || !call) return false;
+   if (!confIdx.isValid() || !call || confIdx.model() != q_ptr)
+      return false;
 
-   for (int i=0;i<confIdx.model()->rowCount(confIdx);i++) { //TODO use model one directly
-      Call* c = q_ptr->getCall(confIdx);
-      if (c && c->dringId() == call->dringId()) {
-         return true;
-      }
-   }
-   return false;
+   const auto conf     = static_cast<const InternalStruct*>(confIdx.internalPointer());
+   const auto internal = m_shInternalMapping.value(call);
+
+   return internal && (internal == conf || internal->m_pParent == conf);
 }
 
 Call* CallModel::fromMime( const QByteArray& fromMime) const
@@ -1408,6 +1493,7 @@ bool CallModel::dropMimeData(const QMimeData* mimedata, Qt::DropAction action, i
 ///When a call state change
 void CallModelPrivate::slotCallStateChanged(const QString& callID, const QString& stateName, int code)
 {
+    TRACE_SCOPE("daemon", "CallModelPrivate::slotCallStateChanged");
 
     //This code is part of the CallModel interface too
     qDebug() << "Call State Changed for call  " << callID << " . New state : " << stateName;
@@ -1479,6 +1565,7 @@ void CallModelPrivate::slotCallStateChanged(const QString& callID, const QString
 ///When a new call is incoming
 void CallModelPrivate::slotIncomingCall(const QString& accountID, const QString& callID)
 {
+    TRACE_SCOPE("daemon", "CallModelPrivate::slotIncomingCall");
     Q_UNUSED(accountID)
     qDebug() << "Signal : Incoming Call ! ID = " << callID;
 
@@ -1491,6 +1578,7 @@ void CallModelPrivate::slotIncomingCall(const QString& accountID, const QString&
 ///When a new conference is incoming
 void CallModelPrivate::slotIncomingConference(const QString& confID)
 {
+    TRACE_SCOPE("daemon", "CallModelPrivate::slotIncomingConference");
     if (q_ptr->getCall(confID))
        return;
 
@@ -1505,13 +1593,14 @@ void CallModelPrivate::slotIncomingConference(const QString& confID)
 ///When a conference change
 void CallModelPrivate::slotChangingConference(const QString &confID, const QString& state)
 {
-    if (!m_shDringId.contains(confID)) {
+    TRACE_SCOPE("daemon", "CallModelPrivate::slotChangingConference");
+    InternalStruct* confInt = m_shDringId.value(confID);
+
+    if (!confInt) {
         qWarning() << "Error: conference not found";
         return;
     }
 
-    InternalStruct* confInt = m_shDringId[confID];
-
     Call* conf = confInt->call_real;
 
     qDebug() << "Changing conference state" << conf << confID;
@@ -1521,68 +1610,83 @@ void CallModelPrivate::slotChangingConference(const QString &confID, const QStri
         return;
     }
 
-    if (!q_ptr->getIndex(conf).isValid()) {
+    if (m_lInternalModel.indexOf(confInt) == -1) {
         qWarning() << "The conference item does not exist";
         return;
     }
 
     conf->d_ptr->stateChanged(state);
     CallManagerInterface& callManager = CallManager::instance();
-    const QStringList participants = callManager.getParticipantList(confID);
+    const QStringList participantList = callManager.getParticipantList(confID);
+    const QSet<QString> participants  = participantList.toSet();
+
+    qDebug() << "The conf has" << confInt->m_lChildren.size() << "calls, daemon has" << participantList.size();
 
-    qDebug() << "The conf has" << confInt->m_lChildren.size() << "calls, daemon has" <<participants.size();
+    // Only apply the difference. Large conferences change often and
+    // re-inserting every participant (and asking the daemon about each of
+    // them) makes every change O(participants^2).
+    QVector<InternalStruct*> changed;
 
     //First remove old participants, add them back to the top level list
-    for (InternalStruct* child : qAsConst(confInt->m_lChildren)) {
-        if (participants.indexOf(child->call_real->dringId()) == -1 && child->call_real->lifeCycleState() != Call::LifeCycleState::FINISHED) {
-            qDebug() << "Remove" << child->call_real << "from" << conf;
-            child->m_pParent = nullptr;
+    for (int i = confInt->m_lChildren.size() - 1; i >= 0; i--) {
+        InternalStruct* child = confInt->m_lChildren[i];
+
+        if (participants.contains(child->call_real->dringId()))
+            continue;
+
+        qDebug() << "Remove" << child->call_real << "from" << conf;
+        detachFromConference(child);
+
+        if (child->call_real->lifeCycleState() != Call::LifeCycleState::FINISHED) {
             q_ptr->beginInsertRows({},m_lInternalModel.size(),m_lInternalModel.size());
             m_lInternalModel << child;
             q_ptr->endInsertRows();
+            changed << child;
         }
     }
 
-    auto confIdx = q_ptr->index(m_lInternalModel.indexOf(confInt),0,{});
-    q_ptr->beginRemoveRows(confIdx,0,confInt->m_lChildren.size());
-    confInt->m_lChildren.clear();
-    q_ptr->endRemoveRows();
+    //Then add the new ones
+    for (const QString& callId : qAsConst(participantList)) {
+        InternalStruct* callInt = m_shDringId.value(callId);
 
-    for (const QString& callId : qAsConst(participants)) {
-        if (!m_shDringId.contains(callId)) {
+        if (!callInt) {
             qDebug() << "Participants not found";
             continue;
         }
 
-        auto callInt = m_shDringId[callId];
-
-        if (callInt->m_pParent && callInt->m_pParent != confInt)
-            callInt->m_pParent->m_lChildren.removeAll(callInt);
+        if (callInt->m_pParent == confInt)
+            continue;
 
+        detachFromConference(callInt);
         removeInternal(callInt);
         callInt->m_pParent = confInt;
+
+        // Removing top level rows can move the conference
+        const auto confIdx = q_ptr->index(m_lInternalModel.indexOf(confInt),0,{});
         q_ptr->beginInsertRows(confIdx, confInt->m_lChildren.size(), confInt->m_lChildren.size());
         confInt->m_lChildren << callInt;
         q_ptr->endInsertRows();
+        changed << callInt;
     }
 
     //The daemon often fail to emit the right signal, cleanup manually
-    for (InternalStruct* topLevel : qAsConst(m_lInternalModel)) {
+    //removeConference() can recurse, skip the conferences already removed
+    const auto conferences = m_lConferences;
+    for (InternalStruct* topLevel : conferences) {
+        if (!m_lConferences.contains(topLevel))
+            continue;
+
         if (topLevel->call_real->type() == Call::Type::CONFERENCE && !topLevel->m_lChildren.size())
             removeConference(topLevel->call_real);
     }
 
     //Test if there is no inconsistencies between the daemon and the client
-    const QStringList deamonCallList = getCallList();
-    for (const QString& callId : qAsConst(deamonCallList)) {
+    for (InternalStruct* callInt : qAsConst(changed)) {
+        const QString callId = callInt->call_real->dringId();
         const QMap<QString,QString> callDetails = callManager.getCallDetails(callId);
 
-        if (!m_shDringId.contains(callId)) {
-            qWarning() << "Conference: Call from call list not found in internal list";
+        if (callDetails[DRing::Call::Details::CALL_STATE] == DRing::Call::StateEvent::INACTIVE)
             continue;
-        }
-
-        InternalStruct* callInt = m_shDringId[callId];
 
         const QString confId = callDetails[DRing::Call::Details::CONF_ID];
         if (callInt->m_pParent) {
@@ -1591,17 +1695,21 @@ void CallModelPrivate::slotChangingConference(const QString &confID, const QStri
             }
             else if (confId.isEmpty() ){
                 qWarning() << "Call:" << callId << "should not be part of a conference";
-                callInt->m_pParent = nullptr;
+                detachFromConference(callInt);
+                q_ptr->beginInsertRows({},m_lInternalModel.size(),m_lInternalModel.size());
+                m_lInternalModel << callInt;
+                q_ptr->endInsertRows();
             }
         }
         else if (!confId.isEmpty()) {
             qWarning() << "Found an orphan call";
-            InternalStruct* confInt2 = m_shDringId[confId];
+            InternalStruct* confInt2 = m_shDringId.value(confId);
             if (confInt2 && confInt2->call_real->type() == Call::Type::CONFERENCE
               && (callInt->call_real->type() != Call::Type::CONFERENCE)) {
                 removeInternal(callInt);
                 if (confInt2->m_lChildren.indexOf(callInt) == -1) {
                     auto confIdx2 = q_ptr->index(m_lInternalModel.indexOf(confInt2), 0, {});
+                    callInt->m_pParent = confInt2;
                     q_ptr->beginInsertRows(confIdx2, confInt2->m_lChildren.size(), confInt2->m_lChildren.size());
                     confInt2->m_lChildren << callInt;
                     q_ptr->endInsertRows();
@@ -1611,16 +1719,22 @@ void CallModelPrivate::slotChangingConference(const QString &confID, const QStri
         callInt->call_real->setProperty("dropState",0);
     }
 
-    //TODO force reload all conferences too
-
     emit q_ptr->layoutChanged();
-    emit q_ptr->dataChanged(confIdx, confIdx);
+
+    // The conference may have been removed if it has no participants left
+    const int confRow = m_lInternalModel.indexOf(confInt);
+    if (confRow != -1) {
+        const auto confIdx = q_ptr->index(confRow,0,{});
+        emit q_ptr->dataChanged(confIdx, confIdx);
+    }
+
     emit q_ptr->conferenceChanged(conf);
 } //slotChangingConference
 
 ///When a conference is removed
 void CallModelPrivate::slotConferenceRemoved(const QString &confId)
 {
+   TRACE_SCOPE("daemon", "CallModelPrivate::slotConferenceRemoved");
    Call* conf = q_ptr->getCall(confId);
    removeConference(confId);
    emit q_ptr->layoutChanged();
@@ -1631,6 +1745,7 @@ void CallModelPrivate::slotConferenceRemoved(const QString &confId)
 ///Make the call aware it has a recording
 void CallModelPrivate::slotNewRecordingAvail( const QString& callId, const QString& filePath)
 {
+    TRACE_SCOPE("daemon", "CallModelPrivate::slotNewRecordingAvail");
     if (auto c = q_ptr->getCall(callId))
         c->d_ptr->setRecordingPath(filePath);
 }
@@ -1761,6 +1876,7 @@ void CallModelPrivate::slotDTMFPlayed( const QString& str )
 ///Called when a recording state change
 void CallModelPrivate::slotRecordStateChanged (const QString& callId, bool state)
 {
+    TRACE_SCOPE("daemon", "CallModelPrivate::slotRecordStateChanged");
     if (auto call = q_ptr->getCall(callId)) {
         call->d_ptr->m_mIsRecording[ Media::Media::Type::AUDIO ].setAt( Media::Media::Direction::IN  , state);
         call->d_ptr->m_mIsRecording[ Media::Media::Type::AUDIO ].setAt( Media::Media::Direction::OUT , state);
@@ -1776,6 +1892,7 @@ void CallModelPrivate::slotRecordStateChanged (const QString& callId, bool state
 
 void CallModelPrivate::slotAudioMuted( const QString& callId, bool state)
 {
+    TRACE_SCOPE("daemon", "CallModelPrivate::slotAudioMuted");
     if (auto call = q_ptr->getCall(callId)) {
         auto a = call->firstMedia<Media::Audio>(Media::Media::Direction::OUT);
         if (state)
@@ -1787,6 +1904,7 @@ void CallModelPrivate::slotAudioMuted( const QString& callId, bool state)
 
 void CallModelPrivate::slotVideoMutex( const QString& callId, bool state)
 {
+   TRACE_SCOPE("daemon", "CallModelPrivate::slotVideoMutex");
    if (auto call = q_ptr->getCall(callId)) {
         auto v = call->firstMedia<Media::Video>(Media::Media::Direction::OUT);
         if (state)
@@ -1798,12 +1916,14 @@ void CallModelPrivate::slotVideoMutex( const QString& callId, bool state)
 
 void CallModelPrivate::slotPeerHold( const QString& callId, bool state)
 {
+    TRACE_SCOPE("daemon", "CallModelPrivate::slotPeerHold");
     if (auto call = q_ptr->getCall(callId))
         call->d_ptr->peerHoldChanged(state);
 }
 
 void CallModelPrivate::slotRtcpReportReceived(const QString& callId, const MapStringInt& m)
 {
+    TRACE_SCOPE("daemon", "CallModelPrivate::slotRtcpReportReceived");
     Q_UNUSED(callId)
     Q_UNUSED(m)
 }
@@ -36,6 +36,7 @@
 #include "personmodel.h"
 #include "individual.h"
 #include "private/sortproxies.h"
+#include "private/nodepool.h"
 
 class ContactTreeNode;
 
@@ -52,6 +53,8 @@ public:
       CATEGORY     ,
    };
 
+   NODE_POOL_ALLOCATED(ContactTreeNode)
+
    //Constructor
    ContactTreeNode( const Person* ct    , CategorizedContactModel* parent);
    ContactTreeNode( ContactMethod* cm   , CategorizedContactModel* parent);
@@ -34,6 +34,7 @@
 #include "libcard/matrixutils.h"
 #include "private/certificatemodel_p.h"
 #include "private/certificate_p.h"
+#include "private/certificatecache.h"
 #include <account.h>
 #include <chainoftrustmodel.h>
 #include "contactmethod.h"
@@ -205,37 +206,70 @@ ChecksCache::ChecksCache(const MapStringString& checks)
 
 void CertificatePrivate::loadDetails(bool reload)
 {
-   if (!m_pDetailsCache || reload) {
-      MapStringString d;
-      switch(m_LoadingType) {
-         case LoadingType::FROM_PATH:
+   if (m_pDetailsCache && !reload)
+      return;
+
+   CertificateCache& cache = CertificateCache::instance();
+   MapStringString d;
+
+   switch(m_LoadingType) {
+      case LoadingType::FROM_PATH: {
+         // Some details come from the private key, only cache the public ones
+         const QByteArray fp = m_PrivateKey.isEmpty() ?
+            cache.fingerprint(m_Path) : QByteArray();
+
+         if (reload || fp.isEmpty() || !cache.details(fp, d)) {
             d = ConfigurationManager::instance().getCertificateDetailsPath(m_Path, m_PrivateKey, m_PrivateKeyPassword);
-            break;
-         case LoadingType::FROM_ID:
-            d = ConfigurationManager::instance().getCertificateDetails(m_Id);
-            break;
+            cache.setDetails(fp, d);
+         }
       }
-      m_pDetailsCache = new DetailsCache(d);
+         break;
+      case LoadingType::FROM_ID:
+         if (reload || !cache.details(m_Id, d)) {
+            d = ConfigurationManager::instance().getCertificateDetails(m_Id);
+            cache.setDetails(m_Id, d);
+         }
+         break;
    }
+
+   if (m_pDetailsCache)
+      delete m_pDetailsCache;
+
+   m_pDetailsCache = new DetailsCache(d);
 }
 
 void CertificatePrivate::loadChecks(bool reload)
 {
-   if ((!m_pCheckCache) || reload) {
-      MapStringString checks;
-      switch(m_LoadingType) {
-         case LoadingType::FROM_PATH:
-            checks = ConfigurationManager::instance().validateCertificatePath(QString(),m_Path,m_PrivateKey, m_PrivateKeyPassword, {});
-            break;
-         case LoadingType::FROM_ID:
-            checks = ConfigurationManager::instance().validateCertificate(QString(),m_Id);
-            break;
-      }
-      if (reload && m_pCheckCache)
-         delete m_pCheckCache;
-      m_pCheckCache = new ChecksCache(checks);
-      CertificateModel::instance().d_ptr->regenChecks(q_ptr);
+   if (m_pCheckCache && !reload)
+      return;
+
+   MapStringString checks;
+
+   // Unlike the details, the checks depend on the trust store, the revocation
+   // lists and the folder permissions. They are never cached.
+   switch(m_LoadingType) {
+      case LoadingType::FROM_PATH:
+         checks = ConfigurationManager::instance().validateCertificatePath(QString(),m_Path,m_PrivateKey, m_PrivateKeyPassword, {});
+         break;
+      case LoadingType::FROM_ID:
+         checks = ConfigurationManager::instance().validateCertificate(QString(),m_Id);
+         break;
    }
+
+   const bool hadChecks = m_pCheckCache;
+
+   // The security level is derived from the checks
+   m_hasLoadedSecurityLevel = false;
+
+   if (m_pCheckCache)
+      delete m_pCheckCache;
+
+   m_pCheckCache = new ChecksCache(checks);
+
+   // The first time, the check nodes don't exist yet and will be created
+   // with the right values
+   if (hadChecks)
+      CertificateModel::instance().d_ptr->regenChecks(q_ptr);
 }
 
 Certificate::Certificate(const QString& path, Type type, const QString& privateKey) : ItemBase(nullptr),d_ptr(new CertificatePrivate(this,LoadingType::FROM_PATH))
@@ -598,7 +632,7 @@ Certificate::Type Certificate::type() const
 
 QString Certificate::outgoingServer() const
 {
-   d_ptr->loadChecks();
+   d_ptr->loadDetails();
    return d_ptr->m_pDetailsCache->m_OutgoingServer;
 }
 
@@ -25,6 +25,7 @@
 #include <QtCore/QMutex>
 #include <QtCore/QMutexLocker>
 #include <QtCore/QAbstractProxyModel>
+#include <QtCore/QSet>
 
 //LibSTDC++
 #include <functional>
@@ -41,7 +42,10 @@
 #include "daemoncertificatecollection.h"
 #include "libcard/matrixutils.h"
 #include "private/certificatemodel_p.h"
+#include "private/certificate_p.h"
+#include "private/nodepool.h"
 #include "accountmodel.h"
+#include "tracing.h"
 
 /*
  * This data structure is a graph wrapping the certificates in different contexts.
@@ -82,6 +86,7 @@ enum class DetailType : uchar
 
 
 struct CertificateNode {
+   NODE_POOL_ALLOCATED(CertificateNode)
 
    CertificateNode(int index, CertificateModel::NodeType level, CertificateNode* parent, Certificate* cert);
    ~CertificateNode();
@@ -143,6 +148,80 @@ CertificateModelPrivate::~CertificateModelPrivate()
    }
 }
 
+///Estimate the memory used by the certificates and the tree nodes
+QVector<MemoryStatistics::Usage> CertificateModelPrivate::memoryUsage()
+{
+   typedef MemoryStatistics MS;
+
+   QMutexLocker l(&m_CertInsertion);
+
+   // The same certificate can be indexed by both its path and its id
+   QSet<const Certificate*> certs;
+   qint64 certBytes = MS::sizeOfHash(m_hCertificates);
+
+   for (auto i = m_hCertificates.constBegin(); i != m_hCertificates.constEnd(); ++i) {
+      certBytes += MS::sizeOf(i.key());
+      certs << i.value();
+   }
+
+   for (const auto c : qAsConst(certs)) {
+      const auto d = c->d_ptr;
+
+      certBytes += sizeof(Certificate) + sizeof(CertificatePrivate) + MS::QOBJECT_OVERHEAD
+         + MS::sizeOf(d->m_Path              )
+         + MS::sizeOf(d->m_Content           )
+         + MS::sizeOf(d->m_Id                )
+         + MS::sizeOf(d->m_PrivateKey        )
+         + MS::sizeOf(d->m_PrivateKeyPassword);
+
+      if (const auto dc = d->m_pDetailsCache) {
+         certBytes += sizeof(DetailsCache)
+            + MS::sizeOf(dc->m_PublicSignature    )
+            + MS::sizeOf(dc->m_SerialNumber       )
+            + MS::sizeOf(dc->m_Issuer             )
+            + MS::sizeOf(dc->m_SubjectKeyAlgorithm)
+            + MS::sizeOf(dc->m_Cn                 )
+            + MS::sizeOf(dc->m_N                  )
+            + MS::sizeOf(dc->m_O                  )
+            + MS::sizeOf(dc->m_SignatureAlgorithm )
+            + MS::sizeOf(dc->m_Md5Fingerprint     )
+            + MS::sizeOf(dc->m_Sha1Fingerprint    )
+            + MS::sizeOf(dc->m_PublicKeyId        )
+            + MS::sizeOf(dc->m_IssuerDn           )
+            + MS::sizeOf(dc->m_OutgoingServer     );
+      }
+
+      if (d->m_pCheckCache)
+         certBytes += sizeof(ChecksCache);
+   }
+
+   int nodes = 0;
+   qint64 nodeBytes = 0;
+
+   QVector<const CertificateNode*> stack;
+   for (const auto n : qAsConst(m_lTopLevelNodes))
+      stack << n;
+
+   while (!stack.isEmpty()) {
+      const auto n = stack.takeLast();
+
+      nodes++;
+      nodeBytes += sizeof(CertificateNode)
+         + MS::sizeOf(n->m_Col1   )
+         + MS::sizeOf(n->m_ToolTip)
+         + MS::sizeOfVector(n->m_lChildren)
+         + MS::sizeOfHash(n->m_hSiblings);
+
+      for (const auto c : qAsConst(n->m_lChildren))
+         stack << c;
+   }
+
+   return {
+      { QStringLiteral("Certificate"    ), certs.size(), certBytes },
+      { QStringLiteral("CertificateNode"), nodes       , nodeBytes },
+   };
+}
+
 CertificateNode::CertificateNode(int index, CertificateModel::NodeType level, CertificateNode* parent, Certificate* cert) :
    m_pParent(parent), m_pCertificate(cert), m_Level(level), m_Index(index), m_IsLoaded(true),m_DetailType(DetailType::NONE),
    m_EnumClassDetail(0),m_CatIdx(-1),m_fIsPartOf(0)
@@ -180,14 +259,17 @@ CertificateModel::CertificateModel(QObject* parent) : QAbstractItemModel(parent)
    //TODO replace with something else
    m_pFallbackCollection = addCollection<FolderCertificateCollection,QString,FlagPack<FolderCertificateCollection::Options>, QString>(QString(),
       FolderCertificateCollection::Options::FALLBACK | FolderCertificateCollection::Options::READ_WRITE,
-      QObject::tr("Local certificate store")
+      QObject::tr("Local certificate store"),
+      static_cast<LoadOptions>(LoadOptions::FORCE_ENABLED | LoadOptions::ASYNC)
    );
    m_pFallbackDaemonCollection = addCollection<DaemonCertificateCollection,Account*,DaemonCertificateCollection::Mode>(
       nullptr,
       DaemonCertificateCollection::Mode::ALLOWED
    );
 
-   m_pFallbackCollection->load();
+   MemoryStatistics::instance().addProvider(QStringLiteral("CertificateModel"), this, [this]() {
+      return d_ptr->memoryUsage();
+   });
 }
 
 CertificateModel::~CertificateModel()
@@ -346,37 +428,46 @@ void CertificateModelPrivate::regenChecks(Certificate* cert)
 //[Re]generate the checks
 void CertificateModelPrivate::loadChecks(CertificateNode* checks, Certificate* cert)
 {
+   // Fetch the results before locking, loading them can regenerate the checks
+   QVector<QPair<Certificate::Checks, Certificate::CheckValues>> results;
+   for (const Certificate::Checks check : EnumIterator<Certificate::Checks>()) {
+      const Certificate::CheckValues value = cert->checkResult(check);
+
+      // unsupported check, not inserting
+      if (value != Certificate::CheckValues::UNSUPPORTED)
+         results << qMakePair(check, value);
+   }
+
    QMutexLocker locker(&m_CertLoader);
    const QModelIndex checksI(q_ptr->createIndex(checks->m_Index,static_cast<int>(CertificateModel::Columns::NAME ),checks));
 
    //Clear the existing nodes
    if (checks->m_lChildren.size()) {
-      q_ptr->beginRemoveRows(checksI, 0, checks->m_lChildren.size());
-      const QList<CertificateNode*> nodes;
+      q_ptr->beginRemoveRows(checksI, 0, checks->m_lChildren.size() - 1);
+      const QVector<CertificateNode*> nodes = checks->m_lChildren;
+
+      checks->m_lChildren.clear();
 
       for (CertificateNode* n : nodes)
          delete n;
 
-      checks->m_lChildren.clear();
-
       q_ptr->endRemoveRows();
    }
 
+   if (results.isEmpty())
+      return;
+
    //Add the new ones
-   for (const Certificate::Checks check : EnumIterator<Certificate::Checks>()) {
-      if (cert->checkResult(check) != Certificate::CheckValues::UNSUPPORTED) {
-         q_ptr->beginInsertRows(checksI, checks->m_lChildren.size(), checks->m_lChildren.size());
-         CertificateNode* d = new CertificateNode(checks->m_lChildren.size(), CertificateModel::NodeType::DETAILS, checks, nullptr);
-         d->setStrings(cert->getName(check),static_cast<bool>(cert->checkResult(check)),cert->getDescription(check));
-         d->m_DetailType = DetailType::CHECK;
-         d->m_pCertificate = cert;
-         d->m_EnumClassDetail = static_cast<int>(check);
-         checks->m_lChildren << d;
-         q_ptr->endInsertRows();
-      } else {
-         // unsupported check, not inserting
-      }
+   q_ptr->beginInsertRows(checksI, 0, results.size() - 1);
+   for (const auto& r : qAsConst(results)) {
+      CertificateNode* d = new CertificateNode(checks->m_lChildren.size(), CertificateModel::NodeType::DETAILS, checks, nullptr);
+      d->setStrings(cert->getName(r.first),static_cast<bool>(r.second),cert->getDescription(r.first));
+      d->m_DetailType = DetailType::CHECK;
+      d->m_pCertificate = cert;
+      d->m_EnumClassDetail = static_cast<int>(r.first);
+      checks->m_lChildren << d;
    }
+   q_ptr->endInsertRows();
 }
 
 CertificateNode* CertificateModelPrivate::addToTree(Certificate* cert, CertificateNode* category)
@@ -980,6 +1071,7 @@ bool CertificateModelPrivate::banCertificate(Certificate* c, Account* a)
 
 void CertificateModelPrivate::slotCertificateStateChanged(const QString& accountId, const QString& certId, const QString& state)
 {
+    TRACE_SCOPE("daemon", "CertificateModelPrivate::slotCertificateStateChanged");
     if( auto a = AccountModel::instance().getById(accountId.toLatin1())) {
         auto c = q_ptr->getCertificateFromId(certId, a);
 
@@ -24,6 +24,9 @@
 #include <QtCore/QItemSelectionModel>
 #include <QMimeData>
 
+//STD
+#include <algorithm>
+
 //DRing
 #include <account_const.h>
 
@@ -43,7 +46,7 @@ public:
    CodecModelPrivate(CodecModel* parent);
    ///@struct CodecData store audio/video codec information
    struct CodecData {
-      int              id         ;
+      int              id         {-1};
       QString          name       ;
       QString          bitrate    ;
       QString          min_bitrate;
@@ -54,6 +57,8 @@ public:
       QString          min_quality;
       QString          max_quality;
       QString          auto_quality_enabled;
+      bool             loaded     {false}; /*!< The per account details were fetched */
+      bool             dirty      {false}; /*!< The details differ from the daemon    */
    };
 
    enum class CodecType {
@@ -62,9 +67,23 @@ public:
        COUNT__
    };
 
+   /**
+    * The codec list and the static part of the codec details (name, type,
+    * limits) are the same for every account. They are fetched once and
+    * shared by all models. The bitrate and quality are per account and
+    * are only fetched when something reads or writes them.
+    */
+   struct SharedCache {
+      VectorUInt                   m_lCodecs     ;
+      QHash<uint, MapStringString> m_hDetails    ;
+      bool                         m_IsLoaded    {false};
+   };
+
    //Attributes
    QList<CodecData*>      m_lCodecs        ;
+   QHash<int,CodecData*>  m_hCodecs        ;
    QMap<int,bool>         m_lEnabledCodecs ;
+   VectorUInt             m_lRemoteActive  ;
    Account*               m_pAccount       {nullptr};
    QSortFilterProxyModel* m_pAudioProxy    ;
    QSortFilterProxyModel* m_pVideoProxy    ;
@@ -87,8 +106,15 @@ public:
    //Helpers
    bool findCodec(int id);
    QModelIndex getIndexofCodecByID(int id);
+   void ensureDetails(CodecData* c);
+   void setOrder(const QList<CodecData*>& ordered);
+   void updateEnabledCount();
    inline void performAction(const CodecModel::EditAction action);
 
+   static SharedCache& sharedCache();
+   static const VectorUInt& codecList(bool refresh);
+   static void applyDetails(CodecData* c, const MapStringString& details);
+
 private:
    CodecModel* q_ptr;
 };
@@ -173,10 +199,11 @@ QVariant CodecModel::data(const QModelIndex& idx, int role) const
         case Qt::DisplayRole:
             return QVariant(d_ptr->m_lCodecs[idx.row()]->name);
         case Qt::CheckStateRole:
-            return QVariant(d_ptr->m_lEnabledCodecs[d_ptr->m_lCodecs[idx.row()]->id] ? Qt::Checked : Qt::Unchecked);
+            return QVariant(d_ptr->m_lEnabledCodecs.value(d_ptr->m_lCodecs[idx.row()]->id) ? Qt::Checked : Qt::Unchecked);
         case CodecModel::Role::NAME:
             return d_ptr->m_lCodecs[idx.row()]->name;
         case CodecModel::Role::BITRATE:
+            d_ptr->ensureDetails(d_ptr->m_lCodecs[idx.row()]);
             return d_ptr->m_lCodecs[idx.row()]->bitrate;
         case CodecModel::Role::MIN_BITRATE:
             return d_ptr->m_lCodecs[idx.row()]->min_bitrate;
@@ -189,12 +216,14 @@ QVariant CodecModel::data(const QModelIndex& idx, int role) const
         case CodecModel::Role::TYPE:
             return d_ptr->m_lCodecs[idx.row()]->type;
         case CodecModel::Role::QUALITY:
+            d_ptr->ensureDetails(d_ptr->m_lCodecs[idx.row()]);
             return d_ptr->m_lCodecs[idx.row()]->quality;
         case CodecModel::Role::MIN_QUALITY:
             return d_ptr->m_lCodecs[idx.row()]->min_quality;
         case CodecModel::Role::MAX_QUALITY:
             return d_ptr->m_lCodecs[idx.row()]->max_quality;
         case CodecModel::Role::AUTO_QUALITY_ENABLED:
+            d_ptr->ensureDetails(d_ptr->m_lCodecs[idx.row()]);
             return d_ptr->m_lCodecs[idx.row()]->auto_quality_enabled;
         default:
             return QVariant();
@@ -226,47 +255,59 @@ bool CodecModel::setData( const QModelIndex& idx, const QVariant &value, int rol
     if (idx.column() != 0)
         return false;
 
+    CodecModelPrivate::CodecData* c = d_ptr->m_lCodecs[idx.row()];
+
+    // The details are sent as a whole, make sure the other fields are known
+    if (role != Qt::CheckStateRole && role != CodecModel::ID)
+        d_ptr->ensureDetails(c);
+
     switch (role) {
         case CodecModel::NAME :
-            d_ptr->m_lCodecs[idx.row()]->name = value.toString();
+            c->name = value.toString();
             break;
         case CodecModel::BITRATE :
-            d_ptr->m_lCodecs[idx.row()]->bitrate = value.toString();
+            c->bitrate = value.toString();
             break;
         case CodecModel::MIN_BITRATE :
-            d_ptr->m_lCodecs[idx.row()]->min_bitrate = value.toString();
+            c->min_bitrate = value.toString();
             break;
         case CodecModel::MAX_BITRATE :
-            d_ptr->m_lCodecs[idx.row()]->max_bitrate = value.toString();
+            c->max_bitrate = value.toString();
             break;
         case Qt::CheckStateRole :
-            d_ptr->m_lEnabledCodecs[d_ptr->m_lCodecs[idx.row()]->id] = value.toBool();
+            d_ptr->m_lEnabledCodecs[c->id] = value.toBool();
+            d_ptr->updateEnabledCount();
             break;
         case CodecModel::SAMPLERATE :
-            d_ptr->m_lCodecs[idx.row()]->samplerate = value.toString();
+            c->samplerate = value.toString();
             break;
         case CodecModel::ID :
-            d_ptr->m_lCodecs[idx.row()]->id = value.toInt();
+            d_ptr->m_hCodecs.remove(c->id);
+            c->id = value.toInt();
+            d_ptr->m_hCodecs[c->id] = c;
             break;
         case CodecModel::TYPE :
-            d_ptr->m_lCodecs[idx.row()]->type = value.toString();
+            c->type = value.toString();
             break;
         case CodecModel::QUALITY :
-            d_ptr->m_lCodecs[idx.row()]->quality = value.toString();
+            c->quality = value.toString();
             break;
         case CodecModel::MIN_QUALITY :
-            d_ptr->m_lCodecs[idx.row()]->min_quality = value.toString();
+            c->min_quality = value.toString();
             break;
         case CodecModel::MAX_QUALITY :
-            d_ptr->m_lCodecs[idx.row()]->max_quality = value.toString();
+            c->max_quality = value.toString();
             break;
         case CodecModel::AUTO_QUALITY_ENABLED :
-            d_ptr->m_lCodecs[idx.row()]->auto_quality_enabled = value.toString();
+            c->auto_quality_enabled = value.toString();
             break;
         default:
             return false;
     }
 
+    if (role != Qt::CheckStateRole && role != CodecModel::ID)
+        c->dirty = true;
+
     //if we did not return yet, then we modified the codec
     emit dataChanged(idx, idx);
     this << EditAction::MODIFY;
@@ -291,6 +332,7 @@ void CodecModelPrivate::remove(const QModelIndex& idx)
       q_ptr->beginRemoveRows(QModelIndex(), idx.row(), idx.row());
       CodecModelPrivate::CodecData* d = m_lCodecs[idx.row()];
       m_lCodecs.removeAt(idx.row());
+      m_hCodecs.remove(d->id);
       delete d;
       q_ptr->endRemoveRows();
       emit q_ptr->dataChanged(idx, q_ptr->index(m_lCodecs.size()-1,0));
@@ -310,91 +352,199 @@ void CodecModelPrivate::clear()
       delete d;
    }
    m_lCodecs.clear();
+   m_hCodecs.clear();
    m_lEnabledCodecs.clear();
+   m_lRemoteActive.clear();
    m_EditState = CodecModel::EditState::READY;
 }
 
+CodecModelPrivate::SharedCache& CodecModelPrivate::sharedCache()
+{
+   static SharedCache cache;
+   return cache;
+}
+
+///Return the daemon codec list, all accounts share it
+const VectorUInt& CodecModelPrivate::codecList(bool refresh)
+{
+   SharedCache& cache = sharedCache();
+
+   if (refresh || !cache.m_IsLoaded) {
+      const VectorUInt list = ConfigurationManager::instance().getCodecList();
+
+      // The static details are only valid for the same codec set
+      if (list != cache.m_lCodecs)
+         cache.m_hDetails.clear();
+
+      cache.m_lCodecs  = list;
+      cache.m_IsLoaded = true;
+   }
+
+   return cache.m_lCodecs;
+}
+
+void CodecModelPrivate::applyDetails(CodecData* c, const MapStringString& details)
+{
+   c->name                 = details[ DRing::Account::ConfProperties::CodecInfo::NAME        ];
+   c->samplerate           = details[ DRing::Account::ConfProperties::CodecInfo::SAMPLE_RATE ];
+   c->bitrate              = details[ DRing::Account::ConfProperties::CodecInfo::BITRATE     ];
+   c->min_bitrate          = details[ DRing::Account::ConfProperties::CodecInfo::MIN_BITRATE ];
+   c->max_bitrate          = details[ DRing::Account::ConfProperties::CodecInfo::MAX_BITRATE ];
+   c->type                 = details[ DRing::Account::ConfProperties::CodecInfo::TYPE        ];
+   c->quality              = details[ DRing::Account::ConfProperties::CodecInfo::QUALITY     ];
+   c->min_quality          = details[ DRing::Account::ConfProperties::CodecInfo::MIN_QUALITY ];
+   c->max_quality          = details[ DRing::Account::ConfProperties::CodecInfo::MAX_QUALITY ];
+   c->auto_quality_enabled = details[ DRing::Account::ConfProperties::CodecInfo::AUTO_QUALITY_ENABLED];
+}
+
+///Fetch the per account part of the codec details
+void CodecModelPrivate::ensureDetails(CodecData* c)
+{
+   if (c->loaded)
+      return;
+
+   const MapStringString details = ConfigurationManager::instance().getCodecDetails(
+      m_pAccount->isNew()? QString() : m_pAccount->id(), c->id
+   );
+
+   applyDetails(c, details);
+   sharedCache().m_hDetails[c->id] = details;
+   c->loaded = true;
+}
+
+///Apply a new row order in a single layout change
+void CodecModelPrivate::setOrder(const QList<CodecData*>& ordered)
+{
+   emit q_ptr->layoutAboutToBeChanged();
+
+   const QModelIndexList oldIndexes = q_ptr->persistentIndexList();
+   QModelIndexList newIndexes;
+   newIndexes.reserve(oldIndexes.size());
+
+   for (const QModelIndex& idx : oldIndexes)
+      newIndexes << q_ptr->index(ordered.indexOf(m_lCodecs[idx.row()]), 0);
+
+   m_lCodecs = ordered;
+
+   q_ptr->changePersistentIndexList(oldIndexes, newIndexes);
+
+   emit q_ptr->layoutChanged();
+}
+
+void CodecModelPrivate::updateEnabledCount()
+{
+   const bool hadAudio = m_mEnabledCount[CodecType::AUDIO];
+   const bool hadVideo = m_mEnabledCount[CodecType::VIDEO];
+
+   uint audio(0), video(0);
+
+   for (const CodecData* c : qAsConst(m_lCodecs)) {
+      if (m_lEnabledCodecs.value(c->id))
+         (c->type == QLatin1String("AUDIO") ? audio : video)++;
+   }
+
+   m_mEnabledCount.setAt(CodecType::AUDIO, audio);
+   m_mEnabledCount.setAt(CodecType::VIDEO, video);
+
+   if (hadAudio != (audio > 0))
+      emit q_ptr->hasAudioChanged(audio > 0);
+
+   if (hadVideo != (video > 0))
+      emit q_ptr->hasVideoChanged(video > 0);
+}
+
 ///Reload the codeclist
 void CodecModelPrivate::reload()
 {
    m_EditState = CodecModel::EditState::RELOADING;
 
    ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
-   QVector<uint> codecIdList = configurationManager.getCodecList();
+   VectorUInt codecIdList = codecList(false);
 
-   const QVector<uint> activeCodecList = m_pAccount->isNew() ? codecIdList :
+   VectorUInt activeCodecList = m_pAccount->isNew() ? codecIdList :
       configurationManager.getActiveCodecList(m_pAccount->id());
 
-   //TODO: the following method cannot update the order of the codecs if it
-   //      changes in the daemon after it has been initially loaded in the client
+   // An unknown codec means the daemon codec set changed since it was cached
+   for (const uint aCodec : qAsConst(activeCodecList)) {
+      if (!codecIdList.contains(aCodec)) {
+         codecIdList = codecList(true);
+         break;
+      }
+   }
+
+   // The active codecs come first to get the correct order
+   QList<CodecData*> ordered;
+   ordered.reserve(codecIdList.size());
+
+   QHash<int,CodecData*> codecs;
+   QMap<int,bool> enabled;
+
+   const auto& details = sharedCache().m_hDetails;
 
-   // load the active codecs first to get the correct order
-   for (const int aCodec : qAsConst(activeCodecList)) {
+   const auto append = [&](uint aCodec, bool isEnabled) {
+      if (codecs.contains(aCodec))
+         return;
 
-      const QMap<QString,QString> codec = configurationManager.getCodecDetails(
-         m_pAccount->isNew()? QString() : m_pAccount->id(), aCodec
-      );
+      CodecData* c = m_hCodecs.value(aCodec);
 
-      if (!findCodec(aCodec)) {
-         const auto idx = add();
-         q_ptr->setData(idx,QString::number(aCodec), CodecModel::Role::ID);
+      if (!c) {
+         c = new CodecData;
+         c->id = aCodec;
       }
 
-      const auto type = codec[DRing::Account::ConfProperties::CodecInfo::TYPE] == QLatin1String("AUDIO") ?
-         CodecType::AUDIO : CodecType::VIDEO;
+      // "their" version wins, the per account details are fetched again
+      c->loaded = false;
+      c->dirty  = false;
 
-      const auto isEnabled = Qt::Checked;
+      const auto d = details.constFind(aCodec);
 
-      //FIXME fix the enabled coded list
-      m_mEnabledCount.setAt(type, m_mEnabledCount[type] + (isEnabled == Qt::Checked ? 1 : 0));
+      if (d != details.constEnd())
+         applyDetails(c, *d);
+      else
+         ensureDetails(c);
 
-      // update the codec
+      ordered << c;
+      codecs[aCodec]  = c;
+      enabled[aCodec] = isEnabled;
+   };
 
-      const auto& idx = getIndexofCodecByID(aCodec);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::NAME        ] ,CodecModel::Role::NAME       );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::SAMPLE_RATE ] ,CodecModel::Role::SAMPLERATE );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::BITRATE     ] ,CodecModel::Role::BITRATE    );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::MIN_BITRATE ] ,CodecModel::Role::MIN_BITRATE);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::MAX_BITRATE ] ,CodecModel::Role::MAX_BITRATE);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::TYPE        ] ,CodecModel::Role::TYPE       );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::QUALITY     ] ,CodecModel::Role::QUALITY    );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::MIN_QUALITY ] ,CodecModel::Role::MIN_QUALITY);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::MAX_QUALITY ] ,CodecModel::Role::MAX_QUALITY);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::AUTO_QUALITY_ENABLED] ,CodecModel::Role::AUTO_QUALITY_ENABLED);
-      q_ptr->setData(idx, Qt::Checked ,Qt::CheckStateRole);
+   for (const uint aCodec : qAsConst(activeCodecList))
+      append(aCodec, true);
 
-      // remove from list of all codecs, since we have already updated it
-      if (codecIdList.indexOf(aCodec)!=-1)
-         codecIdList.remove(codecIdList.indexOf(aCodec));
-   }
+   for (const uint aCodec : qAsConst(codecIdList))
+      append(aCodec, false);
+
+   const bool sameSet = ordered.size() == m_lCodecs.size()
+      && std::all_of(m_lCodecs.constBegin(), m_lCodecs.constEnd(), [&codecs](const CodecData* c) {
+         return codecs.contains(c->id);
+      });
 
-   // now add add/update remaining (inactive) codecs
-   foreach (const int aCodec, codecIdList) {
+   if (sameSet) {
+      m_lEnabledCodecs = enabled;
+      setOrder(ordered);
 
-      const QMap<QString,QString> codec = configurationManager.getCodecDetails(
-         m_pAccount->isNew()? QString() : m_pAccount->id(), aCodec
-      );
+      if (!m_lCodecs.isEmpty())
+         emit q_ptr->dataChanged(q_ptr->index(0,0), q_ptr->index(m_lCodecs.size()-1,0));
+   }
+   else {
+      q_ptr->beginResetModel();
 
-      if (!findCodec(aCodec)) {
-         const auto idx = add();
-         q_ptr->setData(idx,QString::number(aCodec), CodecModel::Role::ID);
+      for (CodecData* c : qAsConst(m_lCodecs)) {
+         if (!codecs.contains(c->id))
+            delete c;
       }
 
-      // update the codec
-      const auto& idx = getIndexofCodecByID(aCodec);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::NAME        ] ,CodecModel::Role::NAME       );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::SAMPLE_RATE ] ,CodecModel::Role::SAMPLERATE );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::BITRATE     ] ,CodecModel::Role::BITRATE    );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::MIN_BITRATE ] ,CodecModel::Role::MIN_BITRATE);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::MAX_BITRATE ] ,CodecModel::Role::MAX_BITRATE);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::TYPE        ] ,CodecModel::Role::TYPE       );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::QUALITY     ] ,CodecModel::Role::QUALITY    );
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::MIN_QUALITY ] ,CodecModel::Role::MIN_QUALITY);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::MAX_QUALITY ] ,CodecModel::Role::MAX_QUALITY);
-      q_ptr->setData(idx,codec[ DRing::Account::ConfProperties::CodecInfo::AUTO_QUALITY_ENABLED] ,CodecModel::Role::AUTO_QUALITY_ENABLED);
-      q_ptr->setData(idx, Qt::Unchecked ,Qt::CheckStateRole);
+      m_lCodecs        = ordered;
+      m_hCodecs        = codecs;
+      m_lEnabledCodecs = enabled;
+
+      q_ptr->endResetModel();
    }
 
+   m_lRemoteActive = activeCodecList;
+
+   updateEnabledCount();
+
    m_EditState = CodecModel::EditState::READY;
 }
 
@@ -403,36 +553,41 @@ void CodecModelPrivate::save()
 {
    //TODO there is a race condition, the account has to be saved first
 
+   ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
+
    //Update active codec list
    VectorUInt _codecList;
-   for (int i = 0; i < q_ptr->rowCount();i++) {
-      const auto idx = q_ptr->index(i,0);
-      if (q_ptr->data(idx,Qt::CheckStateRole) == Qt::Checked) {
-         _codecList << q_ptr->data(idx,CodecModel::Role::ID).toInt();
-      }
+   for (const CodecData* c : qAsConst(m_lCodecs)) {
+      if (m_lEnabledCodecs.value(c->id))
+         _codecList << c->id;
    }
 
-   ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
-   configurationManager.setActiveCodecList(m_pAccount->id(), _codecList);
+   if (_codecList != m_lRemoteActive) {
+      configurationManager.setActiveCodecList(m_pAccount->id(), _codecList);
+      m_lRemoteActive = _codecList;
+   }
+
+   //Update codec details, only those that changed
+   for (CodecData* c : qAsConst(m_lCodecs)) {
+      if (!c->dirty)
+         continue;
 
-   //Update codec details
-   for (int i=0; i < q_ptr->rowCount();i++) {
-      const auto idx = q_ptr->index(i,0);
       MapStringString codecDetails;
-      codecDetails[ DRing::Account::ConfProperties::CodecInfo::NAME        ] = q_ptr->data(idx,CodecModel::Role::NAME).toString();
-      codecDetails[ DRing::Account::ConfProperties::CodecInfo::SAMPLE_RATE ] = q_ptr->data(idx,CodecModel::Role::SAMPLERATE).toString();
-      codecDetails[ DRing::Account::ConfProperties::CodecInfo::BITRATE     ] = q_ptr->data(idx,CodecModel::Role::BITRATE).toString();
-      codecDetails[ DRing::Account::ConfProperties::CodecInfo::MIN_BITRATE ] = q_ptr->data(idx,CodecModel::Role::MIN_BITRATE).toString();
-      codecDetails[ DRing::Account::ConfProperties::CodecInfo::MAX_BITRATE ] = q_ptr->data(idx,CodecModel::Role::MAX_BITRATE).toString();
-      codecDetails[ DRing::Account::ConfProperties::CodecInfo::TYPE        ] = q_ptr->data(idx,CodecModel::Role::TYPE).toString();
-      codecDetails[ DRing::Account::ConfProperties::CodecInfo::QUALITY     ] = q_ptr->data(idx,CodecModel::Role::QUALITY).toString();
-      codecDetails[ DRing::Account::ConfProperties::CodecInfo::MIN_QUALITY ] = q_ptr->data(idx,CodecModel::Role::MIN_QUALITY).toString();
-      codecDetails[ DRing::Account::ConfProperties::CodecInfo::MAX_QUALITY ] = q_ptr->data(idx,CodecModel::Role::MAX_QUALITY).toString();
-      codecDetails[ DRing::Account::ConfProperties::CodecInfo::AUTO_QUALITY_ENABLED] = q_ptr->data(idx,CodecModel::Role::AUTO_QUALITY_ENABLED).toString();
-
-      qDebug() << "setting codec details for " << q_ptr->data(idx,CodecModel::Role::NAME).toString();
-
-      configurationManager.setCodecDetails(m_pAccount->id(), q_ptr->data(idx,CodecModel::Role::ID).toUInt(), codecDetails);
+      codecDetails[ DRing::Account::ConfProperties::CodecInfo::NAME        ] = c->name;
+      codecDetails[ DRing::Account::ConfProperties::CodecInfo::SAMPLE_RATE ] = c->samplerate;
+      codecDetails[ DRing::Account::ConfProperties::CodecInfo::BITRATE     ] = c->bitrate;
+      codecDetails[ DRing::Account::ConfProperties::CodecInfo::MIN_BITRATE ] = c->min_bitrate;
+      codecDetails[ DRing::Account::ConfProperties::CodecInfo::MAX_BITRATE ] = c->max_bitrate;
+      codecDetails[ DRing::Account::ConfProperties::CodecInfo::TYPE        ] = c->type;
+      codecDetails[ DRing::Account::ConfProperties::CodecInfo::QUALITY     ] = c->quality;
+      codecDetails[ DRing::Account::ConfProperties::CodecInfo::MIN_QUALITY ] = c->min_quality;
+      codecDetails[ DRing::Account::ConfProperties::CodecInfo::MAX_QUALITY ] = c->max_quality;
+      codecDetails[ DRing::Account::ConfProperties::CodecInfo::AUTO_QUALITY_ENABLED] = c->auto_quality_enabled;
+
+      qDebug() << "setting codec details for " << c->name;
+
+      configurationManager.setCodecDetails(m_pAccount->id(), c->id, codecDetails);
+      c->dirty = false;
    }
    m_EditState = CodecModel::EditState::READY;
 }
@@ -498,14 +653,103 @@ bool CodecModel::moveDown()
    return false;
 }
 
+/**
+ * Apply a codec priority order and enable mask in a single step.
+ *
+ * The codecs are sorted by their position in `ids`, the others keep their
+ * relative order after them. Only the codecs in `enabled` stay enabled.
+ *
+ * @return If anything changed
+ */
+bool CodecModel::setCodecOrder(const QVector<int>& ids, const QSet<int>& enabled)
+{
+   if (d_ptr->m_EditState == EditState::LOADING || d_ptr->m_EditState == EditState::RELOADING)
+      return false;
+
+   QList<CodecModelPrivate::CodecData*> ordered;
+   ordered.reserve(d_ptr->m_lCodecs.size());
+
+   QSet<int> seen;
+
+   for (const int id : ids) {
+      CodecModelPrivate::CodecData* c = d_ptr->m_hCodecs.value(id);
+      if (c && !seen.contains(id)) {
+         ordered << c;
+         seen.insert(id);
+      }
+   }
+
+   for (CodecModelPrivate::CodecData* c : qAsConst(d_ptr->m_lCodecs)) {
+      if (!seen.contains(c->id))
+         ordered << c;
+   }
+
+   bool maskChanged = false;
+
+   for (const CodecModelPrivate::CodecData* c : qAsConst(d_ptr->m_lCodecs)) {
+      if (d_ptr->m_lEnabledCodecs.value(c->id) != enabled.contains(c->id)) {
+         maskChanged = true;
+         break;
+      }
+   }
+
+   const bool orderChanged = ordered != d_ptr->m_lCodecs;
+
+   if (!(orderChanged || maskChanged))
+      return false;
+
+   if (orderChanged)
+      d_ptr->setOrder(ordered);
+
+   if (maskChanged) {
+      for (const CodecModelPrivate::CodecData* c : qAsConst(d_ptr->m_lCodecs))
+         d_ptr->m_lEnabledCodecs[c->id] = enabled.contains(c->id);
+
+      emit dataChanged(index(0,0), index(rowCount()-1,0), {Qt::CheckStateRole});
+      d_ptr->updateEnabledCount();
+   }
+
+   this << EditAction::MODIFY;
+
+   return true;
+}
+
+/**
+ * Apply the same codec order and enable mask to many accounts.
+ *
+ * The codec list and static details are fetched once for all of them and
+ * each account is saved with a single active codec list update.
+ */
+void CodecModel::setCodecOrder(const QList<Account*>& accounts, const QVector<int>& ids, const QSet<int>& enabled)
+{
+   CodecModelPrivate::codecList(true);
+
+   for (Account* a : accounts) {
+      if (!a)
+         continue;
+
+      CodecModel* m = a->codecModel();
+
+      if (m->setCodecOrder(ids, enabled))
+         m << EditAction::SAVE;
+   }
+}
+
+///Reload the codecs of many accounts, the shared codec list is fetched once
+void CodecModel::reload(const QList<Account*>& accounts)
+{
+   CodecModelPrivate::codecList(true);
+
+   for (Account* a : accounts) {
+      if (a)
+         a->codecModel() << EditAction::RELOAD;
+   }
+}
+
 ///Check is a codec is already in the list
 bool CodecModelPrivate::findCodec(int id)
 {
-   foreach(const CodecData* data, m_lCodecs) {
-      if (data->id == id)
-         return true;
-   }
-   return false;
+   return m_hCodecs.contains(id);
 }
 
 ///Return valid payload types
@@ -542,12 +786,8 @@ QSortFilterProxyModel* CodecModel::audioCodecs() const
 
 QModelIndex CodecModelPrivate::getIndexofCodecByID(int id)
 {
-   for (int i=0; i < q_ptr->rowCount();i++) {
-      const auto idx = q_ptr->index(i,0);
-      if (q_ptr->data(idx, CodecModel::Role::ID) == id)
-         return idx;
-   }
-   return QModelIndex();
+   const auto c = m_hCodecs.value(id);
+   return c ? q_ptr->index(m_lCodecs.indexOf(c), 0) : QModelIndex();
 }
 
 QStringList CodecModel::mimeTypes() const
@@ -21,6 +21,8 @@
 
 //Qt
 #include <QtCore/QString>
+#include <QtCore/QSet>
+#include <QtCore/QVector>
 class QSortFilterProxyModel;
 class QItemSelectionModel;
 
@@ -101,6 +103,11 @@ public:
 
    //Mutator
    bool performAction(CodecModel::EditAction action);
+   bool setCodecOrder(const QVector<int>& ids, const QSet<int>& enabled);
+
+   //Batch
+   static void setCodecOrder(const QList<Account*>& accounts, const QVector<int>& ids, const QSet<int>& enabled);
+   static void reload(const QList<Account*>& accounts);
 
    //Getter
    int                   acceptedPayloadTypes() const;
@@ -0,0 +1,378 @@
+/****************************************************************************
+ *   Copyright (C) 2018 by Bluesystems                                      *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                    *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "collectionloader.h"
+
+//Qt
+#include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QSet>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
+
+//Ring
+#include <collectioninterface.h>
+#include <phonedirectorymodel.h>
+#include <tracing.h>
+#include "private/phonedirectorymodel_p.h"
+
+class CollectionLoaderPrivate final
+{
+public:
+    struct PendingLoad {
+        CollectionInterface*      m_pCollection;
+        QList<QByteArray>         m_lDependencies;
+        std::function<void(bool)> m_fCallback;
+        QElapsedTimer             m_Waiting;
+    };
+
+    /// The result of a run() worker, waiting for the main thread
+    struct PendingPublish {
+        CollectionInterface*  m_pCollection;
+        std::function<void()> m_fPublish;
+        qint64                m_WorkTime;
+    };
+
+    /// Stop loading collections after this many ms and let the events run
+    static constexpr const int SLICE_BUDGET = 16;
+
+    /// The loads are mostly I/O bound, more threads would just add contention
+    static constexpr const int MAX_THREADS = 4;
+
+    QList<PendingLoad>             m_lQueue       ;
+    QSet<QByteArray>               m_lMilestones  ;
+    QVector<CollectionLoader::LoadTrace> m_lTrace ;
+    QHash<CollectionInterface*, int> m_hTraces    ;
+    bool                           m_IsScheduled  {false};
+    bool                           m_IsLoading    {false};
+    CollectionInterface*           m_pLoading     {nullptr};
+    int                            m_RunningWork  {0};
+    QThreadPool                    m_Pool         ;
+
+    // Shared with the workers, protected by m_PublishMutex
+    QMutex                              m_PublishMutex;
+    QList<PendingPublish>               m_lPublish    ;
+    QHash<CollectionInterface*, qint64> m_hBytesRead  ;
+    bool                                m_IsPublishScheduled {false};
+
+    CollectionLoader* q_ptr;
+
+    // Helpers
+    void schedule();
+    void processSlice();
+    void publishSlice();
+    void queuePublish(const PendingPublish& p);
+    bool isReady(const PendingLoad& l) const;
+    CollectionLoader::LoadTrace& traceFor(CollectionInterface* col);
+};
+
+/// Run the expensive part of a load in the pool
+class CollectionWork final : public QRunnable
+{
+public:
+    CollectionWork(CollectionLoaderPrivate* d, CollectionInterface* col,
+        std::function< std::function<void()>() > work) :
+        m_pLoader(d), m_pCollection(col), m_fWork(work) {}
+
+    virtual void run() override;
+
+private:
+    CollectionLoaderPrivate*                 m_pLoader;
+    CollectionInterface*                     m_pCollection;
+    std::function< std::function<void()>() > m_fWork;
+};
+
+constexpr const int CollectionLoaderPrivate::SLICE_BUDGET;
+constexpr const int CollectionLoaderPrivate::MAX_THREADS;
+
+CollectionLoader::CollectionLoader() : QObject(), d_ptr(new CollectionLoaderPrivate)
+{
+    d_ptr->q_ptr = this;
+    d_ptr->m_Pool.setMaxThreadCount(
+        qBound(1, QThread::idealThreadCount(), CollectionLoaderPrivate::MAX_THREADS)
+    );
+}
+
+CollectionLoader::~CollectionLoader()
+{
+    delete d_ptr;
+}
+
+CollectionLoader& CollectionLoader::instance()
+{
+    static auto m_sInstance = new CollectionLoader();
+    return *m_sInstance;
+}
+
+void CollectionLoader::setReady(const QByteArray& milestone)
+{
+    if (d_ptr->m_lMilestones.contains(milestone))
+        return;
+
+    d_ptr->m_lMilestones << milestone;
+
+    if (!d_ptr->m_lQueue.isEmpty())
+        d_ptr->schedule();
+}
+
+bool CollectionLoader::isReady(const QByteArray& milestone) const
+{
+    return d_ptr->m_lMilestones.contains(milestone);
+}
+
+void CollectionLoader::enqueue(CollectionInterface* collection, const QList<QByteArray>& dependencies, std::function<void(bool)> callback)
+{
+    CollectionLoaderPrivate::PendingLoad l {collection, dependencies, callback, {}};
+    l.m_Waiting.start();
+
+    d_ptr->m_lQueue << l;
+    d_ptr->schedule();
+}
+
+bool CollectionLoader::isLoading(const CollectionInterface* collection) const
+{
+    return collection && d_ptr->m_pLoading == collection;
+}
+
+bool CollectionLoader::isIdle() const
+{
+    return d_ptr->m_lQueue.isEmpty() && (!d_ptr->m_IsLoading) && !d_ptr->m_RunningWork;
+}
+
+void CollectionLoader::run(CollectionInterface* collection, std::function< std::function<void()>() > work)
+{
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    d_ptr->m_RunningWork++;
+    d_ptr->m_Pool.start(new CollectionWork(d_ptr, collection, work));
+}
+
+void CollectionLoader::addBytesRead(CollectionInterface* collection, qint64 bytes)
+{
+    QMutexLocker l(&d_ptr->m_PublishMutex);
+    d_ptr->m_hBytesRead[collection] += bytes;
+}
+
+void CollectionWork::run()
+{
+    QElapsedTimer t;
+    t.start();
+
+    std::function<void()> publish;
+
+    {
+        Tracing::Span s("collection", "CollectionLoader::run");
+        publish = m_fWork();
+    }
+
+    m_pLoader->queuePublish({m_pCollection, publish, t.elapsed()});
+}
+
+/// Called from the workers
+void CollectionLoaderPrivate::queuePublish(const PendingPublish& p)
+{
+    QMutexLocker l(&m_PublishMutex);
+
+    m_lPublish << p;
+
+    if (m_IsPublishScheduled)
+        return;
+
+    m_IsPublishScheduled = true;
+    QMetaObject::invokeMethod(q_ptr, "slotPublish", Qt::QueuedConnection);
+}
+
+void CollectionLoader::slotPublish()
+{
+    d_ptr->publishSlice();
+}
+
+/// The trace entry of a collection, created if it wasn't loaded by the loader
+CollectionLoader::LoadTrace& CollectionLoaderPrivate::traceFor(CollectionInterface* col)
+{
+    const auto idx = m_hTraces.constFind(col);
+
+    if (idx != m_hTraces.constEnd())
+        return m_lTrace[idx.value()];
+
+    m_hTraces[col] = m_lTrace.size();
+    m_lTrace << CollectionLoader::LoadTrace {
+        col->id(), col->name(), 0, 0, 0, true, 0, 0, 0
+    };
+
+    return m_lTrace.last();
+}
+
+/**
+ * Insert the results of the workers until the time budget is exhausted.
+ *
+ * All of them are inserted in a single PhoneDirectoryModel batch, the other
+ * models get the rows of a slice in a row.
+ */
+void CollectionLoaderPrivate::publishSlice()
+{
+    QElapsedTimer slice;
+    slice.start();
+
+    bool more = false;
+
+    auto& directory = PhoneDirectoryModel::instance();
+    directory.d_ptr->beginBatch();
+
+    while (true) {
+        PendingPublish p;
+        qint64 bytes;
+
+        {
+            QMutexLocker l(&m_PublishMutex);
+
+            if (m_lPublish.isEmpty()) {
+                m_IsPublishScheduled = false;
+                break;
+            }
+
+            if (slice.elapsed() >= SLICE_BUDGET) {
+                more = true;
+                break;
+            }
+
+            p     = m_lPublish.takeFirst();
+            bytes = m_hBytesRead.take(p.m_pCollection);
+        }
+
+        QElapsedTimer t;
+        t.start();
+
+        if (p.m_fPublish) {
+            Tracing::Span s("collection", "CollectionLoader::publish", p.m_pCollection->name());
+            p.m_fPublish();
+        }
+
+        m_RunningWork--;
+
+        auto& trace        = traceFor(p.m_pCollection);
+        trace.workTime    += p.m_WorkTime;
+        trace.publishTime += t.elapsed();
+        trace.bytesRead   += bytes;
+        trace.items        = p.m_pCollection->size();
+    }
+
+    directory.d_ptr->endBatch();
+
+    // Keep the scheduled flag, the queued call will reset it
+    if (more)
+        QMetaObject::invokeMethod(q_ptr, "slotPublish", Qt::QueuedConnection);
+    else if (q_ptr->isIdle())
+        emit q_ptr->finished();
+}
+
+QVector<CollectionLoader::LoadTrace> CollectionLoader::trace() const
+{
+    return d_ptr->m_lTrace;
+}
+
+void CollectionLoaderPrivate::schedule()
+{
+    if (m_IsScheduled)
+        return;
+
+    m_IsScheduled = true;
+
+    QTimer::singleShot(0, q_ptr, [this]() {
+        m_IsScheduled = false;
+        processSlice();
+    });
+}
+
+bool CollectionLoaderPrivate::isReady(const PendingLoad& l) const
+{
+    for (const auto& m : qAsConst(l.m_lDependencies)) {
+        if (!m_lMilestones.contains(m))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Load the collections which have all their dependencies until the time
+ * budget is exhausted.
+ *
+ * load() is called in the main thread. The collections which do heavy I/O
+ * or parsing move it to the thread pool using CollectionLoader::run(), the
+ * others insert the items directly in the models.
+ */
+void CollectionLoaderPrivate::processSlice()
+{
+    // load() can add more collections, don't recurse
+    if (m_IsLoading)
+        return;
+
+    QElapsedTimer slice;
+    slice.start();
+
+    m_IsLoading = true;
+
+    for (int i = 0; i < m_lQueue.size() && slice.elapsed() < SLICE_BUDGET;) {
+        if (!isReady(m_lQueue[i])) {
+            i++;
+            continue;
+        }
+
+        const auto l = m_lQueue.takeAt(i);
+
+        const qint64 waitTime = l.m_Waiting.elapsed();
+
+        QElapsedTimer t;
+        t.start();
+
+        bool ret;
+        {
+            Tracing::Span s("collection", "CollectionInterface::load", l.m_pCollection->name());
+            m_pLoading = l.m_pCollection;
+            ret = l.m_pCollection->load();
+            m_pLoading = nullptr;
+        }
+
+        auto& trace    = traceFor(l.m_pCollection);
+        trace.waitTime = waitTime;
+        trace.loadTime = t.elapsed();
+        trace.items    = l.m_pCollection->size();
+        trace.success  = ret;
+
+        if (l.m_fCallback)
+            l.m_fCallback(ret);
+
+        emit q_ptr->collectionLoaded(l.m_pCollection, ret);
+    }
+
+    m_IsLoading = false;
+
+    // Continue if some collections can be loaded now, otherwise wait for the
+    // milestones
+    for (const auto& l : qAsConst(m_lQueue)) {
+        if (isReady(l)) {
+            schedule();
+            return;
+        }
+    }
+
+    if (q_ptr->isIdle())
+        emit q_ptr->finished();
+}
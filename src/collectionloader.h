@@ -0,0 +1,164 @@
+/****************************************************************************
+ *   Copyright (C) 2018 by Bluesystems                                      *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                    *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+#include <typedefs.h>
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+
+//STD
+#include <functional>
+
+class CollectionInterface;
+class CollectionLoaderPrivate;
+
+/**
+ * Load the collections outside of the code path which created them.
+ *
+ * The collections added with LoadOptions::ASYNC are queued here instead of
+ * being loaded directly by addCollection(). They are then loaded from the
+ * event loop in small slices so the application stays responsive during
+ * startup.
+ *
+ * Some collections need other parts of the library to be ready before they
+ * can be loaded. For example, the calendars reference the accounts. Those
+ * dependencies are declared using named milestones:
+ *
+ *    CollectionLoader::addDependency<Calendar>("accounts");
+ *    [...]
+ *    CollectionLoader::instance().setReady("accounts");
+ *
+ * The expensive part of a load (I/O, parsing) can be moved to a bounded
+ * thread pool using run(). The results are then published to the models from
+ * the main thread, in batches.
+ *
+ * The time spent waiting and loading each collection is recorded. It can be
+ * read using trace() to find what slows down startup.
+ */
+class LIB_EXPORT CollectionLoader final : public QObject
+{
+    Q_OBJECT
+public:
+    /// The startup trace of a collection
+    struct LoadTrace {
+        QByteArray id         ; /*!< CollectionInterface::id()                    */
+        QString    name       ; /*!< CollectionInterface::name()                  */
+        qint64     waitTime   ; /*!< ms spent waiting for the dependencies         */
+        qint64     loadTime   ; /*!< ms spent in CollectionInterface::load()       */
+        int        items      ; /*!< CollectionInterface::size() once loaded       */
+        bool       success    ; /*!< The return value of load()                   */
+        qint64     workTime   ; /*!< ms spent in the thread pool (see run())       */
+        qint64     publishTime; /*!< ms spent publishing the results (see run())   */
+        qint64     bytesRead  ; /*!< As reported with addBytesRead()              */
+    };
+
+    static CollectionLoader& instance();
+
+    /// Prevent the collections of type T from loading until `milestone` is ready
+    template<class T>
+    static void addDependency(const QByteArray& milestone);
+
+    /// The dependencies declared for the collection type T
+    template<class T>
+    static QList<QByteArray> dependencies();
+
+    void setReady(const QByteArray& milestone);
+    bool isReady(const QByteArray& milestone) const;
+
+    /**
+     * Queue the collection to be loaded.
+     *
+     * @param dependencies The milestones to wait for
+     * @param callback Called with the load() return value
+     */
+    void enqueue(CollectionInterface* collection, const QList<QByteArray>& dependencies,
+        std::function<void(bool)> callback = {});
+
+    /**
+     * Run `work` in the loader thread pool, then the function it returns in
+     * the main thread.
+     *
+     * `work` must not touch the models, the returned function is where the
+     * items are inserted. The returned functions are executed in batches
+     * between the event loop iterations. The number of threads is bounded so
+     * loading many collections at once doesn't starve the application.
+     *
+     * This has to be called from the main thread.
+     */
+    void run(CollectionInterface* collection, std::function< std::function<void()>() > work);
+
+    /// Add to the trace of `collection`, it can be called from `run()` workers
+    void addBytesRead(CollectionInterface* collection, qint64 bytes);
+
+    /**
+     * If the loader is currently calling `collection->load()`.
+     *
+     * The collections use it to move their parsing to run(). When load() is
+     * called directly, the caller expects the items to be there once it
+     * returns.
+     */
+    bool isLoading(const CollectionInterface* collection) const;
+
+    /// If there is nothing left to load
+    bool isIdle() const;
+
+    QVector<LoadTrace> trace() const;
+
+Q_SIGNALS:
+    void collectionLoaded(CollectionInterface* collection, bool success);
+
+    /// All queued collections are loaded
+    void finished();
+
+private Q_SLOTS:
+    void slotPublish();
+
+private:
+    explicit CollectionLoader();
+    virtual ~CollectionLoader();
+
+    template<class T>
+    static QList<QByteArray>& dependencyList();
+
+    CollectionLoaderPrivate* d_ptr;
+    Q_DECLARE_PRIVATE(CollectionLoader)
+};
+
+template<class T>
+QList<QByteArray>& CollectionLoader::dependencyList()
+{
+    static QList<QByteArray> l;
+    return l;
+}
+
+template<class T>
+void CollectionLoader::addDependency(const QByteArray& milestone)
+{
+    auto& l = dependencyList<T>();
+
+    if (!l.contains(milestone))
+        l << milestone;
+}
+
+template<class T>
+QList<QByteArray> CollectionLoader::dependencies()
+{
+    return dependencyList<T>();
+}
@@ -19,6 +19,7 @@
 
 //Ring
 #include <collectionmodel.h>
+#include <collectionloader.h>
 #include "private/collectionmodel_p.h"
 
 class CollectionManagerInterfaceBasePrivate
@@ -46,3 +47,8 @@ void CollectionManagerInterfaceBase::setCollectionConfigurator(CollectionInterfa
 {
    col->setConfigurator(getter);
 }
+
+void CollectionManagerInterfaceBase::loadAsync(CollectionInterface* col, const QList<QByteArray>& dependencies, std::function<void(bool)> callback) const
+{
+   CollectionLoader::instance().enqueue(col, dependencies, callback);
+}
@@ -30,6 +30,7 @@
 //Ring
 #include <collectioninterface.h>
 #include <collectionmediator.h>
+#include <collectionloader.h>
 
 class QAbstractItemModel;
 
@@ -37,6 +38,7 @@ enum LoadOptions {
    NONE           = 0x0     ,
    FORCE_ENABLED  = 0x1 << 0,
    FORCE_DISABLED = 0x1 << 1,
+   ASYNC          = 0x1 << 2, /*!< Use the CollectionLoader for FORCE_ENABLED */
 };
 
 class CollectionManagerInterfaceBasePrivate;
@@ -66,6 +68,7 @@ protected:
    void addCreatorToList(CollectionCreationInterface* creator);
    void addConfiguratorToList(CollectionConfigurationInterface* configurator);
    void setCollectionConfigurator(CollectionInterface* col, std::function<CollectionConfigurationInterface*()> getter);
+   void loadAsync(CollectionInterface* col, const QList<QByteArray>& dependencies, std::function<void(bool)> callback) const;
 
 private:
    CollectionManagerInterfaceBasePrivate* d_ptr;
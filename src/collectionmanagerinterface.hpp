@@ -68,11 +68,16 @@ T2* CollectionManagerInterface<T>::addCollection(Ts... args, const LoadOptions o
       return registerConfigarator<T2>();
    });
 
-   if (options & LoadOptions::FORCE_ENABLED) { //TODO check is the collection is checked
+   if ((options & LoadOptions::FORCE_ENABLED) && (options & LoadOptions::ASYNC)) {
+      //Let the CollectionLoader call load() once the dependencies are ready
+      loadAsync(collection, CollectionLoader::dependencies<T2>(), [this, collection](bool success) {
+         if (success)
+            d_ptr->m_lEnabledCollections << collection;
+      });
+   }
+   else if (options & LoadOptions::FORCE_ENABLED) { //TODO check is the collection is checked
 
       //Some collections can fail to load directly
-      //eventually it will necessary to add an async version of this
-      //to load the collection only when it is loaded
       if (collection->load())
          d_ptr->m_lEnabledCollections << collection;
    }
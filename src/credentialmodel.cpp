@@ -437,9 +437,9 @@ void CredentialModelPrivate::save()
       foreach (CredentialNode* n, m_pTurnCat->m_lChildren) {
          Credential* cred = n->m_pCredential;
 
-         m_pAccount->d_ptr->setAccountProperty(DRing::Account::ConfProperties::TURN::SERVER_UNAME , cred->username());
-         m_pAccount->d_ptr->setAccountProperty(DRing::Account::ConfProperties::TURN::SERVER_PWD   , cred->password());
-         m_pAccount->d_ptr->setAccountProperty(DRing::Account::ConfProperties::TURN::SERVER_REALM , cred->realm   ());
+         m_pAccount->d_ptr->setAccountProperty(AccountDetails::Key::TURN_SERVER_UNAME , cred->username());
+         m_pAccount->d_ptr->setAccountProperty(AccountDetails::Key::TURN_SERVER_PWD   , cred->password());
+         m_pAccount->d_ptr->setAccountProperty(AccountDetails::Key::TURN_SERVER_REALM , cred->realm   ());
       }
    }
 
@@ -466,9 +466,9 @@ void CredentialModelPrivate::reload()
 
       //TURN
       const auto idx = q_ptr->addCredentials(Credential::Type::TURN);
-      const QString usern = m_pAccount->d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER_UNAME);
-      const QString passw = m_pAccount->d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER_PWD  );
-      const QString realm = m_pAccount->d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER_REALM);
+      const QString usern = m_pAccount->d_ptr->accountDetail(AccountDetails::Key::TURN_SERVER_UNAME);
+      const QString passw = m_pAccount->d_ptr->accountDetail(AccountDetails::Key::TURN_SERVER_PWD  );
+      const QString realm = m_pAccount->d_ptr->accountDetail(AccountDetails::Key::TURN_SERVER_REALM);
 
       if (!(usern.isEmpty() && passw.isEmpty() && realm.isEmpty())) {
          q_ptr->setData(idx, usern, CredentialModel::Role::NAME    );
@@ -23,6 +23,7 @@
 #include "certificatemodel.h"
 #include "globalinstances.h"
 #include "interfaces/pixmapmanipulatori.h"
+#include "tracing.h"
 
 //Dring
 #include "dbus/configurationmanager.h"
@@ -90,6 +91,7 @@ DaemonCertificateCollection::~DaemonCertificateCollection()
 
 void DaemonCertificateCollectionPrivate::slotCertificatePinned(const QString& id)
 {
+   TRACE_SCOPE("daemon", "DaemonCertificateCollectionPrivate::slotCertificatePinned");
    //qDebug() << "\n\nCERTIFICATE ADDED" << id;
    Certificate* cert = CertificateModel::instance().getCertificateFromId(id);
 
@@ -101,12 +103,14 @@ void DaemonCertificateCollectionPrivate::slotCertificatePinned(const QString& id
 
 void DaemonCertificateCollectionPrivate::slotCertificateExpired(const QString& id)
 {
+   TRACE_SCOPE("daemon", "DaemonCertificateCollectionPrivate::slotCertificateExpired");
    Q_UNUSED(id);
    //qDebug() << "\n\nCERTIFICATE EXPIRED" << id;
 }
 
 void DaemonCertificateCollectionPrivate::slotCertificatePathPinned(const QString& path, const QStringList& certIds)
 {
+   TRACE_SCOPE("daemon", "DaemonCertificateCollectionPrivate::slotCertificatePathPinned");
    Q_UNUSED(path);
    Q_UNUSED(certIds);
    //Create a new collection if it is a directory or size > 1
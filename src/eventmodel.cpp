@@ -25,6 +25,7 @@
 #include "libcard/event.h"
 #include "libcard/private/event_p.h"
 #include "libcard/private/eventmodel_p.h"
+#include "private/nodepool.h"
 
 #include <stdio.h>
 
@@ -35,6 +36,8 @@
  * generate aggregates and can be sorted properly if the need arise.
  */
 struct EventModelNode {
+    NODE_POOL_ALLOCATED(EventModelNode)
+
     Event*          m_pEvent                   {nullptr};
     EventModelNode* m_pNextByContactMethod     {nullptr};
     EventModelNode* m_pPreviousByContactMethod {nullptr};
@@ -221,6 +224,10 @@ EventModel::EventModel(QObject* parent)
   , d_ptr(new EventModelPrivate())
 {
     d_ptr->q_ptr = this;
+
+    MemoryStatistics::instance().addProvider(QStringLiteral("EventModel"), this, [this]() {
+        return d_ptr->memoryUsage();
+    });
 }
 
 EventModel& EventModel::instance()
@@ -573,3 +580,27 @@ const QVector< QSharedPointer<Event> >& EventModelPrivate::events(const ContactM
 
     return cm->d_ptr->m_pEvents->m_lEvents;
 }
+
+QVector<MemoryStatistics::Usage> EventModelPrivate::memoryUsage() const
+{
+    typedef MemoryStatistics MS;
+
+    qint64 eventBytes = MS::sizeOfVector(m_lEvent) + MS::sizeOfHash(m_hUids);
+
+    for (const auto n : qAsConst(m_lEvent)) {
+        const auto d = n->m_pEvent->d_ptr;
+
+        eventBytes += sizeof(Event) + sizeof(EventPrivate) + sizeof(EventModelNode)
+            + MS::QOBJECT_OVERHEAD
+            + MS::sizeOf(d->m_UID)
+            + MS::sizeOf(d->m_CN )
+            + d->m_lAttachedFiles.size() * sizeof(void*);
+
+        for (const auto& pair : qAsConst(d->m_lAttendees))
+            eventBytes += sizeof(void*) + sizeof(pair) + MS::sizeOf(pair.second);
+    }
+
+    return {
+        { QStringLiteral("Event"), m_lEvent.size(), eventBytes },
+    };
+}
@@ -32,6 +32,10 @@ class Calendar;
 class EventModelPrivate;
 #include <libcard/event.h>
 
+namespace HistoryImporter {
+   class ImportJobPrivate;
+}
+
 /**
  * This model holds all the event.
  *
@@ -48,6 +52,8 @@ class LIB_EXPORT EventModel : public QAbstractListModel, public CollectionManage
 
    friend class ContactMethod; // calls into the private API when deduplicating itself
    friend class EventAggregate; // use the private getters to get references on the event list
+   friend class EventAggregatePrivate; // same, for the lazy loading
+   friend class HistoryImporter::ImportJobPrivate; // look for the events imported before a crash
 public:
 
     virtual ~EventModel();
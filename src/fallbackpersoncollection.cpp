@@ -38,7 +38,7 @@
 #include "interfaces/pixmapmanipulatori.h"
 #include "interfaces/actionextenderi.h"
 #include "interfaces/itemmodelstateserializeri.h"
-#include "private/threadworker.h"
+#include "collectionloader.h"
 
 class FallbackPersonBackendEditor final : public CollectionEditor<Person>
 {
@@ -217,20 +217,28 @@ bool FallbackPersonCollection::isEnabled() const
 
 bool FallbackPersonCollection::load()
 {
-   auto l = [this]() {
+   auto parse = [this]() {
       bool ok;
       Q_UNUSED(ok)
-      const QList< Person* > ret =  VCardUtils::loadDir(QUrl(d_ptr->m_Path),ok,static_cast<FallbackPersonBackendEditor*>(editor<Person>())->m_hPaths);
+      return VCardUtils::loadDir(QUrl(d_ptr->m_Path),ok,static_cast<FallbackPersonBackendEditor*>(editor<Person>())->m_hPaths);
+   };
+
+   auto publish = [this](const QList<Person*>& ret) {
       for(Person* p : ret) {
          p->setCollection(this);
          editor<Person>()->addExisting(p);
       }
    };
 
-   if (d_ptr->m_Async)
-      new ThreadWorker(l);
+   // Parse the vCards in the loader pool, insert them in the main thread
+   if (d_ptr->m_Async) {
+      CollectionLoader::instance().run(this, [parse, publish]() -> std::function<void()> {
+         const QList<Person*> ret = parse();
+         return [publish, ret]() { publish(ret); };
+      });
+   }
    else
-      l();
+      publish(parse());
 
    //Add all sub directories as new backends
    QTimer::singleShot(0,d_ptr,SLOT(loadAsync()));
@@ -31,6 +31,8 @@
 #include "certificatemodel.h"
 #include "globalinstances.h"
 #include "interfaces/pixmapmanipulatori.h"
+#include "private/certificatecache.h"
+#include "collectionloader.h"
 
 //Dring
 #include "dbus/configurationmanager.h"
@@ -90,6 +92,8 @@ public:
 
    //Helper
    QList<CollectionInterface::Element> getCertificateList();
+   void addSubFolders();
+   void publish(const QList<QByteArray>& ids);
 };
 
 bool FolderCertificateCollectionPrivate::m_sHasFallbackStore = false;
@@ -146,7 +150,33 @@ QByteArray BackgroundLoader::loadCertificate(const QByteArray& id)
 
 bool FolderCertificateCollection::load()
 {
-   if (d_ptr->m_IsValid) {
+   if (!d_ptr->m_IsValid)
+      return false;
+
+   // List and parse the certificates in the loader pool, insert them in the
+   // main thread
+   if (CollectionLoader::instance().isLoading(this)) {
+      const QString path = d_ptr->m_Path;
+
+      CollectionLoader::instance().run(this, [this, path]() -> std::function<void()> {
+         QList<QByteArray> ids;
+
+         for (const QString& str : QDir(path).entryList({"*.pem","*.crt"}))
+            ids << (path + "/" + str).toLatin1();
+
+         // The certificates are parsed when they are first used, do it now
+         // for the whole folder while nobody is waiting
+         CertificateCache::instance().prefetch(ids);
+
+         return [this, ids]() {
+            d_ptr->publish(ids);
+         };
+      });
+
+      return true;
+   }
+
+   {
       //Load the stored certificates
       if (!d_ptr->m_spLoader) {
          d_ptr->m_spLoader = new BackgroundLoader(this);
@@ -164,7 +194,6 @@ bool FolderCertificateCollection::load()
          d_ptr->m_spLoader->start();
       return true;
    }
-   return false;
 }
 
 bool FolderCertificateCollection::reload()
@@ -326,21 +355,43 @@ QList<CollectionInterface::Element> FolderCertificateCollectionPrivate::getCerti
       ret << (m_Path + "/" + str).toLatin1();
    }
 
-   if (m_Flags & FolderCertificateCollection::Options::RECURSIVE) {
-      for (const QString& d : dir.entryList(QDir::AllDirs)) {
-         if (d != QString('.') && d != QLatin1String("..")) {
-            CertificateModel::instance().addCollection<FolderCertificateCollection,QString,FlagPack<FolderCertificateCollection::Options>,QString,FolderCertificateCollection*>(
-               m_Path+'/'+d              ,
-               m_Flags                   ,
-               d                         ,
-               q_ptr                     ,
-               LoadOptions::FORCE_ENABLED
-            );
-         }
+   addSubFolders();
+
+   return ret;
+}
+
+void FolderCertificateCollectionPrivate::addSubFolders()
+{
+   if (!(m_Flags & FolderCertificateCollection::Options::RECURSIVE))
+      return;
+
+   for (const QString& d : QDir(m_Path).entryList(QDir::AllDirs)) {
+      if (d != QString('.') && d != QLatin1String("..")) {
+         CertificateModel::instance().addCollection<FolderCertificateCollection,QString,FlagPack<FolderCertificateCollection::Options>,QString,FolderCertificateCollection*>(
+            m_Path+'/'+d              ,
+            m_Flags                   ,
+            d                         ,
+            q_ptr                     ,
+            static_cast<LoadOptions>(LoadOptions::FORCE_ENABLED | LoadOptions::ASYNC)
+         );
       }
    }
+}
 
-   return ret;
+/// Insert the certificates listed by a CollectionLoader worker
+void FolderCertificateCollectionPrivate::publish(const QList<QByteArray>& ids)
+{
+   for(const QByteArray& id : ids) {
+      Certificate* cert = CertificateModel::instance().getCertificateFromPath(id);
+      q_ptr->editor<Certificate>()->addExisting(cert);
+
+      if (m_Flags & FolderCertificateCollection::Options::ROOT)
+         cert->addOrigin(Certificate::OriginHint::ROOT_AUTORITY);
+   }
+
+   ConfigurationManager::instance().pinCertificatePath(q_ptr->path().path()+'/');
+
+   addSubFolders();
 }
 
 void BackgroundLoader::run()
@@ -349,7 +400,8 @@ void BackgroundLoader::run()
       m_pCurrentFolder = m_lFolderQueue.takeFirst();
 
       QMutexLocker(&this->m_LoaderMutex);
-      for(const QByteArray& id : m_pCurrentFolder->listId()) {
+      const QList<QByteArray> ids = m_pCurrentFolder->listId();
+      for(const QByteArray& id : ids) {
          Certificate* cert = CertificateModel::instance().getCertificateFromPath(id);
          m_pCurrentFolder->editor<Certificate>()->addExisting(cert);
 
@@ -360,6 +412,10 @@ void BackgroundLoader::run()
       ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
       //qDebug() << "\n\nPINING PATH TODO remove extra /" << m_pCurrentFolder->path();
       configurationManager.pinCertificatePath(m_pCurrentFolder->path().path()+'/');
+
+      // The certificates are parsed when they are first used, do it now
+      // for the whole folder while nobody is waiting
+      CertificateCache::instance().prefetch(ids);
    }
    FolderCertificateCollectionPrivate::m_spLoader = nullptr;
    QThread::exit(0);
@@ -70,6 +70,28 @@ public:
     TemporaryContactMethod* m_pTmpCM {nullptr};
     QString m_BestName;
 
+    /**
+     * Values aggregated from all ContactMethods.
+     *
+     * They are read by the delegates for every row on every repaint, so
+     * they are cached and only recomputed when a ContactMethod signal marks
+     * them as dirty.
+     */
+    enum Aggregate : uchar {
+        BEST_NAME       = 0x1 << 0,
+        UNREAD_COUNT    = 0x1 << 1,
+        CONTACT_METHODS = 0x1 << 2,
+        ALL             = BEST_NAME | UNREAD_COUNT | CONTACT_METHODS,
+    };
+    uchar m_DirtyAggregates {Aggregate::ALL};
+    int   m_UnreadCount     {0};
+
+    /// ContactMethod::d() of the visible and of all ContactMethods
+    QSet<const void*> m_lVisibleData;
+    QSet<const void*> m_lAllData;
+
+    static Individual::AggregateStatistics m_sStatistics;
+
     ContactMethod*           m_LastUsedCM {nullptr};
     QVector<ContactMethod*>  m_HiddenContactMethods;
     Person::ContactMethods   m_Numbers             ;
@@ -85,6 +107,8 @@ public:
     void disconnectContactMethod(ContactMethod* cm);
     InfoTemplate* infoTemplate();
     bool contains(ContactMethod* cm, bool includeHidden = true) const;
+    void invalidate(uchar aggregates);
+    void indexContactMethod(ContactMethod* cm, bool hidden);
 
     QList<Individual*> m_lParents;
 
@@ -146,6 +170,7 @@ Individual::~Individual()
     // If anything is still listening, make sure at least is gets a proper cleanup
     d_ptr->m_Numbers.clear();
     d_ptr->m_HiddenContactMethods.clear();
+    d_ptr->invalidate(IndividualPrivate::Aggregate::ALL);
 
     if (QSharedPointer<IndividualTimelineModel> tl = d_ptr->m_TimelineModel)
         tl->clear();
@@ -163,17 +188,51 @@ Individual::~Individual()
         delete d_ptr;
 }
 
+Individual::AggregateStatistics IndividualPrivate::m_sStatistics;
+
+void IndividualPrivate::invalidate(uchar aggregates)
+{
+    m_DirtyAggregates |= aggregates;
+}
+
+/// Add to the lookup index without rebuilding it
+void IndividualPrivate::indexContactMethod(ContactMethod* cm, bool hidden)
+{
+    if (m_DirtyAggregates & Aggregate::CONTACT_METHODS)
+        return;
+
+    if (!hidden)
+        m_lVisibleData.insert(cm->d());
+
+    m_lAllData.insert(cm->d());
+}
+
 bool IndividualPrivate::contains(ContactMethod* cm, bool includeHidden) const
 {
-    bool ret = false;
-    q_ptr->forAllNumbers([&ret, cm](ContactMethod* other) {
-        if (other->d() == cm->d()) {
-            ret = true;
-            return;
-        }
-    }, includeHidden);
+    if (m_DirtyAggregates & Aggregate::CONTACT_METHODS) {
+        auto d = const_cast<IndividualPrivate*>(this);
 
-    return ret;
+        d->m_lVisibleData.clear();
+        d->m_lAllData.clear();
+
+        for (auto other : qAsConst(m_Numbers))
+            d->m_lVisibleData.insert(other->d());
+
+        d->m_lAllData = m_lVisibleData;
+
+        for (auto other : qAsConst(m_HiddenContactMethods))
+            d->m_lAllData.insert(other->d());
+
+        d->m_DirtyAggregates &= ~Aggregate::CONTACT_METHODS;
+        m_sStatistics.contactMethods++;
+    }
+
+    return (includeHidden ? m_lAllData : m_lVisibleData).contains(cm->d());
+}
+
+Individual::AggregateStatistics Individual::aggregateStatistics()
+{
+    return IndividualPrivate::m_sStatistics;
 }
 
 /**
@@ -201,7 +260,7 @@ bool Individual::merge(Individual* other)
     }
 
     other->d_ptr->m_lParents << this;
-    other->d_ptr->m_BestName.clear();
+    other->d_ptr->invalidate(IndividualPrivate::Aggregate::BEST_NAME);
 
     if ((!other->d_ptr->m_LastUsedCM) || (d_ptr->m_LastUsedCM && d_ptr->m_LastUsedCM->lastUsed() > other->d_ptr->m_LastUsedCM->lastUsed()))
         other->d_ptr->m_LastUsedCM = d_ptr->m_LastUsedCM;
@@ -339,9 +398,13 @@ Call* Individual::firstActiveCall() const
 
 QString Individual::bestName() const
 {
-    if (!d_ptr->m_BestName.isEmpty())
+    if (!(d_ptr->m_DirtyAggregates & IndividualPrivate::Aggregate::BEST_NAME))
         return d_ptr->m_BestName;
 
+    d_ptr->m_BestName.clear();
+    d_ptr->m_DirtyAggregates &= ~IndividualPrivate::Aggregate::BEST_NAME;
+    IndividualPrivate::m_sStatistics.bestName++;
+
     Person* p = nullptr;
     QString firstRegisteredName, display, firstUri;
 
@@ -468,6 +531,9 @@ Person* Individual::person() const
 
 int Individual::unreadTextMessageCount() const
 {
+    if (!(d_ptr->m_DirtyAggregates & IndividualPrivate::Aggregate::UNREAD_COUNT))
+        return d_ptr->m_UnreadCount;
+
     int unread = 0;
 
     QSet<Media::TextRecording*> trs;
@@ -475,13 +541,17 @@ int Individual::unreadTextMessageCount() const
     forAllNumbers([&unread, &trs](ContactMethod* cm) {
         if (cm->hasTextRecordings()) {
             auto rec = cm->textRecording();
-            if ((!rec) || !trs.contains(rec)) {
+            if (rec && !trs.contains(rec)) {
                 unread += rec->unreadCount();
                 trs << rec;
             }
         }
     });
 
+    d_ptr->m_UnreadCount = unread;
+    d_ptr->m_DirtyAggregates &= ~IndividualPrivate::Aggregate::UNREAD_COUNT;
+    IndividualPrivate::m_sStatistics.unreadCount++;
+
     return unread;
 }
 
@@ -626,7 +696,8 @@ void IndividualPrivate::disconnectContactMethod(ContactMethod* m)
 void Individual::registerContactMethod(ContactMethod* m)
 {
     d_ptr->m_HiddenContactMethods << m;
-    d_ptr->m_BestName.clear();
+    d_ptr->invalidate(IndividualPrivate::Aggregate::BEST_NAME | IndividualPrivate::Aggregate::UNREAD_COUNT);
+    d_ptr->indexContactMethod(m, true);
 
     merge(m->d_ptr->m_pIndividual);
 
@@ -700,6 +771,7 @@ void Individual::setPhoneNumbers(const QVector<ContactMethod*>& numbers)
         d_ptr->disconnectContactMethod(n);
 
     d_ptr->m_Numbers = QVector<ContactMethod*>::fromList(dedup.toList());
+    d_ptr->invalidate(IndividualPrivate::Aggregate::ALL);
 
     for (ContactMethod* n : qAsConst(d_ptr->m_Numbers))
         d_ptr->connectContactMethod(n);
@@ -798,7 +870,8 @@ ContactMethod* Individual::addPhoneNumber(ContactMethod* cm)
 
     beginInsertRows({}, d_ptr->m_Numbers.size(), d_ptr->m_Numbers.size());
     d_ptr->m_Numbers << cm;
-    d_ptr->m_BestName.clear();
+    d_ptr->invalidate(IndividualPrivate::Aggregate::BEST_NAME | IndividualPrivate::Aggregate::UNREAD_COUNT);
+    d_ptr->indexContactMethod(cm, false);
     endInsertRows();
 
     for (auto p : qAsConst(d_ptr->m_lParents)) {
@@ -857,6 +930,7 @@ ContactMethod* Individual::removePhoneNumber(ContactMethod* cm)
     phoneNumbersAboutToChange();
     beginRemoveRows({}, idx, idx);
     d_ptr->m_Numbers.remove(idx);
+    d_ptr->invalidate(IndividualPrivate::Aggregate::ALL);
 
     for (int i =0; i < d_ptr->m_Numbers.size(); i++) {
         auto cm = d_ptr->m_Numbers[i];
@@ -947,7 +1021,7 @@ ContactMethod* Individual::replacePhoneNumber(ContactMethod* old, ContactMethod*
     d_ptr->connectContactMethod(newCm);
     d_ptr->disconnectContactMethod(old);
 
-    d_ptr->m_BestName.clear();
+    d_ptr->invalidate(IndividualPrivate::Aggregate::ALL);
 
     for (auto p : qAsConst(d_ptr->m_lParents))
         emit p->relatedContactMethodsAdded(old);
@@ -1096,6 +1170,8 @@ void IndividualPrivate::slotCallAdded(Call *call)
 
 void IndividualPrivate::slotUnreadCountChanged()
 {
+    invalidate(Aggregate::UNREAD_COUNT);
+
     for (auto p : qAsConst(m_lParents))
         emit p->unreadCountChanged();
 }
@@ -1114,11 +1190,13 @@ void IndividualPrivate::slotCmDestroyed()
 
     m_HiddenContactMethods.removeAll(cm);
     m_Numbers.removeAll(cm);
+
+    invalidate(Aggregate::ALL);
 }
 
 void IndividualPrivate::slotChildrenContactChanged(Person* newContact, Person* oldContact)
 {
-    m_BestName.clear();
+    invalidate(Aggregate::BEST_NAME);
     auto cm = qobject_cast<ContactMethod*>(sender());
     for (auto p : qAsConst(m_lParents))
         emit p->childrenContactChanged(cm, newContact, oldContact);
@@ -1126,6 +1204,8 @@ void IndividualPrivate::slotChildrenContactChanged(Person* newContact, Person* o
 
 void IndividualPrivate::slotChildrenTextRecordingAdded(Media::TextRecording* t)
 {
+    invalidate(Aggregate::UNREAD_COUNT);
+
     if (!m_lRecordings.contains(t))
         m_lRecordings << t;
 
@@ -1137,6 +1217,9 @@ void IndividualPrivate::slotChildrenRebased(ContactMethod* other)
 {
     auto cm = qobject_cast<ContactMethod*>(sender());
 
+    // The ContactMethod::d() changed
+    invalidate(Aggregate::ALL);
+
     // Merge the individual. This assume the contacts are the same
     if (cm->d_ptr->m_pIndividual && cm->d_ptr->m_pIndividual->d_ptr == this) {
         q_ptr->merge(cm->d_ptr->m_pIndividual);
@@ -1208,7 +1291,7 @@ void IndividualPrivate::slotChanged()
 
 void IndividualPrivate::slotRegisteredName()
 {
-    m_BestName.clear();
+    invalidate(Aggregate::BEST_NAME);
     for (auto p : qAsConst(m_lParents))
         emit p->changed();
     emit PeersTimelineModel::instance().individualChanged(q_ptr->masterObject());
@@ -72,6 +72,12 @@ public:
     Q_PROPERTY(bool isAvailable  READ isAvailable  NOTIFY mediaAvailabilityChanged )
     Q_PROPERTY(bool isOffline    READ isOffline    NOTIFY changed                  )
 
+    /// Count how many times the cached aggregates had to be recomputed
+    struct AggregateStatistics {
+        int bestName       {0}; /*!< bestName() rebuilt from the ContactMethods   */
+        int unreadCount    {0}; /*!< unreadTextMessageCount() recomputed          */
+        int contactMethods {0}; /*!< The ContactMethod lookup index rebuilt       */
+    };
 
     virtual ~Individual();
 
@@ -224,6 +230,9 @@ public:
     // Check deduplication
     void* d() const;
 
+    /// The recomputation counters of all individuals (for profiling)
+    static AggregateStatistics aggregateStatistics();
+
 Q_SIGNALS:
     void hasEditRowChanged(bool v);
     ///The number of and/or the contact methods themselves have changed
@@ -19,6 +19,7 @@
 #include "individualtimelinemodel.h"
 
 // LibStdC++
+#include <algorithm>
 #include <chrono>
 #include <memory>
 
@@ -37,6 +38,7 @@
 #include "historytimecategorymodel.h"
 #include "private/textrecording_p.h"
 #include "libcard/matrixutils.h"
+#include "private/nodepool.h"
 #include <media/avrecording.h>
 
 struct TimeCategoryData
@@ -52,7 +54,7 @@ struct IndividualTimelineNode final {
     IndividualTimelineModel::NodeType    m_Type;
     time_t                               m_StartTime {0}; //Also used for generic sorting duties
     time_t                               m_EndTime   {0};
-    int                                  m_Index;
+    int                                  m_Index {-1}; //Storage position hint
 
     enum SumaryEntries {
         INCOMING  ,
@@ -99,6 +101,9 @@ public:
     // Attributes
     Individual* m_pIndividual {nullptr};
 
+    // The timelines are many and rebuilt often, they each own their nodes
+    NodeArena<IndividualTimelineNode> m_Arena {"IndividualTimelineNode"};
+
     std::vector<IndividualTimelineNode*> m_lTimeCategories;
     QHash<int, IndividualTimelineNode*>  m_hCats; //int <-> HistoryTimeCategoryModel::HistoryConst
     int m_TotalEntries {0};
@@ -106,22 +111,54 @@ public:
     // Keep track of the current group to simplify the lookup. It also allows
     // to split upstream (Serializable::Group) in multiple logical groups in
     // case different media need to be inserted in the middle of a group.
-    IndividualTimelineNode* m_pCurrentTextGroup {nullptr};
-    IndividualTimelineNode* m_pCurrentCallGroup {nullptr};
+    struct GroupCursor {
+        IndividualTimelineNode* m_pTextGroup  {nullptr};
+        IndividualTimelineNode* m_pCallGroup  {nullptr};
+        bool                    m_LastWasHead {false  };
+    };
+
+    /// A text recording walked from its newest message to its oldest
+    struct MessageCursor {
+        Media::TextRecording* m_pRecording;
+        int                   m_Position;
+    };
+
+    GroupCursor m_Live;    // New entries, oldest to newest
+    GroupCursor m_Backlog; // The history, newest to oldest
 
     QHash<Serializable::Group*, IndividualTimelineNode*> m_hTextGroups;
     QSet<Media::TextRecording*> m_hTrackedTRs;
     QSet<ContactMethod*> m_hTrackedCMs;
 
+    // The history is materialized newest first in bounded batches. The first
+    // one is loaded right away, the others only when a view asks for them.
+    // This keeps opening a large timeline from blocking the UI.
+    QSharedPointer<EventAggregate> m_pEvents;
+    int  m_EventCursor {0};
+    QVector<MessageCursor> m_lMessageCursors;
+    QSet<const Event*> m_hLoadedEvents;
+    QSet<IndividualTimelineNode*> m_hChanged;
+    bool m_HasNewest  {false};
+    bool m_IsBatching {false};
+
     // Constants
     static const Matrix1D<IndividualTimelineModel::NodeType ,QString> peerTimelineNodeName;
+    constexpr static const int BATCH_SIZE = 64;
 
     // Helpers
     QVariant groupRoleData(IndividualTimelineNode* group, int role);
     IndividualTimelineNode* getCategory(time_t t);
-    IndividualTimelineNode* getGroup(TextMessageNode* message);
+    IndividualTimelineNode* getGroup(TextMessageNode* message, IndividualTimelineNode* current);
     void insert(IndividualTimelineNode* n, time_t t, std::vector<IndividualTimelineNode*>& in, const QModelIndex& parent = {});
+    int row(IndividualTimelineNode* n) const;
+    QModelIndex indexOf(IndividualTimelineNode* n) const;
     void incrementCounter(IndividualTimelineNode* n);
+    void changed(IndividualTimelineNode* n);
+    bool addMessage(TextMessageNode* message, GroupCursor& c);
+    bool addEvent(const QSharedPointer<Event>& event, GroupCursor& c, bool backward);
+    QSharedPointer<Event> nextEvent();
+    bool canLoadMore() const;
+    int  loadBatch(int count);
     void init();
     void disconnectOldCms();
 
@@ -129,6 +166,8 @@ public:
 public Q_SLOTS:
     void slotMessageAdded(TextMessageNode* message);
     void slotEventAdded(QSharedPointer<Event>& call);
+    void slotAggregateInserted(const QSharedPointer<Event>& e, int position);
+    void slotAggregateRemoved(const QSharedPointer<Event>& e, int position);
     void slotReload();
     void slotClear(IndividualTimelineNode* root = nullptr);
     void slotContactChanged(ContactMethod* cm, Person* newContact, Person* oldContact);
@@ -193,14 +232,22 @@ void IndividualTimelineModelPrivate::init()
     for (auto cm : qAsConst(cms))
         q_ptr->addContactMethod(cm);
 
-    const auto events = m_pIndividual->eventAggregate()->events();
+    m_pEvents     = m_pIndividual->eventAggregate();
+    m_EventCursor = 0;
+
+    // Keep the cursor in sync when new events are merged into the aggregate
+    connect(m_pEvents.data(), &EventAggregate::eventInserted,
+        this, &IndividualTimelineModelPrivate::slotAggregateInserted);
 
-    for (auto e : qAsConst(events))
-        slotEventAdded(e);
+    connect(m_pEvents.data(), &EventAggregate::eventRemoved,
+        this, &IndividualTimelineModelPrivate::slotAggregateRemoved);
 
     const auto trs = m_pIndividual->textRecordings();
     for (auto t : qAsConst(trs))
         slotTextRecordingAdded(t);
+
+    // Only the most recent entries are materialized right away
+    loadBatch(BATCH_SIZE);
 }
 
 IndividualTimelineModel::IndividualTimelineModel(Individual* ind) : QAbstractItemModel(ind), d_ptr(new IndividualTimelineModelPrivate(this))
@@ -351,7 +398,7 @@ QVariant IndividualTimelineModel::data( const QModelIndex& idx, int role) const
                 case (int)Media::TextRecording::Role::FormattedDate:
                     return QDateTime::fromTime_t(
                          n->m_lChildren.empty() ?
-                            0 : n->m_lChildren[n->m_lChildren.size()-1]->m_EndTime
+                            0 : n->m_lChildren.front()->m_EndTime
                     );
                 default:
                     return QVariant();
@@ -421,7 +468,7 @@ QModelIndex IndividualTimelineModel::parent(const QModelIndex& index) const
     if (!n->m_pParent)
         return {};
 
-    return createIndex(n->m_pParent->m_Index, 0, n->m_pParent);
+    return d_ptr->indexOf(n->m_pParent);
 }
 
 QModelIndex IndividualTimelineModel::index(int row, int column, const QModelIndex& parent) const
@@ -429,8 +476,10 @@ QModelIndex IndividualTimelineModel::index(int row, int column, const QModelInde
     if (column || row < 0)
         return {};
 
-    if ((!parent.isValid()) && row < (int)d_ptr->m_lTimeCategories.size())
-        return createIndex(row, 0, d_ptr->m_lTimeCategories[row]);
+    const auto& cats = d_ptr->m_lTimeCategories;
+
+    if ((!parent.isValid()) && row < (int)cats.size())
+        return createIndex(row, 0, cats[cats.size() - 1 - row]);
 
     if (!parent.isValid())
         return {};
@@ -440,7 +489,19 @@ QModelIndex IndividualTimelineModel::index(int row, int column, const QModelInde
     if (row >= (int)n->m_lChildren.size())
         return {};
 
-    return createIndex(row, 0, n->m_lChildren[row]);
+    return createIndex(row, 0, n->m_lChildren[n->m_lChildren.size() - 1 - row]);
+}
+
+/// Older entries are only materialized on demand
+bool IndividualTimelineModel::canFetchMore(const QModelIndex& parent) const
+{
+    return (!parent.isValid()) && d_ptr->canLoadMore();
+}
+
+void IndividualTimelineModel::fetchMore(const QModelIndex& parent)
+{
+    if (!parent.isValid())
+        d_ptr->loadBatch(IndividualTimelineModelPrivate::BATCH_SIZE);
 }
 
 ///Set model data
@@ -488,40 +549,83 @@ void IndividualTimelineModelPrivate::incrementCounter(IndividualTimelineNode* n)
 
     m_TotalEntries++;
 
-    const auto idx   = q_ptr->createIndex(n->m_Index, 0, n);
+    changed(n);
+}
+
+/// Notify the views now or, when loading a batch, once it is done
+void IndividualTimelineModelPrivate::changed(IndividualTimelineNode* n)
+{
+    if (m_IsBatching) {
+        m_hChanged.insert(n);
+        return;
+    }
+
+    const auto idx = indexOf(n);
     emit q_ptr->dataChanged(idx, idx);
 }
 
-/// Generic modern C++ function to insert entries
+/**
+ * Generic modern C++ function to insert entries.
+ *
+ * The nodes are stored newest first while the rows are ordered oldest first.
+ * Both the history (loaded backward) and the new entries therefore end up at
+ * one of the extremities and the positions are never renumbered. The row of
+ * a node is computed by `row()`.
+ */
 void IndividualTimelineModelPrivate::insert(IndividualTimelineNode* n, time_t t,
     std::vector<IndividualTimelineNode*>& in, const QModelIndex& parent)
 {
-    // Many, if not most, elements are already sorted, speedup this case
-    if (in.size() > 0 && in[in.size()-1]->m_StartTime < t) {
-        n->m_Index = in.size();
-        q_ptr->beginInsertRows(parent, n->m_Index, n->m_Index);
-        in.push_back(n);
-        q_ptr->endInsertRows();
-        return;
-    }
+    int pos = 0;
 
-    static IndividualTimelineNode fake;
-    fake.m_StartTime = t;
+    if (in.empty() || in.back()->m_StartTime >= t)
+        pos = (int) in.size();
+    else if (in.front()->m_StartTime > t) {
+        auto it = std::upper_bound(in.begin(), in.end(), t,
+            [](time_t t2, const IndividualTimelineNode* a) -> bool {
+                return t2 > a->m_StartTime;
+        });
 
-    auto it = std::upper_bound(in.begin(), in.end(), &fake,
-        [](const IndividualTimelineNode* a, const IndividualTimelineNode* t2) -> bool {
-            return (int)a->m_StartTime < (int)t2->m_StartTime;
-    });
+        pos = (int) std::distance(in.begin(), it);
+    }
 
-    n->m_Index = std::distance(in.begin(), it);
+    n->m_Index = pos;
 
-    std::for_each(it, in.end(), [](IndividualTimelineNode* n) {n->m_Index++;});
+    const int r = (int) in.size() - pos;
 
-    q_ptr->beginInsertRows(parent, n->m_Index, n->m_Index);
-    in.insert(it, n);
+    q_ptr->beginInsertRows(parent, r, r);
+    in.insert(in.begin() + pos, n);
     q_ptr->endInsertRows();
+}
+
+/// Use the cached storage position when still valid, otherwise look it up
+int IndividualTimelineModelPrivate::row(IndividualTimelineNode* n) const
+{
+    const auto& in = n->m_pParent ? n->m_pParent->m_lChildren : m_lTimeCategories;
+
+    if (n->m_Index < 0 || n->m_Index >= (int)in.size() || in[n->m_Index] != n) {
+        auto it = std::lower_bound(in.begin(), in.end(), n->m_StartTime,
+            [](const IndividualTimelineNode* a, time_t t) -> bool {
+                return a->m_StartTime > t;
+        });
+
+        while (it != in.end() && *it != n && (*it)->m_StartTime == n->m_StartTime)
+            ++it;
+
+        // Overlapping groups can break the ordering, it should be rare
+        if (it == in.end() || *it != n)
+            it = std::find(in.begin(), in.end(), n);
 
-    incrementCounter(n);
+        Q_ASSERT(it != in.end());
+
+        n->m_Index = (int) std::distance(in.begin(), it);
+    }
+
+    return (int) in.size() - 1 - n->m_Index;
+}
+
+QModelIndex IndividualTimelineModelPrivate::indexOf(IndividualTimelineNode* n) const
+{
+    return q_ptr->createIndex(row(n), 0, n);
 }
 
 /// Return or create a time category
@@ -532,7 +636,7 @@ IndividualTimelineNode* IndividualTimelineModelPrivate::getCategory(time_t t)
     if (m_hCats.contains((int) cat))
         return m_hCats[(int) cat];
 
-    auto n               = new IndividualTimelineNode;
+    auto n               = m_Arena.create();
     n->m_Type            = IndividualTimelineModel::NodeType::TIME_CATEGORY;
     n->m_pTimeCat        = new TimeCategoryData;
     n->m_pTimeCat->m_Cat = cat;
@@ -548,14 +652,15 @@ IndividualTimelineNode* IndividualTimelineModelPrivate::getCategory(time_t t)
     return n;
 }
 
-IndividualTimelineNode* IndividualTimelineModelPrivate::getGroup(TextMessageNode* message)
+IndividualTimelineNode* IndividualTimelineModelPrivate::
+getGroup(TextMessageNode* message, IndividualTimelineNode* current)
 {
     const auto g = message->m_pGroup;
     Q_ASSERT(g);
 
-    if (m_pCurrentTextGroup && g == m_pCurrentTextGroup->m_pGroup) {
+    if (current && g == current->m_pGroup) {
         // The most simple case, no lookup required and nearly 100% probability
-        return m_pCurrentTextGroup;
+        return current;
     }
     else if (auto n = m_hTextGroups.value(g)) {
         return n;
@@ -569,7 +674,7 @@ IndividualTimelineNode* IndividualTimelineModelPrivate::getGroup(TextMessageNode
         IndividualTimelineModel::NodeType::SECTION_DELIMITER;
 
     // Create a new entry
-    auto ret       = new IndividualTimelineNode;
+    auto ret       = m_Arena.create();
     ret->m_Type    = type;
     ret->m_pGroup  = g;
     ret->m_pParent = cat;
@@ -582,7 +687,7 @@ IndividualTimelineNode* IndividualTimelineModelPrivate::getGroup(TextMessageNode
 
     Q_ASSERT(g->size());
 
-    insert(ret, ret->m_StartTime, cat->m_lChildren, q_ptr->createIndex(cat->m_Index, 0, cat));
+    insert(ret, ret->m_StartTime, cat->m_lChildren, indexOf(cat));
 
     m_hTextGroups[g] = ret;
 
@@ -590,6 +695,11 @@ IndividualTimelineNode* IndividualTimelineModelPrivate::getGroup(TextMessageNode
 }
 
 void IndividualTimelineModelPrivate::slotMessageAdded(TextMessageNode* message)
+{
+    addMessage(message, m_Live);
+}
+
+bool IndividualTimelineModelPrivate::addMessage(TextMessageNode* message, GroupCursor& c)
 {
     const auto messageType = message->m_pMessage->type() == Media::MimeMessage::Type::SNAPSHOT ?
         IndividualTimelineModel::NodeType::SNAPSHOT :
@@ -597,31 +707,45 @@ void IndividualTimelineModelPrivate::slotMessageAdded(TextMessageNode* message)
 
     // Do not show empty messages
     if (message->m_pMessage->plainText().isEmpty() && messageType != IndividualTimelineModel::NodeType::SNAPSHOT)
-        return;
+        return false;
 
-    auto group = getGroup(message);
-    m_pCurrentTextGroup = group;
-    m_pCurrentCallGroup = nullptr;
+    auto group = getGroup(message, c.m_pTextGroup);
+    c.m_pTextGroup = group;
+    c.m_pCallGroup = nullptr;
 
-    auto ret         = new IndividualTimelineNode;
+    auto ret         = m_Arena.create();
     ret->m_pMessage  = message;
     ret->m_StartTime = message->m_pMessage->timestamp();
     ret->m_pParent   = group;
     ret->m_Type      = messageType;
 
-    insert(ret, ret->m_StartTime, group->m_lChildren, q_ptr->createIndex(group->m_Index, 0, group));
+    insert(ret, ret->m_StartTime, group->m_lChildren, indexOf(group));
 
     // Update the group timelapse
     group->m_EndTime = std::max(ret->m_StartTime, group->m_EndTime);
 
-    const auto idx   = q_ptr->createIndex(group->m_Index, 0, group);
-    emit q_ptr->dataChanged(idx, idx);
+    incrementCounter(ret);
+    changed(group);
+
+    return true;
 }
 
 void IndividualTimelineModelPrivate::slotEventAdded(QSharedPointer<Event>& event)
+{
+    addEvent(event, m_Live, false);
+}
+
+bool IndividualTimelineModelPrivate::
+addEvent(const QSharedPointer<Event>& event, GroupCursor& c, bool backward)
 {
     if (event->eventCategory() != Event::EventCategory::CALL)
-        return; //TODO merge both code paths
+        return false; //TODO merge both code paths
+
+    // The live events can also be part of the history being loaded
+    if (m_hLoadedEvents.contains(event.data()))
+        return false;
+
+    m_hLoadedEvents.insert(event.data());
 
     auto cat = getCategory(event->startTimeStamp());
 
@@ -631,72 +755,188 @@ void IndividualTimelineModelPrivate::slotEventAdded(QSharedPointer<Event>& event
         Media::Attachment::BuiltInTypes::AUDIO_RECORDING
     );
 
-    const bool wasRec = m_pCurrentCallGroup && m_pCurrentCallGroup->m_Type ==
+    const bool wasRec = c.m_pCallGroup && c.m_pCallGroup->m_Type ==
         IndividualTimelineModel::NodeType::RECORDINGS;
 
-    const bool hasNewCat = (!m_pCurrentCallGroup)
-        || (m_pCurrentCallGroup->m_pParent != cat);
+    const bool hasNewCat = (!c.m_pCallGroup)
+        || (c.m_pCallGroup->m_pParent != cat);
+
+    // When walking the history backward, the previous event is the one which
+    // started a group.
+    const bool isHead = backward ? c.m_LastWasHead : event->isGroupHead();
+    c.m_LastWasHead   = event->isGroupHead();
 
     // This abuses a bit of implementation details of the history. The calls
     // are expected to arrive ordered by time_t, so this allows to take a
     // little shortcut and skip proper lookup. If this is to ever become a false
     // assumption, then this code will need to be updated.
-    if (hasNewCat || hasRec || wasRec || event->isGroupHead()) {
-        m_pCurrentCallGroup = new IndividualTimelineNode;
-        m_pCurrentTextGroup = nullptr;
+    if (hasNewCat || hasRec || wasRec || isHead) {
+        c.m_pCallGroup = m_Arena.create();
+        c.m_pTextGroup = nullptr;
 
-        m_pCurrentCallGroup->m_Type = hasRec ?
+        c.m_pCallGroup->m_Type = hasRec ?
             IndividualTimelineModel::NodeType::RECORDINGS :
                 IndividualTimelineModel::NodeType::CALL_GROUP;
 
-        m_pCurrentCallGroup->m_StartTime = event->startTimeStamp();
-        m_pCurrentCallGroup->m_EndTime   = event->stopTimeStamp ();
+        c.m_pCallGroup->m_StartTime = event->startTimeStamp();
+        c.m_pCallGroup->m_EndTime   = event->stopTimeStamp ();
 
-        for (int i=0; i < 4; i++) m_pCurrentCallGroup->m_lSummary[i] = 0;
+        for (int i=0; i < 4; i++) c.m_pCallGroup->m_lSummary[i] = 0;
 
-        m_pCurrentCallGroup->m_pParent = cat;
+        c.m_pCallGroup->m_pParent = cat;
 
         insert(
-            m_pCurrentCallGroup, m_pCurrentCallGroup->m_StartTime, cat->m_lChildren,
-            q_ptr->createIndex(cat->m_Index, 0, cat)
+            c.m_pCallGroup, c.m_pCallGroup->m_StartTime, cat->m_lChildren,
+            indexOf(cat)
         );
     }
 
-    if (m_pCurrentCallGroup->m_Type == IndividualTimelineModel::NodeType::RECORDINGS)
-        Q_ASSERT(!m_pCurrentCallGroup->m_lChildren.size());
+    if (c.m_pCallGroup->m_Type == IndividualTimelineModel::NodeType::RECORDINGS)
+        Q_ASSERT(!c.m_pCallGroup->m_lChildren.size());
 
-    auto ret         = new IndividualTimelineNode;
+    auto ret         = m_Arena.create();
     ret->m_pCall     = event.data(); //FIXME
     ret->m_Type      = IndividualTimelineModel::NodeType::CALL;
     ret->m_StartTime = event->startTimeStamp();
     ret->m_EndTime   = event->stopTimeStamp();
-    ret->m_pParent   = m_pCurrentCallGroup;
+    ret->m_pParent   = c.m_pCallGroup;
 
     insert(
-        ret, ret->m_StartTime, m_pCurrentCallGroup->m_lChildren,
-        q_ptr->createIndex(m_pCurrentCallGroup->m_Index, 0, m_pCurrentCallGroup)
+        ret, ret->m_StartTime, c.m_pCallGroup->m_lChildren,
+        indexOf(c.m_pCallGroup)
     );
 
     // Update the group timelapse and counters
-    m_pCurrentCallGroup->m_lSummary[
+    c.m_pCallGroup->m_lSummary[
         (event->status() == Event::Status::X_MISSED ? 2 : 0) +
         (event->direction() == Event::Direction::INCOMING ? 0 : 1)
     ]++;
 
-    m_pCurrentCallGroup->m_EndTime = ret->m_EndTime;
+    if (backward)
+        c.m_pCallGroup->m_StartTime = ret->m_StartTime;
+    else
+        c.m_pCallGroup->m_EndTime = ret->m_EndTime;
 
-    const auto idx = q_ptr->createIndex(
-        m_pCurrentCallGroup->m_pParent->m_Index, 0, m_pCurrentCallGroup->m_pParent
-    );
+    incrementCounter(ret);
 
     // For the CallCount
-    const auto gidx = q_ptr->createIndex(
-        m_pCurrentCallGroup->m_Index, 0, m_pCurrentCallGroup
-    );
+    changed(c.m_pCallGroup);
 
-    emit q_ptr->dataChanged(idx, idx);
+    return true;
+}
+
+void IndividualTimelineModelPrivate::
+slotAggregateInserted(const QSharedPointer<Event>& e, int position)
+{
+    Q_UNUSED(e)
+
+    if (position < m_EventCursor)
+        m_EventCursor++;
+}
 
-    emit q_ptr->dataChanged(gidx, gidx);
+void IndividualTimelineModelPrivate::
+slotAggregateRemoved(const QSharedPointer<Event>& e, int position)
+{
+    Q_UNUSED(e)
+
+    if (position < m_EventCursor)
+        m_EventCursor--;
+}
+
+/// The newest event which has not been loaded yet
+QSharedPointer<Event> IndividualTimelineModelPrivate::nextEvent()
+{
+    if (!m_pEvents)
+        return {};
+
+    if (m_EventCursor >= m_pEvents->count() && m_pEvents->canFetchMore())
+        m_pEvents->fetchMore(BATCH_SIZE);
+
+    if (m_EventCursor >= m_pEvents->count())
+        return {};
+
+    return m_pEvents->eventAt(m_EventCursor);
+}
+
+bool IndividualTimelineModelPrivate::canLoadMore() const
+{
+    if (!m_pIndividual)
+        return false;
+
+    return (!m_lMessageCursors.isEmpty()) || (m_pEvents && (
+        m_EventCursor < m_pEvents->count() || m_pEvents->canFetchMore()
+    ));
+}
+
+/**
+ * Materialize up to `count` older entries.
+ *
+ * The events and the text recordings are merged newest first so the groups
+ * are delimited the same way as if they had been added one by one.
+ */
+int IndividualTimelineModelPrivate::loadBatch(int count)
+{
+    if (m_IsBatching || !canLoadMore())
+        return 0;
+
+    m_IsBatching = true;
+
+    int loaded = 0;
+
+    for (; loaded < count; loaded++) {
+        const auto event = nextEvent();
+
+        // Find the newest message across all text recordings
+        int newest = -1;
+        time_t newestTime = 0;
+
+        for (int i = 0; i < m_lMessageCursors.size(); i++) {
+            const auto& mc = m_lMessageCursors[i];
+            const auto  m  = mc.m_pRecording->d_ptr->m_lNodes[mc.m_Position];
+
+            if (newest == -1 || m->m_pMessage->timestamp() > newestTime) {
+                newest     = i;
+                newestTime = m->m_pMessage->timestamp();
+            }
+        }
+
+        if (newest == -1 && !event)
+            break;
+
+        bool added = false;
+
+        if (newest != -1 && ((!event) || newestTime >= event->startTimeStamp())) {
+            auto& mc = m_lMessageCursors[newest];
+            const auto m = mc.m_pRecording->d_ptr->m_lNodes[mc.m_Position--];
+
+            if (mc.m_Position < 0)
+                m_lMessageCursors.remove(newest);
+
+            added = addMessage(m, m_Backlog);
+        }
+        else {
+            m_EventCursor++;
+            added = addEvent(event, m_Backlog, true);
+        }
+
+        // The newest entry is where the live updates resume from
+        if (added && !m_HasNewest) {
+            m_HasNewest = true;
+
+            if (!(m_Live.m_pCallGroup || m_Live.m_pTextGroup))
+                m_Live = m_Backlog;
+        }
+    }
+
+    m_IsBatching = false;
+
+    const auto nodes = m_hChanged;
+    m_hChanged.clear();
+
+    for (auto n : qAsConst(nodes))
+        changed(n);
+
+    return loaded;
 }
 
 /// To use with extreme restrict, this isn't really intended to be used directly
@@ -765,6 +1005,9 @@ void IndividualTimelineModelPrivate::slotIndividualDestroyed()
     disconnect(m_pIndividual, &QObject::destroyed, this,
         &IndividualTimelineModelPrivate::slotIndividualDestroyed);
 
+    // The recordings may not outlive the individual
+    m_lMessageCursors.clear();
+
     m_pIndividual = nullptr;
 
     qWarning() << "An individual was destroyed while its timeline is referenced" << this;
@@ -772,32 +1015,83 @@ void IndividualTimelineModelPrivate::slotIndividualDestroyed()
 
 void IndividualTimelineModelPrivate::slotReload()
 {
-    // Eventually, this could be optimized to detect if `reset` is more efficient
-    // than individual `move` operation and pick the "right" mode. For now,
-    // `reset` creates more readable code, so that will be it.
+    // As time passes, the entries drift into older categories. The children
+    // are stored newest first, so if both ends still belong to the category,
+    // all of them do.
+    std::vector<IndividualTimelineNode*> stale;
+
+    for (auto cat : m_lTimeCategories) {
+        const auto& in = cat->m_lChildren;
+
+        if (in.empty())
+            continue;
+
+        const auto newest = HistoryTimeCategoryModel::timeToHistoryConst(in.front()->m_StartTime);
+        const auto oldest = HistoryTimeCategoryModel::timeToHistoryConst(in.back()->m_StartTime);
+
+        if (newest != cat->m_pTimeCat->m_Cat || oldest != cat->m_pTimeCat->m_Cat)
+            stale.push_back(cat);
+    }
+
+    if (stale.empty())
+        return;
+
+    // Create the new categories before the reset, `getCategory()` notifies
+    // their insertion.
+    std::vector< std::pair<IndividualTimelineNode*, IndividualTimelineNode*> > moves;
+
+    for (auto cat : stale) {
+        for (auto n : cat->m_lChildren)
+            moves.emplace_back(n, getCategory(n->m_StartTime));
+    }
 
+    // Eventually, this could be optimized to use `move` operations. For now,
+    // `reset` creates more readable code, so that will be it.
     q_ptr->beginResetModel();
 
+    for (auto cat : stale) {
+        cat->m_lChildren.clear();
+        cat->m_pTimeCat->m_Entries = 0;
+    }
+
     // Keep the old sub-trees, there is no point in re-generating them
-    std::list< std::vector<IndividualTimelineNode*> > entries;
+    QSet<IndividualTimelineNode*> targets;
 
-    for (auto n : m_lTimeCategories) {
-        entries.push_back(std::move(n->m_lChildren));
-        n->m_lChildren = {};
+    for (const auto& m : moves) {
+        m.first->m_pParent = m.second;
+        m.second->m_lChildren.push_back(m.first);
+        m.second->m_pTimeCat->m_Entries += (int) m.first->m_lChildren.size();
+        targets.insert(m.second);
     }
 
-    // Add all items to their new categories
-    for (auto nl : entries) {
-        for (auto n : nl) {
-            auto cat = getCategory(n->m_StartTime);
+    // `insert()` and `row()` expect the newest first order
+    for (auto cat : qAsConst(targets)) {
+        auto& in = cat->m_lChildren;
 
-            n->m_pParent = cat;
-            n->m_Index   = cat->m_lChildren.size();
+        std::stable_sort(in.begin(), in.end(),
+            [](const IndividualTimelineNode* a, const IndividualTimelineNode* b) -> bool {
+                return a->m_StartTime > b->m_StartTime;
+        });
 
-            cat->m_lChildren.push_back(n);
-        }
+        for (int i = 0; i < (int) in.size(); i++)
+            in[i]->m_Index = i;
     }
 
+    // Drop the categories left without entries
+    for (auto cat : stale) {
+        if (!cat->m_lChildren.empty())
+            continue;
+
+        m_hCats.remove((int) cat->m_pTimeCat->m_Cat);
+        m_lTimeCategories.erase(
+            std::find(m_lTimeCategories.begin(), m_lTimeCategories.end(), cat)
+        );
+        m_Arena.destroy(cat);
+    }
+
+    for (int i = 0; i < (int) m_lTimeCategories.size(); i++)
+        m_lTimeCategories[i]->m_Index = i;
+
     q_ptr->endResetModel();
 }
 
@@ -806,17 +1100,31 @@ void IndividualTimelineModelPrivate::slotClear(IndividualTimelineNode* root)
     for (auto n : root ? root->m_lChildren : m_lTimeCategories)
         slotClear(n);
 
+    // The nodes own their children vector, so they still need to be
+    // destructed, but their slots are released all at once below.
     if (root)
-        delete root;
+        m_Arena.destruct(root);
     else {
         m_lTimeCategories.clear();
         m_hCats.clear();
         m_hTextGroups.clear();
         m_hTrackedCMs.clear();
         m_hTrackedTRs.clear();
-        m_pCurrentCallGroup = nullptr;
-        m_pCurrentTextGroup = nullptr;
+        m_hLoadedEvents.clear();
+        m_hChanged.clear();
+        m_lMessageCursors.clear();
+        m_Live         = {};
+        m_Backlog      = {};
+        m_HasNewest    = false;
+        m_EventCursor  = 0;
         m_TotalEntries = 0;
+
+        if (m_pEvents)
+            disconnect(m_pEvents.data(), nullptr, this, nullptr);
+
+        m_pEvents.clear();
+
+        m_Arena.clear();
     }
 }
 
@@ -896,8 +1204,9 @@ slotTextRecordingAdded(Media::TextRecording* r)
 
     m_hTrackedTRs.insert(r);
 
-    for (auto m : qAsConst(r->d_ptr->m_lNodes))
-        slotMessageAdded(m);
+    // The existing messages are part of the history, they are loaded in batches
+    if (!r->d_ptr->m_lNodes.isEmpty())
+        m_lMessageCursors << MessageCursor {r, r->d_ptr->m_lNodes.size() - 1};
 
     connect(r->d_ptr, &Media::TextRecordingPrivate::messageAdded,
         this, &IndividualTimelineModelPrivate::slotMessageAdded);
@@ -42,6 +42,9 @@ class IndividualTimelineModelPrivate;
  * layer is occupied by the recordings (history call, audio file, texts, mails)
  * themselves.
  *
+ * The history is loaded newest first in batches. Only the most recent entries
+ * are available right away, the rest is added when a view calls `fetchMore()`.
+ *
  */
 class LIB_EXPORT IndividualTimelineModel final : public QAbstractItemModel
 {
@@ -91,6 +94,8 @@ public:
     virtual QModelIndex   parent   ( const QModelIndex& index                             ) const override;
     virtual QModelIndex   index    ( int row, int column, const QModelIndex& parent = {}  ) const override;
     virtual bool  setData  ( const QModelIndex& index, const QVariant &value, int role)       override;
+    virtual bool  canFetchMore( const QModelIndex& parent                             ) const override;
+    virtual void  fetchMore   ( const QModelIndex& parent                                   ) override;
 
     virtual QHash<int,QByteArray> roleNames() const override;
 
@@ -92,6 +92,16 @@ public:
      * Return the icons associated with the action and its state
      */
     virtual QVariant userActionIcon(const UserActionElement& state) const = 0;
+
+    /**
+     * The memory used by a pixmap returned by personPhoto(), in bytes.
+     *
+     * It is used to bound the decoded photo cache. Return 0 when unknown.
+     */
+    virtual int pixmapCost(const QVariant& pxm) const {
+        Q_UNUSED(pxm)
+        return 0;
+    }
 };
 
 } // namespace Interfaces
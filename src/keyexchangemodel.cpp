@@ -196,13 +196,13 @@ void KeyExchangeModelPrivate::slotCurrentIndexChanged(const QModelIndex& idx, co
 ///Return the key exchange mechanism
 KeyExchangeModel::Type KeyExchangeModelPrivate::keyExchange() const
 {
-   return KeyExchangeModelPrivate::fromDaemonName(m_pAccount->d_ptr->accountDetail(DRing::Account::ConfProperties::SRTP::KEY_EXCHANGE));
+   return KeyExchangeModelPrivate::fromDaemonName(m_pAccount->d_ptr->accountDetail(AccountDetails::Key::SRTP_KEY_EXCHANGE));
 }
 
 ///Set the Tls method
 void KeyExchangeModelPrivate::setKeyExchange(KeyExchangeModel::Type detail)
 {
-   m_pAccount->d_ptr->setAccountProperty(DRing::Account::ConfProperties::SRTP::KEY_EXCHANGE ,KeyExchangeModelPrivate::toDaemonName(detail));
+   m_pAccount->d_ptr->setAccountProperty(AccountDetails::Key::SRTP_KEY_EXCHANGE ,KeyExchangeModelPrivate::toDaemonName(detail));
    m_pAccount->d_ptr->regenSecurityValidation();
 }
 
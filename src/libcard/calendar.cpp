@@ -34,10 +34,14 @@
 #include <phonedirectorymodel.h>
 #include <localrecordingcollection.h>
 #include <media/avrecording.h>
+#include <collectionloader.h>
 #include "../private/call_p.h"
 #include "libcard/private/event_p.h"
 #include "libcard/private/icsbuilder.h"
 #include "libcard/private/icsloader.h"
+#include "tracing.h"
+
+struct ParsedEvent;
 
 class CalendarEditor final : public CollectionEditor<Event>
 {
@@ -85,6 +89,7 @@ public:
 
     // Helpers
     Event* getEvent(const EventPrivate& data, Event::SyncState st);
+    void publish(QVector<ParsedEvent>& parsed);
     Event* updateEvent(Event* e, const EventPrivate& data);
 
 public Q_SLOTS:
@@ -107,7 +112,28 @@ Calendar::~Calendar()
     delete d_ptr;
 }
 
-bool Calendar::load()
+/**
+ * An event read from the file.
+ *
+ * The parsing can happen in a CollectionLoader thread, so the attendees and
+ * attachments are kept as strings until they are resolved in the main thread.
+ */
+struct ParsedEvent final
+{
+    struct Attendee {
+        QByteArray uri      ;
+        QByteArray personUid;
+        QByteArray accountId;
+        QString    cn       ;
+    };
+
+    EventPrivate        data      ;
+    QVector<Attendee>   attendees ;
+    QVector<QByteArray> recordings;
+};
+
+/// Read the file, this doesn't touch the models and is safe to call in a thread
+static QVector<ParsedEvent> parseCalendar(Calendar* cal, const QByteArray& path)
 {
     ICSLoader l;
     auto calendarAdapter = std::shared_ptr<VObjectAdapter<Calendar>>(
@@ -118,6 +144,9 @@ bool Calendar::load()
         new  VObjectAdapter<EventPrivate>
     );
 
+    // The event being parsed
+    ParsedEvent current;
+
     // It was very unreadable without it
 #define ARGS (EventPrivate* self, const std::basic_string<char>& value, const AbstractVObjectAdaptor::Parameters& params)
 
@@ -136,35 +165,26 @@ bool Calendar::load()
         self->m_RevTimeStamp = QString(value.data()).toInt();
     });
 
-    eventAdapter->addPropertyHandler("ATTENDEE", [this]ARGS {
-        const QByteArray val = QByteArray::fromRawData(value.data(), value.size());
-
-        Account* a = nullptr;
-        Person*  p = nullptr;
+    eventAdapter->addPropertyHandler("ATTENDEE", [&current]ARGS {
+        ParsedEvent::Attendee attendee;
+        attendee.uri = QByteArray(value.data(), value.size());
 
         for (auto param : params) {
             const QByteArray pKey = QByteArray::fromRawData(param.first.data (), param.first.size ());
-            QByteArray pVal = QByteArray::fromRawData(param.second.data(), param.second.size());
 
-            //WARNING Always detach the value before sending into other classes
-            // unless it is not stored
+            //WARNING Always detach the value before storing it
+            const QByteArray pVal(param.second.data(), param.second.size());
 
-            if (pKey == "CN") {
-                pVal.detach();
+            if (pKey == "CN")
                 self->m_CN = pVal;
-            }
-            else if (pKey == "UID") {
-                pVal.detach();
-                p = PersonModel::instance().getPlaceHolder(pVal);
-            }
+            else if (pKey == "UID")
+                attendee.personUid = pVal;
             else if (pKey == "X_RING_ACCOUNTID")
-                a = AccountModel::instance().getById(pVal);
+                attendee.accountId = pVal;
         }
 
-        self->m_lAttendees << QPair<ContactMethod*, QString> {
-            PhoneDirectoryModel::instance().getNumber(val, p, a ? a : account()),
-            self->m_CN
-        };
+        attendee.cn = self->m_CN;
+        current.attendees << attendee;
     });
 
     eventAdapter->addPropertyHandler("CATEGORIES", []ARGS {
@@ -193,52 +213,41 @@ bool Calendar::load()
     });
 
     // Import the autio recordings
-    eventAdapter->addPropertyHandler("ATTACH", []ARGS {
+    eventAdapter->addPropertyHandler("ATTACH", [&current]ARGS {
         if (self->m_EventCategory == Event::EventCategory::CALL) {
-            Media::AVRecording* rec = nullptr;
             for (auto param : params) {
-                if (param.first == "FMTTYPE" && param.second == "audio/x-wav") {
-                    rec = LocalRecordingCollection::instance().addFromPath(
-                        value.data()
-                    );
-
-                    self->m_lAttachedFiles << rec;
-
-                    Q_ASSERT(rec->type() == Media::Attachment::BuiltInTypes::AUDIO_RECORDING);
-                }
+                if (param.first == "FMTTYPE" && param.second == "audio/x-wav")
+                    current.recordings << QByteArray(value.data(), value.size());
             }
         }
     });
 
+#undef ARGS
+
     // All events are part of this calendar file, so assume it can be ignored
-    calendarAdapter->setObjectFactory([this](const std::basic_string<char>& object_type) -> Calendar* {
+    calendarAdapter->setObjectFactory([cal](const std::basic_string<char>& object_type) -> Calendar* {
         Q_UNUSED(object_type)
-        return this;
+        return cal;
     });
 
-    // No need to allocate anything for each events, it will happen anyway
-    // in Event:: constructor
-    EventPrivate e;
-
-    eventAdapter->setObjectFactory([&e](const std::basic_string<char>& object_type) -> EventPrivate* {
-        e = {};
-        e.m_Type = Event::typeFromName(object_type.data());
-        return &e;
+    eventAdapter->setObjectFactory([&current](const std::basic_string<char>& object_type) -> EventPrivate* {
+        current = {};
+        current.data.m_Type = Event::typeFromName(object_type.data());
+        return &current.data;
     });
 
-    // Do not add the events yet, batch those insertion once the newest event
-    // is known to avoid triggering thousand of peers timeline updates.
-    QList<Event*> events;
+    QVector<ParsedEvent> events;
 
     calendarAdapter->setFallbackObjectHandler<EventPrivate>(
-        [this, &events](
+        [&events, &current](
            Calendar* self,
            EventPrivate* child,
            const std::basic_string<char>& name
         ) {
             Q_UNUSED(self)
+            Q_UNUSED(child)
             Q_UNUSED(name)
-            events << d_ptr->getEvent(*child, Event::SyncState::SAVED);
+            events << current;
     });
 
     l.registerVObjectAdaptor("VCALENDAR", calendarAdapter);
@@ -247,9 +256,45 @@ bool Calendar::load()
     l.registerVObjectAdaptor("VTODO"    , eventAdapter   );
     l.registerVObjectAdaptor("VALARM"   , eventAdapter   );
 
-    l.loadFile(path().toLatin1().data());
+    {
+        Tracing::Span s("parsing", "ICSLoader::loadFile");
+        l.loadFile(path.data());
+    }
 
-#undef ARGS
+    return events;
+}
+
+/// Resolve the peers and insert the events, in the main thread
+void CalendarPrivate::publish(QVector<ParsedEvent>& parsed)
+{
+    // Do not add the events yet, batch those insertion once the newest event
+    // is known to avoid triggering thousand of peers timeline updates.
+    QList<Event*> events;
+    events.reserve(parsed.size());
+
+    for (auto& p : parsed) {
+        for (const auto& attendee : qAsConst(p.attendees)) {
+            Person*  person = attendee.personUid.isEmpty() ?
+                nullptr : PersonModel::instance().getPlaceHolder(attendee.personUid);
+            Account* a      = attendee.accountId.isEmpty() ?
+                nullptr : AccountModel::instance().getById(attendee.accountId);
+
+            p.data.m_lAttendees << QPair<ContactMethod*, QString> {
+                PhoneDirectoryModel::instance().getNumber(attendee.uri, person, a ? a : m_pAccount),
+                attendee.cn
+            };
+        }
+
+        for (const auto& path : qAsConst(p.recordings)) {
+            auto rec = LocalRecordingCollection::instance().addFromPath(path);
+
+            p.data.m_lAttachedFiles << rec;
+
+            Q_ASSERT(rec->type() == Media::Attachment::BuiltInTypes::AUDIO_RECORDING);
+        }
+
+        events << getEvent(p.data, Event::SyncState::SAVED);
+    }
 
     //TODO add batching to the collection system
 
@@ -258,14 +303,41 @@ bool Calendar::load()
         auto e = events.takeLast();
         if (!e->collection()) {
             if (e->syncState() == Event::SyncState::NEW)
-                editor<Event>()->addNew(e);
+                m_pEditor->addNew(e);
             else
-                editor<Event>()->addExisting(e);
+                m_pEditor->addExisting(e);
         }
     }
 
-    d_ptr->m_IsLoaded = true;
-    emit loadingFinished();
+    m_IsLoaded = true;
+    emit q_ptr->loadingFinished();
+
+    // Save the events added while the calendar was waiting to be loaded
+    {
+        QMutexLocker l(&m_Mutex);
+        if ((!m_lUnsavedEvent.isEmpty()) && !m_HasDelayedSave) {
+            QTimer::singleShot(0, this, &CalendarPrivate::slotSaveOnDisk);
+            m_HasDelayedSave = true;
+        }
+    }
+}
+
+bool Calendar::load()
+{
+    const QByteArray path = this->path().toLatin1();
+
+    // Parse the file in the loader pool, insert the events in the main thread
+    if (CollectionLoader::instance().isLoading(this)) {
+        auto d = d_ptr;
+        CollectionLoader::instance().run(this, [this, d, path]() -> std::function<void()> {
+            auto events = parseCalendar(this, path);
+            return [d, events]() mutable { d->publish(events); };
+        });
+    }
+    else {
+        auto events = parseCalendar(this, path);
+        d_ptr->publish(events);
+    }
 
     return true;
 }
@@ -600,6 +672,13 @@ void CalendarPrivate::slotEventStateChanged(Event::SyncState state, Event::SyncS
 
 void CalendarPrivate::slotSaveOnDisk()
 {
+    // Appending to (or compacting) a file that isn't loaded yet would lose
+    // events. load() will save once it is done.
+    if (!m_IsLoaded) {
+        m_HasDelayedSave = false;
+        return;
+    }
+
     // Decide if it's worth running the garbage collection.
     // The unsorted entries are worth more because they slow down startup
     // while the other 2 are mostly harmless beside more I/O.
@@ -20,6 +20,8 @@
 
 // qt
 #include <QtCore/QAbstractListModel>
+#include <QtCore/QSet>
+#include <QtCore/QHash>
 
 // ring
 #include <libcard/private/event_p.h>
@@ -30,6 +32,9 @@
 
 // libstdc++
 #include <new>
+#include <algorithm>
+#include <functional>
+#include <limits>
 
 struct Multi //TODO
 {
@@ -103,6 +108,8 @@ struct EventAggregateNode final : public EventMetaNode
     EventTimelineNode*    m_pTimelineNode {nullptr};
 };
 
+class UnsortedEventListView;
+
 class EventAggregatePrivate final : public QObject
 {
     Q_OBJECT
@@ -110,6 +117,9 @@ public:
     explicit EventAggregatePrivate() noexcept : QObject(nullptr) {}
     virtual ~EventAggregatePrivate();
 
+    /// The number of events materialized when a view asks for more
+    constexpr static const int PAGE_SIZE = 50;
+
     enum class Mode {
         CONTACT_METHOD, /*!< Only a single contact method and nothing else */
         INDIVIDUAL    , /*!< A single individual                           */
@@ -118,36 +128,72 @@ public:
 
     // Depends on the m_Mode
 //     union { //FIXME it worked, but it was unstable because of unrelated reasons and I wanted to debug less places
-        Individual* m_pIndividual;
-        Multi* m_Multi;
-        ContactMethod* m_pContactMethod;
+        Individual* m_pIndividual {nullptr};
+        Multi* m_Multi {nullptr};
+        ContactMethod* m_pContactMethod {nullptr};
 //     };
 
     // Attributes
     RootEventNode* m_pRoot { new RootEventNode() };
 
-    //HACK no time to do better
+    /// The events materialized so far, newest first
     QVector<QSharedPointer<Event>> m_lAllEvents;
 
+    /// The events not materialized yet, as a heap with the newest on top
+    QVector<QSharedPointer<Event>> m_lPending;
+    bool m_IsPrimed {false};
+
+    /// The merged aggregates are a k-way merge of their source streams
+    QList<QSharedPointer<EventAggregate>> m_lSources;
+    QVector<int> m_lCursors;
+
+    /// Events shared by multiple contact methods of an individual
+    QSet<const Event*> m_hKnown;
+
+    /// How many sources of a merge have delivered each event
+    QHash<const Event*, int> m_hSourceCount;
+
+    /// Events detached before they were materialized, they are still pending
+    QSet<const Event*> m_hDetached;
+
     QSharedPointer<QAbstractItemModel> m_pUnsortedListModel {nullptr};
+    UnsortedEventListView* m_pView {nullptr};
 
-    QSharedPointer<EventAggregate> m_pWeakSelf {nullptr}; //FIXME use QWeakPointer
+    QWeakPointer<EventAggregate> m_pWeakSelf;
 
+    EventAggregate* q_ptr {nullptr};
 
     // Helper
     void splitGroup(EventAggregateNode* toSplit, EventAggregateNode* splitWith);
+    void prime();
+    void collect(const ContactMethod* cm);
+    bool canFetchMore() const;
+    int  fetchMore(int count);
+    QSharedPointer<Event> takeNext();
+    int  indexOf(const QSharedPointer<Event>& e) const;
+    void insert(const QSharedPointer<Event>& e);
+    void remove(int position);
+
+    static bool isNewer(const Event* a, const Event* b);
+    static bool isOlder(const Event* a, const Event* b);
+    static bool isPendingOlder(const QSharedPointer<Event>& a, const QSharedPointer<Event>& b);
+
+    static QSharedPointer<EventAggregate> create(Mode m);
 
 public Q_SLOTS:
     void slotAttendeeAdded(ContactMethod* cm);
     void slotEventChanged();
     void slotEventAdded(QSharedPointer<Event> e);
     void slotEventDetached(QSharedPointer<Event> e);
+    void slotSourceInserted(const QSharedPointer<Event>& e, int position);
+    void slotSourceRemoved(const QSharedPointer<Event>& e, int position);
 };
 
 
 class UnsortedEventListView final : public QAbstractListModel
 {
     Q_OBJECT
+    friend class EventAggregatePrivate; // notify the row changes
 public:
     explicit UnsortedEventListView(const QSharedPointer<EventAggregatePrivate>& d_ptr);
     virtual ~UnsortedEventListView();
@@ -155,6 +201,8 @@ public:
     virtual QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const override;
     virtual int rowCount( const QModelIndex& parent = {} ) const override;
     virtual QHash<int,QByteArray> roleNames() const override;
+    virtual bool canFetchMore(const QModelIndex& parent) const override;
+    virtual void fetchMore(const QModelIndex& parent) override;
 
     virtual QModelIndex parent( const QModelIndex& index ) const override;
     virtual QModelIndex index( int row, int column, const QModelIndex& parent=QModelIndex()) const override;
@@ -175,7 +223,7 @@ EventAggregate::EventAggregate() : QObject(&EventModel::instance())
     d_ptr = QSharedPointer<EventAggregatePrivate>(new EventAggregatePrivate());
 
     d_ptr->m_pUnsortedListModel = nullptr;
-    d_ptr->m_pWeakSelf = QSharedPointer<EventAggregate>(this);
+    d_ptr->q_ptr = this;
 }
 
 EventAggregate::~EventAggregate()
@@ -199,11 +247,38 @@ QSharedPointer<QAbstractItemModel> EventAggregate::calendarView() const
     return {};
 }
 
+/**
+ * This materializes every event, prefer fetchMore() and eventAt() when only
+ * the most recent events are needed.
+ */
 const QVector< QSharedPointer<Event> > EventAggregate::events() const
 {
+    d_ptr->fetchMore(std::numeric_limits<int>::max());
+
     return d_ptr->m_lAllEvents;
 }
 
+int EventAggregate::count() const
+{
+    return d_ptr->m_lAllEvents.size();
+}
+
+QSharedPointer<Event> EventAggregate::eventAt(int position) const
+{
+    return position >= 0 && position < d_ptr->m_lAllEvents.size() ?
+        d_ptr->m_lAllEvents[position] : nullptr;
+}
+
+bool EventAggregate::canFetchMore() const
+{
+    return d_ptr->canFetchMore();
+}
+
+int EventAggregate::fetchMore(int count)
+{
+    return d_ptr->fetchMore(count);
+}
+
 QSharedPointer<QAbstractItemModel> EventAggregate::unsortedListView() const
 {
     if (!d_ptr->m_pUnsortedListModel) {
@@ -217,17 +292,24 @@ QSharedPointer<QAbstractItemModel> EventAggregate::unsortedListView() const
     return d_ptr->m_pUnsortedListModel;
 }
 
-QSharedPointer<EventAggregate> EventAggregate::build(ContactMethod* cm)
+QSharedPointer<EventAggregate> EventAggregatePrivate::create(Mode m)
 {
     auto ret = QSharedPointer<EventAggregate>(new EventAggregate);
 
-    ret->d_ptr->m_Mode = EventAggregatePrivate::Mode::CONTACT_METHOD;
+    ret->d_ptr->m_Mode      = m;
+    ret->d_ptr->m_pWeakSelf = ret;
 
-    ret->d_ptr->m_lAllEvents = EventModel::instance().d_ptr->events(cm);
+    return ret;
+}
 
-    int i=0;
-    for (auto e : qAsConst(ret->d_ptr->m_lAllEvents))
-        e->setProperty("__singleAggregate", i++); //HACK it has to work-ish ASAP at any cost
+/**
+ * Nothing is fetched until something asks for the events, see fetchMore().
+ */
+QSharedPointer<EventAggregate> EventAggregate::build(ContactMethod* cm)
+{
+    auto ret = EventAggregatePrivate::create(EventAggregatePrivate::Mode::CONTACT_METHOD);
+
+    ret->d_ptr->m_pContactMethod = cm;
 
     connect(cm, &ContactMethod::eventAdded, ret->d_ptr.data(), &EventAggregatePrivate::slotEventAdded);
     connect(cm, &ContactMethod::eventDetached, ret->d_ptr.data(), &EventAggregatePrivate::slotEventDetached);
@@ -238,17 +320,9 @@ QSharedPointer<EventAggregate> EventAggregate::build(ContactMethod* cm)
 QSharedPointer<EventAggregate> EventAggregate::build(Individual* ind)
 {
     Q_ASSERT(ind);
-    auto ret = QSharedPointer<EventAggregate>(new EventAggregate);
-    ret->d_ptr->m_Mode = EventAggregatePrivate::Mode::INDIVIDUAL;
+    auto ret = EventAggregatePrivate::create(EventAggregatePrivate::Mode::INDIVIDUAL);
 
-
-    ind->forAllNumbers([ret](ContactMethod* cm) {
-        ret->d_ptr->m_lAllEvents.append(EventModel::instance().d_ptr->events(cm));
-    });
-
-    int i=0;
-    for (auto e : qAsConst(ret->d_ptr->m_lAllEvents))
-        e->setProperty("__singleAggregate", i++); //HACK it has to work-ish ASAP at any cost
+    ret->d_ptr->m_pIndividual = ind;
 
     connect(ind, &Individual::eventAdded, ret->d_ptr.data(), &EventAggregatePrivate::slotEventAdded);
     connect(ind, &Individual::eventDetached, ret->d_ptr.data(), &EventAggregatePrivate::slotEventDetached);
@@ -256,18 +330,242 @@ QSharedPointer<EventAggregate> EventAggregate::build(Individual* ind)
     return ret;
 }
 
-
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wsuggest-attribute=noreturn"
+/**
+ * The sources are not copied. The events are pulled from them, newest first,
+ * when the merged aggregate is asked for more.
+ */
 QSharedPointer<EventAggregate> EventAggregate::merge(const QList<QSharedPointer<EventAggregate> >& source)
 {
-    Q_UNUSED(source) //TODO
-    Q_ASSERT(false);
-    auto ret = QSharedPointer<EventAggregate>(new EventAggregate);
+    auto ret = EventAggregatePrivate::create(EventAggregatePrivate::Mode::MULTI);
+
+    for (const auto& s : qAsConst(source)) {
+        if (!s)
+            continue;
+
+        ret->d_ptr->m_lSources << s;
+
+        connect(s.data(), &EventAggregate::eventInserted, ret->d_ptr.data(), &EventAggregatePrivate::slotSourceInserted);
+        connect(s.data(), &EventAggregate::eventRemoved, ret->d_ptr.data(), &EventAggregatePrivate::slotSourceRemoved);
+    }
 
     return ret;
 }
-#pragma GCC diagnostic pop
+
+bool EventAggregatePrivate::isNewer(const Event* a, const Event* b)
+{
+    // Only use what never changes, otherwise the sorted vectors get corrupted
+    // when an ongoing event ends
+    if (a->startTimeStamp() != b->startTimeStamp())
+        return a->startTimeStamp() > b->startTimeStamp();
+
+    // Keep the order total so the binary searches find the exact event
+    return std::greater<const Event*>()(a, b);
+}
+
+bool EventAggregatePrivate::isOlder(const Event* a, const Event* b)
+{
+    return isNewer(b, a);
+}
+
+bool EventAggregatePrivate::isPendingOlder(const QSharedPointer<Event>& a, const QSharedPointer<Event>& b)
+{
+    return isNewer(b.data(), a.data());
+}
+
+void EventAggregatePrivate::collect(const ContactMethod* cm)
+{
+    const auto& events = EventModel::instance().d_ptr->events(cm);
+
+    m_lPending.reserve(m_lPending.size() + events.size());
+
+    for (const auto& e : events) {
+        if (m_hDetached.contains(e.data()))
+            continue;
+
+        // An individual can have the same event from multiple contact methods
+        if (m_Mode == Mode::INDIVIDUAL) {
+            if (m_hKnown.contains(e.data()))
+                continue;
+
+            m_hKnown.insert(e.data());
+        }
+
+        m_lPending << e;
+    }
+}
+
+/**
+ * Gather the event pointers in a heap. This is a single linear pass over
+ * pointers, the sorting happens one page at a time.
+ */
+void EventAggregatePrivate::prime()
+{
+    if (m_IsPrimed)
+        return;
+
+    m_IsPrimed = true;
+
+    switch(m_Mode) {
+        case Mode::CONTACT_METHOD:
+            collect(m_pContactMethod);
+            break;
+        case Mode::INDIVIDUAL:
+            m_pIndividual->forAllNumbers([this](ContactMethod* cm) {
+                collect(cm);
+            });
+            break;
+        case Mode::MULTI:
+            m_lCursors.fill(0, m_lSources.size());
+            return;
+    }
+
+    m_hDetached.clear();
+
+    std::make_heap(m_lPending.begin(), m_lPending.end(), &EventAggregatePrivate::isPendingOlder);
+}
+
+bool EventAggregatePrivate::canFetchMore() const
+{
+    if (!m_IsPrimed)
+        return true;
+
+    if (m_Mode != Mode::MULTI)
+        return !m_lPending.isEmpty();
+
+    for (int i = 0; i < m_lSources.size(); i++) {
+        const auto& s = m_lSources[i];
+        if (m_lCursors[i] < s->d_ptr->m_lAllEvents.size() || s->d_ptr->canFetchMore())
+            return true;
+    }
+
+    return false;
+}
+
+QSharedPointer<Event> EventAggregatePrivate::takeNext()
+{
+    if (m_Mode != Mode::MULTI) {
+        while (!m_lPending.isEmpty()) {
+            std::pop_heap(m_lPending.begin(), m_lPending.end(), &EventAggregatePrivate::isPendingOlder);
+            const auto e = m_lPending.takeLast();
+
+            if (!m_hDetached.remove(e.data()))
+                return e;
+        }
+
+        return nullptr;
+    }
+
+    // k-way merge, the newest head of all sources comes next
+    while (true) {
+        int best = -1;
+        QSharedPointer<Event> next;
+
+        for (int i = 0; i < m_lSources.size(); i++) {
+            const auto& s = m_lSources[i];
+
+            if (m_lCursors[i] >= s->d_ptr->m_lAllEvents.size())
+                s->d_ptr->fetchMore(PAGE_SIZE);
+
+            if (m_lCursors[i] < s->d_ptr->m_lAllEvents.size()) {
+                const auto& head = s->d_ptr->m_lAllEvents[m_lCursors[i]];
+                if ((!next) || isNewer(head.data(), next.data())) {
+                    best = i;
+                    next = head;
+                }
+            }
+        }
+
+        if (best == -1)
+            return nullptr;
+
+        m_lCursors[best]++;
+
+        // The other sources will also deliver it, only count them
+        if (m_hSourceCount[next.data()]++ == 0)
+            return next;
+    }
+}
+
+int EventAggregatePrivate::fetchMore(int count)
+{
+    prime();
+
+    QVector<QSharedPointer<Event>> page;
+
+    while (page.size() < count) {
+        auto e = takeNext();
+
+        if (!e)
+            break;
+
+        page << e;
+    }
+
+    if (page.isEmpty())
+        return 0;
+
+    const int first = m_lAllEvents.size();
+    const int last  = first + page.size() - 1;
+
+    if (m_pView)
+        m_pView->beginInsertRows({}, first, last);
+
+    m_lAllEvents << page;
+
+    if (m_pView)
+        m_pView->endInsertRows();
+
+    emit q_ptr->eventsFetched(first, last);
+
+    return page.size();
+}
+
+int EventAggregatePrivate::indexOf(const QSharedPointer<Event>& e) const
+{
+    const auto it = std::lower_bound(m_lAllEvents.constBegin(), m_lAllEvents.constEnd(), e,
+        [](const QSharedPointer<Event>& a, const QSharedPointer<Event>& b) {
+            return isNewer(a.data(), b.data());
+    });
+
+    return (it != m_lAllEvents.constEnd() && *it == e) ?
+        int(std::distance(m_lAllEvents.constBegin(), it)) : -1;
+}
+
+/// Add an event within the range that has already been materialized
+void EventAggregatePrivate::insert(const QSharedPointer<Event>& e)
+{
+    const auto it = std::lower_bound(m_lAllEvents.constBegin(), m_lAllEvents.constEnd(), e,
+        [](const QSharedPointer<Event>& a, const QSharedPointer<Event>& b) {
+            return isNewer(a.data(), b.data());
+    });
+
+    const int position = int(std::distance(m_lAllEvents.constBegin(), it));
+
+    if (m_pView)
+        m_pView->beginInsertRows({}, position, position);
+
+    m_lAllEvents.insert(position, e);
+
+    if (m_pView)
+        m_pView->endInsertRows();
+
+    emit q_ptr->eventInserted(e, position);
+}
+
+void EventAggregatePrivate::remove(int position)
+{
+    const auto e = m_lAllEvents[position];
+
+    if (m_pView)
+        m_pView->beginRemoveRows({}, position, position);
+
+    m_lAllEvents.remove(position);
+
+    if (m_pView)
+        m_pView->endRemoveRows();
+
+    emit q_ptr->eventRemoved(e, position);
+}
 
 void EventAggregatePrivate::splitGroup(EventAggregateNode* toSplit, EventAggregateNode* splitWith)
 {
@@ -291,28 +589,124 @@ void EventAggregatePrivate::slotEventChanged()
 
 void EventAggregatePrivate::slotEventAdded(QSharedPointer<Event> e)
 {
-    e->setProperty("__singleAggregate", m_lAllEvents.size()); //HACK it has to work-ish ASAP at any cost
+    // Once primed, only the events still in the heap can be flagged
+    const bool isPending = m_hDetached.remove(e.data());
 
-    m_lAllEvents << e;
+    // It will be collected along with the others
+    if (!m_IsPrimed)
+        return;
 
-    /*if (QSharedPointer<QAbstractItemModel> ptr = m_pUnsortedListModel) {
-        auto m = qobject_cast<UnsortedEventListView*>(ptr.data());
-    }*/
+    if (m_Mode == Mode::INDIVIDUAL) {
+        if (m_hKnown.contains(e.data()))
+            return;
+
+        m_hKnown.insert(e.data());
+    }
+
+    // Unflagging it is enough, pushing it again would fetch it twice
+    if (isPending)
+        return;
+
+    // Newer than the oldest materialized event, the views need it now
+    if ((!m_lAllEvents.isEmpty()) && isNewer(e.data(), m_lAllEvents.last().data())) {
+        insert(e);
+        return;
+    }
+
+    m_lPending << e;
+    std::push_heap(m_lPending.begin(), m_lPending.end(), &EventAggregatePrivate::isPendingOlder);
 }
 
 void EventAggregatePrivate::slotEventDetached(QSharedPointer<Event> e)
 {
-    Q_UNUSED(e)
+    const int position = indexOf(e);
+
+    if (m_Mode == Mode::INDIVIDUAL)
+        m_hKnown.remove(e.data());
+
+    // Skip it when it comes out of the heap (or when priming)
+    if (position == -1) {
+        m_hDetached.insert(e.data());
+        return;
+    }
+
+    remove(position);
+}
+
+void EventAggregatePrivate::slotSourceInserted(const QSharedPointer<Event>& e, int position)
+{
+    if (!m_IsPrimed)
+        return;
+
+    const auto src = qobject_cast<EventAggregate*>(sender());
+
+    for (int i = 0; i < m_lSources.size(); i++) {
+        if (m_lSources[i].data() != src)
+            continue;
+
+        const bool isBehind = position < m_lCursors[i];
+
+        // After the cursor, it will be pulled by the merge. Unless it is newer
+        // than what the other sources already delivered, then it would come
+        // out of order. The source being sorted, it is its head.
+        if ((!isBehind) && (m_lAllEvents.isEmpty()
+          || !isNewer(e.data(), m_lAllEvents.last().data())))
+            return;
+
+        Q_ASSERT(isBehind || position == m_lCursors[i]);
+
+        m_lCursors[i]++;
+
+        if (m_hSourceCount[e.data()]++ == 0)
+            insert(e);
+
+        return;
+    }
+}
+
+void EventAggregatePrivate::slotSourceRemoved(const QSharedPointer<Event>& e, int position)
+{
+    if (!m_IsPrimed)
+        return;
+
+    const auto src = qobject_cast<EventAggregate*>(sender());
+
+    for (int i = 0; i < m_lSources.size(); i++) {
+        if (m_lSources[i].data() != src)
+            continue;
+
+        if (position >= m_lCursors[i])
+            return;
+
+        m_lCursors[i]--;
+
+        // Another source still has it
+        auto count = m_hSourceCount.find(e.data());
+
+        if (count == m_hSourceCount.end() || --(*count) > 0)
+            return;
+
+        m_hSourceCount.erase(count);
+
+        const int idx = indexOf(e);
+
+        if (idx != -1)
+            remove(idx);
+
+        return;
+    }
 }
 
 UnsortedEventListView::UnsortedEventListView(const QSharedPointer<EventAggregatePrivate>& d) :
-    QAbstractListModel(d.data()), d_ptr(d), m_pParentRef(d->m_pWeakSelf)
+    QAbstractListModel(d.data()), d_ptr(d), m_pParentRef(d->m_pWeakSelf.toStrongRef())
 {
+    d_ptr->m_pView = this;
 }
 
 UnsortedEventListView::~UnsortedEventListView()
 {
-
+    if (d_ptr->m_pView == this)
+        d_ptr->m_pView = nullptr;
 }
 
 QVariant UnsortedEventListView::data( const QModelIndex& index, int role ) const
@@ -328,6 +722,17 @@ int UnsortedEventListView::rowCount( const QModelIndex& parent ) const
     return parent.isValid() ? 0 : d_ptr->m_lAllEvents.count();
 }
 
+bool UnsortedEventListView::canFetchMore(const QModelIndex& parent) const
+{
+    return (!parent.isValid()) && d_ptr->canFetchMore();
+}
+
+void UnsortedEventListView::fetchMore(const QModelIndex& parent)
+{
+    if (!parent.isValid())
+        d_ptr->fetchMore(EventAggregatePrivate::PAGE_SIZE);
+}
+
 QHash<int,QByteArray> UnsortedEventListView::roleNames() const
 {
     return EventModel::instance().roleNames();
@@ -22,6 +22,7 @@
 
 // Qt
 #include <QtCore/QObject>
+#include <QtCore/QSharedPointer>
 class QAbstractItemModel;
 
 // Ring
@@ -55,12 +56,24 @@ public:
     /// A grid with cells representing days and their children events for that day
     QSharedPointer<QAbstractItemModel> calendarView() const;
 
-    /// Nothing fancy, no grouping, no sorting, just a list
+    /// Nothing fancy, no grouping, just a list (newest first, fetched in pages)
     QSharedPointer<QAbstractItemModel> unsortedListView() const;
 
-    /// Get a reference to the list of events
+    /// Get a reference to the list of events (this fetches all of them)
     const QVector< QSharedPointer<Event> > events() const;
 
+    /// The number of events fetched so far
+    int count() const;
+
+    /// The event at `position` in the fetched events (newest first)
+    QSharedPointer<Event> eventAt(int position) const;
+
+    /// If there is older events to fetch
+    bool canFetchMore() const;
+
+    /// Fetch up to `count` older events, return how many were fetched
+    int fetchMore(int count = 50);
+
     /** The correct way to create multi-party aggregates is to create them
      * individually then merge them. Most of the memory and computation will be
      * shared.
@@ -69,6 +82,16 @@ public:
         const QList<QSharedPointer<EventAggregate> >& source
     );
 
+Q_SIGNALS:
+    /// Events appended at the end by fetchMore()
+    void eventsFetched(int first, int last);
+
+    /// A new event was added within the range of fetched events
+    void eventInserted(const QSharedPointer<Event>& e, int position);
+
+    /// A fetched event was detached
+    void eventRemoved(const QSharedPointer<Event>& e, int position);
+
 private:
     explicit EventAggregate();
 
@@ -19,8 +19,18 @@
 #include "historyimporter.h"
 #include "../localhistorycollection.h"
 
+// LibStdC++
+#include <algorithm>
+
 // Qt
 #include <QtCore/QTimer>
+#include <QtCore/QSet>
+#include <QtCore/QFile>
+#include <QtCore/QDir>
+#include <QtCore/QTextStream>
+#include <QtCore/QSaveFile>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QStandardPaths>
 
 // Ring
 #include <call.h>
@@ -33,125 +43,424 @@
 #include <private/textrecording_p.h>
 #include <libcard/calendar.h>
 #include <libcard/event.h>
+#include <libcard/private/eventmodel_p.h>
+#include <eventmodel.h>
+#include <contactmethod.h>
 
 #include <QtCore/QDebug>
 
 namespace HistoryImporter
 {
 
-void importHistory(LocalHistoryCollection* histo)
+class ImportJobPrivate final : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ImportJobPrivate(ImportJob* q) : QObject(q), q_ptr(q) {}
+
+    /// Do not hold the event loop for longer than this (in milliseconds)
+    constexpr static const int SLICE_BUDGET = 16;
+
+    /// Saving the checkpoint is an fsync and a rename (in milliseconds)
+    constexpr static const int CHECKPOINT_INTERVAL = 2000;
+
+    LocalHistoryCollection*   m_pCollection  {nullptr};
+    ImportJob::Phase          m_Phase        {ImportJob::Phase::WAITING};
+    QVector<Call*>            m_lCalls       {       };
+    QVector<Media::Recording*> m_lRecordings {       };
+    int                       m_CallIndex    {   0   };
+    int                       m_TextIndex    {   0   };
+    int                       m_ResumedFrom  {   0   };
+    QSet<Calendar*>           m_hPendingCals {       };
+    bool                      m_HistoryReady { false };
+    bool                      m_IsVerifying  { true  };
+    QString                   m_LastCall     {       };
+    QString                   m_LastText     {       };
+    QElapsedTimer             m_Elapsed;
+    QElapsedTimer             m_LastCheckpoint;
+
+    static QString checkpointPath();
+    static QString recordingId(Media::Recording* r);
+    static bool hasCallEvent(Call* c);
+    void readCheckpoint();
+    void writeCheckpoint() const;
+    void setPhase(ImportJob::Phase p);
+    void scheduleNextSlice();
+
+    bool importCalls(const QElapsedTimer& slice);
+    bool importTextMessages(const QElapsedTimer& slice);
+
+    ImportJob* q_ptr;
+
+public Q_SLOTS:
+    void slotHistoryLoaded();
+    void slotCalendarLoaded(Calendar* cal);
+    void slotProcessSlice();
+};
+
+}
+
+using namespace HistoryImporter;
+
+QString ImportJobPrivate::checkpointPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::DataLocation)
+        + QLatin1String("/historyimport.checkpoint");
+}
+
+QString ImportJobPrivate::recordingId(Media::Recording* r)
+{
+    return static_cast<Media::TextRecording*>(r)->paths().join(QLatin1Char(';'));
+}
+
+/// If the call was imported by a previous run after its last checkpoint
+bool ImportJobPrivate::hasCallEvent(Call* c)
+{
+    const auto& events = EventModel::instance().d_ptr->events(c->peerContactMethod());
+
+    return std::any_of(events.constBegin(), events.constEnd(), [c](const QSharedPointer<Event>& e) {
+        return e->eventCategory() == Event::EventCategory::CALL
+            && e->startTimeStamp() == c->startTimeStamp();
+    });
+}
+
+/**
+ * The checkpoint has two lines, the history id of the last imported call and
+ * the paths of the last imported text recording. An empty line means nothing
+ * was imported yet.
+ */
+void ImportJobPrivate::readCheckpoint()
 {
-    // Import the history
-    histo->addCompletionCallback([](LocalHistoryCollection* c) {
-        if (c->size() == 0)
+    QFile f(checkpointPath());
+
+    if (!f.open(QIODevice::ReadOnly))
+        return;
+
+    QTextStream stream(&f);
+
+    const QString lastCall = stream.readLine();
+    const QString lastText = stream.readLine();
+
+    // The files changed since the checkpoint was written, start over. It is
+    // safe since both passes skip the elements which already have an event.
+    if (!lastCall.isEmpty()) {
+        const auto it = std::find_if(m_lCalls.constBegin(), m_lCalls.constEnd(), [&lastCall](Call* c) {
+            return c->historyId() == lastCall;
+        });
+
+        if (it == m_lCalls.constEnd()) {
+            qWarning() << "The history import checkpoint is invalid, restarting";
             return;
+        }
 
-        // Create the events for all calls
-        const auto calls = c->items<Call>();
+        m_CallIndex = std::distance(m_lCalls.constBegin(), it) + 1;
+        m_LastCall  = lastCall;
+    }
 
-        for (auto c : qAsConst(calls)) {
-            // The account may have been deleted
-            if (!c->account())
-                continue;
+    if (!lastText.isEmpty()) {
+        const auto it = std::find_if(m_lRecordings.constBegin(), m_lRecordings.constEnd(), [&lastText](Media::Recording* r) {
+            return recordingId(r) == lastText;
+        });
+
+        if (it == m_lRecordings.constEnd()) {
+            qWarning() << "The history import checkpoint is invalid, restarting";
+            m_CallIndex = 0;
+            m_LastCall.clear();
+            return;
+        }
+
+        m_TextIndex = std::distance(m_lRecordings.constBegin(), it) + 1;
+        m_LastText  = lastText;
+    }
+}
+
+void ImportJobPrivate::writeCheckpoint() const
+{
+    QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+
+    QSaveFile f(checkpointPath());
+
+    if (!f.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to save the history import checkpoint" << f.errorString();
+        return;
+    }
+
+    f.write(m_LastCall.toUtf8() + '\n' + m_LastText.toUtf8() + '\n');
+    f.commit();
+}
+
+ImportJob::ImportJob(LocalHistoryCollection* col) : QObject(nullptr),
+    d_ptr(new ImportJobPrivate(this))
+{
+    d_ptr->m_pCollection = col;
+}
+
+ImportJob::~ImportJob()
+{
+    // d_ptr is a child QObject
+}
 
-            auto cal = c->account()->calendar();
+ImportJob::Phase ImportJob::phase() const
+{
+    return d_ptr->m_Phase;
+}
+
+int ImportJob::done() const
+{
+    return d_ptr->m_CallIndex + d_ptr->m_TextIndex;
+}
+
+int ImportJob::total() const
+{
+    return d_ptr->m_lCalls.size() + d_ptr->m_lRecordings.size();
+}
 
-            Q_ASSERT(cal);
+qint64 ImportJob::eta() const
+{
+    const int processed = done() - d_ptr->m_ResumedFrom;
+
+    if (processed <= 0 || !d_ptr->m_Elapsed.isValid())
+        return -1;
+
+    return (d_ptr->m_Elapsed.elapsed() * (total() - done())) / processed;
+}
 
-            cal->addEvent(c);
+void ImportJobPrivate::setPhase(ImportJob::Phase p)
+{
+    if (m_Phase == p)
+        return;
+
+    m_Phase = p;
+    emit q_ptr->phaseChanged(p);
+}
 
-            //histo->clear();
+void ImportJobPrivate::scheduleNextSlice()
+{
+    // The calendars queue their save on the next iteration of the event loop.
+    // Using a 0ms timer here guarantees they are written before the checkpoint
+    // of the next slice.
+    QTimer::singleShot(0, this, &ImportJobPrivate::slotProcessSlice);
+}
+
+void ImportJobPrivate::slotHistoryLoaded()
+{
+    m_HistoryReady = true;
+
+    if (!m_hPendingCals.isEmpty())
+        return;
+
+    m_lCalls = m_pCollection->items<Call>();
+
+    // Make *sure* it's loaded if for unknown reason it is not, there will
+    // be some data corruption
+    LocalTextRecordingCollection::instance();
+
+    const auto recordingCollections = Media::RecordingModel::instance().collections();
+
+    for (CollectionInterface* backend : qAsConst(recordingCollections)) {
+        if (backend->id() != "localtextrecording")
+            continue;
+
+        const auto items = backend->items<Media::Recording>();
+
+        for (auto r : qAsConst(items)) {
+            if (r->type() == Media::Recording::Type::TEXT)
+                m_lRecordings << r;
         }
+    }
+
+    // The collection order is not guaranteed across restarts
+    std::sort(m_lCalls.begin(), m_lCalls.end(), [](Call* a, Call* b) {
+        return a->startTimeStamp() == b->startTimeStamp() ?
+            a->historyId() < b->historyId() : a->startTimeStamp() < b->startTimeStamp();
+    });
+
+    std::sort(m_lRecordings.begin(), m_lRecordings.end(), [](Media::Recording* a, Media::Recording* b) {
+        return recordingId(a) < recordingId(b);
     });
 
-    static QHash<Serializable::Group*, QSharedPointer<Event> > fuck;
-    // Import the text messages after the first event loop (to prevent being
-    // created before the accounts are loaded.
-    QTimer::singleShot(0, []() {
-        // Make *sure* it's loaded if for unknown reason it is not, there will
-        // be some data corruption
-        LocalTextRecordingCollection::instance();
-
-        auto callback = [] {
-            const auto recordingCollections = Media::RecordingModel::instance().collections();
-
-            // Load all text recording, read all files, scan everything
-            for (CollectionInterface* backend : qAsConst(recordingCollections)) {
-                if (backend->id() == "localtextrecording") {
-                    const auto items = backend->items<Media::Recording>();
-
-                    // All text recordings (files)
-                    for (auto r : qAsConst(items)) {
-                        if (r->type() == Media::Recording::Type::TEXT) {
-                            const auto tR = static_cast<Media::TextRecording*>(r);
-                            const auto groups = tR->d_ptr->allGroups();
-
-                            // All messages
-                            for (auto g : qAsConst(groups)) {
-                                // The event has already been loaded
-                                if (g->hasEvent()) {
-                                    Q_ASSERT(!g->eventUid.isEmpty());
-                                    continue;
-                                }
-
-                                // Get the event only if it exists
-                                auto e = g->event(false);
-
-                                // If that happens, either the database is corrupted or
-                                // deleting something failed to remove the messages themselves
-                                // but succeeded in deleting the event.
-                                if (e && e->syncState() == Event::SyncState::PLACEHOLDER)
-                                    qWarning() << "An event was referenced by a text message but was not found (1)" << e->uid();
-                                else if ((!e) && !g->eventUid.isEmpty())
-                                    qWarning() << "An event was referenced by a text message but was not found (2)" << g->eventUid;
-
-                                // Create an event
-                                e = g->event(true);
-
-                                fuck[g] = e;
-
-                                // There is no event
-                                Q_ASSERT(e);
-
-                                Q_ASSERT(g->hasEvent());
-                            }
-                        }
-                    }
-                }
+    readCheckpoint();
+
+    m_ResumedFrom = m_CallIndex + m_TextIndex;
+
+    m_Elapsed.start();
+    m_LastCheckpoint.start();
+
+    setPhase(ImportJob::Phase::CALLS);
+    scheduleNextSlice();
+}
+
+void ImportJobPrivate::slotCalendarLoaded(Calendar* cal)
+{
+    // Calendars can be reloaded once the import is started, ignore them
+    if (m_Phase != ImportJob::Phase::WAITING)
+        return;
+
+    // They can also finish loading more than once
+    if (!m_hPendingCals.remove(cal))
+        return;
+
+    if (m_hPendingCals.isEmpty() && m_HistoryReady)
+        slotHistoryLoaded();
+}
+
+/// Create the events for the calls, return true when there is nothing left
+bool ImportJobPrivate::importCalls(const QElapsedTimer& slice)
+{
+    while (m_CallIndex < m_lCalls.size() && !slice.hasExpired(SLICE_BUDGET)) {
+        auto c = m_lCalls[m_CallIndex++];
+
+        m_LastCall = c->historyId();
+
+        // The account may have been deleted
+        if (!c->account())
+            continue;
+
+        // The checkpoint is only saved once in a while, the calls imported
+        // after it are at the beginning of what is left. Once a call without
+        // an event is found, the remaining ones cannot have one either.
+        if (m_IsVerifying && hasCallEvent(c))
+            continue;
+
+        m_IsVerifying = false;
+
+        auto cal = c->account()->calendar();
+
+        Q_ASSERT(cal);
+
+        cal->addEvent(c);
+    }
+
+    return m_CallIndex >= m_lCalls.size();
+}
+
+/**
+ * Create the events for the text message groups, one recording (file) at
+ * a time, return true when there is nothing left.
+ */
+bool ImportJobPrivate::importTextMessages(const QElapsedTimer& slice)
+{
+    while (m_TextIndex < m_lRecordings.size() && !slice.hasExpired(SLICE_BUDGET)) {
+        const auto tR = static_cast<Media::TextRecording*>(m_lRecordings[m_TextIndex++]);
+
+        m_LastText = recordingId(tR);
+        const auto groups = tR->d_ptr->allGroups();
+
+        // Keep the events alive until the recording is saved
+        QList<QSharedPointer<Event>> created;
+
+        // All messages
+        for (auto g : qAsConst(groups)) {
+            // The event has already been loaded
+            if (g->hasEvent()) {
+                Q_ASSERT(!g->eventUid.isEmpty());
+                continue;
             }
 
-            // If there is new groups while they are imported, it's game over
+            // Get the event only if it exists
+            auto e = g->event(false);
+
+            // If that happens, either the database is corrupted or
+            // deleting something failed to remove the messages themselves
+            // but succeeded in deleting the event.
+            if (e && e->syncState() == Event::SyncState::PLACEHOLDER)
+                qWarning() << "An event was referenced by a text message but was not found (1)" << e->uid();
+            else if ((!e) && !g->eventUid.isEmpty())
+                qWarning() << "An event was referenced by a text message but was not found (2)" << g->eventUid;
+
+            // Create an event
+            e = g->event(true);
+
+            // There is no event
+            Q_ASSERT(e);
+
+            Q_ASSERT(g->hasEvent());
+
+            created << e;
+        }
+
+        // Save each file once it is done so the checkpoint never points past
+        // unsaved groups. If there is new groups while they are imported,
+        // it's game over.
+        if (!created.isEmpty()) {
             Serializable::Group::warnOfRaceCondition = true;
-            LocalTextRecordingCollection::instance().saveEverything();
+            tR->save();
             Serializable::Group::warnOfRaceCondition = false;
-        };
+        }
+    }
 
+    return m_TextIndex >= m_lRecordings.size();
+}
 
-        int counter = 0;
+void ImportJobPrivate::slotProcessSlice()
+{
+    // Everything processed in the previous slices has been flushed by now
+    if (m_LastCheckpoint.hasExpired(CHECKPOINT_INTERVAL)) {
+        writeCheckpoint();
+        m_LastCheckpoint.restart();
+    }
+
+    QElapsedTimer slice;
+    slice.start();
+
+    switch(m_Phase) {
+        case ImportJob::Phase::CALLS:
+            if (importCalls(slice))
+                setPhase(ImportJob::Phase::TEXT_MESSAGES);
+            break;
+        case ImportJob::Phase::TEXT_MESSAGES:
+            if (importTextMessages(slice))
+                setPhase(ImportJob::Phase::DONE);
+            break;
+        case ImportJob::Phase::WAITING:
+        case ImportJob::Phase::DONE:
+            break;
+    }
+
+    emit q_ptr->progress(q_ptr->done(), q_ptr->total());
+
+    if (m_Phase != ImportJob::Phase::DONE) {
+        scheduleNextSlice();
+        return;
+    }
+
+    QFile::remove(checkpointPath());
+
+    emit q_ptr->finished();
+    q_ptr->deleteLater();
+}
+
+ImportJob* HistoryImporter::importHistory(LocalHistoryCollection* histo)
+{
+    auto job = new ImportJob(histo);
+    auto d   = job->d_ptr;
+
+    // Start after the first event loop (to prevent the text events from
+    // being created before the accounts are loaded.
+    QTimer::singleShot(0, d, [d]() {
         const auto accountCount = AccountModel::instance().size();
 
-        // Wait until all calendars are loaded to limit the number of placeholder events
+        // Wait until all calendars are loaded to limit the number of
+        // placeholder events.
         for (int i = 0; i < accountCount; i++) {
             const auto a = AccountModel::instance()[i];
 
-            // While they currently load synchronously in the main thread, in the
-            // future this should move either to threads or use coroutines.
-            // To avoid forgetting about this, handle it anyway
-            if (!a->calendar()->isLoaded()) {
-                counter++;
-                QMetaObject::Connection conn;
-                conn = QObject::connect(a->calendar(), &Calendar::loadingFinished, a, [&conn, &counter, &callback]() {
-                    QObject::disconnect(conn);
-                    if (!--counter)
-                        callback();
+            const auto cal = a->calendar();
+
+            if (!cal->isLoaded()) {
+                d->m_hPendingCals.insert(cal);
+                QObject::connect(cal, &Calendar::loadingFinished, d, [d, cal]() {
+                    d->slotCalendarLoaded(cal);
                 });
             }
         }
 
-        if (!counter)
-            callback();
-
+        d->m_pCollection->addCompletionCallback([d](LocalHistoryCollection*) {
+            d->slotHistoryLoaded();
+        });
     });
-}
 
+    return job;
 }
+
+#include <historyimporter.moc>
@@ -19,6 +19,7 @@
 #pragma once
 
 // Qt
+#include <QtCore/QObject>
 #include <QtCore/QVector>
 
 // StdC++
@@ -32,11 +33,70 @@ class Calendar;
 namespace HistoryImporter
 {
 
+class ImportJob;
+class ImportJobPrivate;
+
+/**
+ * Wait for the old history to be loaded, then create and save the files.
+ *
+ * The returned job reports the progress and is deleted once the import
+ * is completed.
+ */
+LIB_EXPORT ImportJob* importHistory(LocalHistoryCollection* col);
+
 /**
-    * Wait for the old history to be loaded, then create and save the files.
-    *
-    * The `callback` is executed once saving is completed.
-    */
-void LIB_EXPORT importHistory(LocalHistoryCollection* col);
+ * Track the progress of an history migration.
+ *
+ * The migration is processed in small time slices in the main event loop to
+ * avoid freezing the UI. Every few seconds, the position is written to a
+ * checkpoint file. If the process is killed during the migration, the next
+ * call to `importHistory()` resumes where it stopped instead of starting over.
+ * The calls imported after the last checkpoint are detected and skipped.
+ *
+ * The object deletes itself after `finished()` is emitted.
+ */
+class LIB_EXPORT ImportJob : public QObject
+{
+    Q_OBJECT
+    friend class ImportJobPrivate;
+    friend ImportJob* importHistory(LocalHistoryCollection* col);
+public:
+    enum class Phase {
+        WAITING      , /*!< Waiting for the history and the calendars to load */
+        CALLS        , /*!< Converting the legacy calls into events           */
+        TEXT_MESSAGES, /*!< Attaching events to the text message groups       */
+        DONE         , /*!< Everything has been imported and saved            */
+    };
+    Q_ENUM(Phase)
+
+    Q_PROPERTY(Phase  phase READ phase NOTIFY phaseChanged)
+    Q_PROPERTY(int    done  READ done  NOTIFY progress    )
+    Q_PROPERTY(int    total READ total NOTIFY progress    )
+    Q_PROPERTY(qint64 eta   READ eta   NOTIFY progress    )
+
+    virtual ~ImportJob();
+
+    Phase phase() const;
+
+    /// The number of elements (calls and text recordings) processed so far
+    int done() const;
+
+    /// The total number of elements to process, including the resumed ones
+    int total() const;
+
+    /// The estimated remaining time in milliseconds (or -1 if unknown)
+    qint64 eta() const;
+
+Q_SIGNALS:
+    void progress(int done, int total);
+    void phaseChanged(Phase phase);
+    void finished();
+
+private:
+    explicit ImportJob(LocalHistoryCollection* col);
+
+    ImportJobPrivate* d_ptr;
+    Q_DECLARE_PRIVATE(ImportJob)
+};
 
 }
@@ -18,6 +18,9 @@
  ***********************************************************************************/
 #include <QtCore/QObject>
 
+//Ring
+#include <memorystatistics.h>
+
 struct EventModelNode;
 class Individual;
 class EventModel;
@@ -34,6 +37,7 @@ public:
     void sort(ContactMethod* cm);
     void sort(Individual* ind);
     void mergeEvents(ContactMethod* dest, ContactMethod* src);
+    QVector<MemoryStatistics::Usage> memoryUsage() const;
 
     // Unoptimal internal API to get events, time not permitting anything better
     const QVector< QSharedPointer<Event> >& events(const ContactMethod* cm) const;
@@ -19,6 +19,7 @@
 #include "icsloader.h"
 
 #include <thread>
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <unordered_map>
@@ -87,7 +88,8 @@ void AbstractVObjectAdaptor::setAbstractFallbackObjectHandler(int typeId, Fallba
 
 int AbstractVObjectAdaptor::getNewTypeId()
 {
-    static int typeSystem = 42;
+    // The calendars are parsed in the CollectionLoader threads
+    static std::atomic<int> typeSystem {42};
     return typeSystem++;
 }
 
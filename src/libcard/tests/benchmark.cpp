@@ -0,0 +1,648 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+
+// Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QDir>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QAbstractItemModel>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QEventLoop>
+#include <QtCore/QTextStream>
+
+// Ring
+#include <icsloader.h>
+#include <icsbuilder.h>
+#include <libcard/private/event_p.h>
+#include <libcard/calendar.h>
+#include <libcard/eventaggregate.h>
+#include <libcard/historyimporter.h>
+#include <eventmodel.h>
+#include <account.h>
+#include <accountmodel.h>
+#include <contactmethod.h>
+#include <phonedirectorymodel.h>
+#include <uri.h>
+#include <globalinstances.h>
+#include <individual.h>
+#include <call.h>
+#include <categorizedhistorymodel.h>
+#include <localhistorycollection.h>
+#include <private/nodepool.h>
+#include "fakedaemon.h"
+
+// STD
+#include <algorithm>
+#include <iostream>
+
+/**
+ * Synthetic benchmark for the libcard parser, serializer and models.
+ *
+ * It does not need a running daemon. Only the history import enters the
+ * event loop, since it is processed in time slices. The results are printed
+ * as JSON so they can be compared between revisions.
+ *
+ * Note that this needs the private symbols, so the library has to be built
+ * with BUILD_SHARED_LIBS=OFF.
+ */
+
+struct Options
+{
+    int events      {1000};
+    int attendees   {1   };
+    int attachments {0   };
+    int timezones   {1   };
+    int peers       {50  };
+    int iterations  {5   };
+};
+
+/**
+ * The timing samples of a single benchmark.
+ */
+struct Result
+{
+    QString         name;
+    qint64          items {0};
+    qint64          bytes {0};
+    QVector<qint64> samples; // nanoseconds
+    qint64          allocations {0}; // Pooled nodes
+
+    QJsonObject toJson() const;
+};
+
+QJsonObject Result::toJson() const
+{
+    QVector<qint64> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+
+    const qint64 min    = sorted.isEmpty() ? 0 : sorted.first();
+    const qint64 median = sorted.isEmpty() ? 0 : sorted[sorted.size()/2];
+
+    // Per second, based on the median to ignore the cold cache outliers
+    const double seconds = median / 1e9;
+
+    return {
+        { "name"          , name                                        },
+        { "iterations"    , samples.size()                              },
+        { "items"         , items                                       },
+        { "bytes"         , bytes                                       },
+        { "min_ms"        , min    / 1e6                                },
+        { "median_ms"     , median / 1e6                                },
+        { "items_per_sec" , seconds > 0 ? items / seconds : 0.0         },
+        { "mb_per_sec"    , seconds > 0 ? bytes / seconds / 1e6 : 0.0   },
+        { "allocations"   , allocations                                 },
+    };
+}
+
+static QByteArray peerUri(int peer)
+{
+    return "ring:" + QByteArray::number(0x1000000 + peer, 16).rightJustified(40, '0');
+}
+
+/**
+ * Generate a VCALENDAR in the format written by the ICSBuilder.
+ */
+static QByteArray generateCalendar(const Options& o)
+{
+    QByteArray ret;
+    ret.reserve(o.events * (320 + 96*o.attendees + 96*o.attachments));
+
+    ret += "BEGIN:VCALENDAR\n";
+    ret += "VERSION:2.0\n";
+    ret += "PRODID:-//libringqt//benchmark//EN\n";
+
+    for (int i = 0; i < o.timezones; i++) {
+        ret += "BEGIN:VTIMEZONE\n";
+        ret += "TZID:Benchmark/Zone" + QByteArray::number(i) + '\n';
+        ret += "END:VTIMEZONE\n";
+    }
+
+    // Start a year ago so the timeline has some depth
+    const time_t base = QDateTime::currentDateTimeUtc().toTime_t() - 365*24*3600;
+
+    for (int i = 0; i < o.events; i++) {
+        const QByteArray tz    = "Benchmark/Zone" + QByteArray::number(o.timezones ? i % o.timezones : 0);
+        const QByteArray start = QByteArray::number(qlonglong(base + i*600));
+        const QByteArray stop  = QByteArray::number(qlonglong(base + i*600 + i%300));
+
+        ret += "BEGIN:VEVENT\n";
+        ret += "UID:benchmark-" + QByteArray::number(i) + '\n';
+        ret += "CATEGORIES:PHONE CALL\n";
+        ret += "DTSTART;TZID=" + tz + ':' + start + '\n';
+        ret += "DTEND;TZID="   + tz + ':' + stop  + '\n';
+        ret += "DTSTAMP;TZID=" + tz + ':' + stop  + '\n';
+        ret += i%2 ? "X_RING_DIRECTION;VALUE=STRING:INCOMING\n" : "X_RING_DIRECTION;VALUE=STRING:OUTGOING\n";
+        ret += "STATUS:FINAL\n";
+
+        for (int j = 0; j < o.attendees; j++) {
+            const int peer = (i*o.attendees + j) % std::max(1, o.peers);
+            ret += "ATTENDEE;CN=\"Peer " + QByteArray::number(peer) + "\":" + peerUri(peer) + '\n';
+        }
+
+        for (int j = 0; j < o.attachments; j++) {
+            ret += "ATTACH;FMTTYPE=audio/x-wav;X_RING_ROLE=\"recording\":/tmp/benchmark/";
+            ret += QByteArray::number(i) + '-' + QByteArray::number(j) + ".wav\n";
+        }
+
+        ret += "END:VEVENT\n";
+    }
+
+    ret += "END:VCALENDAR\n";
+
+    return ret;
+}
+
+template<typename F>
+static qint64 measure(F&& f)
+{
+    QElapsedTimer t;
+    t.start();
+    f();
+    return t.nsecsElapsed();
+}
+
+/// The number of nodes allocated from the pools so far
+static qint64 poolAllocations()
+{
+    qint64 ret = 0;
+
+    const auto pools = NodePoolBase::allStatistics();
+
+    for (const auto& s : pools)
+        ret += s.allocations;
+
+    return ret;
+}
+
+/// About the size of the model nodes
+struct BenchmarkNode final
+{
+    NODE_POOL_ALLOCATED(BenchmarkNode)
+
+    BenchmarkNode* m_pParent {nullptr};
+    qint64         m_Data[5];
+};
+
+/**
+ * Raw parser throughput, the adapters only count what they see.
+ */
+static Result benchmarkParse(const Options& o, const QString& path, qint64 size)
+{
+    struct Counter {};
+
+    Result r {QStringLiteral("ics_parse"), 0, size, {}};
+
+    for (int i = 0; i < o.iterations; i++) {
+        static Counter c;
+        qint64 objects = 0;
+
+        auto adapter = std::shared_ptr<VObjectAdapter<Counter>>(new VObjectAdapter<Counter>);
+
+        adapter->setObjectFactory([](const std::basic_string<char>& object_type) -> Counter* {
+            Q_UNUSED(object_type)
+            return &c;
+        });
+
+        adapter->setFallbackPropertyHandler([](
+            Counter* self,
+            const std::basic_string<char>& name,
+            const std::basic_string<char>& value,
+            const AbstractVObjectAdaptor::Parameters& params
+        ) {
+            Q_UNUSED(self)
+            Q_UNUSED(name)
+            Q_UNUSED(value)
+            Q_UNUSED(params)
+        });
+
+        adapter->setFallbackObjectHandler<Counter>([&objects](
+            Counter* self,
+            Counter* child,
+            const std::basic_string<char>& name
+        ) {
+            Q_UNUSED(self)
+            Q_UNUSED(child)
+            Q_UNUSED(name)
+            objects++;
+        });
+
+        ICSLoader loader;
+        loader.registerVObjectAdaptor("VCALENDAR", adapter);
+        loader.registerVObjectAdaptor("VEVENT"   , adapter);
+        loader.registerFallbackVObjectAdaptor(adapter);
+
+        r.samples << measure([&loader, &path]() {
+            loader.loadFile(path.toLatin1().data());
+        });
+
+        r.items = objects;
+    }
+
+    return r;
+}
+
+static Result benchmarkLoad(Calendar* cal, const QByteArray& content)
+{
+    Result r {QStringLiteral("calendar_load"), 0, content.size(), {}};
+
+    QDir().mkpath(QFileInfo(cal->path()).absolutePath());
+
+    QFile f(cal->path());
+    f.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    f.write(content);
+    f.close();
+
+    const qint64 before = poolAllocations();
+
+    r.samples << measure([cal]() { cal->load(); });
+    r.items       = cal->size();
+    r.allocations = poolAllocations() - before;
+
+    return r;
+}
+
+static Result benchmarkInsert(const Options& o, Calendar* cal, const QList<ContactMethod*>& peers)
+{
+    Result r {QStringLiteral("eventmodel_insert"), o.events, 0, {}};
+
+    const time_t base = QDateTime::currentDateTimeUtc().toTime_t();
+
+    r.samples << measure([&]() {
+        for (int i = 0; i < o.events; i++) {
+            EventPrivate data;
+            data.m_UID            = "benchmark-new-" + QByteArray::number(i);
+            data.m_StartTimeStamp = base + i;
+            data.m_StopTimeStamp  = base + i + 60;
+            data.m_RevTimeStamp   = base + i + 60;
+            data.m_EventCategory  = Event::EventCategory::CALL;
+            data.m_Status         = Event::Status::FINAL;
+            data.m_Type           = Event::Type::VEVENT;
+
+            for (int j = 0; j < o.attendees && !peers.isEmpty(); j++) {
+                ContactMethod* cm = peers[(i*o.attendees + j) % peers.size()];
+                data.m_lAttendees << QPair<ContactMethod*, QString> { cm, cm->bestName() };
+            }
+
+            cal->addEvent(data);
+        }
+    });
+
+    return r;
+}
+
+static Result benchmarkAppend(Calendar* cal)
+{
+    Result r {QStringLiteral("ics_append"), cal->unsavedCount(), 0, {}};
+
+    const qint64 before = QFileInfo(cal->path()).size();
+
+    r.samples << measure([cal]() { ICSBuilder::save(cal); });
+
+    r.bytes = QFileInfo(cal->path()).size() - before;
+
+    return r;
+}
+
+static Result benchmarkBuild(const Options& o, Calendar* cal)
+{
+    Result r {QStringLiteral("ics_build"), cal->size(), 0, {}};
+
+    for (int i = 0; i < o.iterations; i++)
+        r.samples << measure([cal]() { ICSBuilder::rebuild(cal); });
+
+    r.bytes = QFileInfo(cal->path()).size();
+
+    return r;
+}
+
+static Result benchmarkAggregate(const QList<ContactMethod*>& peers)
+{
+    Result r {QStringLiteral("aggregate_build"), 0, 0, {}};
+
+    qint64 total = 0;
+
+    for (ContactMethod* cm : peers) {
+        QSharedPointer<EventAggregate> a;
+        // What a timeline needs before it can show something
+        total += measure([cm, &a]() {
+            a = cm->eventAggregate();
+            a->fetchMore();
+        });
+        r.items += a->count();
+    }
+
+    r.samples << total;
+
+    return r;
+}
+
+/**
+ * What opening the timeline of every peer costs.
+ */
+static Result benchmarkTimeline(const QList<ContactMethod*>& peers)
+{
+    Result r {QStringLiteral("timeline_load"), 0, 0, {}};
+
+    qint64 total = 0;
+
+    const qint64 before = poolAllocations();
+
+    for (ContactMethod* cm : peers) {
+        QSharedPointer<QAbstractItemModel> m;
+        total += measure([cm, &m]() {
+            m = cm->individual()->timelineModel();
+        });
+        r.items += m->rowCount();
+    }
+
+    r.samples    << total;
+    r.allocations = poolAllocations() - before;
+
+    return r;
+}
+
+/**
+ * A model going back and forth between 0 and 1 node.
+ */
+static Result benchmarkNodeChurn(const Options& o)
+{
+    Result r {QStringLiteral("nodepool_churn"), o.events * 100, 0, {}};
+
+    const auto before = NodePool<BenchmarkNode>::instance("BenchmarkNode").statistics();
+
+    for (int i = 0; i < o.iterations; i++) {
+        r.samples << measure([&o]() {
+            for (int j = 0; j < o.events * 100; j++)
+                delete new BenchmarkNode;
+        });
+    }
+
+    const auto after = NodePool<BenchmarkNode>::instance("BenchmarkNode").statistics();
+
+    r.allocations = after.allocations - before.allocations;
+    r.bytes       = after.bytes;
+
+    return r;
+}
+
+/**
+ * Fill a model and reset it.
+ */
+static Result benchmarkNodeArena(const Options& o)
+{
+    Result r {QStringLiteral("nodearena_reset"), o.events * 10, 0, {}};
+
+    NodeArena<BenchmarkNode> arena {"BenchmarkNode"};
+    std::vector<BenchmarkNode*> nodes;
+    nodes.reserve(o.events * 10);
+
+    for (int i = 0; i < o.iterations; i++) {
+        r.samples << measure([&o, &arena, &nodes]() {
+            for (int j = 0; j < o.events * 10; j++)
+                nodes.push_back(arena.create());
+
+            // The nodes are trivially destructible, drop them with the chunks
+            nodes.clear();
+            arena.clear();
+        });
+    }
+
+    const auto s = arena.statistics();
+
+    r.allocations = s.allocations;
+    r.bytes       = s.bytes;
+
+    return r;
+}
+
+/**
+ * Convert a legacy history into events, like the first start after an upgrade.
+ *
+ * The calls need an account known by the daemon, so this is only available
+ * when the fake daemon could be registered.
+ */
+static Result benchmarkImport(const Options& o, const QByteArray& accountId)
+{
+    Result r {QStringLiteral("history_import"), o.events, 0, {}};
+
+    const QString path = QStandardPaths::writableLocation(QStandardPaths::DataLocation)
+        + QStringLiteral("/history.ini");
+
+    QFile f(path);
+    f.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text);
+
+    QTextStream stream(&f);
+
+    const time_t base = QDateTime::currentDateTimeUtc().toTime_t() - 365*24*3600;
+
+    for (int i = 0; i < o.events; i++) {
+        stream << Call::HistoryMapFields::CALLID          << '=' << "import-" << i                         << '\n';
+        stream << Call::HistoryMapFields::TIMESTAMP_START << '=' << qlonglong(base + i*600)               << '\n';
+        stream << Call::HistoryMapFields::TIMESTAMP_STOP  << '=' << qlonglong(base + i*600 + 60)          << '\n';
+        stream << Call::HistoryMapFields::ACCOUNT_ID      << '=' << accountId                             << '\n';
+        stream << Call::HistoryMapFields::PEER_NUMBER     << '=' << peerUri(i % std::max(1, o.peers))     << '\n';
+        stream << Call::HistoryMapFields::DIRECTION       << '=' << Call::HistoryStateName::INCOMING      << '\n';
+        stream << Call::HistoryMapFields::MISSED          << '=' << (i%5 ? '0' : '1')                     << '\n';
+        stream << '\n';
+    }
+
+    stream.flush();
+    r.bytes = f.size();
+    f.close();
+
+    auto col = CategorizedHistoryModel::instance().addCollection<LocalHistoryCollection>(
+        LoadOptions::FORCE_ENABLED
+    );
+
+    r.samples << measure([col]() {
+        QEventLoop loop;
+        auto job = HistoryImporter::importHistory(col);
+        QObject::connect(job, &HistoryImporter::ImportJob::finished, &loop, &QEventLoop::quit);
+        loop.exec();
+    });
+
+    return r;
+}
+
+/**
+ * What a view showing the accounts costs. Most Account roles read one or
+ * more account details.
+ */
+static Result benchmarkAccountData(const Options& o)
+{
+    Result r {QStringLiteral("account_data"), 0, 0, {}};
+
+    auto& m = AccountModel::instance();
+    const auto roles = m.roleNames().keys();
+
+    for (int i = 0; i < o.iterations; i++) {
+        r.samples << measure([&m, &roles, &o]() {
+            for (int j = 0; j < o.events; j++) {
+                for (int row = 0; row < m.rowCount(); row++) {
+                    const QModelIndex idx = m.index(row, 0);
+                    for (int role : roles)
+                        idx.data(role);
+                }
+            }
+        });
+    }
+
+    r.items = qint64(o.events) * m.rowCount() * roles.size();
+
+    return r;
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    // Never touch the real history
+    QStandardPaths::setTestModeEnabled(true);
+
+    GlobalInstances::setInterface<SilentDBusErrorHandler>();
+
+    // The history import needs an account which exists in the daemon
+    static const QByteArray importAccount = "libcardbenchmarkimport";
+    bool canImport = false;
+
+#ifndef ENABLE_LIBWRAP
+    auto daemon = FakeConfigurationManager::instance();
+    canImport = daemon->isRegistered();
+
+    daemon->addAccount(importAccount, {
+        { QStringLiteral("Account.type" ), QStringLiteral("RING"             ) },
+        { QStringLiteral("Account.alias"), QStringLiteral("Benchmark import" ) },
+    });
+#endif
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("libcard synthetic benchmarks"));
+    parser.addHelpOption();
+
+    const QCommandLineOption eventsOpt     ({"e", "events"     }, "Number of events"            , "n", "1000");
+    const QCommandLineOption attendeesOpt  ({"a", "attendees"  }, "Attendees per event"         , "n", "1"   );
+    const QCommandLineOption attachmentsOpt({"f", "attachments"}, "Attachments per event"       , "n", "0"   );
+    const QCommandLineOption timezonesOpt  ({"t", "timezones"  }, "Number of timezones"         , "n", "1"   );
+    const QCommandLineOption peersOpt      ({"p", "peers"      }, "Number of distinct attendees", "n", "50"  );
+    const QCommandLineOption iterationsOpt ({"i", "iterations" }, "Iterations of the pure tests", "n", "5"   );
+    const QCommandLineOption outputOpt     ({"o", "output"     }, "Write the JSON to this file" , "path"     );
+
+    parser.addOptions({
+        eventsOpt, attendeesOpt, attachmentsOpt, timezonesOpt, peersOpt, iterationsOpt, outputOpt
+    });
+
+    parser.process(app);
+
+    Options o;
+    o.events      = parser.value(eventsOpt     ).toInt();
+    o.attendees   = parser.value(attendeesOpt  ).toInt();
+    o.attachments = parser.value(attachmentsOpt).toInt();
+    o.timezones   = parser.value(timezonesOpt  ).toInt();
+    o.peers       = parser.value(peersOpt      ).toInt();
+    o.iterations  = std::max(1, parser.value(iterationsOpt).toInt());
+
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
+    QDir().mkpath(dir);
+
+    // Generate the calendar once, it is used by both the parser and loader
+    const QByteArray content = generateCalendar(o);
+    const QString rawPath = dir + QStringLiteral("/benchmark.ics");
+
+    {
+        QFile f(rawPath);
+        f.open(QIODevice::WriteOnly | QIODevice::Truncate);
+        f.write(content);
+    }
+
+    QList<Result> results;
+
+    results << benchmarkParse(o, rawPath, content.size());
+
+    // The account only has to exist, it is never saved
+    Account* a = AccountModel::instance().add(
+        QStringLiteral("libcard-benchmark"), Account::Protocol::RING
+    );
+
+    Calendar* cal = EventModel::instance().addCollection<Calendar, Account*>(
+        a, LoadOptions::NONE
+    );
+
+    results << benchmarkLoad(cal, content);
+
+    QList<ContactMethod*> peers;
+
+    for (int i = 0; i < o.peers; i++)
+        peers << PhoneDirectoryModel::instance().getNumber(URI(peerUri(i)), a);
+
+    results << benchmarkInsert(o, cal, peers);
+    results << benchmarkAppend(cal);
+    results << benchmarkBuild(o, cal);
+    results << benchmarkAggregate(peers);
+    results << benchmarkTimeline(peers);
+    results << benchmarkNodeChurn(o);
+    results << benchmarkNodeArena(o);
+    results << benchmarkAccountData(o);
+
+    if (canImport)
+        results << benchmarkImport(o, importAccount);
+    else
+        std::cerr << "The fake daemon is not available, skipping history_import" << std::endl;
+
+    QJsonArray resultArray;
+
+    for (const Result& r : qAsConst(results))
+        resultArray << r.toJson();
+
+    const QJsonObject root {
+        { "benchmark", "libcard"                                               },
+        { "version"  , 2                                                       },
+        { "timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)   },
+        { "options"  , QJsonObject {
+            { "events"     , o.events      },
+            { "attendees"  , o.attendees   },
+            { "attachments", o.attachments },
+            { "timezones"  , o.timezones   },
+            { "peers"      , o.peers       },
+            { "iterations" , o.iterations  },
+        }},
+        { "results"  , resultArray                                             },
+    };
+
+    const QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet(outputOpt)) {
+        QFile f(parser.value(outputOpt));
+        if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::cerr << "Cannot write " << f.fileName().toStdString() << std::endl;
+            return 1;
+        }
+        f.write(json);
+    }
+    else
+        std::cout << json.constData();
+
+    return 0;
+}
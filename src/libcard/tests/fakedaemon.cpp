@@ -0,0 +1,112 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "fakedaemon.h"
+
+#ifndef ENABLE_LIBWRAP
+
+// Qt
+#include <QtDBus/QDBusConnection>
+
+// Ring
+#include <dbus/metatypes.h>
+
+FakeConfigurationManager::FakeConfigurationManager() : QObject(nullptr)
+{
+    registerCommTypes();
+
+    auto bus = QDBusConnection::sessionBus();
+
+    m_IsRegistered = bus.registerService(QStringLiteral("cx.ring.Ring")) && bus.registerObject(
+        QStringLiteral("/cx/ring/Ring/ConfigurationManager"), this, QDBusConnection::ExportAllSlots
+    );
+}
+
+FakeConfigurationManager* FakeConfigurationManager::instance()
+{
+    static auto i = new FakeConfigurationManager();
+    return i;
+}
+
+bool FakeConfigurationManager::isRegistered() const
+{
+    return m_IsRegistered;
+}
+
+void FakeConfigurationManager::addAccount(const QString& id, const MapStringString& details)
+{
+    if (!m_hAccounts.contains(id))
+        m_lAccountIds << id;
+
+    m_hAccounts[id] = details;
+}
+
+void FakeConfigurationManager::called(const QString& method)
+{
+    m_hCalls[method]++;
+    m_lCallLog << method;
+}
+
+QStringList FakeConfigurationManager::getAccountList()
+{
+    called(QStringLiteral("getAccountList"));
+    return m_lAccountIds;
+}
+
+MapStringString FakeConfigurationManager::getAccountDetails(const QString& accountId)
+{
+    called(QStringLiteral("getAccountDetails"));
+    return m_hAccounts.value(accountId);
+}
+
+MapStringString FakeConfigurationManager::getVolatileAccountDetails(const QString& accountId)
+{
+    Q_UNUSED(accountId)
+    called(QStringLiteral("getVolatileAccountDetails"));
+    return {};
+}
+
+/// Like the daemon, the map replaces the old details
+void FakeConfigurationManager::setAccountDetails(const QString& accountId, const MapStringString& map)
+{
+    called(QStringLiteral("setAccountDetails"));
+    m_lReceivedDetails << map;
+    m_hAccounts[accountId] = map;
+}
+
+VectorMapStringString FakeConfigurationManager::getContacts(const QString& accountId)
+{
+    Q_UNUSED(accountId)
+    called(QStringLiteral("getContacts"));
+    return {};
+}
+
+VectorMapStringString FakeConfigurationManager::getTrustRequests(const QString& accountId)
+{
+    Q_UNUSED(accountId)
+    called(QStringLiteral("getTrustRequests"));
+    return {};
+}
+
+/// Keep the history enabled and unlimited
+int FakeConfigurationManager::getHistoryLimit()
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,99 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+// Qt
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+#include <QtCore/QStringList>
+
+// Ring
+#include <typedefs.h>
+#include <interfaces/dbuserrorhandleri.h>
+
+/**
+ * Without a daemon, every DBus call fails. The default handler aborts, but
+ * empty replies are fine for the tests and benchmarks.
+ */
+class SilentDBusErrorHandler final : public Interfaces::DBusErrorHandlerI
+{
+public:
+    virtual void connectionError(const QString& error) override {
+        Q_UNUSED(error)
+    }
+
+    virtual void invalidInterfaceError(const QString& error) override {
+        Q_UNUSED(error)
+    }
+};
+
+#ifndef ENABLE_LIBWRAP
+
+/**
+ * A ConfigurationManager good enough to bootstrap some accounts.
+ *
+ * It owns the daemon name on the session bus, so the library talks to it as
+ * if it was the daemon. The calls never leave the process. Only the account
+ * methods are implemented, the others fail and the library uses empty values.
+ *
+ * To simulate the daemon signals, emit them on ConfigurationManager::instance().
+ */
+class FakeConfigurationManager final : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "cx.ring.Ring.ConfigurationManager")
+public:
+    /// It has to be called before anything talks to the daemon
+    static FakeConfigurationManager* instance();
+
+    /// False when the name is already owned, usually by a real daemon
+    bool isRegistered() const;
+
+    void addAccount(const QString& id, const MapStringString& details);
+
+    /// The number of times each method was called
+    QHash<QString, int> m_hCalls;
+
+    /// The methods in the order they were called
+    QStringList m_lCallLog;
+
+    /// The maps received by setAccountDetails(), oldest first
+    QVector<MapStringString> m_lReceivedDetails;
+
+public Q_SLOTS:
+    QStringList           getAccountList           (                                                    );
+    MapStringString       getAccountDetails        (const QString& accountId                            );
+    MapStringString       getVolatileAccountDetails(const QString& accountId                            );
+    void                  setAccountDetails        (const QString& accountId, const MapStringString& map);
+    VectorMapStringString getContacts              (const QString& accountId                            );
+    VectorMapStringString getTrustRequests         (const QString& accountId                            );
+    int                   getHistoryLimit          (                                                    );
+
+private:
+    explicit FakeConfigurationManager();
+
+    void called(const QString& method);
+
+    QStringList                     m_lAccountIds;
+    QHash<QString, MapStringString> m_hAccounts;
+    bool                            m_IsRegistered {false};
+};
+
+#endif
@@ -0,0 +1,490 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+
+// Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTextStream>
+
+// Ring
+#include <account.h>
+#include <accountmodel.h>
+#include <call.h>
+#include <categorizedhistorymodel.h>
+#include <contactmethod.h>
+#include <globalinstances.h>
+#include <localhistorycollection.h>
+#include <namedirectory.h>
+#include <phonedirectorymodel.h>
+#include <securityevaluationmodel.h>
+#include <uri.h>
+#include <dbus/configurationmanager.h>
+#include <libcard/calendar.h>
+#include <libcard/eventaggregate.h>
+#include <libcard/historyimporter.h>
+#include <libcard/private/event_p.h>
+#include <private/namedirectory_p.h>
+#include "fakedaemon.h"
+
+// STD
+#include <functional>
+#include <iostream>
+
+/**
+ * Regression tests for the library internals.
+ *
+ * The daemon is replaced by FakeConfigurationManager, so they need a session
+ * bus without a daemon. The tests share the process, each of them uses its
+ * own peers to avoid depending on the others.
+ *
+ * Note that this needs the private symbols, so the library has to be built
+ * with BUILD_SHARED_LIBS=OFF.
+ */
+
+#define CHECK(cond) do {                                                      \
+    if (!(cond)) {                                                            \
+        std::cerr << __FILE__ << ':' << __LINE__ << ": CHECK(" #cond ")"      \
+            << std::endl;                                                     \
+        return false;                                                         \
+    }                                                                         \
+} while (0)
+
+/// Created by the fake daemon before the AccountModel is loaded
+static const QByteArray s_AccountId = "regressionring";
+
+/// Run the event loop until `cond` is true or the timeout expires
+static bool waitFor(const std::function<bool()>& cond, int timeout = 5000)
+{
+    QElapsedTimer t;
+    t.start();
+
+    while (!cond()) {
+        if (t.hasExpired(timeout))
+            return false;
+
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+    }
+
+    return true;
+}
+
+/// A valid RingId unique to each test
+static QByteArray peerUri(const char* test, int peer)
+{
+    return "ring:" + QCryptographicHash::hash(
+        test + QByteArray::number(peer), QCryptographicHash::Sha1
+    ).toHex();
+}
+
+static QString dataPath(const QString& fileName)
+{
+    return QStandardPaths::writableLocation(QStandardPaths::DataLocation)
+        + QLatin1Char('/') + fileName;
+}
+
+/**
+ * The previous import was killed after importing the calls 4 and 5, but its
+ * last checkpoint was saved after the call 3. None of them can be imported
+ * again.
+ */
+static bool testHistoryImportResume()
+{
+    constexpr static const int count = 10;
+
+    Account* a = AccountModel::instance().getById(s_AccountId);
+    CHECK(a);
+
+    const time_t base = QDateTime::currentDateTimeUtc().toTime_t() - 24*3600;
+
+    QFile history(dataPath(QStringLiteral("history.ini")));
+    CHECK(history.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text));
+
+    QTextStream stream(&history);
+
+    for (int i = 0; i < count; i++) {
+        stream << Call::HistoryMapFields::CALLID          << '=' << "resume-" << i                   << '\n';
+        stream << Call::HistoryMapFields::TIMESTAMP_START << '=' << qlonglong(base + i*600)          << '\n';
+        stream << Call::HistoryMapFields::TIMESTAMP_STOP  << '=' << qlonglong(base + i*600 + 60)     << '\n';
+        stream << Call::HistoryMapFields::ACCOUNT_ID      << '=' << s_AccountId                      << '\n';
+        stream << Call::HistoryMapFields::PEER_NUMBER     << '=' << peerUri("resume", i)             << '\n';
+        stream << Call::HistoryMapFields::DIRECTION       << '=' << Call::HistoryStateName::OUTGOING << '\n';
+        stream << Call::HistoryMapFields::MISSED          << '=' << '0'                              << '\n';
+        stream << '\n';
+    }
+
+    stream.flush();
+    history.close();
+
+    QFile checkpoint(dataPath(QStringLiteral("historyimport.checkpoint")));
+    CHECK(checkpoint.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    checkpoint.write("resume-3\n\n");
+    checkpoint.close();
+
+    auto cal = a->calendar();
+    CHECK(waitFor([cal]() { return cal->isLoaded(); }));
+
+    QList<ContactMethod*> peers;
+
+    for (int i = 0; i < count; i++)
+        peers << PhoneDirectoryModel::instance().getNumber(URI(peerUri("resume", i)), a);
+
+    for (int i : {4, 5}) {
+        EventPrivate data;
+        data.m_UID            = "resume-event-" + QByteArray::number(i);
+        data.m_StartTimeStamp = base + i*600;
+        data.m_StopTimeStamp  = base + i*600 + 60;
+        data.m_RevTimeStamp   = base + i*600 + 60;
+        data.m_EventCategory  = Event::EventCategory::CALL;
+        data.m_Status         = Event::Status::FINAL;
+        data.m_Type           = Event::Type::VEVENT;
+        data.m_lAttendees << QPair<ContactMethod*, QString> { peers[i], QString() };
+
+        cal->addEvent(data);
+    }
+
+    auto col = CategorizedHistoryModel::instance().addCollection<LocalHistoryCollection>(
+        LoadOptions::FORCE_ENABLED
+    );
+
+    bool finished = false;
+
+    auto job = HistoryImporter::importHistory(col);
+    QObject::connect(job, &HistoryImporter::ImportJob::finished, [&finished]() {
+        finished = true;
+    });
+
+    CHECK(waitFor([&finished]() { return finished; }, 30000));
+
+    const auto calls = col->items<Call>();
+    CHECK(calls.size() == count);
+
+    for (Call* c : qAsConst(calls)) {
+        const int i = c->historyId().mid(7).toInt();
+        const int events = peers[i]->eventAggregate()->events().size();
+
+        // Before the checkpoint
+        if (i <= 3) {
+            CHECK(events == 0);
+            CHECK(!c->calendarEvent());
+            continue;
+        }
+
+        CHECK(events == 1);
+        CHECK((i <= 5) == c->calendarEvent().isNull());
+    }
+
+    CHECK(!QFile::exists(checkpoint.fileName()));
+
+    return true;
+}
+
+class NameDirectoryTest
+{
+public:
+    static NameDirectoryPrivate* d() {
+        return NameDirectory::instance().d_ptr;
+    }
+};
+
+/**
+ * The same name looked up twice before the reply only reaches the daemon
+ * once and both get the reply. The next lookup comes from the cache, even
+ * without an account.
+ */
+static bool testNameLookupCache()
+{
+    Account* a = AccountModel::instance().getById(s_AccountId);
+    CHECK(a);
+
+    auto d = NameDirectoryTest::d();
+
+    const auto oldLookup = d->m_fLookupName;
+
+    int sent = 0;
+    d->m_fLookupName = [&sent](const QString&, const QString&, const QString&) {
+        sent++;
+        return true;
+    };
+
+    QVector<Account*> replies;
+    const QString address = peerUri("lookup", 0).mid(5);
+
+    auto conn = QObject::connect(&NameDirectory::instance(), &NameDirectory::registeredNameFound,
+        [&replies, &address](Account* account, NameDirectory::LookupStatus status, const QString& addr, const QString& name) {
+            if (name == QLatin1String("lookup-alice") && addr == address
+              && status == NameDirectory::LookupStatus::SUCCESS)
+                replies << account;
+    });
+
+    const auto cleanup = [d, oldLookup, conn]() {
+        d->m_fLookupName = oldLookup;
+        QObject::disconnect(conn);
+    };
+
+    const bool ok = [&]() {
+        CHECK(NameDirectory::instance().lookupName(a, {}, QStringLiteral("lookup-alice")));
+        CHECK(NameDirectory::instance().lookupName(a, {}, QStringLiteral("lookup-alice")));
+        CHECK(sent == 1);
+
+        d->slotRegisteredNameFound(a->id(), static_cast<int>(NameDirectory::LookupStatus::SUCCESS),
+            address, QStringLiteral("lookup-alice"));
+
+        // Both waiters were for the same account
+        CHECK(replies.size() == 1 && replies.first() == a);
+
+        CHECK(NameDirectory::instance().cachedLookup(a, QStringLiteral("lookup-alice")));
+
+        // The cache hit is asynchronous and uses the same fallback account
+        // as the daemon requests
+        CHECK(NameDirectory::instance().lookupName(nullptr, {}, QStringLiteral("lookup-alice")));
+        CHECK(replies.size() == 1);
+        CHECK(waitFor([&replies]() { return replies.size() == 2; }));
+        CHECK(replies[1] == a);
+        CHECK(sent == 1);
+
+        return true;
+    }();
+
+    cleanup();
+
+    return ok;
+}
+
+/**
+ * When the daemon reports a change for an unknown account, all the missing
+ * accounts are built at once and their details are fetched before anything
+ * else.
+ */
+static bool testMissingAccountsBatch()
+{
+    static const QString ids[] = {
+        QStringLiteral("regressionlate0"),
+        QStringLiteral("regressionlate1"),
+    };
+
+    auto daemon = FakeConfigurationManager::instance();
+
+    for (const auto& id : ids) {
+        CHECK(!AccountModel::instance().getById(id.toLatin1()));
+
+        daemon->addAccount(id, {
+            { QStringLiteral("Account.type" ), QStringLiteral("RING") },
+            { QStringLiteral("Account.alias"), id                     },
+        });
+    }
+
+    daemon->m_lCallLog.clear();
+
+    emit ConfigurationManager::instance().registrationStateChanged(
+        ids[0], QStringLiteral("REGISTERED"), 0, QStringLiteral("OK")
+    );
+
+    CHECK(waitFor([]() {
+        for (const auto& id : ids) {
+            if (!AccountModel::instance().getById(id.toLatin1()))
+                return false;
+        }
+        return true;
+    }));
+
+    const auto& log = daemon->m_lCallLog;
+
+    CHECK(log.count(QStringLiteral("getAccountList"   )) == 1);
+    CHECK(log.count(QStringLiteral("getAccountDetails")) == 2);
+
+    // The details of the second account were queried before the contacts of
+    // the first one
+    const int lastDetails = log.lastIndexOf(QStringLiteral("getAccountDetails"));
+    const int firstContacts = log.indexOf(QStringLiteral("getContacts"));
+    CHECK(firstContacts != -1 && lastDetails < firstContacts);
+
+    return true;
+}
+
+/**
+ * Reloading the details from the daemon replaces them without emitting
+ * propertyChanged, the security evaluation has to follow anyway.
+ */
+static bool testSecurityEvaluationReload()
+{
+    static const QString id = QStringLiteral("regressionsecurity");
+
+    auto daemon = FakeConfigurationManager::instance();
+
+    auto details = [](bool verifyServer) -> MapStringString {
+        return {
+            { QStringLiteral("Account.type" ), QStringLiteral("RING") },
+            { QStringLiteral("Account.alias"), id                     },
+            { QStringLiteral("TLS.verifyServer"),
+                verifyServer ? QStringLiteral("true") : QStringLiteral("false") },
+        };
+    };
+
+    daemon->addAccount(id, details(true));
+
+    emit ConfigurationManager::instance().registrationStateChanged(
+        id, QStringLiteral("REGISTERED"), 0, QStringLiteral("OK")
+    );
+
+    CHECK(waitFor([]() { return AccountModel::instance().getById(id.toLatin1()); }));
+
+    Account* a = AccountModel::instance().getById(id.toLatin1());
+    CHECK(a->isTlsVerifyServer());
+
+    auto m = a->securityEvaluationModel();
+
+    auto flaws = [m]() {
+        return m->informationCount() + m->warningCount() + m->issueCount()
+            + m->errorCount() + m->fatalWarningCount();
+    };
+
+    CHECK(waitFor([m]() { return m->evaluatedRuleCount() > 0; }));
+
+    const qint64 evaluated = m->evaluatedRuleCount();
+    const int    before    = flaws();
+
+    // Change the TLS setting behind the client back
+    daemon->addAccount(id, details(false));
+    a->performAction(Account::EditAction::RELOAD);
+
+    CHECK(!a->isTlsVerifyServer());
+    CHECK(waitFor([m, evaluated]() { return m->evaluatedRuleCount() > evaluated; }));
+    CHECK(flaws() != before);
+
+    return true;
+}
+
+/**
+ * A merged aggregate already delivered the events of one source past the
+ * head of the other. An event newer than those added to the other source
+ * has to be inserted in place rather than left to the merge.
+ */
+static bool testMergedAggregateInsert()
+{
+    Account* a = AccountModel::instance().getById(s_AccountId);
+    CHECK(a);
+
+    auto cal = a->calendar();
+    CHECK(waitFor([cal]() { return cal->isLoaded(); }));
+
+    ContactMethod* peers[] = {
+        PhoneDirectoryModel::instance().getNumber(URI(peerUri("merge", 0)), a),
+        PhoneDirectoryModel::instance().getNumber(URI(peerUri("merge", 1)), a),
+    };
+
+    const time_t base = QDateTime::currentDateTimeUtc().toTime_t() - 3600;
+
+    auto addEvent = [cal, base](ContactMethod* cm, int offset) {
+        EventPrivate data;
+        data.m_UID            = "merge-event-" + QByteArray::number(offset);
+        data.m_StartTimeStamp = base + offset;
+        data.m_StopTimeStamp  = base + offset + 10;
+        data.m_RevTimeStamp   = base + offset + 10;
+        data.m_EventCategory  = Event::EventCategory::CALL;
+        data.m_Status         = Event::Status::FINAL;
+        data.m_Type           = Event::Type::VEVENT;
+        data.m_lAttendees << QPair<ContactMethod*, QString> { cm, QString() };
+
+        return cal->addEvent(data);
+    };
+
+    // The first source is older than everything in the second one
+    addEvent(peers[0], 100);
+    addEvent(peers[1], 900);
+    addEvent(peers[1], 800);
+
+    const auto sources = QList<QSharedPointer<EventAggregate>> {
+        peers[0]->eventAggregate(), peers[1]->eventAggregate(),
+    };
+
+    auto merged = EventAggregate::merge(sources);
+
+    // Only the second source is delivered, the first one is primed
+    CHECK(merged->fetchMore(2) == 2);
+    CHECK(merged->eventAt(1)->startTimeStamp() == base + 800);
+
+    const auto e = addEvent(peers[0], 1000);
+    CHECK(e);
+
+    CHECK(waitFor([&merged, &e]() { return merged->eventAt(0) == e; }));
+
+    const auto all = merged->events();
+    CHECK(all.size() == 4);
+
+    for (int i = 1; i < all.size(); i++)
+        CHECK(all[i-1]->startTimeStamp() > all[i]->startTimeStamp());
+
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    // Never touch the real history and always start from scratch
+    QStandardPaths::setTestModeEnabled(true);
+
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
+    QDir(dir).removeRecursively();
+    QDir().mkpath(dir);
+
+    GlobalInstances::setInterface<SilentDBusErrorHandler>();
+
+    auto daemon = FakeConfigurationManager::instance();
+
+    if (!daemon->isRegistered()) {
+        std::cerr << "The fake daemon cannot be registered, is a daemon using this session bus?" << std::endl;
+        return 1;
+    }
+
+    daemon->addAccount(s_AccountId, {
+        { QStringLiteral("Account.type" ), QStringLiteral("RING"      ) },
+        { QStringLiteral("Account.alias"), QStringLiteral("Regression") },
+    });
+
+    // Build the accounts from the fake daemon
+    AccountModel::instance();
+
+    const struct {
+        const char* name;
+        bool (*run)();
+    } tests[] = {
+        { "history_import_resume" , &testHistoryImportResume      },
+        { "name_lookup_cache"     , &testNameLookupCache          },
+        { "missing_accounts_batch", &testMissingAccountsBatch     },
+        { "security_reload"       , &testSecurityEvaluationReload },
+        { "merged_aggregate"      , &testMergedAggregateInsert    },
+    };
+
+    int failures = 0;
+
+    for (const auto& t : tests) {
+        const bool ok = t.run();
+        std::cout << (ok ? "PASS " : "FAIL ") << t.name << std::endl;
+        failures += ok ? 0 : 1;
+    }
+
+    return failures ? 1 : 0;
+}
@@ -20,8 +20,8 @@
 
 //Qt
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <QtCore/QHash>
-#include <QtCore/QTimer>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
@@ -35,6 +35,7 @@
 #include <personmodel.h>
 #include <phonedirectorymodel.h>
 #include <collectioneditor.h>
+#include <collectionloader.h>
 #include <globalinstances.h>
 #include <interfaces/pixmapmanipulatori.h>
 
@@ -84,7 +85,8 @@ constexpr const char LocalBookmarkCollectionPrivate::FILENAME[];
 LocalBookmarkCollection::LocalBookmarkCollection(CollectionMediator<ContactMethod>* mediator) :
    CollectionInterface(new LocalBookmarkEditor(mediator)), d_ptr(new LocalBookmarkCollectionPrivate())
 {
-    QTimer::singleShot(0, [this]() {load();});
+    // Parse the file in the loader pool
+    CollectionLoader::instance().enqueue(this, {});
 }
 
 
@@ -95,14 +97,26 @@ LocalBookmarkCollection::~LocalBookmarkCollection()
 
 bool LocalBookmarkCollection::load()
 {
-   QFile file(QStandardPaths::writableLocation(QStandardPaths::DataLocation)
+   const QString path = QStandardPaths::writableLocation(QStandardPaths::DataLocation)
               + QLatin1Char('/')
-              + LocalBookmarkCollectionPrivate::FILENAME);
-   if ( file.open(QIODevice::ReadOnly | QIODevice::Text) ) {
+              + LocalBookmarkCollectionPrivate::FILENAME;
+
+   if (!QFileInfo(path).isReadable()) {
+      qWarning() << "Bookmarks doesn't exist or is not readable";
+      return false;
+   }
+
+   auto parse = [path]() {
+      QFile file(path);
+
+      if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+         return QJsonArray();
+
+      return QJsonDocument::fromJson(file.readAll()).array();
+   };
+
+   auto publish = [this](const QJsonArray& a) {
       LocalBookmarkEditor* e = static_cast<LocalBookmarkEditor*>(editor<ContactMethod>());
-      const QByteArray content = file.readAll();
-      QJsonDocument loadDoc = QJsonDocument::fromJson(content);
-      QJsonArray a = loadDoc.array();
 
       for (int i = 0; i < a.size(); ++i) {
          QJsonObject o = a[i].toObject();
@@ -116,12 +130,19 @@ bool LocalBookmarkCollection::load()
 
          e->m_Nodes << n;
       }
+   };
 
-      return true;
+   // The ContactMethods can only be created in the main thread
+   if (CollectionLoader::instance().isLoading(this)) {
+      CollectionLoader::instance().run(this, [parse, publish]() -> std::function<void()> {
+         const QJsonArray a = parse();
+         return [publish, a]() { publish(a); };
+      });
    }
    else
-      qWarning() << "Bookmarks doesn't exist or is not readable";
-   return false;
+      publish(parse());
+
+   return true;
 }
 
 bool LocalBookmarkEditor::save(const ContactMethod* number)
@@ -22,6 +22,8 @@
 #include <QtCore/QFile>
 #include <QtCore/QDir>
 #include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QTextStream>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QUrl>
@@ -55,12 +57,35 @@ public:
    bool m_IsLoaded {false};
    LocalHistoryCollection* m_pCollection;
 
+   /**
+    * The position of each call record in history.ini.
+    *
+    * Removing or editing a call appends the old position to the tombstone
+    * file instead of rewriting the whole history. The loader skips those
+    * records and compact() eventually rewrites the file.
+    *
+    * It is indexed by Call::historyId() since the calls can be deleted
+    * behind the collection back.
+    */
+   QHash<QString, qint64> m_hOffsets;
+
+   /// The number of dead records (tombstones and superseded entries)
+   int m_Garbage {0};
+
+   //Helpers
+   static QString historyPath  ();
+   static QString tombstonePath();
+   QSet<qint64> readTombstones() const;
+
 private:
    virtual QVector<Call*> items() const override;
 
    //Helpers
-   void saveCall(QTextStream& stream, const Call* call);
+   bool saveCall(QTextStream& stream, const Call* call);
    bool regenFile(const Call* toIgnore);
+   bool appendCall(const Call* call);
+   bool addTombstone(const Call* call);
+   void compact();
 };
 
 LocalHistoryEditor::LocalHistoryEditor(CollectionMediator<Call>* m, LocalHistoryCollection* parent) :
@@ -80,10 +105,41 @@ LocalHistoryCollection::~LocalHistoryCollection()
 
 }
 
-void LocalHistoryEditor::saveCall(QTextStream& stream, const Call* call)
+QString LocalHistoryEditor::historyPath()
+{
+   return QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1Char('/') +"history.ini";
+}
+
+QString LocalHistoryEditor::tombstonePath()
+{
+   return QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1Char('/') +"history.tombstones";
+}
+
+/// The tombstone file has the offset of a dead record on each line
+QSet<qint64> LocalHistoryEditor::readTombstones() const
+{
+   QSet<qint64> ret;
+
+   QFile file(tombstonePath());
+
+   if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+      return ret;
+
+   while (!file.atEnd()) {
+      bool ok = false;
+      const qint64 offset = file.readLine().trimmed().toLongLong(&ok);
+
+      if (ok)
+         ret.insert(offset);
+   }
+
+   return ret;
+}
+
+bool LocalHistoryEditor::saveCall(QTextStream& stream, const Call* call)
 {
    if (!CategorizedHistoryModel::instance().isHistoryEnabled())
-      return;
+      return false;
 
    stream.setCodec("UTF-8");
    const QString direction = (call->direction()==Call::Direction::INCOMING)?
@@ -120,6 +176,8 @@ void LocalHistoryEditor::saveCall(QTextStream& stream, const Call* call)
       stream << QStringLiteral("%1=%2\n").arg(Call::HistoryMapFields::CERT_PATH).arg(call->certificate()->path());
    stream << "\n";
    stream.flush();
+
+   return true;
 }
 
 bool LocalHistoryEditor::regenFile(const Call* toIgnore)
@@ -127,31 +185,112 @@ bool LocalHistoryEditor::regenFile(const Call* toIgnore)
    QDir dir(QString('/'));
    dir.mkpath(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1Char('/') + QString());
 
-   QFile file(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1Char('/') +"history.ini");
+   QFile file(historyPath());
    if ( file.open(QIODevice::WriteOnly | QIODevice::Text) ) {
+      m_hOffsets.clear();
+
       QTextStream stream(&file);
       for (const Call* c : CategorizedHistoryModel::instance().getHistoryCalls()) {
-         if (c != toIgnore)
-            saveCall(stream, c);
+         // saveCall() flushes the stream, so pos() is the start of the record
+         const qint64 offset = file.pos();
+
+         if (c != toIgnore && saveCall(stream, c))
+            m_hOffsets[c->historyId()] = offset;
       }
       file.close();
+
+      // All dead records are gone
+      QFile::remove(tombstonePath());
+      m_Garbage = 0;
+
       return true;
    }
    return false;
 }
 
+/// Add a record at the end of the file and track its position
+bool LocalHistoryEditor::appendCall(const Call* call)
+{
+   QDir dir(QString('/'));
+   dir.mkpath(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1Char('/') + QString());
+
+   //TODO support \r and \n\r end of line
+   QFile file(historyPath());
+
+   if (!file.open(QIODevice::Append | QIODevice::Text)) {
+      qWarning() << "Unable to save history";
+      return false;
+   }
+
+   const qint64 offset = file.size();
+
+   QTextStream streamFileOut(&file);
+   const bool ret = saveCall(streamFileOut, call)
+      && streamFileOut.status() == QTextStream::Ok;
+
+   if (ret)
+      m_hOffsets[call->historyId()] = offset;
+
+   file.close();
+
+   return ret;
+}
+
+/// Mark the current record of `call` as dead without touching history.ini
+bool LocalHistoryEditor::addTombstone(const Call* call)
+{
+   if (!m_hOffsets.contains(call->historyId()))
+      return false;
+
+   QFile file(tombstonePath());
+
+   if (!file.open(QIODevice::Append | QIODevice::Text)) {
+      qWarning() << "Unable to save the history tombstones";
+      return false;
+   }
+
+   file.write(QByteArray::number(m_hOffsets.take(call->historyId())) + '\n');
+   file.close();
+
+   m_Garbage++;
+
+   return true;
+}
+
+/// Rewrite the file once enough dead records accumulated
+void LocalHistoryEditor::compact()
+{
+   // A rather random value, see CalendarPrivate::slotSaveOnDisk
+   constexpr static const int threshold = 200;
+
+   if (m_Garbage > threshold && m_Garbage > m_hOffsets.size()/4)
+      regenFile(nullptr);
+}
+
 bool LocalHistoryEditor::save(const Call* call)
 {
    if (call->collection()->editor<Call>() != this)
       return addNew(const_cast<Call*>(call));
 
-   return regenFile(nullptr);
+   // The position is unknown, fallback to a full rewrite
+   if (!addTombstone(call))
+      return regenFile(nullptr);
+
+   const bool ret = appendCall(call);
+
+   compact();
+
+   return ret;
 }
 
 bool LocalHistoryEditor::remove(const Call* item)
 {
-   if (regenFile(item)) {
+   if (addTombstone(item) || regenFile(item)) {
+      m_lItems.removeAll(const_cast<Call*>(item));
       mediator()->removeItem(item);
+
+      compact();
+
       return true;
    }
    return false;
@@ -165,24 +304,14 @@ bool LocalHistoryEditor::edit( Call* item)
 
 bool LocalHistoryEditor::addNew( Call* call)
 {
-   QDir dir(QString('/'));
-   dir.mkpath(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1Char('/') + QString());
-
    if ((call->collection() && call->collection()->editor<Call>() == this)  || call->historyId().isEmpty()) return false;
-   //TODO support \r and \n\r end of line
-   QFile file(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1Char('/')+"history.ini");
-
-   if ( file.open(QIODevice::Append | QIODevice::Text) ) {
-      QTextStream streamFileOut(&file);
-      saveCall(streamFileOut, call);
-      file.close();
 
+   if (appendCall(call)) {
       const_cast<Call*>(call)->setCollection(m_pCollection);
       addExisting(call);
       return true;
    }
-   else
-      qWarning() << "Unable to save history";
+
    return false;
 }
 
@@ -218,56 +347,120 @@ bool LocalHistoryCollection::isEnabled() const
    return true;
 }
 
+/**
+ * Load the history one line at a time.
+ *
+ * Only the current record is kept in memory. The start timestamp is checked
+ * before creating the Call, so entries older than the history limit are
+ * never materialized.
+ */
 bool LocalHistoryCollection::load()
 {
    if (!CategorizedHistoryModel::instance().isHistoryEnabled())
       return false;
 
-   QFile file(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1Char('/') +"history.ini");
-   if ( file.open(QIODevice::ReadOnly | QIODevice::Text) ) {
-      QMap<QStringRef,QStringRef> hc;
+   auto e = static_cast<LocalHistoryEditor*>(editor<Call>());
 
-      // QByteArray -> QString since there is no QByteArrayRef and the
-      // data is UTF anyway
-      const QString data = file.readAll();
-      file.close();
-
-      //TODO support windows again
-      QVector<QStringRef> lines = QStringRef(&data).trimmed().split('\n');
+   QFile file(LocalHistoryEditor::historyPath());
+   if ( file.open(QIODevice::ReadOnly) ) {
+      const QSet<qint64> tombstones = e->readTombstones();
 
       const bool      isLimited = CategorizedHistoryModel::instance().isHistoryLimited();
       const long long dayLimit  = CategorizedHistoryModel::instance().historyLimit() * 24 * 3600;
 
       time_t now = time(0); // get time now
 
-      for (const QStringRef& line : qAsConst(lines)) {
-         //The item is complete
-         if ((line.isEmpty() || !line.size()) && hc.size()) {
-            Call* pastCall = Call::buildHistoryCall(hc);
+      // Add the calls to the mediator in batches rather than interleaving
+      // the model insertions with the parsing.
+      constexpr static const int batchSize = 256;
+      QVector<Call*> batch;
+      batch.reserve(batchSize);
 
-            if (!pastCall)
-               continue;
+      const auto flush = [this, e, &batch]() {
+         for (Call* c : qAsConst(batch)) {
+            c->setCollection(this);
+            e->addExisting(c);
+         }
+         batch.clear();
+      };
+
+      // The lines of the current record
+      QVector<QString> record;
+      qint64 recordStart = 0;
+      qint64 pos         = 0;
+
+      const auto parseRecord = [&]() {
+         if (tombstones.contains(recordStart)) {
+            e->m_Garbage++;
+            return;
+         }
 
-            if (!isLimited || ( (now - pastCall->startTimeStamp()) < dayLimit) ) {
-               pastCall->setCollection(this);
-               editor<Call>()->addExisting(pastCall);
-            }
+         // The QStringRef point to `record`, it must not change past this point
+         QMap<QStringRef,QStringRef> hc;
 
-            hc.clear();
-         }
-         // Add to the current set
-         else {
+         for (const QString& line : qAsConst(record)) {
             const int idx = line.indexOf('=');
             if (idx >= 0)
-               hc[line.left(idx)] = line.right(line.size()-idx-1);
+               hc[line.leftRef(idx)] = line.midRef(idx+1);
          }
+
+         const time_t start = hc.value(QStringRef(&Call::HistoryMapFields::TIMESTAMP_START)).toUInt();
+
+         if (isLimited && (now - start) >= dayLimit)
+            return;
+
+         Call* pastCall = Call::buildHistoryCall(hc);
+
+         if (!pastCall)
+            return;
+
+         e->m_hOffsets[pastCall->historyId()] = recordStart;
+
+         batch << pastCall;
+
+         if (batch.size() >= batchSize)
+            flush();
+      };
+
+      while (true) {
+         const QByteArray raw = file.readLine();
+         const qint64 lineStart = pos;
+         pos += raw.size();
+
+         QString line = QString::fromUtf8(raw);
+
+         while (line.endsWith('\n') || line.endsWith('\r'))
+            line.chop(1);
+
+         //The item is complete
+         if (line.isEmpty()) {
+            if (!record.isEmpty()) {
+               parseRecord();
+               record.clear();
+            }
+
+            if (raw.isEmpty())
+               break;
+
+            continue;
+         }
+
+         // Add to the current set
+         if (record.isEmpty())
+            recordStart = lineStart;
+
+         record << line;
       }
 
-      for (auto cb :  static_cast<LocalHistoryEditor*>(editor<Call>())->m_lCallbacks) {
+      file.close();
+
+      flush();
+
+      for (auto cb :  e->m_lCallbacks) {
           cb(this);
       }
 
-      static_cast<LocalHistoryEditor*>(editor<Call>())->m_IsLoaded = true;
+      e->m_IsLoaded = true;
 
       return true;
    }
@@ -293,7 +486,12 @@ FlagPack<CollectionInterface::SupportedFeatures> LocalHistoryCollection::support
 
 bool LocalHistoryCollection::clear()
 {
-   QFile::remove(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QLatin1Char('/') +"history.ini");
+   auto e = static_cast<LocalHistoryEditor*>(editor<Call>());
+   e->m_hOffsets.clear();
+   e->m_Garbage = 0;
+
+   QFile::remove(LocalHistoryEditor::historyPath  ());
+   QFile::remove(LocalHistoryEditor::tombstonePath());
    return true;
 }
 
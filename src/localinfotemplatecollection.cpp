@@ -33,7 +33,7 @@
 #include "collectioneditor.h"
 #include "individual.h"
 #include "infotemplatemanager.h"
-#include "private/threadworker.h"
+#include "collectionloader.h"
 
 class LocalInfoTemplateCollectionEditor final : public CollectionEditor<InfoTemplate>
 {
@@ -174,33 +174,42 @@ bool LocalInfoTemplateCollection::isEnabled() const
 
 bool LocalInfoTemplateCollection::load()
 {
-    new ThreadWorker([this]() {
+    // Read the files in the loader pool, create the templates in the main thread
+    CollectionLoader::instance().run(this, [this]() -> std::function<void()> {
         QDir dir(LocalInfoTemplateCollectionEditor::m_Path);
 
-        if (!dir.exists())
-            return;
+        QList<QByteArray> content;
 
-        for (const QString& path : dir.entryList({"*.vcf"}, QDir::Files)) {
-            QFile file(path);
+        if (dir.exists()) {
+            for (const QString& path : dir.entryList({"*.vcf"}, QDir::Files)) {
+                QFile file(dir.absoluteFilePath(path));
 
-            if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-                qDebug() << "Error opening vcard: " << path;
-                continue;
+                if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+                    qDebug() << "Error opening vcard: " << path;
+                    continue;
+                }
+
+                content << file.readAll();
+                CollectionLoader::instance().addBytesRead(this, content.last().size());
             }
+        }
 
-            auto it = new InfoTemplate(file.readAll(), &InfoTemplateManager::instance());
+        return [this, content]() {
+            for (const auto& vcard : qAsConst(content)) {
+                auto it = new InfoTemplate(vcard, &InfoTemplateManager::instance());
 
-            it->setCollection(this);
-            editor<InfoTemplate>()->addExisting(it);
-        }
+                it->setCollection(this);
+                editor<InfoTemplate>()->addExisting(it);
+            }
 
-        // Add the default template
-        if (size() == 0) {
-            auto it = new InfoTemplate(d_ptr->defaultTemplate(), &InfoTemplateManager::instance());
+            // Add the default template
+            if (size() == 0) {
+                auto it = new InfoTemplate(d_ptr->defaultTemplate(), &InfoTemplateManager::instance());
 
-            it->setCollection(this);
-            editor<InfoTemplate>()->addExisting(it);
-        }
+                it->setCollection(this);
+                editor<InfoTemplate>()->addExisting(it);
+            }
+        };
     });
 
     return true;
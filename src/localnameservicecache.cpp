@@ -22,6 +22,7 @@
 #include <QtCore/QFile>
 #include <QtCore/QHash>
 #include <QtCore/QTimer>
+#include <QtCore/QDataStream>
 #include <QtCore/QStandardPaths>
 
 //Ring
@@ -34,13 +35,13 @@
 #include <collectioneditor.h>
 #include <globalinstances.h>
 #include <interfaces/pixmapmanipulatori.h>
+#include "private/threadworker.h"
 
 class LocalNameServiceEditor final : public QObject, public CollectionEditor<ContactMethod>
 {
     Q_OBJECT
 public:
-    LocalNameServiceEditor(CollectionMediator<ContactMethod>* m)
-        : CollectionEditor<ContactMethod>(m), QObject(QCoreApplication::instance()) {}
+    LocalNameServiceEditor(CollectionMediator<ContactMethod>* m);
     virtual bool save       ( const ContactMethod* item ) override;
     virtual bool remove     ( const ContactMethod* item ) override;
     virtual bool addNew     ( ContactMethod*       item ) override;
@@ -49,26 +50,242 @@ public:
 
     //Attributes
     QHash<QByteArray, QString> m_hCache;
-    QMutex m_AsyncMutex;
+
+    /// The entries added since the last flush
+    QHash<QByteArray, QString> m_hPending;
+
+    /// If entries were removed, the file has to be rewritten
+    bool m_NeedsRewrite {false};
+
+    QTimer* m_pSaveTimer;
+
+    /// Nothing is written before the existing file is read
+    bool m_IsLoadDone {false};
+
+    /// All file accesses are serialized in this thread
+    SerialThreadWorker* m_pWorker;
+
+    /// Only used by the I/O thread
+    QHash<QString, quint32> m_hNameIds;
 
 private:
     virtual QVector<ContactMethod*> items() const override;
+
+private Q_SLOTS:
+    void slotFlush();
 };
 
+/**
+ * The cache file is a stream of records:
+ *
+ *  * NAME      : quint32 id, QString name
+ *  * HASHED_ID : 20 raw bytes of the hexadecimal RingID, quint32 name id
+ *  * RAW_ID    : QByteArray id, quint32 name id
+ *
+ * The names are interned. A name is written once and referenced by id by
+ * all entries using it. New entries are appended, so saving does not depend
+ * on the size of the cache. The file is only rewritten when entries are
+ * removed.
+ */
 class LocalNameServiceCachePrivate
 {
 public:
+    enum class RecordType : quint8 {
+        NAME      = 1,
+        HASHED_ID = 2,
+        RAW_ID    = 3,
+    };
 
     //Attributes
-    constexpr static const char FILENAME[] = "nameservice.csv";
+    bool m_IsLoaded {false};
+
+    constexpr static const char    FILENAME       [] = "nameservice.cache";
+    constexpr static const char    LEGACY_FILENAME[] = "nameservice.csv";
+    constexpr static const quint32 MAGIC             = 0x524e4331; // RNC1
+    constexpr static const int     RINGID_SIZE       = 20;
+
+    //Helpers
+    static QString path(const char* fileName);
+    static bool readCache (QHash<QByteArray, QString>& out, QHash<QString, quint32>& names, bool& isCorrupted);
+    static bool readLegacy(QHash<QByteArray, QString>& out);
+    static bool writeCache(const QHash<QByteArray, QString>& entries, QHash<QString, quint32>& names, bool rewrite);
 };
 
 constexpr const char LocalNameServiceCachePrivate::FILENAME[];
+constexpr const char LocalNameServiceCachePrivate::LEGACY_FILENAME[];
+constexpr const quint32 LocalNameServiceCachePrivate::MAGIC;
+constexpr const int LocalNameServiceCachePrivate::RINGID_SIZE;
+
+QString LocalNameServiceCachePrivate::path(const char* fileName)
+{
+    return QStandardPaths::writableLocation(QStandardPaths::DataLocation)
+        + QLatin1Char('/')
+        + fileName;
+}
+
+/**
+ * Read the cache file.
+ *
+ * `isCorrupted` is set when a record can't be read. What was read before is
+ * kept, but the file has to be rewritten, otherwise the next appended
+ * records would follow the garbage and never be read back.
+ */
+bool LocalNameServiceCachePrivate::readCache(QHash<QByteArray, QString>& out, QHash<QString, quint32>& names, bool& isCorrupted)
+{
+    isCorrupted = false;
+
+    QFile file(path(FILENAME));
+
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_9);
+
+    quint32 magic;
+    stream >> magic;
+
+    if (magic != MAGIC) {
+        qWarning() << "The registered name cache is corrupted";
+        return false;
+    }
+
+    // Resolve the ids to the interned (implicitly shared) strings
+    QHash<quint32, QString> byId;
+
+    while (!stream.atEnd()) {
+        quint8 type;
+        stream >> type;
+
+        switch(static_cast<RecordType>(type)) {
+            case RecordType::NAME: {
+                quint32 id;
+                QString name;
+                stream >> id >> name;
+                byId [id  ] = name;
+                names[name] = id;
+            } break;
+            case RecordType::HASHED_ID: {
+                QByteArray raw(RINGID_SIZE, Qt::Uninitialized);
+                quint32 id;
+
+                if (stream.readRawData(raw.data(), RINGID_SIZE) != RINGID_SIZE) {
+                    stream.setStatus(QDataStream::ReadPastEnd);
+                    break;
+                }
+
+                stream >> id;
+                out[raw.toHex()] = byId.value(id);
+            } break;
+            case RecordType::RAW_ID: {
+                QByteArray ringId;
+                quint32 id;
+                stream >> ringId >> id;
+                out[ringId] = byId.value(id);
+            } break;
+            default:
+                stream.setStatus(QDataStream::ReadCorruptData);
+                break;
+        }
+
+        // A partial write (crash while appending), keep what was read
+        if (stream.status() != QDataStream::Ok) {
+            qWarning() << "The registered name cache is corrupted";
+            isCorrupted = true;
+            break;
+        }
+    }
+
+    out.remove({});
+
+    return true;
+}
+
+bool LocalNameServiceCachePrivate::readLegacy(QHash<QByteArray, QString>& out)
+{
+    QFile file(path(LEGACY_FILENAME));
+
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+
+        if (line.isEmpty())
+            continue;
+
+        const int idx = line.indexOf('\t');
+
+        if (idx == -1 || line.indexOf('\t', idx + 1) != -1) {
+            qWarning() << "The registered name cache is corrupted";
+            return true;
+        }
+
+        out[line.left(idx)] = QString::fromUtf8(line.mid(idx + 1));
+    }
+
+    return true;
+}
+
+/// Append (or rewrite) the entries, only call this from the I/O thread
+bool LocalNameServiceCachePrivate::writeCache(const QHash<QByteArray, QString>& entries, QHash<QString, quint32>& names, bool rewrite)
+{
+    QFile file(path(FILENAME));
+
+    if (rewrite)
+        names.clear();
+
+    if (!file.open(rewrite ? QIODevice::WriteOnly | QIODevice::Truncate : QIODevice::Append)) {
+        qWarning() << "Unable to save the registered names";
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_9);
+
+    if (file.size() == 0)
+        stream << MAGIC;
+
+    for (auto i = entries.constBegin(); i != entries.constEnd(); ++i) {
+        auto nameId = names.constFind(i.value());
+
+        if (nameId == names.constEnd()) {
+            nameId = names.insert(i.value(), names.size());
+            stream << static_cast<quint8>(RecordType::NAME) << nameId.value() << i.value();
+        }
+
+        const QByteArray raw = i.key().size() == 2*RINGID_SIZE ?
+            QByteArray::fromHex(i.key()) : QByteArray();
+
+        // Only use the compact form when it round-trips
+        if (raw.size() == RINGID_SIZE && raw.toHex() == i.key()) {
+            stream << static_cast<quint8>(RecordType::HASHED_ID);
+            stream.writeRawData(raw.constData(), RINGID_SIZE);
+        }
+        else
+            stream << static_cast<quint8>(RecordType::RAW_ID) << i.key();
+
+        stream << nameId.value();
+    }
+
+    file.close();
+
+    return true;
+}
+
+LocalNameServiceEditor::LocalNameServiceEditor(CollectionMediator<ContactMethod>* m)
+    : QObject(QCoreApplication::instance()), CollectionEditor<ContactMethod>(m),
+    m_pSaveTimer(new QTimer(this)), m_pWorker(new SerialThreadWorker(this))
+{
+    // Do not trash the I/O for nothing, it's just a cache
+    m_pSaveTimer->setSingleShot(true);
+    m_pSaveTimer->setInterval(500);
+    connect(m_pSaveTimer, &QTimer::timeout, this, &LocalNameServiceEditor::slotFlush);
+}
 
 LocalNameServiceCache::LocalNameServiceCache(CollectionMediator<ContactMethod>* mediator) :
    CollectionInterface(new LocalNameServiceEditor(mediator)), d_ptr(new LocalNameServiceCachePrivate())
 {
-    QTimer::singleShot(0, [this]() {load();});
 }
 
 
@@ -77,34 +294,59 @@ LocalNameServiceCache::~LocalNameServiceCache()
     delete d_ptr;
 }
 
+/**
+ * Read the file in a thread, then insert all names in the directory in a
+ * single batch.
+ */
 bool LocalNameServiceCache::load()
 {
-    QTimer::singleShot(0, []() {
-        QFile file(QStandardPaths::writableLocation(QStandardPaths::DataLocation)
-                    + QLatin1Char('/')
-                    + LocalNameServiceCachePrivate::FILENAME);
-        if ( file.open(QIODevice::ReadOnly | QIODevice::Text) ) {
+    if (d_ptr->m_IsLoaded)
+        return true;
 
-            const QByteArray content = file.readAll();
+    d_ptr->m_IsLoaded = true;
 
-            const auto lines = content.split('\n');
+    auto e = static_cast<LocalNameServiceEditor*>(editor<ContactMethod>());
 
-            for (const auto& line : qAsConst(lines)) {
-                if (line.isEmpty())
-                    continue;
+    e->m_pWorker->run([e]() {
+        QHash<QByteArray, QString> entries;
+        bool migrate     = false;
+        bool isCorrupted = false;
 
-                const auto fields = line.split('\t');
-                if (fields.count() != 2) {
-                    qWarning() << "The registered name cache is corrupted";
-                    return;
-                }
-                PhoneDirectoryModel::instance().setRegisteredNameForRingId(fields[0], fields[1]);
-            }
+        if (!LocalNameServiceCachePrivate::readCache(entries, e->m_hNameIds, isCorrupted)) {
+            migrate = LocalNameServiceCachePrivate::readLegacy(entries);
 
-            return;
+            if (!migrate)
+                qWarning() << "Name cache doesn't exist or is not readable";
         }
-        else
-            qWarning() << "Name cache doesn't exist or is not readable";
+
+        QTimer::singleShot(0, e, [e, entries, migrate, isCorrupted]() {
+            // Fill the cache first so addExisting() doesn't schedule a save
+            // for every entry.
+            for (auto i = entries.constBegin(); i != entries.constEnd(); ++i) {
+                if (!e->m_hCache.contains(i.key()))
+                    e->m_hCache[i.key()] = i.value();
+            }
+
+            PhoneDirectoryModel::instance().setRegisteredNamesForRingIds(entries);
+
+            e->m_IsLoadDone = true;
+
+            // Convert the old CSV file
+            if (migrate) {
+                e->m_NeedsRewrite = true;
+                QFile::remove(LocalNameServiceCachePrivate::path(
+                    LocalNameServiceCachePrivate::LEGACY_FILENAME
+                ));
+            }
+
+            // Drop the unreadable tail
+            if (isCorrupted)
+                e->m_NeedsRewrite = true;
+
+            // Entries may have been added while loading
+            if (e->m_NeedsRewrite || !e->m_hPending.isEmpty())
+                e->save(nullptr);
+        });
     });
 
     return true;
@@ -114,46 +356,43 @@ bool LocalNameServiceEditor::save(const ContactMethod* number)
 {
     Q_UNUSED(number)
 
-    if (!m_AsyncMutex.tryLock())
-        return true;
+    if (!m_pSaveTimer->isActive())
+        m_pSaveTimer->start();
 
-    // Do not trash the I/O for nothing, it's just a cache
-    //TODO support append only operations
-    QTimer::singleShot(500, [this]() {
-        m_AsyncMutex.unlock();
+    return true;
+}
 
-        static QString path = QStandardPaths::writableLocation(QStandardPaths::DataLocation)
-            + QLatin1Char('/')
-            + LocalNameServiceCachePrivate::FILENAME;
+/// Write the pending changes in a thread
+void LocalNameServiceEditor::slotFlush()
+{
+    // The names ids are not known yet, load() will flush once it is done
+    if (!m_IsLoadDone)
+        return;
 
-        QFile file(path);
+    const bool rewrite = m_NeedsRewrite;
 
-        if (file.open(QIODevice::WriteOnly | QIODevice::Text) ) {
-            QTextStream stream(&file);
+    const QHash<QByteArray, QString> entries = rewrite ? m_hCache : m_hPending;
 
-            for (auto i = m_hCache.constBegin(); i != m_hCache.constEnd(); i++) {
-                stream
-                    << i.key()
-                    << '\t'
-                    << i.value()
-                    << '\n';
-            }
+    m_hPending.clear();
+    m_NeedsRewrite = false;
 
-            file.close();
-        }
-        else
-            qWarning() << "Unable to save the registered names";
-    });
+    if (entries.isEmpty() && !rewrite)
+        return;
 
-    return true;
+    m_pWorker->run([this, entries, rewrite]() {
+        LocalNameServiceCachePrivate::writeCache(entries, m_hNameIds, rewrite);
+    });
 }
 
 bool LocalNameServiceEditor::remove(const ContactMethod* item)
 {
-    Q_UNUSED(item)
+    const QByteArray ringId = item->uri().format(URI::Section::USER_INFO).toLatin1();
 
-    if (m_hCache.remove(item->uri().format(URI::Section::USER_INFO).toLatin1()))
+    if (m_hCache.remove(ringId)) {
+        m_hPending.remove(ringId);
+        m_NeedsRewrite = true;
         return save(nullptr);
+    }
 
     return false;
 }
@@ -186,7 +425,10 @@ bool LocalNameServiceEditor::addExisting(const ContactMethod* item)
     if (contains(item))
         return true;
 
-    m_hCache[item->uri().format(URI::Section::USER_INFO).toLatin1()] = item->registeredName();
+    const QByteArray ringId = item->uri().format(URI::Section::USER_INFO).toLatin1();
+
+    m_hCache  [ringId] = item->registeredName();
+    m_hPending[ringId] = item->registeredName();
     mediator()->addItem(item);
     return save(item);
 }
@@ -233,9 +475,21 @@ FlagPack<CollectionInterface::SupportedFeatures> LocalNameServiceCache::supporte
 
 bool LocalNameServiceCache::clear()
 {
-    return QFile::remove(QStandardPaths::writableLocation(QStandardPaths::DataLocation)
-                        + QLatin1Char('/')
-                        + LocalNameServiceCachePrivate::FILENAME);
+    auto e = static_cast<LocalNameServiceEditor*>(editor<ContactMethod>());
+
+    e->m_hCache.clear();
+    e->m_hPending.clear();
+    e->m_NeedsRewrite = false;
+
+    // After the pending writes
+    e->m_pWorker->run([e]() {
+        e->m_hNameIds.clear();
+
+        QFile::remove(LocalNameServiceCachePrivate::path(LocalNameServiceCachePrivate::LEGACY_FILENAME));
+        QFile::remove(LocalNameServiceCachePrivate::path(LocalNameServiceCachePrivate::FILENAME));
+    });
+
+    return true;
 }
 
 QByteArray LocalNameServiceCache::id() const
@@ -35,6 +35,8 @@
 #include <private/textrecording_p.h>
 #include <private/contactmethod_p.h>
 #include <media/media.h>
+#include <tracing.h>
+#include <collectionloader.h>
 
 /*
  * This collection store and load the instant messaging conversations. Lets call
@@ -64,6 +66,7 @@ public:
 
     void clearAll();
     void loadStat();
+    QVector<MemoryStatistics::Usage> memoryUsage() const;
 
     virtual QVector<Media::Recording*> items() const override;
 private:
@@ -255,6 +258,22 @@ QVector<Media::Recording*> LocalTextRecordingEditor::items() const
     return m_lNumbers;
 }
 
+QVector<MemoryStatistics::Usage> LocalTextRecordingEditor::memoryUsage() const
+{
+    qint64 bytes = 0, messageBytes = 0;
+    int messages = 0;
+
+    for (const auto recording : qAsConst(m_lNumbers)) {
+        bytes += static_cast<const Media::TextRecording*>(recording)->d_ptr
+            ->estimatedSize(messages, messageBytes);
+    }
+
+    return {
+        { QStringLiteral("TextRecording"), m_lNumbers.size(), bytes        },
+        { QStringLiteral("MimeMessage"  ), messages         , messageBytes },
+    };
+}
+
 QString LocalTextRecordingCollection::name () const
 {
     return QObject::tr("Local text recordings");
@@ -286,13 +305,33 @@ bool LocalTextRecordingCollection::load()
     if (!dir.exists())
         return true;
 
-    const auto list = dir.entryInfoList(
-        {QStringLiteral("*.json")},
-        QDir::Files | QDir::NoSymLinks | QDir::Readable, QDir::Time
-    );
+    typedef QVector< QPair<QString, QJsonObject> > Files;
+
+    // Read and parse the JSON, it doesn't touch the models
+    auto parse = [dir]() {
+        Files ret;
+
+        const auto list = dir.entryInfoList(
+            {QStringLiteral("*.json")},
+            QDir::Files | QDir::NoSymLinks | QDir::Readable, QDir::Time
+        );
 
-    for (const auto& fileInfo : qAsConst(list)) {
-        if (auto r = Media::TextRecording::fromPath(fileInfo.absoluteFilePath(), {}, this)) {
+        ret.reserve(list.size());
+
+        for (const auto& fileInfo : qAsConst(list)) {
+            const QString path = fileInfo.absoluteFilePath();
+            QJsonObject obj;
+
+            if (Media::TextRecordingPrivate::readJson(path, obj))
+                ret << QPair<QString, QJsonObject> {path, obj};
+        }
+
+        return ret;
+    };
+
+    auto publish = [this](const Files& files) {
+        for (const auto& file : qAsConst(files)) {
+            auto r = Media::TextRecording::fromJson({file.second}, file.first, nullptr, this);
 
             // get CMs from recording
             const auto peers = r->peers();
@@ -312,7 +351,17 @@ bool LocalTextRecordingCollection::load()
 
             editor<Media::Recording>()->addExisting(r);
         }
+    };
+
+    // Parse the files in the loader pool, create the recordings in the main thread
+    if (CollectionLoader::instance().isLoading(this)) {
+        CollectionLoader::instance().run(this, [parse, publish]() -> std::function<void()> {
+            const Files files = parse();
+            return [publish, files]() { publish(files); };
+        });
     }
+    else
+        publish(parse());
 
     return true;
 }
@@ -397,7 +446,11 @@ Media::TextRecording* LocalTextRecordingCollection::fetchFor(const ContactMethod
         return nullptr;
 
     QJsonParseError err;
-    QJsonDocument loadDoc = QJsonDocument::fromJson(content.toUtf8(), &err);
+    QJsonDocument loadDoc;
+    {
+        Tracing::Span s("parsing", "TextRecording JSON");
+        loadDoc = QJsonDocument::fromJson(content.toUtf8(), &err);
+    }
 
     if (err.error != QJsonParseError::ParseError::NoError) {
         qWarning() << "Error Decoding Text Message History Json" << err.errorString();
@@ -440,3 +493,10 @@ void LocalTextRecordingCollection::saveEverything() const
         recording->save();
     }
 }
+
+QVector<MemoryStatistics::Usage> LocalTextRecordingCollection::memoryUsage() const
+{
+    return static_cast<const LocalTextRecordingEditor*>(
+        editor<Media::Recording>()
+    )->memoryUsage();
+}
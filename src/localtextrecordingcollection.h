@@ -21,6 +21,7 @@
 #include <collectioneditor.h>
 
 #include <typedefs.h>
+#include <memorystatistics.h>
 
 namespace Media {
    class Recording;
@@ -63,6 +64,9 @@ public:
     */
    void saveEverything() const;
 
+   /// The estimated memory used by the loaded conversations
+   QVector<MemoryStatistics::Usage> memoryUsage() const;
+
    static LocalTextRecordingCollection& instance();
 
 };
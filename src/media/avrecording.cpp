@@ -26,6 +26,7 @@
 //Ring
 #include <callmodel.h>
 #include <media/recordingmodel.h>
+#include <tracing.h>
 
 namespace Media {
 
@@ -297,6 +298,7 @@ void Media::AVRecordingPrivate::notifySeek(int position, int size)
 ///Callback when a recording start
 void RecordingPlaybackManager::slotRecordPlaybackFilepath(const QString& callID, const QString& filepath)
 {
+   TRACE_SCOPE("daemon", "RecordingPlaybackManager::slotRecordPlaybackFilepath");
    //TODO is this method dead code?
    qDebug() << "Playback started" << callID << filepath;
 }
@@ -304,6 +306,7 @@ void RecordingPlaybackManager::slotRecordPlaybackFilepath(const QString& callID,
 ///Callback when a recording stop
 void RecordingPlaybackManager::slotRecordPlaybackStopped(const QString& filepath)
 {
+   TRACE_SCOPE("daemon", "RecordingPlaybackManager::slotRecordPlaybackStopped");
    Media::AVRecording* r = m_hActiveRecordings[filepath];
    if (r) {
       desactivateRecording(r);
@@ -313,6 +316,7 @@ void RecordingPlaybackManager::slotRecordPlaybackStopped(const QString& filepath
 ///Callback when a recording position changed
 void RecordingPlaybackManager::slotUpdatePlaybackScale(const QString& filepath, int position, int size)
 {
+   TRACE_SCOPE("daemon", "RecordingPlaybackManager::slotUpdatePlaybackScale");
    Media::AVRecording* r = m_hActiveRecordings[filepath];
 
    if (r) {
@@ -31,6 +31,7 @@
 #include "mime.h"
 #include "libcard/matrixutils.h"
 #include "account_const.h"
+#include "memorystatistics.h"
 
 namespace Media {
 
@@ -426,6 +427,23 @@ QList<MimeMessage::Payload*> MimeMessage::payloads() const
     return d_ptr->m_lPayloads;
 }
 
+qint64 MimeMessage::estimatedSize() const
+{
+    typedef MemoryStatistics MS;
+
+    qint64 ret = sizeof(MimeMessage) + sizeof(MimeMessagePrivate)
+        + MS::sizeOf(d_ptr->authorSha1    )
+        + MS::sizeOf(d_ptr->m_PlainText   )
+        + MS::sizeOf(d_ptr->m_HTML        )
+        + MS::sizeOf(d_ptr->m_FormattedHtml)
+        + d_ptr->m_LinkList.size() * (sizeof(void*) + sizeof(QUrl));
+
+    for (const auto p : qAsConst(d_ptr->m_lPayloads))
+        ret += sizeof(void*) + sizeof(Payload) + MS::sizeOf(p->payload) + MS::sizeOf(p->mimeType);
+
+    return ret;
+}
+
 void MimeMessage::Payload::read(const QJsonObject &json)
 {
    payload  = json[QStringLiteral("payload") ].toString();
@@ -127,6 +127,9 @@ private:
 
     void write(QJsonObject       &json) const;
 
+    /// The estimated size of the message and its payloads, in bytes
+    qint64 estimatedSize() const;
+
     MimeMessagePrivate* d_ptr;
     Q_DECLARE_PRIVATE(MimeMessage)
 };
@@ -174,6 +174,10 @@ d_ptr(new RecordingModelPrivate(this))
         Q_UNUSED(e);
     });
 
+    MemoryStatistics::instance().addProvider(QStringLiteral("RecordingModel"), this, [this]() {
+        return d_ptr->m_pTextRecordingCollection->memoryUsage();
+    });
+
     d_ptr->initCategories();
 }
 
@@ -17,6 +17,11 @@
  ***************************************************************************/
 #include "text.h"
 
+//Qt
+#include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QPointer>
+
 //Dring
 #include <media_const.h>
 #include "dbus/callmanager.h"
@@ -36,9 +41,11 @@
 #include <private/vcardutils.h>
 #include <private/textrecording_p.h>
 #include <private/imconversationmanagerprivate.h>
+#include <private/threadworker.h>
 #include <peerprofilecollection2.h>
 #include <accountmodel.h>
 #include <personmodel.h>
+#include <tracing.h>
 
 /*
  * Instant message have 3 major modes, "past", "in call" and "offline"
@@ -75,20 +82,47 @@ private:
    Media::Text* q_ptr;
 };
 
+/**
+ * Reassemble the profile vCard sent in parts by CallPrivate::sendProfile().
+ *
+ * Each transfer has a slot per announced part, so the chunks are placed in
+ * O(1) whatever order they arrive in. The number of parts, the size and the
+ * number of concurrent transfers are capped. When the cap is reached, the
+ * least recently active transfer is evicted. Incomplete transfers expire
+ * after TIMEOUT without new chunks.
+ */
 class ProfileChunk
 {
 public:
    //Helper
-   static bool addChunk( const QMap<QString,QString>& args, const QString& payload, ContactMethod *contactMethod);
+   static bool addChunk(const QString& mimeType, const QString& payload, ContactMethod* contactMethod);
 
 private:
+   static constexpr const int MAX_PARTS     = 256       ;
+   static constexpr const int MAX_SIZE      = 512 * 1024; ///< In UTF-16 units
+   static constexpr const int MAX_TRANSFERS = 16        ;
+   static constexpr const int TIMEOUT       = 60 * 1000 ; ///< In milliseconds
+
+   using Key = QPair<ContactMethod*, QString>;
+
    //Attributes
-   QHash<int, QString> m_hParts     {       };
-   int                 m_PartsCount { 0     };
-   static QHash<QString, ProfileChunk*> m_hRequest;
+   QVector<QString>        m_lParts   {   };
+   int                     m_Received { 0 };
+   int                     m_Size     { 0 };
+   qint64                  m_LastSeen { 0 };
+   QPointer<ContactMethod> m_pCM      {   }; ///< Null if the key CM was destroyed
+
+   static QHash<Key, ProfileChunk*> m_hRequest;
+
+   //Helpers
+   static bool parseAttributes(const QString& mimeType, QStringRef& id, int& part, int& total);
+   static qint64 now();
+   static void expire();
+   static void evict();
+   static void import(const QPointer<ContactMethod>& cm, const QVector<QString>& parts, int size);
 };
 
-QHash<QString, ProfileChunk*> ProfileChunk::m_hRequest;
+QHash<ProfileChunk::Key, ProfileChunk*> ProfileChunk::m_hRequest;
 
 IMConversationManagerPrivate::IMConversationManagerPrivate(QObject* parent) : QObject(parent)
 {
@@ -106,36 +140,87 @@ IMConversationManagerPrivate& IMConversationManagerPrivate::instance()
    return *instance;
 }
 
-bool ProfileChunk::addChunk(const QMap<QString, QString>& args, const QString& payload, ContactMethod *contactMethod)
+/**
+ * Parse the "x-ring/ring.profile.vcard; id=1234,part=1,of=3" MIME type
+ * without allocating a string for each attribute.
+ */
+bool ProfileChunk::parseAttributes(const QString& mimeType, QStringRef& id, int& part, int& total)
 {
-    const int total  = args[ QStringLiteral("of")   ].toInt();
-    const int part   = args[ QStringLiteral("part") ].toInt();
-    const QString id = args[ QStringLiteral("id")   ];
+    const int sep = mimeType.indexOf(';');
 
-    auto c = m_hRequest[id];
-    if (!c) {
-        c = new ProfileChunk();
-        c->m_PartsCount = total;
-        m_hRequest[id] = c;
+    if (sep == -1)
+        return false;
+
+    bool hasPart(false), hasTotal(false);
+
+    const auto pairs = mimeType.midRef(sep + 1).split(',');
+
+    for (const QStringRef& p : pairs) {
+        const int eq = p.indexOf('=');
+
+        if (eq == -1)
+            continue;
+
+        const QStringRef k = p.left(eq).trimmed();
+        const QStringRef v = p.mid(eq + 1).trimmed();
+
+        if (k == QLatin1String("id"))
+            id = v;
+        else if (k == QLatin1String("part"))
+            part = v.toInt(&hasPart);
+        else if (k == QLatin1String("of"))
+            total = v.toInt(&hasTotal);
     }
 
-    if (part < 1 and part > total)
-        return false;
+    return hasPart && hasTotal && !id.isEmpty();
+}
+
+qint64 ProfileChunk::now()
+{
+    static QElapsedTimer t;
 
-    c->m_hParts[part] = payload;
+    if (!t.isValid())
+        t.start();
 
-    if (c->m_hParts.size() != c->m_PartsCount)
-        return false;
+    return t.elapsed();
+}
+
+///Drop the transfers without activity for more than TIMEOUT
+void ProfileChunk::expire()
+{
+    const qint64 current = now();
+
+    for (auto i = m_hRequest.begin(); i != m_hRequest.end();) {
+        if (current - (*i)->m_LastSeen >= TIMEOUT) {
+            qWarning() << "Incomplete profile transfer expired" << i.key().second;
+            delete *i;
+            i = m_hRequest.erase(i);
+        }
+        else
+            ++i;
+    }
+}
 
-    QByteArray cv;
-    for (int i=0; i < c->m_PartsCount; ++i) {
-        cv += c->m_hParts[i+1];
+///Drop the least recently active transfer
+void ProfileChunk::evict()
+{
+    auto oldest = m_hRequest.end();
+
+    for (auto i = m_hRequest.begin(); i != m_hRequest.end(); ++i) {
+        if (oldest == m_hRequest.end() || (*i)->m_LastSeen < (*oldest)->m_LastSeen)
+            oldest = i;
     }
 
-    m_hRequest[id] = nullptr;
-    delete c;
+    if (oldest == m_hRequest.end())
+        return;
 
-    // Notify the peer profile collection it has a potentially new entry
+    qWarning() << "Too many profile transfers, dropping" << oldest.key().second;
+    delete *oldest;
+    m_hRequest.erase(oldest);
+}
+
+static PeerProfileCollection2* peerProfileCollection()
+{
     static PeerProfileCollection2* ppc = nullptr;
 
     // The peer profile collection is not mandatory, but should never change
@@ -145,34 +230,134 @@ bool ProfileChunk::addChunk(const QMap<QString, QString>& args, const QString& p
         const auto iter = std::find_if(cols.constBegin(), cols.constEnd(), [](CollectionInterface* c) {
             return c->id() == "ppc";
         });
-        ppc = static_cast<PeerProfileCollection2*>(*iter);
+
+        if (iter != cols.constEnd())
+            ppc = static_cast<PeerProfileCollection2*>(*iter);
     }
 
-    if (ppc)
-        return ppc->importPayload(contactMethod, cv);
+    return ppc;
+}
+
+void ProfileChunk::import(const QPointer<ContactMethod>& cm, const QVector<QString>& parts, int size)
+{
+    // Joining and parsing a vCard with a photo is not free, keep it out of
+    // the main thread. Only the Person creation has to happen there.
+    new ThreadWorker([cm, parts, size]() {
+        QString content;
+        content.reserve(size);
+
+        for (const QString& p : parts)
+            content += p;
+
+        const auto vCard = VCardUtils::toHashMap(content.toUtf8());
+
+        QTimer::singleShot(0, &IMConversationManagerPrivate::instance(), [cm, vCard]() {
+            // The contact method may have been destroyed or merged while parsing
+            if (!cm)
+                return;
 
-    return false;
+            ContactMethod* target = cm->isDuplicate() ?
+                PhoneDirectoryModel::instance().getNumber(cm->uri(), cm->account()) : cm.data();
+
+            // Notify the peer profile collection it has a potentially new entry
+            if (auto ppc = peerProfileCollection())
+                ppc->importPayload(target, vCard);
+        });
+    });
+}
+
+/**
+ * Add a chunk to its transfer.
+ *
+ * @return if the transfer is complete and the profile queued for import
+ */
+bool ProfileChunk::addChunk(const QString& mimeType, const QString& payload, ContactMethod* contactMethod)
+{
+    QStringRef id;
+    int part(0), total(0);
+
+    if ((!parseAttributes(mimeType, id, part, total))
+      || total < 1 || total > MAX_PARTS || part < 1 || part > total) {
+        qWarning() << "Dropping an invalid profile chunk" << mimeType;
+        return false;
+    }
+
+    expire();
+
+    const Key key {contactMethod, id.toString()};
+
+    auto c = m_hRequest.value(key);
+
+    // The CM of this transfer is gone and its address was reused
+    if (c && !c->m_pCM) {
+        delete m_hRequest.take(key);
+        c = nullptr;
+    }
+
+    if (!c) {
+        if (m_hRequest.size() >= MAX_TRANSFERS)
+            evict();
+
+        c = new ProfileChunk();
+        c->m_pCM = contactMethod;
+        c->m_lParts.resize(total);
+        m_hRequest[key] = c;
+
+        // Free abandoned transfers even if no other chunk ever comes
+        QTimer::singleShot(TIMEOUT, &IMConversationManagerPrivate::instance(), &ProfileChunk::expire);
+    }
+    else if (c->m_lParts.size() != total) {
+        qWarning() << "The profile part count changed, dropping" << key.second;
+        delete m_hRequest.take(key);
+        return false;
+    }
+
+    QString& slot = c->m_lParts[part - 1];
+
+    // Null slots are the missing parts, keep empty chunks non-null
+    if (slot.isNull())
+        c->m_Received++;
+
+    c->m_Size += payload.size() - slot.size();
+    slot       = payload.isNull() ? QStringLiteral("") : payload;
+
+    c->m_LastSeen = now();
+
+    if (c->m_Size > MAX_SIZE) {
+        qWarning() << "The profile is too large, dropping" << key.second;
+        delete m_hRequest.take(key);
+        return false;
+    }
+
+    if (c->m_Received != c->m_lParts.size())
+        return false;
+
+    m_hRequest.remove(key);
+
+    import(c->m_pCM, c->m_lParts, c->m_Size);
+
+    delete c;
+
+    return true;
 }
 
 ///Called when a new message is incoming
 void IMConversationManagerPrivate::newMessage(const QString& callId, const QString& from, const QMap<QString,QString>& message)
 {
+   TRACE_SCOPE("daemon", "IMConversationManagerPrivate::newMessage");
    Q_UNUSED(from)
 
    auto call = CallModel::instance().getCall(callId);
    if ((!call) || (!call->peerContactMethod()))
       return;
 
-   static const int profileSize = QString(RingMimes::PROFILE_VCF).size();
-
    //Intercept some messages early, those are intended for internal Ring usage
    QMapIterator<QString, QString> iter(message);
    while (iter.hasNext()) {
       iter.next();
 
-      if (iter.key().left(profileSize) == RingMimes::PROFILE_VCF) {
-         auto args = VCardUtils::parseMimeAttributes(iter.key());
-         ProfileChunk::addChunk(args, iter.value(), call->peerContactMethod());
+      if (iter.key().startsWith(QLatin1String(RingMimes::PROFILE_VCF))) {
+         ProfileChunk::addChunk(iter.key(), iter.value(), call->peerContactMethod());
          return;
       }
    }
@@ -193,6 +378,7 @@ void IMConversationManagerPrivate::newMessage(const QString& callId, const QStri
 
 void IMConversationManagerPrivate::newAccountMessage(const QString& accountId, const QString& from, const QMap<QString,QString>& payloads)
 {
+   TRACE_SCOPE("daemon", "IMConversationManagerPrivate::newAccountMessage");
    if (auto cm = PhoneDirectoryModel::instance().getNumber(from, AccountModel::instance().getById(accountId.toLatin1()))) {
        auto txtRecording = cm->textRecording();
        txtRecording->d_ptr->insertNewMessage(payloads, cm, Media::Media::Direction::IN);
@@ -201,6 +387,7 @@ void IMConversationManagerPrivate::newAccountMessage(const QString& accountId, c
 
 void IMConversationManagerPrivate::accountMessageStatusChanged(const QString& accountId, uint64_t id, const QString& to, int status)
 {
+    TRACE_SCOPE("daemon", "IMConversationManagerPrivate::accountMessageStatusChanged");
     if (auto cm = PhoneDirectoryModel::instance().getNumber(to, AccountModel::instance().getById(accountId.toLatin1()))) {
         auto txtRecording = cm->textRecording();
         txtRecording->d_ptr->accountMessageStatusChanged(id, static_cast<DRing::Account::MessageStates>(status));
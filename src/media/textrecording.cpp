@@ -45,6 +45,8 @@
 #include "dbus/configurationmanager.h"
 #include "private/textrecordingmodel.h"
 #include "localtextrecordingcollection.h"
+#include "tracing.h"
+#include "memorystatistics.h"
 
 //Std
 #include <ctime>
@@ -415,6 +417,31 @@ QList<Serializable::Group*> Media::TextRecordingPrivate::allGroups() const
     return ret;
 }
 
+qint64 Media::TextRecordingPrivate::estimatedSize(int& messageCount, qint64& messageBytes) const
+{
+    typedef MemoryStatistics MS;
+
+    qint64 ret = sizeof(TextRecording) + sizeof(TextRecordingPrivate)
+        + 2 * MS::QOBJECT_OVERHEAD
+        + MS::sizeOfVector(m_lNodes)
+        + MS::sizeOfHash(m_hPendingMessages)
+        + MS::sizeOfHash(m_hMimeTypes);
+
+    for (const auto n : qAsConst(m_lNodes)) {
+        ret += sizeof(::TextMessageNode) + MS::sizeOf(n->m_AuthorSha1);
+
+        if (n->m_pMessage) {
+            messageBytes += n->m_pMessage->estimatedSize();
+            messageCount++;
+        }
+    }
+
+    for (const auto& mime : qAsConst(m_lMimeTypes))
+        ret += sizeof(void*) + MS::sizeOf(mime);
+
+    return ret;
+}
+
 Media::TextRecording* Media::TextRecording::fromJson(const QList<QJsonObject>& items, const QString& path, ContactMethod* cm, CollectionInterface* backend)
 {
 
@@ -504,35 +531,51 @@ Media::TextRecording* Media::TextRecording::fromJson(const QList<QJsonObject>& i
     return t;
 }
 
-Media::TextRecording* Media::TextRecording::fromPath(const QString& path, const Metadata& metadata, CollectionInterface* backend)
+bool Media::TextRecordingPrivate::readJson(const QString& path, QJsonObject& out)
 {
-    Q_UNUSED(metadata)
-
     QString content;
 
     QFile file(path);
 
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         qWarning() << "Could not open text recording json file";
-        return nullptr;
+        return false;
     }
 
     content = QString::fromUtf8(file.readAll());
 
     if (content.isEmpty()) {
         qWarning() << "Text recording file is empty";
-        return nullptr;
+        return false;
     }
 
     QJsonParseError err;
-    QJsonDocument loadDoc = QJsonDocument::fromJson(content.toUtf8(), &err);
+    QJsonDocument loadDoc;
+    {
+        Tracing::Span s("parsing", "TextRecording JSON");
+        loadDoc = QJsonDocument::fromJson(content.toUtf8(), &err);
+    }
 
     if (err.error != QJsonParseError::ParseError::NoError) {
         qWarning() << "Error Decoding Text Message History Json" << err.errorString();
-        return nullptr;
+        return false;
     }
 
-    return fromJson({loadDoc.object()}, path, nullptr, backend);
+    out = loadDoc.object();
+
+    return true;
+}
+
+Media::TextRecording* Media::TextRecording::fromPath(const QString& path, const Metadata& metadata, CollectionInterface* backend)
+{
+    Q_UNUSED(metadata)
+
+    QJsonObject obj;
+
+    if (!TextRecordingPrivate::readJson(path, obj))
+        return nullptr;
+
+    return fromJson({obj}, path, nullptr, backend);
 }
 
 void Media::TextRecordingPrivate::initGroup(MimeMessage::Type t, ContactMethod* cm)
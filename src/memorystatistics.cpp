@@ -0,0 +1,315 @@
+/****************************************************************************
+ *   Copyright (C) 2018 by Bluesystems                                      *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                    *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "memorystatistics.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
+#include <QtCore/QDebug>
+
+//STD
+#include <atomic>
+
+//Ring
+#include "private/nodepool.h"
+
+class MemoryStatisticsPrivate final : public QObject
+{
+    Q_OBJECT
+public:
+    struct ProviderInfo {
+        QString                     m_Subsystem;
+        QPointer<QObject>           m_pOwner   ;
+        MemoryStatistics::Provider  m_Provider ;
+    };
+
+    QVector<ProviderInfo>            m_lProviders;
+    QVector<MemoryStatistics::Entry> m_lEntries  ;
+    QTimer*                          m_pTimer    {nullptr};
+    int                              m_Interval  {0};
+
+    MemoryStatistics* q_ptr;
+
+public Q_SLOTS:
+    void slotDump();
+};
+
+MemoryStatistics::MemoryStatistics() : QAbstractTableModel(QCoreApplication::instance()),
+    d_ptr(new MemoryStatisticsPrivate())
+{
+    d_ptr->q_ptr = this;
+
+    // The chunks also hold the free slots, so the bytes can exceed the live nodes
+    addProvider(QStringLiteral("NodePool"), this, []() {
+        QVector<Usage> ret;
+
+        const auto pools = NodePoolBase::allStatistics();
+
+        for (const auto& p : pools)
+            ret << Usage { QString::fromLatin1(p.name), p.live, p.bytes };
+
+        return ret;
+    });
+}
+
+MemoryStatistics::~MemoryStatistics()
+{
+    delete d_ptr;
+}
+
+MemoryStatistics& MemoryStatistics::instance()
+{
+    static auto m_sInstance = new MemoryStatistics();
+    return *m_sInstance;
+}
+
+QHash<int,QByteArray> MemoryStatistics::roleNames() const
+{
+    static QHash<int, QByteArray> roles = QAbstractItemModel::roleNames();
+    static std::atomic_flag initRoles = ATOMIC_FLAG_INIT;
+
+    if (!initRoles.test_and_set()) {
+        roles[static_cast<int>(Role::SUBSYSTEM)] = "subsystem";
+        roles[static_cast<int>(Role::TYPE     )] = "type"     ;
+        roles[static_cast<int>(Role::COUNT    )] = "count"    ;
+        roles[static_cast<int>(Role::BYTES    )] = "bytes"    ;
+    }
+
+    return roles;
+}
+
+QVariant MemoryStatistics::data(const QModelIndex& index, int role) const
+{
+    if ((!index.isValid()) || index.row() >= d_ptr->m_lEntries.size())
+        return {};
+
+    const auto& e = d_ptr->m_lEntries[index.row()];
+
+    if (role == Qt::DisplayRole) {
+        switch(static_cast<Column>(index.column())) {
+            case Column::SUBSYSTEM:
+                return e.subsystem;
+            case Column::TYPE:
+                return e.usage.type;
+            case Column::COUNT:
+                return e.usage.count;
+            case Column::BYTES:
+                return e.usage.bytes;
+            case Column::COUNT__:
+                break;
+        }
+        return {};
+    }
+
+    switch(role) {
+        case static_cast<int>(Role::SUBSYSTEM):
+            return e.subsystem;
+        case static_cast<int>(Role::TYPE):
+            return e.usage.type;
+        case static_cast<int>(Role::COUNT):
+            return e.usage.count;
+        case static_cast<int>(Role::BYTES):
+            return e.usage.bytes;
+    }
+
+    return {};
+}
+
+int MemoryStatistics::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : d_ptr->m_lEntries.size();
+}
+
+int MemoryStatistics::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(Column::COUNT__);
+}
+
+QVariant MemoryStatistics::headerData(int section, Qt::Orientation o, int role) const
+{
+    if (o != Qt::Horizontal || role != Qt::DisplayRole)
+        return {};
+
+    switch(static_cast<Column>(section)) {
+        case Column::SUBSYSTEM:
+            return tr("Subsystem");
+        case Column::TYPE:
+            return tr("Type");
+        case Column::COUNT:
+            return tr("Objects");
+        case Column::BYTES:
+            return tr("Bytes");
+        case Column::COUNT__:
+            break;
+    }
+
+    return {};
+}
+
+void MemoryStatistics::addProvider(const QString& subsystem, QObject* owner, const Provider& provider)
+{
+    d_ptr->m_lProviders << MemoryStatisticsPrivate::ProviderInfo {
+        subsystem, owner, provider
+    };
+}
+
+void MemoryStatistics::refresh()
+{
+    QVector<Entry> entries;
+
+    for (int i = d_ptr->m_lProviders.size() - 1; i >= 0; i--) {
+        if (!d_ptr->m_lProviders[i].m_pOwner)
+            d_ptr->m_lProviders.remove(i);
+    }
+
+    for (const auto& p : qAsConst(d_ptr->m_lProviders)) {
+        const auto usages = p.m_Provider();
+
+        for (const auto& u : usages)
+            entries << Entry { p.m_Subsystem, u };
+    }
+
+    // Keep the views stable when the rows are the same
+    bool sameRows = entries.size() == d_ptr->m_lEntries.size();
+
+    for (int i = 0; sameRows && i < entries.size(); i++) {
+        sameRows = entries[i].subsystem  == d_ptr->m_lEntries[i].subsystem
+            && entries[i].usage.type == d_ptr->m_lEntries[i].usage.type;
+    }
+
+    if (sameRows) {
+        d_ptr->m_lEntries = entries;
+        if (!entries.isEmpty())
+            emit dataChanged(
+                index(0, 0),
+                index(entries.size() - 1, static_cast<int>(Column::COUNT__) - 1)
+            );
+    }
+    else {
+        beginResetModel();
+        d_ptr->m_lEntries = entries;
+        endResetModel();
+    }
+
+    emit refreshed();
+}
+
+QVector<MemoryStatistics::Entry> MemoryStatistics::entries() const
+{
+    return d_ptr->m_lEntries;
+}
+
+qint64 MemoryStatistics::totalBytes() const
+{
+    qint64 ret = 0;
+
+    for (const auto& e : qAsConst(d_ptr->m_lEntries))
+        ret += e.usage.bytes;
+
+    return ret;
+}
+
+QByteArray MemoryStatistics::toJson() const
+{
+    QJsonArray array;
+
+    for (const auto& e : qAsConst(d_ptr->m_lEntries)) {
+        array.append(QJsonObject {
+            {QStringLiteral("subsystem"), e.subsystem        },
+            {QStringLiteral("type"     ), e.usage.type       },
+            {QStringLiteral("count"    ), e.usage.count      },
+            {QStringLiteral("bytes"    ), e.usage.bytes      },
+        });
+    }
+
+    return QJsonDocument(QJsonObject {
+        {QStringLiteral("timestamp"), QDateTime::currentMSecsSinceEpoch()},
+        {QStringLiteral("total"    ), totalBytes()                       },
+        {QStringLiteral("entries"  ), array                              },
+    }).toJson(QJsonDocument::Compact);
+}
+
+void MemoryStatistics::setDumpInterval(int seconds)
+{
+    d_ptr->m_Interval = std::max(0, seconds);
+
+    if (!d_ptr->m_Interval) {
+        if (d_ptr->m_pTimer)
+            d_ptr->m_pTimer->stop();
+        return;
+    }
+
+    if (!d_ptr->m_pTimer) {
+        d_ptr->m_pTimer = new QTimer(this);
+        connect(d_ptr->m_pTimer, &QTimer::timeout, d_ptr, &MemoryStatisticsPrivate::slotDump);
+    }
+
+    d_ptr->m_pTimer->start(d_ptr->m_Interval * 1000);
+}
+
+int MemoryStatistics::dumpInterval() const
+{
+    return d_ptr->m_Interval;
+}
+
+void MemoryStatisticsPrivate::slotDump()
+{
+    q_ptr->refresh();
+
+    const QByteArray json = q_ptr->toJson();
+
+    qDebug().noquote() << "Memory statistics" << json;
+
+    emit q_ptr->dumped(json);
+}
+
+qint64 MemoryStatistics::sizeOf(const QString& s)
+{
+    // The shared null and empty strings are not allocated
+    if (s.isNull() || !s.capacity())
+        return 0;
+
+    return sizeof(QArrayData) + (s.capacity() + 1) * sizeof(QChar);
+}
+
+qint64 MemoryStatistics::sizeOf(const QByteArray& a)
+{
+    if (a.isNull() || !a.capacity())
+        return 0;
+
+    return sizeof(QArrayData) + a.capacity() + 1;
+}
+
+/// Enable the periodic dump from the environment
+static void initFromEnvironment()
+{
+    bool ok = false;
+    const int interval = qEnvironmentVariableIntValue("LIBRINGQT_MEMORY_STATS", &ok);
+
+    if (ok && interval > 0)
+        MemoryStatistics::instance().setDumpInterval(interval);
+}
+
+Q_COREAPP_STARTUP_FUNCTION(initFromEnvironment)
+
+#include <memorystatistics.moc>
@@ -0,0 +1,156 @@
+/****************************************************************************
+ *   Copyright (C) 2018 by Bluesystems                                      *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                    *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+#include <typedefs.h>
+
+//Qt
+#include <QtCore/QAbstractTableModel>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+//STD
+#include <functional>
+
+class MemoryStatisticsPrivate;
+
+/**
+ * Report how much memory each subsystem uses.
+ *
+ * The models and collections register a provider. When the statistics are
+ * refreshed, each provider returns the number of objects it owns and an
+ * estimate of their size. The estimate includes the QObject overhead and the
+ * QString/QByteArray payloads. It ignores the allocator overhead and counts
+ * implicitly shared data once per reference, so it is an upper bound. It is
+ * meant to find which subsystem grows, not to replace a heap profiler.
+ *
+ * Each row is a (subsystem, object type) pair. The model is only refreshed
+ * when refresh() is called or when the dump interval expires.
+ *
+ * Setting the LIBRINGQT_MEMORY_STATS environment variable to a number of
+ * seconds prints the statistics at that interval. This is intended for the
+ * soak tests.
+ */
+class LIB_EXPORT MemoryStatistics final : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum class Column {
+        SUBSYSTEM,
+        TYPE     ,
+        COUNT    ,
+        BYTES    ,
+        COUNT__
+    };
+
+    enum class Role {
+        SUBSYSTEM = Qt::UserRole + 1,
+        TYPE     ,
+        COUNT    ,
+        BYTES    ,
+    };
+
+    /// The memory used by a type of object
+    struct Usage {
+        QString type ;
+        int     count;
+        qint64  bytes;
+    };
+
+    /// A row of the model
+    struct Entry {
+        QString subsystem;
+        Usage   usage    ;
+    };
+
+    typedef std::function<QVector<Usage>()> Provider;
+
+    /// The estimated size of a QObject and its private object
+    static constexpr const qint64 QOBJECT_OVERHEAD = 136;
+
+    static MemoryStatistics& instance();
+
+    //Model functions
+    virtual QVariant      data       ( const QModelIndex& index, int role = Qt::DisplayRole ) const override;
+    virtual int           rowCount   ( const QModelIndex& parent = {}                       ) const override;
+    virtual int           columnCount( const QModelIndex& parent = {}                       ) const override;
+    virtual QVariant      headerData ( int section, Qt::Orientation, int role = Qt::DisplayRole ) const override;
+    virtual QHash<int,QByteArray> roleNames() const override;
+
+    /**
+     * Add a subsystem to the statistics.
+     *
+     * The provider is removed when the owner is destroyed.
+     */
+    void addProvider(const QString& subsystem, QObject* owner, const Provider& provider);
+
+    /// Query all providers and update the model
+    void refresh();
+
+    QVector<Entry> entries() const;
+    qint64 totalBytes() const;
+
+    /// The last refresh as a JSON document
+    QByteArray toJson() const;
+
+    /**
+     * Refresh and dump the statistics every `seconds`.
+     *
+     * Use 0 to disable. Each dump is printed and emitted as dumped().
+     */
+    void setDumpInterval(int seconds);
+    int dumpInterval() const;
+
+    //Estimation helpers
+    static qint64 sizeOf(const QString& s);
+    static qint64 sizeOf(const QByteArray& a);
+
+    /// The size of the container storage, not of the elements payloads
+    template<typename T>
+    static qint64 sizeOfVector(const T& container);
+
+    template<typename K, typename V>
+    static qint64 sizeOfHash(const QHash<K, V>& hash);
+
+Q_SIGNALS:
+    void refreshed();
+    void dumped(const QByteArray& json);
+
+private:
+    explicit MemoryStatistics();
+    virtual ~MemoryStatistics();
+
+    MemoryStatisticsPrivate* d_ptr;
+    Q_DECLARE_PRIVATE(MemoryStatistics)
+};
+
+template<typename T>
+qint64 MemoryStatistics::sizeOfVector(const T& container)
+{
+    return container.capacity() * sizeof(typename T::value_type);
+}
+
+template<typename K, typename V>
+qint64 MemoryStatistics::sizeOfHash(const QHash<K, V>& hash)
+{
+    // Each node holds the next pointer, the hash, the key and the value
+    return hash.capacity() * sizeof(void*)
+        + hash.size() * (sizeof(void*) + sizeof(uint) + sizeof(K) + sizeof(V));
+}
+
+Q_DECLARE_METATYPE(MemoryStatistics*)
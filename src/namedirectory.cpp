@@ -17,14 +17,36 @@
  ***************************************************************************/
 
 #include "namedirectory.h"
+
+//Qt
+#include <QtCore/QTimer>
+#include <QtCore/QDateTime>
+
+//Ring
 #include "accountmodel.h"
 #include "private/namedirectory_p.h"
 #include "dbus/configurationmanager.h"
+#include "tracing.h"
+
+constexpr const int    NameDirectoryPrivate::DEBOUNCE_DELAY;
+constexpr const int    NameDirectoryPrivate::CACHE_SIZE;
+constexpr const qint64 NameDirectoryPrivate::POSITIVE_TTL;
+constexpr const qint64 NameDirectoryPrivate::NEGATIVE_TTL;
+constexpr const qint64 NameDirectoryPrivate::IN_FLIGHT_TIMEOUT;
 
 NameDirectoryPrivate::NameDirectoryPrivate(NameDirectory* q) : q_ptr(q)
 {
     ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
 
+    m_fLookupName = [](const QString& accountId, const QString& nameServiceURL, const QString& name) {
+        return ConfigurationManager::instance().lookupName(accountId, nameServiceURL, name);
+    };
+
+    m_pDebounceTimer = new QTimer(this);
+    m_pDebounceTimer->setSingleShot(true);
+    m_pDebounceTimer->setInterval(DEBOUNCE_DELAY);
+    connect(m_pDebounceTimer, &QTimer::timeout, this, &NameDirectoryPrivate::slotFlushLookups);
+
     connect(&configurationManager, &ConfigurationManagerInterface::nameRegistrationEnded, this,
             &NameDirectoryPrivate::slotNameRegistrationEnded, Qt::QueuedConnection);
     connect(&configurationManager, &ConfigurationManagerInterface::registeredNameFound, this,
@@ -45,6 +67,7 @@ NameDirectory& NameDirectory::instance()
 //Name registration ended
 void NameDirectoryPrivate::slotNameRegistrationEnded(const QString& accountId, int status, const QString& name)
 {
+    TRACE_SCOPE("daemon", "NameDirectoryPrivate::slotNameRegistrationEnded");
     qDebug() << "Name registration ended. Account:" << accountId << "status:" << status << "name:" << name;
 
    Account* account = AccountModel::instance().getById(accountId.toLatin1());
@@ -62,6 +85,7 @@ void NameDirectoryPrivate::slotNameRegistrationEnded(const QString& accountId, i
 //Registered Name found
 void NameDirectoryPrivate::slotRegisteredNameFound(const QString& accountId, int status, const QString& address, const QString& name)
 {
+    TRACE_SCOPE("daemon", "NameDirectoryPrivate::slotRegisteredNameFound");
     if (name.isEmpty())
         return;
 
@@ -79,18 +103,174 @@ void NameDirectoryPrivate::slotRegisteredNameFound(const QString& accountId, int
             break;
     }
 
+    const auto st = static_cast<NameDirectory::LookupStatus>(status);
+
+    // Find the requests this reply is for
+    QVector<NameKey> keys;
+    QSet<QString> waiters;
+
+    for (auto i = m_hInFlight.constBegin(); i != m_hInFlight.constEnd(); ++i) {
+        if (i.key().second == name && i.value().accountIds.contains(accountId)) {
+            keys << i.key();
+            waiters += i.value().accountIds;
+        }
+    }
+
+    // Sent by someone else, assume the default name service was used
+    if (keys.isEmpty())
+        keys << key(AccountModel::instance().getById(accountId.toLatin1()), {}, name);
+
+    waiters.insert(accountId);
+
+    // Network errors are transient, everything else is worth remembering
+    for (const auto& k : qAsConst(keys)) {
+        m_hInFlight.remove(k);
+
+        if (st == NameDirectory::LookupStatus::ERROR)
+            continue;
+
+        const bool success = st == NameDirectory::LookupStatus::SUCCESS;
+
+        m_Cache.insert(k, new CachedName {
+            address,
+            st,
+            QDateTime::currentMSecsSinceEpoch() + (success ? POSITIVE_TTL : NEGATIVE_TTL)
+        });
+    }
+
+    for (const auto& id : qAsConst(waiters))
+        emitRegisteredNameFound(id, st, address, name);
+}
+
+void NameDirectoryPrivate::emitRegisteredNameFound(const QString& accountId, NameDirectory::LookupStatus status, const QString& address, const QString& name)
+{
     Account* account = AccountModel::instance().getById(accountId.toLatin1());
 
-    emit q_ptr->registeredNameFound(account, static_cast<NameDirectory::LookupStatus>(status), address, name);
+    emit q_ptr->registeredNameFound(account, status, address, name);
 
     if (account) {
-        emit account->registeredNameFound(static_cast<NameDirectory::LookupStatus>(status), address, name);
+        emit account->registeredNameFound(status, address, name);
     }
     else {
         qWarning() << "registered name found for unknown account" << accountId;
     }
 }
 
+NameDirectoryPrivate::NameKey NameDirectoryPrivate::key(const Account* account, const QString& nameServiceURL, const QString& name)
+{
+    // An empty URL means the daemon uses the one from the account
+    if (nameServiceURL.isEmpty() && account)
+        return { account->nameServiceURL(), name };
+
+    return { nameServiceURL, name };
+}
+
+/**
+ * The account used when none is specified.
+ *
+ * Both the cache and the daemon requests use it, so a cached reply is
+ * emitted for the same account as the one from the daemon.
+ */
+const Account* NameDirectoryPrivate::lookupAccount(const Account* account)
+{
+    if (account)
+        return account;
+
+    return AccountModel::instance().findAccountIf([](const Account& a) {
+        return a.protocol() == Account::Protocol::RING;
+    });
+}
+
+/// Get the cache entry if it exists and didn't expire
+const NameDirectoryPrivate::CachedName* NameDirectoryPrivate::cached(const NameKey& k)
+{
+    const CachedName* ret = m_Cache.object(k);
+
+    if (ret && ret->expiry < QDateTime::currentMSecsSinceEpoch()) {
+        m_Cache.remove(k);
+        return nullptr;
+    }
+
+    return ret;
+}
+
+/**
+ * Send the lookup unless the same one is already in flight. In that case the
+ * account is added to the ones waiting for the reply.
+ *
+ * @return the daemon result, or true if the request was merged
+ */
+bool NameDirectoryPrivate::sendLookup(const QString& accountId, const QString& nameServiceURL, const NameKey& k)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    auto inFlight = m_hInFlight.find(k);
+
+    if (inFlight != m_hInFlight.end() && now - inFlight->sentAt < IN_FLIGHT_TIMEOUT) {
+        m_Stats.coalesced++;
+        inFlight->accountIds.insert(accountId);
+        return true;
+    }
+
+    m_hInFlight[k] = { now, { accountId } };
+    m_Stats.requests++;
+
+    const bool ret = m_fLookupName(accountId, nameServiceURL, k.second);
+
+    if (!ret)
+        m_hInFlight.remove(k);
+
+    return ret;
+}
+
+/**
+ * Add a prefix lookup to the queue.
+ *
+ * When the user is typing, each new prefix supersedes the previous one for
+ * the same account, so only the last one is sent once the typing stops.
+ */
+void NameDirectoryPrivate::queueLookup(const QString& accountId, const QString& name)
+{
+    for (auto& pending : m_lPending) {
+        if (pending.accountId != accountId)
+            continue;
+
+        if (pending.name == name) {
+            m_Stats.coalesced++;
+            return;
+        }
+
+        if (name.startsWith(pending.name) || pending.name.startsWith(name)) {
+            m_Stats.coalesced++;
+            pending.name = name;
+            m_pDebounceTimer->start();
+            return;
+        }
+    }
+
+    m_lPending << PendingLookup { accountId, name };
+    m_pDebounceTimer->start();
+}
+
+void NameDirectoryPrivate::slotFlushLookups()
+{
+    const auto pending = m_lPending;
+    m_lPending.clear();
+
+    for (const auto& l : qAsConst(pending)) {
+        const auto a = AccountModel::instance().getById(l.accountId.toLatin1());
+        const auto k = key(a, {}, l.name);
+
+        // It may have been received in the meantime
+        if (auto c = cached(k)) {
+            emitRegisteredNameFound(l.accountId, c->status, c->address, l.name);
+            continue;
+        }
+
+        sendLookup(l.accountId, {}, k);
+    }
+}
+
 //Register a name
 bool NameDirectory::registerName(const Account* account, const QString& password, const QString& name) const
 {
@@ -106,8 +286,68 @@ bool NameDirectory::lookupName(const Account* account, const QString& nameServic
     if (account && account->protocol() != Account::Protocol::RING)
         return false;
 
-    QString accountId = account ? account->id() : QString();
-    return ConfigurationManager::instance().lookupName(accountId, nameServiceURL, name);
+    account = NameDirectoryPrivate::lookupAccount(account);
+
+    const QString accountId = account ? account->id() : QString();
+    const auto    k         = NameDirectoryPrivate::key(account, nameServiceURL, name);
+
+    if (auto c = d_ptr->cached(k)) {
+        d_ptr->m_Stats.hits++;
+
+        // Keep the same asynchronous semantic as the daemon
+        const NameDirectoryPrivate::CachedName entry = *c;
+        auto d = d_ptr;
+        QTimer::singleShot(0, d_ptr, [d, accountId, entry, name]() {
+            d->emitRegisteredNameFound(accountId, entry.status, entry.address, name);
+        });
+
+        return true;
+    }
+
+    d_ptr->m_Stats.misses++;
+
+    return d_ptr->sendLookup(accountId, nameServiceURL, k);
+}
+
+void NameDirectory::lookupNamePrefix(const Account* account, const QString& name) const
+{
+    Q_ASSERT(!name.isEmpty());
+
+    if (account && account->protocol() != Account::Protocol::RING)
+        return;
+
+    account = NameDirectoryPrivate::lookupAccount(account);
+
+    if (d_ptr->cached(NameDirectoryPrivate::key(account, {}, name))) {
+        d_ptr->m_Stats.hits++;
+        return;
+    }
+
+    d_ptr->m_Stats.misses++;
+    d_ptr->queueLookup(account ? account->id() : QString(), name);
+}
+
+bool NameDirectory::cachedLookup(const Account* account, const QString& name, LookupStatus* status, QString* address) const
+{
+    const auto c = d_ptr->cached(NameDirectoryPrivate::key(
+        NameDirectoryPrivate::lookupAccount(account), {}, name
+    ));
+
+    if (!c)
+        return false;
+
+    if (status)
+        *status = c->status;
+
+    if (address)
+        *address = c->address;
+
+    return true;
+}
+
+NameDirectory::LookupStatistics NameDirectory::lookupStatistics() const
+{
+    return d_ptr->m_Stats;
 }
 
 //Lookup an address
@@ -26,6 +26,8 @@ class Account;
 class LIB_EXPORT NameDirectory : public QObject
 {
     Q_OBJECT
+
+    friend class NameDirectoryTest; // Replace the daemon lookups
 public:
 
     //Register name status
@@ -47,6 +49,14 @@ public:
     };
     Q_ENUMS(LookupStatus)
 
+    /// Counters to evaluate the efficiency of the lookup cache
+    struct LookupStatistics {
+        int hits      {0}; /*!< Answered from the cache (positive or negative)  */
+        int misses    {0}; /*!< Not in the cache, a request is sent or queued   */
+        int coalesced {0}; /*!< Duplicated or superseded requests merged        */
+        int requests  {0}; /*!< Requests actually sent to the daemon            */
+    };
+
     //Singleton
     static NameDirectory& instance();
 
@@ -55,6 +65,27 @@ public:
     Q_INVOKABLE bool lookupAddress (const Account* account, const QString& nameServiceURL, const QString& address ) const;
     Q_INVOKABLE bool registerName  (const Account* account, const QString& password,       const QString& name    ) const;
 
+    /**
+     * Lookup a name while the user is typing it.
+     *
+     * The request is delayed until the typing stops and is superseded by a
+     * longer (or shorter) prefix for the same account. Only use it when the
+     * result of the intermediate prefixes doesn't matter.
+     */
+    void lookupNamePrefix(const Account* account, const QString& name) const;
+
+    /**
+     * Get the result of a previous lookup without contacting the daemon.
+     *
+     * The results are cached per name service, the one of `account` (or of
+     * the first Ring account if it is null) is used.
+     *
+     * @return false if the name is not in the cache (or it expired)
+     */
+    bool cachedLookup(const Account* account, const QString& name, LookupStatus* status = nullptr, QString* address = nullptr) const;
+
+    LookupStatistics lookupStatistics() const;
+
 private:
     //Constructors & Destructors
     explicit NameDirectory ();
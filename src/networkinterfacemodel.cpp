@@ -76,13 +76,13 @@ QHash<int,QByteArray> NetworkInterfaceModel::roleNames() const
 ///Return the account local interface
 QString NetworkInterfaceModelPrivate::localInterface() const
 {
-   return m_pAccount->d_ptr->accountDetail(DRing::Account::ConfProperties::LOCAL_INTERFACE);
+   return m_pAccount->d_ptr->accountDetail(AccountDetails::Key::LOCAL_INTERFACE);
 }
 
 ///Set the local interface
 void NetworkInterfaceModelPrivate::setLocalInterface(const QString& detail)
 {
-   m_pAccount->d_ptr->setAccountProperty(DRing::Account::ConfProperties::LOCAL_INTERFACE, detail);
+   m_pAccount->d_ptr->setAccountProperty(AccountDetails::Key::LOCAL_INTERFACE, detail);
 }
 
 //Model functions
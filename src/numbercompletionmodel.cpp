@@ -20,7 +20,6 @@
 //Qt
 #include <QtCore/QCoreApplication>
 #include <QtCore/QItemSelectionModel>
-#include <QtCore/QTimer>
 
 //System
 #include <cmath>
@@ -41,6 +40,7 @@
 #include "namedirectory.h"
 #include "person.h"
 #include "libcard/matrixutils.h"
+#include "tracing.h"
 
 //Private
 #include "private/phonedirectorymodel_p.h"
@@ -78,7 +78,6 @@ public:
    bool                          m_DisplayMostUsedNumbers;
    QItemSelectionModel*          m_pSelectionModel       ;
    bool                          m_HasCustomSelection    ;
-   QHash<QString, QString>       m_hNameCache            ;
 
    QHash<Account*,TemporaryContactMethod*> m_hSipTemporaryNumbers;
    QHash<Account*,TemporaryContactMethod*> m_hRingTemporaryNumbers;
@@ -100,7 +99,6 @@ public Q_SLOTS:
    void slotSelectionChanged(const QModelIndex& sel, const QModelIndex& prev);
 
    void slotRegisteredNameFound(const Account* account, NameDirectory::LookupStatus status, const QString& address, const QString& name);
-   void slotClearNameCache();
 
 private:
    NumberCompletionModel* q_ptr;
@@ -134,11 +132,6 @@ m_pSelectionModel(nullptr),m_HasCustomSelection(false)
 
    connect(&NameDirectory::instance(), &NameDirectory::registeredNameFound,
       this, &NumberCompletionModelPrivate::slotRegisteredNameFound);
-
-   auto t = new QTimer(this);
-   t->setInterval(5 * 60 * 1000);
-   connect(t, &QTimer::timeout, this, &NumberCompletionModelPrivate::slotClearNameCache);
-   t->start();
 }
 
 NumberCompletionModel::NumberCompletionModel() : QAbstractTableModel(&PhoneDirectoryModel::instance()), d_ptr(new NumberCompletionModelPrivate(this))
@@ -195,6 +188,8 @@ QHash<int,QByteArray> NumberCompletionModel::roleNames() const
 
 QVariant NumberCompletionModel::data(const QModelIndex& index, int role ) const
 {
+   Tracing::Span s("model", "NumberCompletionModel::data");
+
    if (!index.isValid())
       return QVariant();
 
@@ -312,6 +307,8 @@ bool NumberCompletionModel::setData(const QModelIndex& index, const QVariant &va
 
 void NumberCompletionModelPrivate::setPrefix(const QString& str)
 {
+    Tracing::Span s("completion", "NumberCompletionModel::setPrefix");
+
     if ((!str.isEmpty()) && !CallModel::instance().hasDialingCall()) {
         m_Prefix.clear();
         if (auto c = CallModel::instance().dialingCall()) {
@@ -350,16 +347,21 @@ void NumberCompletionModelPrivate::setPrefix(const QString& str)
             if (cm->account()->registrationState() != Account::RegistrationState::READY)
                 continue;
 
-            if (m_hNameCache.contains(m_Prefix) && m_hNameCache[m_Prefix] != QLatin1String("-1")) {
-                cm->setUri(m_hNameCache[m_Prefix]);
+            NameDirectory::LookupStatus status;
+            QString address;
+            const bool isCached = NameDirectory::instance().cachedLookup(cm->account(), m_Prefix, &status, &address);
+
+            if (isCached && status == NameDirectory::LookupStatus::SUCCESS) {
+                cm->setUri(address);
                 cm->setRegisteredName(m_Prefix);
             }
             else
                 cm->setUri(m_Prefix);
 
-            // Perform name lookups
-            if (str.size() >=3 && !m_hNameCache.contains(str))
-                NameDirectory::instance().lookupName(cm->account(), {}, str);
+            // Perform name lookups, NameDirectory takes care of debouncing
+            // and merging the requests while the user is typing
+            if (str.size() >=3)
+                NameDirectory::instance().lookupNamePrefix(cm->account(), str);
         }
     }
 
@@ -416,6 +418,8 @@ QPair<bool, bool> NumberCompletionModelPrivate::matchSipAndRing(const URI& uri)
 
 void NumberCompletionModelPrivate::updateModel()
 {
+   Tracing::Span s("completion", "NumberCompletionModel::updateModel");
+
    QSet<ContactMethod*> numbers;
    q_ptr->beginRemoveRows({}, 0, m_hNumbers.size()-1);
    m_hNumbers.clear();
@@ -738,11 +742,6 @@ void NumberCompletionModelPrivate::slotRegisteredNameFound(const Account* accoun
     // Check if there's a match
     for (TemporaryContactMethod* cm : qAsConst(m_hRingTemporaryNumbers)) {
         if (cm->uri() == name) {
-
-            // Cache the names for up to 5 minutes to prevent useless deaemon calls
-            m_hNameCache[name] = status == NameDirectory::LookupStatus::SUCCESS ?
-                address : QStringLiteral("-1");
-
             if (status == NameDirectory::LookupStatus::SUCCESS) {
                 cm->setUri(address);
                 cm->setRegisteredName(name);
@@ -759,11 +758,6 @@ void NumberCompletionModelPrivate::slotRegisteredNameFound(const Account* accoun
         updateModel();
 }
 
-void NumberCompletionModelPrivate::slotClearNameCache()
-{
-    m_hNameCache.clear();
-}
-
 NumberCompletionModel::LookupStatus NumberCompletionModelPrivate::entryStatus(const ContactMethod* cm) const
 {
     if (cm->type() == ContactMethod::Type::TEMPORARY) {
@@ -773,8 +767,10 @@ NumberCompletionModel::LookupStatus NumberCompletionModelPrivate::entryStatus(co
         if (!cm->registeredName().isEmpty())
             return NumberCompletionModel::LookupStatus::SUCCESS;
 
-        if (m_hNameCache.contains(cm->uri())) {
-            return m_hNameCache[cm->uri()] == QLatin1String("-1") ?
+        NameDirectory::LookupStatus status;
+
+        if (NameDirectory::instance().cachedLookup(cm->account(), cm->uri(), &status)) {
+            return status != NameDirectory::LookupStatus::SUCCESS ?
                 NumberCompletionModel::LookupStatus::FAILURE:
                 NumberCompletionModel::LookupStatus::SUCCESS;
         }
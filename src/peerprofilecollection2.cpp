@@ -111,9 +111,14 @@ void PeerProfileCollection2Private::quickMerge(Person* source, Person* target) c
         }
     }
 
-    if (target->photo().isNull() && !source->photo().isNull()) {
+    if ((!target->hasPhoto()) && source->hasPhoto()) {
         changed = true;
-        target->setPhoto(source->photo());
+
+        // Keep it encoded
+        if (source->d_ptr->m_PhotoData.isEmpty())
+            target->setPhoto(source->d_ptr->m_vPhoto);
+        else
+            target->setPhoto(source->d_ptr->m_PhotoData, source->d_ptr->m_PhotoType);
     }
 
     QSet<QString> dedup;
@@ -179,7 +184,17 @@ void PeerProfileCollection2Private::mergePersons(Person* source, ContactMethod*
 ///We cannot trust the UID in the vCard for uniqueness. We can only rely on the RingID to be unique.
 bool PeerProfileCollection2::importPayload(ContactMethod* cm, const QByteArray& payload)
 {
-    auto person = VCardUtils::mapToPerson(payload, true);
+    return importPayload(cm, VCardUtils::toHashMap(payload));
+}
+
+/**
+ * Same as above, but with a vCard already parsed by VCardUtils::toHashMap.
+ *
+ * This allows the parsing to be done in a worker thread.
+ */
+bool PeerProfileCollection2::importPayload(ContactMethod* cm, const QHash<QByteArray, QByteArray>& vCard)
+{
+    auto person = VCardUtils::mapToPersonFromHash(vCard, true);
 
     if (Q_UNLIKELY(!person)) {
         qWarning() << "Expected a vCard, but got something else";
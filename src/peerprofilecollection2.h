@@ -75,6 +75,7 @@ public:
     MergeOption mergeOption(Person::Role);
 
     bool importPayload(ContactMethod* cm, const QByteArray& payload);
+    bool importPayload(ContactMethod* cm, const QHash<QByteArray, QByteArray>& vCard);
 
 private:
     PeerProfileCollection2Private* d_ptr;
@@ -29,12 +29,16 @@
 #include <individual.h>
 #include <phonedirectorymodel.h>
 #include <historytimecategorymodel.h>
+#include <tracing.h>
+#include <private/nodepool.h>
 
 #define NEVER static_cast<int>(HistoryTimeCategoryModel::HistoryConst::Never)
 class SummaryModel;
 
 struct ITLNode final
 {
+    NODE_POOL_ALLOCATED(ITLNode)
+
     enum InsertStatus {
         NEW = -1
     };
@@ -143,6 +147,8 @@ QHash<int,QByteArray> PeersTimelineModel::roleNames() const
 
 QVariant PeersTimelineModel::data( const QModelIndex& idx, int role) const
 {
+    Tracing::Span s("model", "PeersTimelineModel::data");
+
     if ((!idx.isValid()) || (idx.column() && role != Qt::DisplayRole))
         return {};
 
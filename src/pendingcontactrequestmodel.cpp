@@ -35,6 +35,7 @@
 #include "private/vcardutils.h"
 #include "dbus/configurationmanager.h"
 #include "uri.h"
+#include "tracing.h"
 
 
 class IncomingContactRequestManager : public QObject
@@ -257,6 +258,7 @@ PendingContactRequestModel::findContactRequestFrom(const ContactMethod* cm) cons
 ///When a Ring-DHT trust request arrive
 void IncomingContactRequestManager::slotIncomingContactRequest(const QString& accountId, const QString& ringID, const QByteArray& payload, time_t time)
 {
+   TRACE_SCOPE("daemon", "IncomingContactRequestManager::slotIncomingContactRequest");
    Q_UNUSED(payload);
 
    auto a = AccountModel::instance().getById(accountId.toLatin1());
@@ -281,6 +283,7 @@ void IncomingContactRequestManager::slotIncomingContactRequest(const QString& ac
 
 void IncomingContactRequestManager::slotContactAdded(const QString& accountId, const QString& hash, bool confirm)
 {
+    TRACE_SCOPE("daemon", "IncomingContactRequestManager::slotContactAdded");
     auto a = AccountModel::instance().getById(accountId.toLatin1());
 
     if (!a) {
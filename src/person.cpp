@@ -21,7 +21,10 @@
 #include "person.h"
 
 //Qt
+#include <QtCore/QCache>
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QDateTime>
+#include <QtCore/QMutex>
 
 //Ring library
 #include "contactmethod.h"
@@ -50,6 +53,58 @@
 // Std
 #include <random>
 
+/**
+ * The decoded photos, shared by all persons.
+ *
+ * The persons keep their photo encoded until it is displayed. Many profiles
+ * received from peers use the same avatar, so the decoded photos are indexed
+ * by their content hash and decoded only once. The persons are used by the
+ * collection loader threads too, the cache is locked.
+ *
+ * It is never deleted, the pixmaps cannot outlive the QGuiApplication.
+ */
+static QCache<QByteArray, QVariant>& photoCache()
+{
+    static auto cache = new QCache<QByteArray, QVariant>(64*1024*1024);
+    return *cache;
+}
+
+static QMutex s_PhotoCacheMutex;
+
+QVariant PersonPrivate::decodedPhoto()
+{
+    if (m_PhotoData.isEmpty())
+        return m_vPhoto;
+
+    if (m_PhotoHash.isEmpty()) {
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(m_PhotoType);
+        hash.addData(m_PhotoData);
+        m_PhotoHash = hash.result();
+    }
+
+    { // mutex
+    QMutexLocker l(&s_PhotoCacheMutex);
+
+    if (const QVariant* photo = photoCache().object(m_PhotoHash))
+        return *photo;
+    } // mutex
+
+    auto& manipulator = GlobalInstances::pixmapManipulator();
+
+    const QVariant photo = manipulator.personPhoto(m_PhotoData, m_PhotoType);
+
+    // When the implementation doesn't know, assume the decoded photo is about
+    // the size of the (base64) payload
+    const int pixmapCost = manipulator.pixmapCost(photo);
+    const int cost       = pixmapCost > 0 ? pixmapCost : m_PhotoData.size();
+
+    QMutexLocker l(&s_PhotoCacheMutex);
+    photoCache().insert(m_PhotoHash, new QVariant(photo), cost);
+
+    return photo;
+}
+
 QString PersonPrivate::filterString()
 {
     if (m_CachedFilterString.size())
@@ -183,6 +238,9 @@ Person::Person(const Person& other) noexcept : ItemBase(&PersonModel::instance()
    d_ptr->m_SecondName           = other.d_ptr->m_SecondName          ;
    d_ptr->m_NickName             = other.d_ptr->m_NickName            ;
    d_ptr->m_vPhoto               = other.d_ptr->m_vPhoto              ;
+   d_ptr->m_PhotoData            = other.d_ptr->m_PhotoData           ;
+   d_ptr->m_PhotoType            = other.d_ptr->m_PhotoType           ;
+   d_ptr->m_PhotoHash            = other.d_ptr->m_PhotoHash           ;
    d_ptr->m_FormattedName        = other.d_ptr->m_FormattedName       ;
    d_ptr->m_PreferredEmail       = other.d_ptr->m_PreferredEmail      ;
    d_ptr->m_Organization         = other.d_ptr->m_Organization        ;
@@ -237,10 +295,16 @@ QString Person::secondName() const
    return d_ptr->m_SecondName;
 }
 
-///Get the photo
+///Get the photo, it is decoded when first used
 QVariant Person::photo() const
 {
-   return d_ptr->m_vPhoto;
+   return d_ptr->decodedPhoto();
+}
+
+///Return if there is a photo, without decoding it
+bool Person::hasPhoto() const
+{
+   return (!d_ptr->m_PhotoData.isEmpty()) || !d_ptr->m_vPhoto.isNull();
 }
 
 ///Get the formatted name
@@ -355,6 +419,24 @@ void Person::setFamilyName(const QString& name)
 void Person::setPhoto(const QVariant& photo)
 {
    d_ptr->m_vPhoto = photo;
+   d_ptr->m_PhotoData.clear();
+   d_ptr->m_PhotoType.clear();
+   d_ptr->m_PhotoHash.clear();
+   d_ptr->changed();
+   d_ptr->photoChanged();
+}
+
+/**
+ * Set the photo as found in a vCard.
+ *
+ * It is only decoded by the PixmapManipulator when it is displayed.
+ */
+void Person::setPhoto(const QByteArray& data, const QByteArray& type)
+{
+   d_ptr->m_vPhoto    = QVariant();
+   d_ptr->m_PhotoData = data;
+   d_ptr->m_PhotoType = type;
+   d_ptr->m_PhotoHash.clear();
    d_ptr->changed();
    d_ptr->photoChanged();
 }
@@ -785,7 +867,11 @@ const QByteArray Person::toVCard(QList<Account*> accounts) const
         maker.addProperty(VCardUtils::Property::X_RINGACCOUNT, acc->id());
     }
 
-    maker.addPhoto(GlobalInstances::pixmapManipulator().toByteArray(photo()));
+    // Avoid decoding and encoding the image again when it is already a PNG
+    if ((!d_ptr->m_PhotoData.isEmpty()) && d_ptr->m_PhotoType.toUpper() == "PNG")
+        maker.addPhoto(QByteArray::fromBase64(d_ptr->m_PhotoData));
+    else
+        maker.addPhoto(GlobalInstances::pixmapManipulator().toByteArray(photo()));
     return maker.endVCard();
 }
 
@@ -50,6 +50,7 @@ class LIB_EXPORT Person : public ItemBase
    friend class ContactMethod;
    friend class Individual;
    friend class PeerProfileCollection2Private; //FIXME ugly memory leak, but not enough time to fix
+   friend class PersonModelPrivate; // Memory statistics
 
 public:
 
@@ -137,6 +138,7 @@ public:
    QByteArray uid           () const;
    QString preferredEmail   () const;
    QVariant photo           () const;
+   bool    hasPhoto         () const;
    QString group            () const;
    QString department       () const;
    bool    isProfile        () const;
@@ -180,6 +182,7 @@ public:
    void setDepartment     ( const QString&    name   );
    void setUid            ( const QByteArray& id     );
    void setPhoto          ( const QVariant&   photo  );
+   void setPhoto          ( const QByteArray& data, const QByteArray& type);
    void ensureUid         (                          );
 
    //Updates an existing contact from vCard info
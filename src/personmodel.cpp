@@ -34,6 +34,8 @@
 #include "individual.h"
 #include "transitionalpersonbackend.h"
 #include "peerprofilecollection2.h"
+#include "memorystatistics.h"
+#include "private/person_p.h"
 
 //Qt
 #include <QtCore/QHash>
@@ -74,6 +76,9 @@ public:
    QHash<QByteArray,Person*> m_hPersonsByUid;
    std::vector<std::unique_ptr<PersonItemNode>> m_lPersons;
 
+   //Helpers
+   QVector<MemoryStatistics::Usage> memoryUsage() const;
+
 private:
    PersonModel* q_ptr;
 //    void slotPersonAdded(Person* c);
@@ -104,6 +109,10 @@ PersonModel::PersonModel(QObject* par) : QAbstractItemModel(par?par:QCoreApplica
 d_ptr(new PersonModelPrivate(this))
 {
    setObjectName(QStringLiteral("PersonModel"));
+
+   MemoryStatistics::instance().addProvider(QStringLiteral("PersonModel"), this, [this]() {
+      return d_ptr->memoryUsage();
+   });
 }
 
 ///Destructor
@@ -118,6 +127,48 @@ PersonModel& PersonModel::instance()
     return *instance;
 }
 
+/**
+ * Estimate the memory used by the persons.
+ *
+ * The photos are counted only when they are still encoded. Once decoded by
+ * the PixmapManipulator, they belong to the client (and to the shared photo
+ * cache).
+ */
+QVector<MemoryStatistics::Usage> PersonModelPrivate::memoryUsage() const
+{
+   typedef MemoryStatistics MS;
+
+   qint64 bytes = MS::sizeOfHash(m_hPersonsByUid) + MS::sizeOfHash(m_hPlaceholders);
+
+   for (const auto& node : m_lPersons) {
+      const Person* p = node->m_pPerson;
+
+      bytes += sizeof(PersonItemNode) + sizeof(Person) + sizeof(PersonPrivate)
+         + 2 * MS::QOBJECT_OVERHEAD
+         + MS::sizeOf(p->firstName     ())
+         + MS::sizeOf(p->secondName    ())
+         + MS::sizeOf(p->nickName      ())
+         + MS::sizeOf(p->formattedName ())
+         + MS::sizeOf(p->preferredEmail())
+         + MS::sizeOf(p->organization  ())
+         + MS::sizeOf(p->uid           ())
+         + MS::sizeOf(p->group         ())
+         + MS::sizeOf(p->department    ())
+         + node->m_lChildren.capacity() * (sizeof(void*) + sizeof(PersonItemNode));
+
+      // Don't use photo(), it would decode it
+      bytes += MS::sizeOf(p->d_ptr->m_PhotoData);
+
+      const auto fields = p->otherFields();
+      for (auto i = fields.constBegin(); i != fields.constEnd(); ++i)
+         bytes += MS::sizeOf(i.key()) + MS::sizeOf(i.value());
+   }
+
+   return {
+      { QStringLiteral("Person"), static_cast<int>(m_lPersons.size()), bytes },
+   };
+}
+
 /*****************************************************************************
  *                                                                           *
  *                                   Model                                   *
@@ -22,6 +22,7 @@
 #include <QtCore/QDateTime>
 #include <QtCore/QMetaEnum>
 #include <QtCore/QJsonObject>
+#include <QtCore/QSet>
 
 //DRing
 #include <account_const.h>
@@ -47,6 +48,7 @@
 #include "localnameservicecache.h"
 #include "categorizedbookmarkmodel.h"
 #include "individual.h"
+#include "tracing.h"
 
 //Private
 #include "private/phonedirectorymodel_p.h"
@@ -56,13 +58,19 @@ class ContactMethodDirectoryPrivate
 public:
    int m_Index          {-1};
    int m_PopularityIndex{-1};
+
+   /// The m_hNumbersByAccount bucket, the account may have changed since
+   Account* m_pIndexedAccount {nullptr};
+   bool     m_IsAccountIndexed{false};
 };
 
 PhoneDirectoryModelPrivate::PhoneDirectoryModelPrivate(PhoneDirectoryModel* parent) : QObject(parent), q_ptr(parent),
 m_CallWithAccount(false),m_pPopularModel(nullptr)
 {
     QTimer::singleShot(0, [this]() {
-        m_pNameServiceCache = CategorizedBookmarkModel::instance().addCollection<LocalNameServiceCache>(LoadOptions::FORCE_ENABLED);
+        m_pNameServiceCache = CategorizedBookmarkModel::instance().addCollection<LocalNameServiceCache>(
+            static_cast<LoadOptions>(LoadOptions::FORCE_ENABLED | LoadOptions::ASYNC)
+        );
     });
     connect(&NameDirectory::instance(), &NameDirectory::registeredNameFound, this, &PhoneDirectoryModelPrivate::slotRegisteredNameFound);
 }
@@ -78,6 +86,10 @@ PhoneDirectoryModel::PhoneDirectoryModel(QObject* parent) :
       connect(&AccountModel::instance(), &AccountModel::accountStateChanged,
          d_ptr.data(), &PhoneDirectoryModelPrivate::slotAccountStateChanged);
    });
+
+   MemoryStatistics::instance().addProvider(QStringLiteral("PhoneDirectoryModel"), this, [this]() {
+      return d_ptr->memoryUsage();
+   });
 }
 
 PhoneDirectoryModel::~PhoneDirectoryModel()
@@ -171,6 +183,8 @@ QHash<int,QByteArray> PhoneDirectoryModel::roleNames() const
 
 QVariant PhoneDirectoryModel::data(const QModelIndex& index, int role ) const
 {
+   Tracing::Span s("model", "PhoneDirectoryModel::data");
+
    if (!index.isValid() || index.row() >= d_ptr->m_lNumbers.size()) return QVariant();
    const ContactMethod* number = d_ptr->m_lNumbers[index.row()];
    switch (static_cast<PhoneDirectoryModelPrivate::Columns>(index.column())) {
@@ -627,7 +641,7 @@ ContactMethod* PhoneDirectoryModel::getNumber(const URI& uri, Individual* i, Acc
     // create a new one.
     cm = new ContactMethod(uri, NumberCategoryModel::instance().getCategory(type));
     cm->dir_d_ptr = new ContactMethodDirectoryPrivate;
-    cm->dir_d_ptr->m_Index = d_ptr->m_lNumbers.size();
+    cm->dir_d_ptr->m_Index = d_ptr->m_lNumbers.size() + d_ptr->m_lBatchedNumbers.size();
 
     // Add it to the index
     auto wrap  = d_ptr->m_hDirectory.value(uri);
@@ -644,18 +658,16 @@ ContactMethod* PhoneDirectoryModel::getNumber(const URI& uri, Individual* i, Acc
 
     d_ptr->m_DirectoryAccess.unlock();
 
-    beginInsertRows({}, d_ptr->m_lNumbers.size(), d_ptr->m_lNumbers.size());
-    {
-        QMutexLocker l(&d_ptr->m_DirectoryAccess);
-        d_ptr->m_lNumbers << cm;
-    }
-    endInsertRows();
+    d_ptr->appendNumber(cm);
 
     connect(cm,SIGNAL(callAdded(Call*)),d_ptr.data(),SLOT(slotCallAdded(Call*)));
     connect(cm,SIGNAL(changed()),d_ptr.data(),SLOT(slotChanged()));
     connect(cm,&ContactMethod::lastUsedChanged,d_ptr.data(), &PhoneDirectoryModelPrivate::slotLastUsedChanged);
     connect(cm,&ContactMethod::contactChanged ,d_ptr.data(), &PhoneDirectoryModelPrivate::slotContactChanged);
     connect(cm,&ContactMethod::rebased ,d_ptr.data(), &PhoneDirectoryModelPrivate::slotContactMethodMerged);
+    connect(cm,&ContactMethod::accountChanged ,d_ptr.data(), &PhoneDirectoryModelPrivate::slotAccountChanged);
+
+    d_ptr->indexAccount(cm);
 
     // perform a username lookup for new CM with RingID
     if (cm->uri().protocolHint() == URI::ProtocolHint::RING)
@@ -864,7 +876,7 @@ ContactMethod* PhoneDirectoryModel::getNumber(const URI& uri, Person* contact, A
    number->dir_d_ptr = new ContactMethodDirectoryPrivate;
 
    number->setAccount(account);
-   number->dir_d_ptr->m_Index = d_ptr->m_lNumbers.size();
+   number->dir_d_ptr->m_Index = d_ptr->m_lNumbers.size() + d_ptr->m_lBatchedNumbers.size();
    if (contact)
       number->setPerson(contact);
    if (!wrap) {
@@ -885,13 +897,11 @@ ContactMethod* PhoneDirectoryModel::getNumber(const URI& uri, Person* contact, A
    connect(number,&ContactMethod::lastUsedChanged,d_ptr.data(), &PhoneDirectoryModelPrivate::slotLastUsedChanged);
    connect(number,&ContactMethod::contactChanged ,d_ptr.data(), &PhoneDirectoryModelPrivate::slotContactChanged );
    connect(number,&ContactMethod::rebased ,d_ptr.data(), &PhoneDirectoryModelPrivate::slotContactMethodMerged);
+   connect(number,&ContactMethod::accountChanged ,d_ptr.data(), &PhoneDirectoryModelPrivate::slotAccountChanged);
 
-   beginInsertRows({}, d_ptr->m_lNumbers.size(), d_ptr->m_lNumbers.size());
-   {
-      QMutexLocker l(&d_ptr->m_DirectoryAccess);
-      d_ptr->m_lNumbers << number;
-   }
-   endInsertRows();
+   d_ptr->indexAccount(number);
+
+   d_ptr->appendNumber(number);
 
    // perform a username lookup for new CM with RingID
    if (number->uri().protocolHint() == URI::ProtocolHint::RING)
@@ -1051,6 +1061,17 @@ void PhoneDirectoryModelPrivate::slotChanged()
       if (idx<0)
          qDebug() << "Invalid slotChanged() index!" << idx;
 #endif
+      // The row is part of a batch and isn't inserted yet
+      if (idx >= m_lNumbers.size())
+         return;
+
+      // Merged into a single dataChanged() by slotFlushPresence()
+      if (m_IsFlushing) {
+         m_DirtyFirst = m_DirtyFirst == -1 ? idx : std::min(m_DirtyFirst, idx);
+         m_DirtyLast  = std::max(m_DirtyLast, idx);
+         return;
+      }
+
       emit q_ptr->dataChanged(q_ptr->index(idx,0),q_ptr->index(idx,static_cast<int>(Columns::REGISTERED_NAME)));
    }
 }
@@ -1068,23 +1089,24 @@ void PhoneDirectoryModelPrivate::slotContactMethodMerged(ContactMethod* other)
 
     Q_ASSERT(cm->isDuplicate() ^ other->isDuplicate());
 
+    // The buddy will be resolved again to the new ContactMethod
+    forgetPresenceIds(cm->isDuplicate() ? cm : other);
+
     emit q_ptr->contactMethodMerged(
         cm->isDuplicate() ? cm    : other,
         cm->isDuplicate() ? other : cm
     );
 }
 
-// Reload all ContactMethod mediaavailability. This is done here and only once
-// rather than having 1 qobject connection per CM.
+// Reload the ContactMethod media availability. This is done here and only
+// once rather than having 1 qobject connection per CM. As accounts tend to
+// change state in bursts, the accounts are collected until the next event
+// loop iteration.
 void PhoneDirectoryModelPrivate::slotAccountStateChanged(Account* a, const Account::RegistrationState state)
 {
     Q_UNUSED(state)
-    for (const auto numbers : qAsConst(m_hDirectory)) {
-        for (auto cm : qAsConst(numbers->numbers)) {
-            if ((!cm->account()) || cm->account()->protocol() == a->protocol())
-                cm->d_ptr->mediaAvailabilityChanged();
-        }
-    }
+    m_lPendingAccounts << a;
+    schedulePresenceFlush();
 }
 
 void PhoneDirectoryModelPrivate::slotLastUsedChanged(time_t t)
@@ -1114,10 +1136,166 @@ void PhoneDirectoryModelPrivate::slotContactChanged(Person* newContact, Person*
 
 void PhoneDirectoryModelPrivate::slotNewBuddySubscription(const QString& accountId, const QString& uri, bool status, const QString& message)
 {
-   ContactMethod* number = q_ptr->getNumber(uri,AccountModel::instance().getById(accountId.toLatin1()));
-   number->d_ptr->setPresent(status);
-   number->setPresenceMessage(message);
-   emit number->changed();
+   TRACE_SCOPE("daemon", "PhoneDirectoryModelPrivate::slotNewBuddySubscription");
+   const PresenceId id {AccountModel::instance().getById(accountId.toLatin1()), uri};
+
+   m_PresenceUpdates++;
+
+   // Reconnecting accounts notify every buddy, sometimes more than once
+   if (m_hPendingPresence.contains(id))
+      m_CoalescedUpdates++;
+
+   m_hPendingPresence[id] = {status, message};
+
+   schedulePresenceFlush();
+}
+
+void PhoneDirectoryModelPrivate::schedulePresenceFlush()
+{
+   if (m_FlushScheduled)
+      return;
+
+   m_FlushScheduled = true;
+
+   QTimer::singleShot(0, this, &PhoneDirectoryModelPrivate::slotFlushPresence);
+}
+
+/**
+ * Resolve the buddy once, getNumber() has to parse the URI and walk the
+ * indices.
+ */
+ContactMethod* PhoneDirectoryModelPrivate::presenceContactMethod(const PresenceId& id)
+{
+   auto cm = m_hPresenceIds.value(id);
+
+   if (cm && !cm->isDuplicate())
+      return cm;
+
+   if (cm)
+      forgetPresenceIds(cm);
+
+   cm = q_ptr->getNumber(id.second, id.first);
+
+   // Everyone reconnecting at once refills it, no need to be smarter
+   if (m_hPresenceIds.size() >= MAX_PRESENCE_IDS) {
+      m_hPresenceIds.clear();
+      m_hPresenceCMs.clear();
+   }
+
+   connect(cm, &QObject::destroyed, this,
+      &PhoneDirectoryModelPrivate::slotPresenceContactMethodDestroyed, Qt::UniqueConnection);
+
+   m_hPresenceIds[id] = cm;
+   m_hPresenceCMs.insert(cm, id);
+
+   return cm;
+}
+
+void PhoneDirectoryModelPrivate::forgetPresenceIds(ContactMethod* cm)
+{
+   const auto ids = m_hPresenceCMs.values(cm);
+
+   for (const auto& id : ids) {
+      if (m_hPresenceIds.value(id) == cm)
+         m_hPresenceIds.remove(id);
+   }
+
+   m_hPresenceCMs.remove(cm);
+}
+
+void PhoneDirectoryModelPrivate::slotPresenceContactMethodDestroyed(QObject* o)
+{
+   // Only the address is used, the object is already half destroyed
+   forgetPresenceIds(static_cast<ContactMethod*>(o));
+}
+
+/// Keep m_hNumbersByAccount in sync with the ContactMethod account
+void PhoneDirectoryModelPrivate::indexAccount(ContactMethod* cm)
+{
+   auto d = cm->dir_d_ptr;
+
+   QMutexLocker l(&m_DirectoryAccess);
+
+   if (d->m_IsAccountIndexed) {
+      if (d->m_pIndexedAccount == cm->account())
+         return;
+
+      auto i = m_hNumbersByAccount.find(d->m_pIndexedAccount);
+
+      if (i != m_hNumbersByAccount.end()) {
+         i->removeOne(cm);
+
+         if (i->isEmpty())
+            m_hNumbersByAccount.erase(i);
+      }
+   }
+
+   d->m_pIndexedAccount  = cm->account();
+   d->m_IsAccountIndexed = true;
+
+   m_hNumbersByAccount[cm->account()] << cm;
+}
+
+void PhoneDirectoryModelPrivate::slotAccountChanged()
+{
+   if (auto cm = qobject_cast<ContactMethod*>(sender()))
+      indexAccount(cm);
+}
+
+void PhoneDirectoryModelPrivate::slotFlushPresence()
+{
+   m_FlushScheduled = false;
+
+   const auto pending  = m_hPendingPresence;
+   const auto accounts = m_lPendingAccounts;
+   m_hPendingPresence.clear();
+   m_lPendingAccounts.clear();
+
+   m_IsFlushing = true;
+
+   for (auto i = pending.constBegin(); i != pending.constEnd(); ++i) {
+      ContactMethod* cm = presenceContactMethod(i.key());
+
+      if (cm->isPresent() == i->present && cm->presenceMessage() == i->message) {
+         m_CoalescedUpdates++;
+         continue;
+      }
+
+      cm->d_ptr->setPresent(i->present);
+      cm->setPresenceMessage(i->message);
+      emit cm->changed();
+   }
+
+   m_IsFlushing = false;
+
+   if (m_DirtyFirst != -1) {
+      emit q_ptr->dataChanged(
+         q_ptr->index(m_DirtyFirst, 0),
+         q_ptr->index(m_DirtyLast , static_cast<int>(Columns::REGISTERED_NAME))
+      );
+   }
+
+   m_DirtyFirst = m_DirtyLast = -1;
+
+   // Only the CMs using that account, or the default one, are affected
+   if (!accounts.isEmpty()) {
+      QVector<ContactMethod*> affected;
+
+      {
+         QMutexLocker l(&m_DirectoryAccess);
+
+         affected = m_hNumbersByAccount.value(nullptr);
+
+         for (auto a : accounts)
+            affected << m_hNumbersByAccount.value(a);
+      }
+
+      for (auto cm : qAsConst(affected))
+         cm->d_ptr->mediaAvailabilityChanged();
+   }
+
+   Tracing::counter("presence", "PhoneDirectoryModel::presenceUpdates", m_PresenceUpdates);
+   Tracing::counter("presence", "PhoneDirectoryModel::coalescedUpdates", m_CoalescedUpdates);
 }
 
 ///Make sure the indexes are still valid for those names
@@ -1152,6 +1330,134 @@ void PhoneDirectoryModelPrivate::indexNumber(ContactMethod* number, const QStrin
 }
 
 
+/// Add the number to the model, or queue it if a batch is in progress
+void PhoneDirectoryModelPrivate::appendNumber(ContactMethod* cm)
+{
+   {
+      QMutexLocker l(&m_DirectoryAccess);
+
+      if (m_BatchDepth) {
+         m_lBatchedNumbers << cm;
+         return;
+      }
+   }
+
+   q_ptr->beginInsertRows({}, m_lNumbers.size(), m_lNumbers.size());
+   {
+      QMutexLocker l(&m_DirectoryAccess);
+      m_lNumbers << cm;
+   }
+   q_ptr->endInsertRows();
+}
+
+/**
+ * Start inserting many numbers.
+ *
+ * getNumber() keeps working as usual (the numbers are in the directory
+ * index), but the rows are inserted in the model only once endBatch() is
+ * called. This avoids one beginInsertRows() per number when loading large
+ * contact lists.
+ */
+void PhoneDirectoryModelPrivate::beginBatch()
+{
+   QMutexLocker l(&m_DirectoryAccess);
+   m_BatchDepth++;
+}
+
+void PhoneDirectoryModelPrivate::endBatch()
+{
+   QVector<ContactMethod*> batch;
+
+   {
+      QMutexLocker l(&m_DirectoryAccess);
+
+      Q_ASSERT(m_BatchDepth > 0);
+
+      if (--m_BatchDepth || m_lBatchedNumbers.isEmpty())
+         return;
+
+      batch = m_lBatchedNumbers;
+      m_lBatchedNumbers.clear();
+   }
+
+   const int first = m_lNumbers.size();
+
+   q_ptr->beginInsertRows({}, first, first + batch.size() - 1);
+   {
+      QMutexLocker l(&m_DirectoryAccess);
+      m_lNumbers << batch;
+   }
+   q_ptr->endInsertRows();
+}
+
+///Estimate the memory used by the ContactMethods and the directory indices
+QVector<MemoryStatistics::Usage> PhoneDirectoryModelPrivate::memoryUsage() const
+{
+   typedef MemoryStatistics MS;
+
+   qint64 cmBytes = 0;
+
+   for (const auto cm : qAsConst(m_lNumbers)) {
+      const auto d = cm->d_ptr;
+
+      cmBytes += sizeof(ContactMethod) + sizeof(ContactMethodPrivate)
+         + 2 * MS::QOBJECT_OVERHEAD
+         + MS::sizeOf(d->m_PresentMessage   )
+         + MS::sizeOf(d->m_MostCommonName   )
+         + MS::sizeOf(d->m_Uid              )
+         + MS::sizeOf(d->m_PrimaryName_cache)
+         + MS::sizeOf(d->m_Uri              )
+         + MS::sizeOf(d->m_Sha1             )
+         + MS::sizeOf(d->m_RegisteredName   )
+         + MS::sizeOfHash(d->m_hNames       )
+         + MS::sizeOfVector(d->m_lAltTR     );
+
+      for (auto i = d->m_hNames.constBegin(); i != d->m_hNames.constEnd(); ++i)
+         cmBytes += MS::sizeOf(i.key());
+
+      for (const auto& uri : qAsConst(d->m_lOtherURIs))
+         cmBytes += sizeof(void*) + sizeof(URI) + MS::sizeOf(uri);
+   }
+
+   // The wrappers are shared between the indices, count them once
+   QSet<const NumberWrapper*> wrappers;
+   qint64 indexBytes = MS::sizeOfVector(m_lNumbers        )
+      + MS::sizeOfVector(m_lPopularityIndex)
+      + MS::sizeOfHash  (m_hDirectory      )
+      + MS::sizeOfHash  (m_hNumbersByNames );
+
+   for (const auto* map : {&m_lSortedNames, &m_hSortedNumbers}) {
+      // Each QMap node has 3 pointers (parent/color, left, right)
+      indexBytes += map->size() * (3 * sizeof(void*) + sizeof(QString) + sizeof(void*));
+
+      for (auto i = map->constBegin(); i != map->constEnd(); ++i) {
+         indexBytes += MS::sizeOf(i.key());
+         wrappers << i.value();
+      }
+   }
+
+   for (const auto* hash : {&m_hDirectory, &m_hNumbersByNames}) {
+      for (auto i = hash->constBegin(); i != hash->constEnd(); ++i) {
+         indexBytes += MS::sizeOf(i.key());
+         wrappers << i.value();
+      }
+   }
+
+   for (const auto w : qAsConst(wrappers))
+      indexBytes += sizeof(NumberWrapper) + MS::sizeOf(w->key) + MS::sizeOfVector(w->numbers);
+
+   qint64 presenceBytes = MS::sizeOfHash(m_hPresenceIds) + MS::sizeOfHash(m_hPresenceCMs);
+
+   for (auto i = m_hPresenceIds.constBegin(); i != m_hPresenceIds.constEnd(); ++i)
+      presenceBytes += MS::sizeOf(i.key().second);
+
+   return {
+      { QStringLiteral("ContactMethod"), m_lNumbers.size(), cmBytes    },
+      { QStringLiteral("NumberWrapper"), wrappers.size()  , indexBytes },
+      { QStringLiteral("PresenceId")   , m_hPresenceIds.size(), presenceBytes },
+   };
+}
+
 /**
  * Useful for caching locally some names
  */
@@ -1169,6 +1475,32 @@ PhoneDirectoryModel::setRegisteredNameForRingId(const QByteArray& ringId, const
     d_ptr->slotRegisteredNameFound(nullptr, NameDirectory::LookupStatus::SUCCESS, ringId, name);
 }
 
+/**
+ * Insert many names at once.
+ *
+ * The account lookup is done only once for the whole batch.
+ */
+void
+PhoneDirectoryModel::setRegisteredNamesForRingIds(const QHash<QByteArray, QString>& names)
+{
+    auto account = AccountModel::instance().findAccountIf([](const Account& a) {
+        return a.protocol() == Account::Protocol::RING;
+    });
+
+    // Insert the new rows all at once
+    d_ptr->beginBatch();
+
+    for (auto i = names.constBegin(); i != names.constEnd(); ++i) {
+        // Make sure a CM exists otherwise this is NOP
+        if (account)
+            getNumber(i.key(), account);
+
+        d_ptr->slotRegisteredNameFound(nullptr, NameDirectory::LookupStatus::SUCCESS, i.key(), i.value());
+    }
+
+    d_ptr->endBatch();
+}
+
 void
 PhoneDirectoryModelPrivate::slotRegisteredNameFound(Account* account, NameDirectory::LookupStatus status, const QString& address, const QString& name)
 {
@@ -53,6 +53,9 @@ class LIB_EXPORT PhoneDirectoryModel : public QAbstractTableModel {
 
    //Phone number need to update the indexes as they change
    friend class ContactMethod;
+   friend class PhoneDirectoryModelPrivate;
+   friend class AccountPrivate; // Batch insertion
+   friend class CollectionLoaderPrivate; // Batch insertion
 
    #pragma GCC diagnostic push
    #pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
@@ -116,6 +119,10 @@ private:
 public Q_SLOTS:
     void setRegisteredNameForRingId(const QByteArray& ringId, const QByteArray& name);
 
+public:
+    /// Batch version of setRegisteredNameForRingId used when loading caches
+    void setRegisteredNamesForRingIds(const QHash<QByteArray, QString>& names);
+
 Q_SIGNALS:
    void lastUsedChanged(ContactMethod* cm, time_t t);
    void contactChanged(ContactMethod* cm, Person* newContact, Person* oldContact);
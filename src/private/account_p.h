@@ -20,10 +20,13 @@
 //Qt
 #include <QtCore/QObject>
 #include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QPointer>
 
 //Ring
 #include <account.h>
 #include <libcard/matrixutils.h>
+#include "private/accountdetails.h"
 
 class AccountPrivate;
 class ContactMethod;
@@ -58,7 +61,7 @@ public:
 
     //Attributes
     QByteArray                 m_AccountId                ;
-    QHash<QString,QString>     m_hAccountDetails          ;
+    AccountDetails             m_Details                  ;
     QString                    m_LastTransportMessage     ;
     QString                    m_LastSipRegistrationStatus;
     ContactMethod*             m_pAccountNumber           {nullptr};
@@ -75,13 +78,31 @@ public:
     QMetaObject::Connection    m_cTlsCaCert               {};
     QMutex                     m_ReloadLock               {};
 
+    /// Details prefetched by buildExistingAccountsFromIds()
+    struct BootstrapData {
+       MapStringString details;
+       MapStringString volatileDetails;
+    };
+    const BootstrapData*       m_pBootstrap               {nullptr};
+
+    /// The profile vCard, already split into SIP sized chunks
+    struct ProfilePayload {
+       QByteArray                     version           ; ///< SHA1 of the vCard
+       QVector<QMap<QString,QString>> chunks            ;
+       QPointer<Person>               profile           ; ///< The person it was built from
+       QMetaObject::Connection        connection        ; ///< Invalidate when it changes
+       bool                           isDirty   {true } ;
+    };
+    ProfilePayload             m_ProfilePayload           {};
+
     //Factory
     static Account* buildExistingAccountFromId(const QByteArray& _accountId);
+    static QVector<Account*> buildExistingAccountsFromIds(const QList<QByteArray>& ids);
     static Account* buildNewAccountFromAlias  (Account::Protocol proto, const QString& alias);
 
     //Setters
-    void setAccountProperties(const QHash<QString,QString>& m);
-    bool setAccountProperty(const QString& param, const QString& val);
+    void setAccountProperties(const MapStringString& m);
+    bool setAccountProperty(AccountDetails::Key key, const QString& val);
     void setRegistrationState(Account::RegistrationState value);
     void setId(const QByteArray& id);
     void setLastSipRegistrationStatus(const QString& value);
@@ -89,7 +110,9 @@ public:
     void setLastTransportMessage(const QString& value);
 
     //Getters
-    QString accountDetail(const QString& param) const;
+    QString accountDetail(AccountDetails::Key key) const;
+    bool    accountDetailBool(AccountDetails::Key key) const;
+    int     accountDetailInt (AccountDetails::Key key) const;
 
     //Mutator
     bool merge(Account* account);
@@ -99,6 +122,7 @@ public:
     void regenSecurityValidation();
     bool updateState();
     QString buildUri();
+    const ProfilePayload& profilePayload();
 
     //State actions
     void performAction(Account::EditAction action);
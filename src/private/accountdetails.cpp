@@ -0,0 +1,261 @@
+/****************************************************************************
+ *   Copyright (C) 2018 by Bluesystems                                      *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                    *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "accountdetails.h"
+
+//Ring daemon
+#include <account_const.h>
+
+// Must be in the same order as the Key enum
+static const char* const s_lNames[] = {
+    DRing::Account::ConfProperties::ALIAS,
+    DRing::Account::ConfProperties::TYPE,
+    DRing::Account::ConfProperties::ENABLED,
+    DRing::Account::ConfProperties::HOSTNAME,
+    DRing::Account::ConfProperties::USERNAME,
+    DRing::Account::ConfProperties::DISPLAYNAME,
+    DRing::Account::ConfProperties::MAILBOX,
+    DRing::Account::ConfProperties::ROUTE,
+    DRing::Account::ConfProperties::USER_AGENT,
+    DRing::Account::ConfProperties::HAS_CUSTOM_USER_AGENT,
+    DRing::Account::ConfProperties::AUTOANSWER,
+    DRing::Account::ConfProperties::ACTIVE_CALL_LIMIT,
+    DRing::Account::ConfProperties::DTMF_TYPE,
+    DRing::Account::ConfProperties::LOCAL_INTERFACE,
+    DRing::Account::ConfProperties::LOCAL_PORT,
+    DRing::Account::ConfProperties::PUBLISHED_ADDRESS,
+    DRing::Account::ConfProperties::PUBLISHED_PORT,
+    DRing::Account::ConfProperties::PUBLISHED_SAMEAS_LOCAL,
+    DRing::Account::ConfProperties::UPNP_ENABLED,
+    DRing::Account::ConfProperties::ARCHIVE_PASSWORD,
+    DRing::Account::ConfProperties::ARCHIVE_PIN,
+    DRing::Account::ConfProperties::RING_DEVICE_ID,
+    DRing::Account::ConfProperties::RING_DEVICE_NAME,
+    DRing::Account::ConfProperties::ALLOW_CERT_FROM_CONTACT,
+    DRing::Account::ConfProperties::ALLOW_CERT_FROM_HISTORY,
+    DRing::Account::ConfProperties::Registration::STATUS,
+    DRing::Account::ConfProperties::Registration::EXPIRE,
+    DRing::Account::ConfProperties::Audio::PORT_MIN,
+    DRing::Account::ConfProperties::Audio::PORT_MAX,
+    DRing::Account::ConfProperties::Video::ENABLED,
+    DRing::Account::ConfProperties::Video::PORT_MIN,
+    DRing::Account::ConfProperties::Video::PORT_MAX,
+    DRing::Account::ConfProperties::Ringtone::ENABLED,
+    DRing::Account::ConfProperties::Ringtone::PATH,
+    DRing::Account::ConfProperties::Presence::ENABLED,
+    DRing::Account::ConfProperties::Presence::SUPPORT_PUBLISH,
+    DRing::Account::ConfProperties::Presence::SUPPORT_SUBSCRIBE,
+    DRing::Account::ConfProperties::DHT::PORT,
+    DRing::Account::ConfProperties::DHT::PUBLIC_IN_CALLS,
+    DRing::Account::ConfProperties::RingNS::URI,
+    DRing::Account::ConfProperties::SRTP::ENABLED,
+    DRing::Account::ConfProperties::SRTP::KEY_EXCHANGE,
+    DRing::Account::ConfProperties::SRTP::RTP_FALLBACK,
+    DRing::Account::ConfProperties::STUN::ENABLED,
+    DRing::Account::ConfProperties::STUN::SERVER,
+    DRing::Account::ConfProperties::TURN::ENABLED,
+    DRing::Account::ConfProperties::TURN::SERVER,
+    DRing::Account::ConfProperties::TURN::SERVER_UNAME,
+    DRing::Account::ConfProperties::TURN::SERVER_PWD,
+    DRing::Account::ConfProperties::TURN::SERVER_REALM,
+    DRing::Account::ConfProperties::TLS::ENABLED,
+    DRing::Account::ConfProperties::TLS::LISTENER_PORT,
+    DRing::Account::ConfProperties::TLS::CA_LIST_FILE,
+    DRing::Account::ConfProperties::TLS::CERTIFICATE_FILE,
+    DRing::Account::ConfProperties::TLS::PRIVATE_KEY_FILE,
+    DRing::Account::ConfProperties::TLS::PASSWORD,
+    DRing::Account::ConfProperties::TLS::METHOD,
+    DRing::Account::ConfProperties::TLS::CIPHERS,
+    DRing::Account::ConfProperties::TLS::SERVER_NAME,
+    DRing::Account::ConfProperties::TLS::VERIFY_SERVER,
+    DRing::Account::ConfProperties::TLS::VERIFY_CLIENT,
+    DRing::Account::ConfProperties::TLS::REQUIRE_CLIENT_CERTIFICATE,
+    DRing::Account::ConfProperties::TLS::NEGOTIATION_TIMEOUT_SEC,
+};
+
+static_assert(sizeof(s_lNames)/sizeof(s_lNames[0]) == static_cast<int>(AccountDetails::Key::COUNT__),
+    "The names must match the AccountDetails::Key enum");
+
+constexpr const int AccountDetails::COUNT;
+
+typedef std::array<QString, static_cast<int>(AccountDetails::Key::COUNT__)> NameArray;
+
+static const NameArray& names()
+{
+    static const NameArray ret = [] {
+        NameArray n;
+        for (int i = 0; i < static_cast<int>(AccountDetails::Key::COUNT__); i++)
+            n[i] = QString::fromLatin1(s_lNames[i]);
+        return n;
+    }();
+
+    return ret;
+}
+
+static const QHash<QString, AccountDetails::Key>& keys()
+{
+    static const QHash<QString, AccountDetails::Key> ret = [] {
+        QHash<QString, AccountDetails::Key> k;
+        const auto& n = names();
+        k.reserve(static_cast<int>(AccountDetails::Key::COUNT__));
+
+        for (int i = 0; i < static_cast<int>(AccountDetails::Key::COUNT__); i++)
+            k[n[i]] = static_cast<AccountDetails::Key>(i);
+
+        return k;
+    }();
+
+    return ret;
+}
+
+QString AccountDetails::name(Key key)
+{
+    Q_ASSERT(key != Key::COUNT__);
+    return names()[static_cast<int>(key)];
+}
+
+AccountDetails::Key AccountDetails::keyOf(const QString& name)
+{
+    return keys().value(name, Key::COUNT__);
+}
+
+bool AccountDetails::isEmpty() const
+{
+    return m_IsSet.none() && m_hOverflow.isEmpty();
+}
+
+int AccountDetails::size() const
+{
+    return static_cast<int>(m_IsSet.count()) + m_hOverflow.size();
+}
+
+bool AccountDetails::contains(Key key) const
+{
+    return m_IsSet[static_cast<int>(key)];
+}
+
+QString AccountDetails::value(Key key) const
+{
+    return m_lValues[static_cast<int>(key)];
+}
+
+QString AccountDetails::value(const QString& name) const
+{
+    const Key k = keyOf(name);
+
+    return k == Key::COUNT__ ? m_hOverflow.value(name) : value(k);
+}
+
+bool AccountDetails::boolValue(Key key) const
+{
+    return m_IsTrue[static_cast<int>(key)];
+}
+
+int AccountDetails::intValue(Key key) const
+{
+    return m_lNumbers[static_cast<int>(key)];
+}
+
+/// Keep the parsed forms in sync with the string
+void AccountDetails::store(int idx, const QString& value)
+{
+    m_lValues [idx] = value;
+    m_lNumbers[idx] = value.toInt();
+    m_IsTrue  [idx] = value == QLatin1String("true");
+    m_IsSet   [idx] = true;
+}
+
+void AccountDetails::setValue(Key key, const QString& value)
+{
+    const int idx = static_cast<int>(key);
+
+    store(idx, value);
+    m_IsDirty[idx] = true;
+}
+
+void AccountDetails::setRemoteValue(Key key, const QString& value)
+{
+    store(static_cast<int>(key), value);
+}
+
+void AccountDetails::setValue(const QString& name, const QString& value)
+{
+    const Key k = keyOf(name);
+
+    if (k != Key::COUNT__) {
+        setValue(k, value);
+        return;
+    }
+
+    m_hOverflow[name] = value;
+    m_lDirtyOverflow << name;
+}
+
+void AccountDetails::load(const MapStringString& details)
+{
+    clear();
+
+    for (auto i = details.constBegin(); i != details.constEnd(); ++i) {
+        const Key k = keyOf(i.key());
+
+        if (k == Key::COUNT__) {
+            m_hOverflow[i.key()] = i.value();
+            continue;
+        }
+
+        store(static_cast<int>(k), i.value());
+    }
+}
+
+void AccountDetails::clear()
+{
+    for (auto& v : m_lValues)
+        v.clear();
+
+    m_lNumbers.fill(0);
+    m_IsTrue .reset();
+    m_IsSet  .reset();
+    m_IsDirty.reset();
+    m_hOverflow.clear();
+    m_lDirtyOverflow.clear();
+}
+
+MapStringString AccountDetails::toMap() const
+{
+    MapStringString ret;
+
+    for (int i = 0; i < COUNT; i++) {
+        if (m_IsSet[i])
+            ret[name(static_cast<Key>(i))] = m_lValues[i];
+    }
+
+    for (auto i = m_hOverflow.constBegin(); i != m_hOverflow.constEnd(); ++i)
+        ret[i.key()] = i.value();
+
+    return ret;
+}
+
+bool AccountDetails::isDirty() const
+{
+    return m_IsDirty.any() || !m_lDirtyOverflow.isEmpty();
+}
+
+void AccountDetails::clearDirty()
+{
+    m_IsDirty.reset();
+    m_lDirtyOverflow.clear();
+}
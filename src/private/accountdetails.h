@@ -0,0 +1,167 @@
+/****************************************************************************
+ *   Copyright (C) 2018 by Bluesystems                                      *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                    *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+
+//STD
+#include <array>
+#include <bitset>
+
+//Ring
+#include <typedefs.h>
+
+/**
+ * Storage for the account details.
+ *
+ * The daemon exposes the account configuration as a string map. Most of
+ * the keys are known in advance and are read very often (each
+ * Account::roleData() call reads a few of them). Hashing the key string each
+ * time is wasteful, so the known keys are stored in an array indexed by the
+ * Key enum. The values the client doesn't know about are kept in a hash so
+ * they can be sent back to the daemon unchanged.
+ *
+ * Most known values are booleans or numbers. They are parsed once when they
+ * are set rather than each time a getter converts the string.
+ *
+ * Each known key also has a dirty bit. It is used to know if an existing
+ * account has to be saved at all.
+ */
+class AccountDetails final
+{
+public:
+    /// The account properties known by this library
+    enum class Key : uchar {
+        ALIAS,
+        TYPE,
+        ENABLED,
+        HOSTNAME,
+        USERNAME,
+        DISPLAYNAME,
+        MAILBOX,
+        ROUTE,
+        USER_AGENT,
+        HAS_CUSTOM_USER_AGENT,
+        AUTOANSWER,
+        ACTIVE_CALL_LIMIT,
+        DTMF_TYPE,
+        LOCAL_INTERFACE,
+        LOCAL_PORT,
+        PUBLISHED_ADDRESS,
+        PUBLISHED_PORT,
+        PUBLISHED_SAMEAS_LOCAL,
+        UPNP_ENABLED,
+        ARCHIVE_PASSWORD,
+        ARCHIVE_PIN,
+        RING_DEVICE_ID,
+        RING_DEVICE_NAME,
+        ALLOW_CERT_FROM_CONTACT,
+        ALLOW_CERT_FROM_HISTORY,
+        REGISTRATION_STATUS,
+        REGISTRATION_EXPIRE,
+        AUDIO_PORT_MIN,
+        AUDIO_PORT_MAX,
+        VIDEO_ENABLED,
+        VIDEO_PORT_MIN,
+        VIDEO_PORT_MAX,
+        RINGTONE_ENABLED,
+        RINGTONE_PATH,
+        PRESENCE_ENABLED,
+        PRESENCE_SUPPORT_PUBLISH,
+        PRESENCE_SUPPORT_SUBSCRIBE,
+        DHT_PORT,
+        DHT_PUBLIC_IN_CALLS,
+        RINGNS_URI,
+        SRTP_ENABLED,
+        SRTP_KEY_EXCHANGE,
+        SRTP_RTP_FALLBACK,
+        STUN_ENABLED,
+        STUN_SERVER,
+        TURN_ENABLED,
+        TURN_SERVER,
+        TURN_SERVER_UNAME,
+        TURN_SERVER_PWD,
+        TURN_SERVER_REALM,
+        TLS_ENABLED,
+        TLS_LISTENER_PORT,
+        TLS_CA_LIST_FILE,
+        TLS_CERTIFICATE_FILE,
+        TLS_PRIVATE_KEY_FILE,
+        TLS_PASSWORD,
+        TLS_METHOD,
+        TLS_CIPHERS,
+        TLS_SERVER_NAME,
+        TLS_VERIFY_SERVER,
+        TLS_VERIFY_CLIENT,
+        TLS_REQUIRE_CLIENT_CERTIFICATE,
+        TLS_NEGOTIATION_TIMEOUT_SEC,
+        COUNT__
+    };
+
+    bool isEmpty() const;
+    int  size   () const;
+
+    bool contains(Key key) const;
+
+    QString value(Key key) const;
+    QString value(const QString& name) const;
+
+    /// The value parsed as a boolean (only "true" is true)
+    bool boolValue(Key key) const;
+
+    /// The value parsed as an integer (0 if it isn't a number)
+    int  intValue (Key key) const;
+
+    /// Set a value and mark it as modified
+    void setValue(Key key, const QString& value);
+    void setValue(const QString& name, const QString& value);
+
+    /// Set a value coming from the daemon, it wont be sent back on save
+    void setRemoteValue(Key key, const QString& value);
+
+    /// Replace all values with the ones from the daemon
+    void load(const MapStringString& details);
+    void clear();
+
+    MapStringString toMap() const;
+
+    /// If a value changed since the last load() or clearDirty()
+    bool isDirty() const;
+    void clearDirty();
+
+    static QString name(Key key);
+
+    /// Return Key::COUNT__ for keys unknown to this library
+    static Key keyOf(const QString& name);
+
+private:
+    static constexpr const int COUNT = static_cast<int>(Key::COUNT__);
+
+    void store(int idx, const QString& value);
+
+    std::array<QString, COUNT> m_lValues        ;
+    std::array<int    , COUNT> m_lNumbers       {};
+    std::bitset<COUNT>         m_IsTrue         ;
+    std::bitset<COUNT>         m_IsSet          ;
+    std::bitset<COUNT>         m_IsDirty        ;
+    QHash<QString, QString>    m_hOverflow      ;
+    QSet<QString>              m_lDirtyOverflow ;
+};
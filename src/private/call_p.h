@@ -108,6 +108,7 @@ public:
     int                       m_LastErrorCode      {            200          };
     int                       m_VideoFrameCounter  {             0           };
     int                       m_UnholdCounter      {             0           };
+    QByteArray                m_PendingProfile     {                         };
 
     FlagPack<Call::LiveMediaIssues> m_fCurrentIssues {Call::LiveMediaIssues::OK};
 
@@ -253,6 +254,7 @@ public:
     void registerRenderer(Video::Renderer* renderer);
     void removeRenderer(Video::Renderer* renderer);
     void setRecordingPath(const QString& path);
+    void confirmProfileSent();
     static MapStringString getCallDetailsCommon(const QString& callId);
     void peerHoldChanged(bool onPeerHold);
     template<typename T>
@@ -0,0 +1,270 @@
+/****************************************************************************
+ *   Copyright (C) 2018 by Bluesystems                                      *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                    *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "certificatecache.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTimer>
+
+//Ring
+#include "dbus/configurationmanager.h"
+#include "private/threadworker.h"
+
+constexpr const char    CertificateCache::FILENAME[];
+constexpr const quint32 CertificateCache::MAGIC;
+
+CertificateCache::CertificateCache(QObject* parent) : QObject(nullptr),
+m_pSaveTimer(new QTimer(this)), m_pWorker(new SerialThreadWorker(this))
+{
+   // It can be created by the loader thread, but the timer must live
+   // in the main one
+   moveToThread(parent->thread());
+   setParent(parent);
+
+   // Do not trash the I/O for nothing, it's just a cache
+   m_pSaveTimer->setSingleShot(true);
+   m_pSaveTimer->setInterval(1000);
+   connect(m_pSaveTimer, &QTimer::timeout, this, &CertificateCache::save);
+}
+
+CertificateCache& CertificateCache::instance()
+{
+   static auto instance = new CertificateCache(QCoreApplication::instance());
+   return *instance;
+}
+
+QString CertificateCache::path()
+{
+   return QStandardPaths::writableLocation(QStandardPaths::DataLocation)
+      + QLatin1Char('/')
+      + FILENAME;
+}
+
+/// Anything telling the file may have changed
+QByteArray CertificateCache::stamp(const QString& path)
+{
+   if (path.isEmpty())
+      return {};
+
+   const QFileInfo fi(path);
+
+   if (!fi.exists())
+      return {};
+
+   return QByteArray::number(fi.lastModified().toMSecsSinceEpoch())
+      + ':' + QByteArray::number(fi.size())
+      + ':' + QByteArray::number(static_cast<int>(fi.permissions()), 16);
+}
+
+/// Read the cache file, the caller must hold the mutex
+void CertificateCache::load()
+{
+   if (m_IsLoaded)
+      return;
+
+   m_IsLoaded = true;
+
+   QFile file(path());
+
+   if (!file.open(QIODevice::ReadOnly))
+      return;
+
+   QDataStream stream(&file);
+   stream.setVersion(QDataStream::Qt_5_9);
+
+   quint32 magic, fileCount, detailsCount;
+   stream >> magic;
+
+   // Also true for the older versions, it will be rewritten
+   if (magic != MAGIC)
+      return;
+
+   stream >> fileCount;
+   for (quint32 i = 0; i < fileCount && stream.status() == QDataStream::Ok; i++) {
+      QString   p;
+      FileStamp s;
+      stream >> p >> s.stamp >> s.fingerprint;
+      m_hFiles[p] = s;
+   }
+
+   stream >> detailsCount;
+   for (quint32 i = 0; i < detailsCount && stream.status() == QDataStream::Ok; i++) {
+      QByteArray      key;
+      MapStringString d;
+      stream >> key >> d;
+      m_hDetails[key] = d;
+   }
+
+   // A partial write, it will be fixed by the next flush
+   if (stream.status() != QDataStream::Ok)
+      qWarning() << "The certificate cache is truncated";
+}
+
+/// Write a snapshot in the worker thread, after the previous ones
+void CertificateCache::save()
+{
+   QHash<QString   , FileStamp      > files;
+   QHash<QByteArray, MapStringString> details;
+
+   { // mutex
+   QMutexLocker l(&m_Mutex);
+   files   = m_hFiles  ;
+   details = m_hDetails;
+   } // mutex
+
+   m_pWorker->run([files, details]() {
+      QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+
+      QFile file(path());
+
+      if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+         qWarning() << "Unable to save the certificate cache";
+         return;
+      }
+
+      QDataStream stream(&file);
+      stream.setVersion(QDataStream::Qt_5_9);
+
+      stream << MAGIC;
+
+      stream << static_cast<quint32>(files.size());
+      for (auto i = files.constBegin(); i != files.constEnd(); ++i)
+         stream << i.key() << i->stamp << i->fingerprint;
+
+      stream << static_cast<quint32>(details.size());
+      for (auto i = details.constBegin(); i != details.constEnd(); ++i)
+         stream << i.key() << i.value();
+   });
+}
+
+/// Can be called from any thread
+void CertificateCache::scheduleSave()
+{
+   QTimer::singleShot(0, this, [this]() {
+      if (!m_pSaveTimer->isActive())
+         m_pSaveTimer->start();
+   });
+}
+
+/**
+ * The SHA1 of the file content.
+ *
+ * It is empty when the file cannot be read, in which case it should not be
+ * cached.
+ */
+QByteArray CertificateCache::fingerprint(const QString& path)
+{
+   const QByteArray s = stamp(path);
+
+   if (s.isEmpty())
+      return {};
+
+   { // mutex
+   QMutexLocker l(&m_Mutex);
+   load();
+
+   const auto i = m_hFiles.constFind(path);
+
+   if (i != m_hFiles.constEnd() && i->stamp == s)
+      return i->fingerprint;
+   } // mutex
+
+   // Don't block the other threads while reading the file
+   QFile file(path);
+
+   if (!file.open(QIODevice::ReadOnly))
+      return {};
+
+   QCryptographicHash hash(QCryptographicHash::Sha1);
+   hash.addData(&file);
+
+   const QByteArray fp = hash.result().toHex();
+
+   { // mutex
+   QMutexLocker l(&m_Mutex);
+   m_hFiles[path] = { s, fp };
+   } // mutex
+
+   scheduleSave();
+
+   return fp;
+}
+
+bool CertificateCache::details(const QByteArray& key, MapStringString& out)
+{
+   QMutexLocker l(&m_Mutex);
+   load();
+
+   const auto i = m_hDetails.constFind(key);
+
+   if (i == m_hDetails.constEnd())
+      return false;
+
+   out = i.value();
+
+   return true;
+}
+
+void CertificateCache::setDetails(const QByteArray& key, const MapStringString& details)
+{
+   // Don't remember the daemon failures
+   if (key.isEmpty() || details.isEmpty())
+      return;
+
+   { // mutex
+   QMutexLocker l(&m_Mutex);
+   load();
+   m_hDetails[key] = details;
+   } // mutex
+
+   scheduleSave();
+}
+
+/**
+ * Parse the certificates which are not in the cache yet.
+ *
+ * This is blocking and intended to be called from a worker thread. It uses
+ * the same arguments as a Certificate without private key so the details are
+ * found once the certificates are displayed. They are not validated, this
+ * is left until the checks are needed.
+ */
+void CertificateCache::prefetch(const QList<QByteArray>& paths)
+{
+   ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
+
+   for (const QByteArray& p : paths) {
+      const QString    path = QString::fromLatin1(p);
+      const QByteArray fp   = fingerprint(path);
+
+      if (fp.isEmpty())
+         continue;
+
+      MapStringString m;
+
+      if (!details(fp, m))
+         setDetails(fp, configurationManager.getCertificateDetailsPath(path, QString(), QString()));
+   }
+}
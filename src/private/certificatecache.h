@@ -0,0 +1,85 @@
+/****************************************************************************
+ *   Copyright (C) 2018 by Bluesystems                                      *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                    *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+
+//Ring
+#include <typedefs.h>
+
+class QTimer;
+class SerialThreadWorker;
+
+/**
+ * Persistent cache of the certificate details.
+ *
+ * Asking the daemon to parse a certificate is expensive and each certificate
+ * of a trust store used to be parsed every time the security settings were
+ * opened. The daemon answers are now kept on disk and reused.
+ *
+ * The details only depend on the certificate content and are keyed by its
+ * fingerprint. For the files, it is the SHA1 of the content and is computed
+ * again only when the modification time, size or permissions change.
+ *
+ * The checks are not cached. They also depend on the trust store, the
+ * revocation lists and the folder permissions, which can change at any time.
+ *
+ * This class is thread safe, the bulk parsing happens in the certificate
+ * folder loader thread.
+ */
+class CertificateCache final : public QObject
+{
+public:
+   static CertificateCache& instance();
+
+   QByteArray fingerprint(const QString& path);
+
+   bool details   (const QByteArray& key, MapStringString& out);
+   void setDetails(const QByteArray& key, const MapStringString& details);
+
+   void prefetch(const QList<QByteArray>& paths);
+
+private:
+   explicit CertificateCache(QObject* parent);
+
+   struct FileStamp {
+      QByteArray stamp      ;
+      QByteArray fingerprint;
+   };
+
+   //Attributes
+   QMutex                             m_Mutex             ;
+   bool                               m_IsLoaded  {false} ;
+   QHash<QString   , FileStamp      > m_hFiles            ;
+   QHash<QByteArray, MapStringString> m_hDetails          ;
+   QTimer*                            m_pSaveTimer        ;
+   SerialThreadWorker*                m_pWorker           ;
+
+   constexpr static const char    FILENAME[] = "certificates.cache";
+   constexpr static const quint32 MAGIC      = 0x52434332; // RCC2
+
+   //Helpers
+   static QString    path ();
+   static QByteArray stamp(const QString& path);
+   void load        ();
+   void save        ();
+   void scheduleSave();
+};
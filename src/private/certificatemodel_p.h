@@ -23,6 +23,8 @@
 #include <QtCore/QMutex>
 #include <QtCore/QObject>
 
+#include "memorystatistics.h"
+
 struct CertificateNode;
 class Account;
 class CertificateModel;
@@ -51,6 +53,7 @@ public:
    void loadChecks(CertificateNode* checks, Certificate* cert);
    void regenChecks(Certificate* cert);
    bool isPartOf(CertificateNode* sibling, CertificateNode* list);
+   QVector<MemoryStatistics::Usage> memoryUsage();
 
    //Attributes
    QVector<CertificateNode*>        m_lTopLevelNodes    ;
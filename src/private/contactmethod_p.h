@@ -65,6 +65,7 @@ public:
    QString            m_RegisteredName             ;
    UsageStatistics*   m_pUsageStats       {nullptr};
    QVector<Media::TextRecording*> m_lAltTR;
+   QByteArray         m_SentProfileVersion         ; ///< Last profile sent to this CM
 
    // ContactRequests
    bool m_IsConfirmationEnabled {true};
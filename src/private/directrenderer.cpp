@@ -33,6 +33,7 @@
 #include "private/videorenderermanager.h"
 #include "video/resolution.h"
 #include "private/videorenderer_p.h"
+#include "tracing.h"
 
 #include "videomanager_interface.h"
 
@@ -101,6 +102,8 @@ DRing::SinkTarget::FrameBufferPtr Video::DirectRendererPrivate::requestFrameBuff
 
 void Video::DirectRendererPrivate::onNewFrame(DRing::SinkTarget::FrameBufferPtr buf)
 {
+    Tracing::Span s("video", "DirectRenderer::onNewFrame");
+
     if (not q_ptr->isRendering())
         return;
 
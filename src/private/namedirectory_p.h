@@ -19,6 +19,16 @@
 
 #include "namedirectory.h"
 
+//Qt
+#include <QtCore/QCache>
+#include <QtCore/QVector>
+#include <QtCore/QPair>
+#include <QtCore/QSet>
+class QTimer;
+
+//Std
+#include <functional>
+
 typedef void (NameDirectoryPrivate::*NameDirectoryPrivateFct)();
 
 class NameDirectoryPrivate: public QObject
@@ -31,7 +41,54 @@ private:
 public:
     NameDirectoryPrivate(NameDirectory*);
 
+    /// The name service URL and the name, the results depend on both
+    using NameKey = QPair<QString, QString>;
+
+    struct CachedName {
+        QString                     address;
+        NameDirectory::LookupStatus status ;
+        qint64                      expiry ;
+    };
+
+    /// A request sent to the daemon, all accounts waiting for it get the reply
+    struct InFlightLookup {
+        qint64        sentAt    ;
+        QSet<QString> accountIds;
+    };
+
+    struct PendingLookup {
+        QString accountId;
+        QString name     ;
+    };
+
+    // Wait until the user stops typing before sending the lookups
+    constexpr static const int    DEBOUNCE_DELAY    = 150;
+    constexpr static const int    CACHE_SIZE        = 1024;
+    constexpr static const qint64 POSITIVE_TTL      = 30 * 60 * 1000;
+    constexpr static const qint64 NEGATIVE_TTL      = 5  * 60 * 1000;
+    // If the daemon never replies, allow the lookup to be sent again
+    constexpr static const qint64 IN_FLIGHT_TIMEOUT = 30 * 1000;
+
+    //Attributes
+    QCache<NameKey, CachedName>     m_Cache         {CACHE_SIZE};
+    QHash<NameKey, InFlightLookup>  m_hInFlight     ;
+    QVector<PendingLookup>          m_lPending      ;
+    QTimer*                         m_pDebounceTimer;
+    NameDirectory::LookupStatistics m_Stats         ;
+
+    /// The daemon call, it can be replaced by a stub for testing
+    std::function<bool(const QString& accountId, const QString& nameServiceURL, const QString& name)> m_fLookupName;
+
+    //Helpers
+    static NameKey key(const Account* account, const QString& nameServiceURL, const QString& name);
+    static const Account* lookupAccount(const Account* account);
+    const CachedName* cached(const NameKey& k);
+    bool sendLookup(const QString& accountId, const QString& nameServiceURL, const NameKey& k);
+    void queueLookup(const QString& accountId, const QString& name);
+    void emitRegisteredNameFound(const QString& accountId, NameDirectory::LookupStatus status, const QString& address, const QString& name);
+
 public Q_SLOTS:
+    void slotFlushLookups();
     void slotNameRegistrationEnded(const QString& accountId, int status, const QString& name);
     void slotRegisteredNameFound(const QString& accountId, int status, const QString& address, const QString& name);
 
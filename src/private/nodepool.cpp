@@ -0,0 +1,161 @@
+/****************************************************************************
+ *   Copyright (C) 2018 by Bluesystems                                      *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                    *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "nodepool.h"
+
+//STD
+#include <algorithm>
+
+/// All pools, they are never deleted
+static QVector<NodePoolBase*>& pools()
+{
+    static QVector<NodePoolBase*> l;
+    return l;
+}
+
+static QMutex& poolsMutex()
+{
+    static QMutex m;
+    return m;
+}
+
+NodeSlab::NodeSlab(const char* name, std::size_t slotSize, std::size_t alignment, int chunkSize) :
+    m_pName(name), m_ChunkSize(chunkSize)
+{
+    // Chunks are aligned for any type, align the slots within them
+    alignment  = std::max(alignment, alignof(FreeSlot));
+    slotSize   = std::max(slotSize, sizeof(FreeSlot));
+    m_SlotSize = ((slotSize + alignment - 1) / alignment) * alignment;
+}
+
+NodeSlab::~NodeSlab()
+{
+    Q_ASSERT(!m_Live);
+
+    for (auto c : m_lChunks)
+        ::operator delete(c);
+}
+
+void* NodeSlab::allocate()
+{
+    m_Allocations++;
+    m_Live++;
+
+    if (m_pFree) {
+        auto s  = m_pFree;
+        m_pFree = s->m_pNext;
+        return s;
+    }
+
+    if (m_lChunks.empty() || m_NextSlot == m_ChunkSize) {
+        m_lChunks.push_back(static_cast<char*>(::operator new(m_SlotSize * m_ChunkSize)));
+        m_NextSlot = 0;
+    }
+
+    return m_lChunks.back() + (m_NextSlot++) * m_SlotSize;
+}
+
+void NodeSlab::release(void* p)
+{
+    if (!p)
+        return;
+
+    Q_ASSERT(m_Live > 0);
+
+    // Everything is gone, give the memory back at once
+    if (!--m_Live) {
+        reset();
+        return;
+    }
+
+    auto s     = static_cast<FreeSlot*>(p);
+    s->m_pNext = m_pFree;
+    m_pFree    = s;
+}
+
+void NodeSlab::reset()
+{
+    Q_ASSERT(!m_Live);
+    clear();
+}
+
+void NodeSlab::clear()
+{
+    m_Live = 0;
+
+    // Keep the first chunk, models often go back and forth between 0 and 1
+    // node. It would otherwise allocate and free the whole chunk each time.
+    for (std::size_t i = 1; i < m_lChunks.size(); i++)
+        ::operator delete(m_lChunks[i]);
+
+    if (m_lChunks.size() > 1)
+        m_lChunks.resize(1);
+
+    m_pFree    = nullptr;
+    m_NextSlot = 0;
+}
+
+NodeSlab::Statistics NodeSlab::statistics() const
+{
+    return {
+        m_pName,
+        m_Allocations,
+        m_Live,
+        static_cast<int>(m_lChunks.size()),
+        static_cast<qint64>(m_lChunks.size() * m_SlotSize * m_ChunkSize)
+    };
+}
+
+NodePoolBase::NodePoolBase(const char* name, std::size_t slotSize, std::size_t alignment, int chunkSize) :
+    m_Slab(name, slotSize, alignment, chunkSize)
+{
+    QMutexLocker l(&poolsMutex());
+    pools() << this;
+}
+
+void* NodePoolBase::allocate()
+{
+    QMutexLocker l(&m_Mutex);
+    return m_Slab.allocate();
+}
+
+void NodePoolBase::release(void* p)
+{
+    if (!p)
+        return;
+
+    QMutexLocker l(&m_Mutex);
+    m_Slab.release(p);
+}
+
+NodePoolBase::Statistics NodePoolBase::statistics() const
+{
+    QMutexLocker l(&m_Mutex);
+    return m_Slab.statistics();
+}
+
+QVector<NodePoolBase::Statistics> NodePoolBase::allStatistics()
+{
+    QVector<Statistics> ret;
+
+    QMutexLocker l(&poolsMutex());
+
+    for (const auto p : qAsConst(pools()))
+        ret << p->statistics();
+
+    return ret;
+}
@@ -0,0 +1,205 @@
+/****************************************************************************
+ *   Copyright (C) 2018 by Bluesystems                                      *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                    *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+
+//STD
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * Allocate the small bookkeeping nodes of the models from typed pools.
+ *
+ * Large histories create millions of small nodes. Allocating them with the
+ * global `new` scatters them in the heap and makes the linked list and tree
+ * walks cache unfriendly. Each pool allocates slots contiguously from large
+ * chunks. Freed slots are reused first. When the last node of a type is
+ * freed, all chunks but the first are released.
+ *
+ * The nodes keep using `new` and `delete`. A type opts in by adding
+ * NODE_POOL_ALLOCATED to its public section:
+ *
+ *    struct MyNode final {
+ *        NODE_POOL_ALLOCATED(MyNode)
+ *        [...]
+ *    };
+ *
+ * The types must not be derived from, the slots have a fixed size.
+ *
+ * The pools are shared by every instance of a model, so their memory can
+ * only be given back node by node. A model which has many instances, or
+ * resets often, should own a NodeArena instead. It is not locked and
+ * NodeArena::clear() gives all its memory back at once.
+ *
+ * Both are built on a NodeSlab, which manages the chunks and slots.
+ */
+class NodeSlab final
+{
+public:
+    struct Statistics {
+        const char* name       ; /*!< The node type                     */
+        quint64     allocations; /*!< Total allocations since creation  */
+        int         live       ; /*!< Currently allocated nodes         */
+        int         chunks     ; /*!< Currently allocated chunks        */
+        qint64      bytes      ; /*!< Memory held by the chunks         */
+    };
+
+    explicit NodeSlab(const char* name, std::size_t slotSize, std::size_t alignment, int chunkSize);
+    ~NodeSlab();
+
+    void* allocate();
+    void  release(void* p);
+
+    /// Release all chunks but the first, every node must have been released
+    void reset();
+
+    /// Like reset(), but the nodes still allocated are dropped with the chunks
+    void clear();
+
+    Statistics statistics() const;
+
+private:
+    struct FreeSlot { FreeSlot* m_pNext; };
+
+    const char*        m_pName                ;
+    std::size_t        m_SlotSize             ;
+    int                m_ChunkSize            ;
+    std::vector<char*> m_lChunks              ;
+    FreeSlot*          m_pFree       {nullptr};
+    int                m_NextSlot    {   0   };
+    int                m_Live        {   0   };
+    quint64            m_Allocations {   0   };
+
+    Q_DISABLE_COPY(NodeSlab)
+};
+
+/// A NodeSlab shared by all threads
+class NodePoolBase
+{
+public:
+    using Statistics = NodeSlab::Statistics;
+
+    void* allocate();
+    void  release(void* p);
+
+    Statistics statistics() const;
+
+    /// The statistics of every pool
+    static QVector<Statistics> allStatistics();
+
+protected:
+    explicit NodePoolBase(const char* name, std::size_t slotSize, std::size_t alignment, int chunkSize);
+
+private:
+    mutable QMutex m_Mutex;
+    NodeSlab       m_Slab ;
+
+    Q_DISABLE_COPY(NodePoolBase)
+};
+
+template<typename T, int ChunkSize = 512>
+class NodePool final : public NodePoolBase
+{
+public:
+    static NodePool& instance(const char* name);
+
+private:
+    explicit NodePool(const char* name) :
+        NodePoolBase(name, sizeof(T), alignof(T), ChunkSize) {}
+};
+
+template<typename T, int ChunkSize>
+NodePool<T, ChunkSize>& NodePool<T, ChunkSize>::instance(const char* name)
+{
+    // Never deleted, the nodes can outlive the static destructors
+    static auto pool = new NodePool<T, ChunkSize>(name);
+    return *pool;
+}
+
+#define NODE_POOL_ALLOCATED(T) \
+    static void* operator new(std::size_t size) { \
+        Q_ASSERT(size == sizeof(T)); Q_UNUSED(size) \
+        return NodePool<T>::instance(#T).allocate(); \
+    } \
+    static void operator delete(void* p) { \
+        NodePool<T>::instance(#T).release(p); \
+    }
+
+/**
+ * The nodes of a single model instance.
+ *
+ * It must only be used from the thread owning the model. Everything is
+ * released when the arena is destroyed, so the model has to destroy or
+ * clear() the nodes first.
+ *
+ *    auto n = m_Arena.create();
+ *    [...]
+ *    m_Arena.destroy(n);
+ *
+ * When the model is reset, clear() releases the slots in O(chunks) instead
+ * of pushing each of them on the free list.
+ */
+template<typename T, int ChunkSize = 512>
+class NodeArena final
+{
+public:
+    explicit NodeArena(const char* name) :
+        m_Slab(name, sizeof(T), alignof(T), ChunkSize) {}
+
+    template<typename... Args>
+    T* create(Args&&... args) {
+        return ::new (m_Slab.allocate()) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T* n) {
+        if (!n)
+            return;
+
+        n->~T();
+        m_Slab.release(n);
+    }
+
+    /// Call after destroying all nodes, when the model is reset
+    void reset() { m_Slab.reset(); }
+
+    /**
+     * Release all nodes at once.
+     *
+     * The destructors are not called. It is meant for trivially destructible
+     * nodes or for nodes already passed to destruct().
+     */
+    void clear() { m_Slab.clear(); }
+
+    /// Run the destructor of `n` but keep its slot until clear()
+    void destruct(T* n) {
+        if (n)
+            n->~T();
+    }
+
+    NodeSlab::Statistics statistics() const { return m_Slab.statistics(); }
+
+private:
+    NodeSlab m_Slab;
+
+    Q_DISABLE_COPY(NodeArena)
+};
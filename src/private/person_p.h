@@ -40,6 +40,9 @@ public:
     QString                  m_SecondName          ;
     QString                  m_NickName            ;
     QVariant                 m_vPhoto              ;
+    QByteArray               m_PhotoData           ;
+    QByteArray               m_PhotoType           ;
+    QByteArray               m_PhotoHash           ;
     QString                  m_FormattedName       ;
     QString                  m_PreferredEmail      ;
     QString                  m_Organization        ;
@@ -71,6 +74,7 @@ public:
     QString m_CachedFilterString;
 
     QString filterString();
+    QVariant decodedPhoto();
 
     //Helper code to help handle multiple parents
     QList<Person*> m_lParents;
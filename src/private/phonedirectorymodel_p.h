@@ -18,6 +18,7 @@
 #pragma once
 
 #include <QtCore/QObject>
+#include <QtCore/QSet>
 
 //Ring
 class PhoneDirectoryModel;
@@ -25,10 +26,14 @@ class LocalNameServiceCache;
 #include "contactmethod.h"
 #include "account.h"
 #include "namedirectory.h"
+#include "memorystatistics.h"
+#include "private/nodepool.h"
 
 //Internal data structures
 ///@struct NumberWrapper Wrap phone numbers to prevent collisions
 struct NumberWrapper final {
+   NODE_POOL_ALLOCATED(NumberWrapper)
+
    explicit NumberWrapper(const QString& k) : key(k) {}
 
    QString key;
@@ -85,11 +90,26 @@ public:
    };
 
 
+   /// Presence notifications received since the last flush, the last one wins
+   struct PendingPresence {
+      bool    present;
+      QString message;
+   };
+   using PresenceId = QPair<Account*, QString>;
+
    //Helpers
    void indexNumber(ContactMethod* number, const QStringList& names   );
    void setAccount (ContactMethod* number,       Account*     account );
    ContactMethod* fillDetails(NumberWrapper* wrap, const URI& strippedUri, Account* account, Person* contact, const QString& type);
    void registerAlternateNames(ContactMethod* number, Account* account, const URI& uri, const URI& extendedUri);
+   void appendNumber(ContactMethod* cm);
+   void beginBatch();
+   void endBatch();
+   void schedulePresenceFlush();
+   ContactMethod* presenceContactMethod(const PresenceId& id);
+   void forgetPresenceIds(ContactMethod* cm);
+   void indexAccount(ContactMethod* cm);
+   QVector<MemoryStatistics::Usage> memoryUsage() const;
 
    //Attributes
    QVector<ContactMethod*>         m_lNumbers         ;
@@ -102,6 +122,27 @@ public:
    MostPopularNumberModel*       m_pPopularModel    ;
    LocalNameServiceCache*        m_pNameServiceCache {nullptr};
    QMutex                        m_DirectoryAccess;
+   int                           m_BatchDepth       {0};
+   QVector<ContactMethod*>       m_lBatchedNumbers  ;
+
+   QHash<PresenceId, PendingPresence> m_hPendingPresence  ;
+   QHash<PresenceId, ContactMethod*>  m_hPresenceIds      ; ///< Resolved buddies
+   QMultiHash<ContactMethod*, PresenceId> m_hPresenceCMs  ; ///< The reverse of m_hPresenceIds
+   QHash<Account*, QVector<ContactMethod*> > m_hNumbersByAccount; ///< nullptr for the default account
+   QSet<Account*>                     m_lPendingAccounts  ;
+   bool                               m_FlushScheduled    {false};
+
+   /// Rows changed while the presence is being applied, -1 when not flushing
+   int                           m_DirtyFirst       {-1};
+   int                           m_DirtyLast        {-1};
+   bool                          m_IsFlushing       {false};
+
+   // Statistics
+   quint64                       m_PresenceUpdates  {0};
+   quint64                       m_CoalescedUpdates {0};
+
+   /// The resolved buddies are only a shortcut, forget them past that size
+   static constexpr const int MAX_PRESENCE_IDS = 8192;
 
    Q_DECLARE_PUBLIC(PhoneDirectoryModel)
 
@@ -116,6 +157,9 @@ private Q_SLOTS:
    void slotRegisteredNameFound(Account* account, NameDirectory::LookupStatus status, const QString& address, const QString& name);
    void slotContactMethodMerged(ContactMethod* other);
    void slotAccountStateChanged(Account* a, const Account::RegistrationState state);
+   void slotFlushPresence();
+   void slotAccountChanged();
+   void slotPresenceContactMethodDestroyed(QObject* o);
 
    //From DBus
    void slotNewBuddySubscription(const QString& uri, const QString& accountId, bool status, const QString& message);
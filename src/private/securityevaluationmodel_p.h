@@ -32,6 +32,32 @@ class SecurityEvaluationModelPrivate final : public QObject
 public:
    SecurityEvaluationModelPrivate(Account* account, SecurityEvaluationModel* parent);
 
+   /**
+    * What the security rules read.
+    *
+    * Each rule declares its inputs. When the account or one of its
+    * certificates change, only the rules depending on what changed are
+    * evaluated again.
+    */
+   enum class Input {
+      NONE            = 0x0     ,
+      PROTOCOL        = 0x1 << 0, /*!< The account type                                */
+      SRTP            = 0x1 << 1, /*!< The media encryption settings                   */
+      TLS             = 0x1 << 2, /*!< The negotiation encryption                      */
+      TLS_VERIFY      = 0x1 << 3, /*!< The peer certificates verification policies     */
+      TLS_SERVER_NAME = 0x1 << 4, /*!< The expected server name                        */
+      CIPHERS         = 0x1 << 5, /*!< The TLS method and cipher list                  */
+      CERTIFICATE     = 0x1 << 6, /*!< The account certificate, its private key and checks */
+      AUTHORITY       = 0x1 << 7, /*!< The certificate authority and its checks        */
+      ALL             = 0xff    ,
+   };
+
+   /// The failed rules of a source, as they affect the aggregate
+   struct Contribution {
+      int counts[enum_class_size<SecurityEvaluationModel::Severity>()] {};
+      SecurityEvaluationModel::SecurityLevel level {SecurityEvaluationModel::SecurityLevel::COMPLETE};
+   };
+
    //Attributes
    QList<SecurityFlaw*>  m_lCurrentFlaws       ;
    SecurityEvaluationModel::SecurityLevel m_CurrentSecurityLevel;
@@ -42,10 +68,30 @@ public:
 
    AccountChecksModel*          m_pAccChecks;
 
+   /// The inputs changed since the last evaluation
+   FlagPack<Input> m_PendingInputs;
+
+   Contribution m_AccountContribution    ;
+   Contribution m_CertificateContribution;
+   Contribution m_AuthorityContribution  ;
+
+   /// The certificates the contributions were computed from
+   Certificate*            m_pCertificate {nullptr};
+   Certificate*            m_pAuthority   {nullptr};
+   QMetaObject::Connection m_cCertificate ;
+   QMetaObject::Connection m_cAuthority   ;
+
+   /// Number of rules evaluated by the last change and since the creation
+   int    m_LastEvaluatedRules  {0};
+   qint64 m_TotalEvaluatedRules {0};
+
    //Helper
-   static SecurityEvaluationModel::SecurityLevel maxSecurityLevel(QAbstractItemModel* m, int* counter = nullptr);
    static QAbstractItemModel* getCertificateSeverityProxy(Certificate* c);
    static SecurityEvaluationModel::SecurityLevel certificateSecurityLevel(const Certificate* c, bool forceIgnorePrivateKey = false);
+   static FlagPack<Input> inputsOf(const QString& property);
+   int evaluateCertificate(Certificate* c, Contribution& contribution);
+   void trackCertificate(Certificate* c, Certificate*& current, QMetaObject::Connection& connection, Input input);
+   void update(const FlagPack<Input>& inputs = Input::NONE);
 
    ///Messages to show to the end user
    static const QString messages[enum_class_size<SecurityEvaluationModel::AccountSecurityChecks>()];
@@ -57,11 +103,13 @@ public:
    static const TypedStateMachine< SecurityEvaluationModel::SecurityLevel , Certificate::Checks > maximumCertificateSecurityLevel;
    static const TypedStateMachine< SecurityEvaluationModel::Severity      , Certificate::Checks > certificateFlawSeverity        ;
 
+   static const TypedStateMachine< FlagPack<Input>                        , SecurityEvaluationModel::AccountSecurityChecks > ruleInputs;
+
    SecurityEvaluationModel* q_ptr;
 
 public Q_SLOTS:
-   void update();
    void updateReal();
 
 };
+DECLARE_ENUM_FLAGS(SecurityEvaluationModelPrivate::Input)
 
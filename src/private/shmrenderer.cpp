@@ -41,6 +41,7 @@
 #include "private/videorenderermanager.h"
 #include "video/resolution.h"
 #include "private/videorenderer_p.h"
+#include "tracing.h"
 
 // Uncomment following line to output in console the FPS value
 //#define DEBUG_FPS
@@ -145,6 +146,8 @@ ShmRenderer::~ShmRenderer()
 /// Wait new frame data from shared memory and save pointer
 bool ShmRendererPrivate::getNewFrame(bool wait)
 {
+   Tracing::Span s("video", "ShmRenderer::getNewFrame");
+
    if (!shmLock())
       return false;
 
@@ -24,6 +24,11 @@
 #include <QtCore/QAbstractListModel>
 #include <QtCore/QItemSelectionModel>
 #include <QtCore/QSortFilterProxyModel>
+#include <QtCore/QCollator>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
 
 //Ring
 #include "libcard/matrixutils.h"
@@ -31,6 +36,10 @@
 #include <categorizedhistorymodel.h>
 #include <globalinstances.h>
 #include <interfaces/pixmapmanipulatori.h>
+#include <historytimecategorymodel.h>
+#include <contactmethod.h>
+#include <person.h>
+#include <call.h>
 
 namespace CategoryModelCommon {
    inline Qt::ItemFlags flags(const QModelIndex& idx) {
@@ -67,11 +76,45 @@ class RemoveDisabledProxy : public QSortFilterProxyModel
 {
    Q_OBJECT
 public:
-   explicit RemoveDisabledProxy(QObject* parent) : QSortFilterProxyModel(parent) {
-      setDynamicSortFilter(true);
-   }
+   /// The cached keys used instead of the sort role QVariant
+   enum class SortKey {
+      DEFAULT         , /*!< Use QSortFilterProxyModel::lessThan    */
+      PERSON_NAME     , /*!< Person::formattedName collation key    */
+      PERSON_LAST_USED, /*!< Person::lastUsedTime history category  */
+      CALL_DATE       , /*!< Call::startTimeStamp                   */
+      CALL_NAME       , /*!< Call::formattedName collation key      */
+      CALL_COUNT      , /*!< ContactMethod::callCount               */
+      CALL_LENGTH     , /*!< The call duration in seconds           */
+      CALL_SPENT_TIME , /*!< ContactMethod::totalSpentTime          */
+   };
+
+   explicit RemoveDisabledProxy(QObject* parent);
+
+   void setSortKey(SortKey k);
+
 protected:
    virtual bool filterAcceptsRow ( int source_row, const QModelIndex & source_parent ) const override;
+   virtual bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
+   virtual bool eventFilter(QObject* obj, QEvent* event) override;
+
+private:
+   /// A collation key and the name it was built from
+   struct NameKey {
+      QString          name;
+      QCollatorSortKey key ;
+   };
+
+   SortKey                       m_SortKey           {SortKey::DEFAULT};
+   QCollator                     m_Collator          {                };
+   QHash<const QObject*,NameKey> m_hNameKeys         {                };
+   QSet<const QObject*>          m_hTracked          {                };
+   bool                          m_IsResortScheduled {     false      };
+
+   static QString sortName(const QObject* o);
+   QCollatorSortKey nameKey(const QObject* o);
+   void checkName(const QObject* o);
+   void forget(const QObject* o);
+   void resetCollator();
 };
 
 class ContactSortingCategoryModel : public QAbstractListModel
@@ -109,6 +152,219 @@ bool RemoveDisabledProxy::filterAcceptsRow ( int source_row, const QModelIndex &
    return QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
 }
 
+RemoveDisabledProxy::RemoveDisabledProxy(QObject* parent) : QSortFilterProxyModel(parent)
+{
+   setDynamicSortFilter(true);
+   resetCollator();
+
+   // The collator is bound to the locale it was created with
+   if (QCoreApplication::instance())
+      QCoreApplication::instance()->installEventFilter(this);
+}
+
+void RemoveDisabledProxy::resetCollator()
+{
+   // Match the proxies setSortLocaleAware and setSortCaseSensitivity
+   m_Collator = QCollator();
+   m_Collator.setCaseSensitivity(Qt::CaseInsensitive);
+}
+
+bool RemoveDisabledProxy::eventFilter(QObject* obj, QEvent* event)
+{
+   if (obj == QCoreApplication::instance() && event->type() == QEvent::LocaleChange) {
+      resetCollator();
+      m_hNameKeys.clear();
+
+      if (m_SortKey == SortKey::PERSON_NAME || m_SortKey == SortKey::CALL_NAME)
+         invalidate();
+   }
+
+   return QSortFilterProxyModel::eventFilter(obj, event);
+}
+
+QString RemoveDisabledProxy::sortName(const QObject* o)
+{
+   if (auto p = qobject_cast<const Person*>(o))
+      return p->formattedName();
+
+   return static_cast<const ContactMethod*>(o)->bestName();
+}
+
+/**
+ * Building a QCollatorSortKey is expensive, but comparing two of them is
+ * little more than a memcmp. The keys are kept until the name changes.
+ *
+ * Note that the key is returned by value (it is implicitly shared) because
+ * inserting in the hash can invalidate the references.
+ */
+QCollatorSortKey RemoveDisabledProxy::nameKey(const QObject* o)
+{
+   const auto it = m_hNameKeys.constFind(o);
+
+   if (it != m_hNameKeys.constEnd())
+      return it->key;
+
+   const QString name = sortName(o);
+   const QCollatorSortKey key = m_Collator.sortKey(name);
+
+   m_hNameKeys.insert(o, {name, key});
+
+   if (m_hTracked.contains(o))
+      return key;
+
+   m_hTracked.insert(o);
+
+   if (auto p = qobject_cast<const Person*>(o)) {
+      connect(p, &Person::changed, this, [this, o]() { checkName(o); });
+      connect(p, &Person::formattedNameChanged, this, [this, o]() { checkName(o); });
+   }
+   else if (auto cm = qobject_cast<const ContactMethod*>(o)) {
+      connect(cm, &ContactMethod::changed, this, [this, o]() { checkName(o); });
+      connect(cm, &ContactMethod::primaryNameChanged, this, [this, o]() { checkName(o); });
+   }
+
+   connect(o, &QObject::destroyed, this, [this, o]() { forget(o); });
+
+   return key;
+}
+
+/// Drop the key when the name changes and re-sort once the events settled
+void RemoveDisabledProxy::checkName(const QObject* o)
+{
+   const auto it = m_hNameKeys.find(o);
+
+   if (it == m_hNameKeys.end() || it->name == sortName(o))
+      return;
+
+   m_hNameKeys.erase(it);
+
+   // The source model may already have asked for a re-sort using the old
+   // key, so a full one is needed. Many names can change at once (e.g. when
+   // the contacts are loaded), only do it once.
+   if (m_IsResortScheduled)
+      return;
+
+   m_IsResortScheduled = true;
+
+   QTimer::singleShot(0, this, [this]() {
+      m_IsResortScheduled = false;
+      if (m_SortKey == SortKey::PERSON_NAME || m_SortKey == SortKey::CALL_NAME)
+         invalidate();
+   });
+}
+
+void RemoveDisabledProxy::forget(const QObject* o)
+{
+   m_hNameKeys.remove(o);
+   m_hTracked.remove(o);
+}
+
+/// The call duration in seconds (without the QString formatting of length())
+static time_t callDuration(const Call* c)
+{
+   const time_t start = c->startTimeStamp();
+
+   if (!start)
+      return 0;
+
+   if (const time_t stop = c->stopTimeStamp())
+      return stop > start ? stop - start : 0;
+
+   time_t curTime;
+   ::time(&curTime);
+
+   return curTime - start;
+}
+
+void RemoveDisabledProxy::setSortKey(SortKey k)
+{
+   if (m_SortKey == k)
+      return;
+
+   m_SortKey = k;
+   invalidate();
+}
+
+bool RemoveDisabledProxy::lessThan(const QModelIndex& left, const QModelIndex& right) const
+{
+   // The key cache is lazy loaded
+   auto self = const_cast<RemoveDisabledProxy*>(this);
+
+   // The categories are few and have no objects, let Qt handle them
+   if (m_SortKey == SortKey::DEFAULT || !left.parent().isValid())
+      return QSortFilterProxyModel::lessThan(left, right);
+
+   // A single QVariant with a pointer instead of materializing and comparing
+   // the role strings for each comparison.
+   const QVariant lv = left .data(static_cast<int>(Ring::Role::Object));
+   const QVariant rv = right.data(static_cast<int>(Ring::Role::Object));
+
+   switch(m_SortKey) {
+      case SortKey::PERSON_NAME:
+      case SortKey::PERSON_LAST_USED: {
+         const auto lp = qvariant_cast<Person*>(lv);
+         const auto rp = qvariant_cast<Person*>(rv);
+
+         // ContactMethods under the person are not sorted by the keys
+         if ((!lp) || (!rp))
+            return QSortFilterProxyModel::lessThan(left, right);
+
+         if (m_SortKey == SortKey::PERSON_NAME)
+            return self->nameKey(lp).compare(self->nameKey(rp)) < 0;
+
+         return HistoryTimeCategoryModel::timeToHistoryConst(lp->lastUsedTime())
+            < HistoryTimeCategoryModel::timeToHistoryConst(rp->lastUsedTime());
+      }
+      case SortKey::CALL_DATE:
+      case SortKey::CALL_NAME:
+      case SortKey::CALL_COUNT:
+      case SortKey::CALL_LENGTH:
+      case SortKey::CALL_SPENT_TIME: {
+         const auto lc = qvariant_cast<Call*>(lv);
+         const auto rc = qvariant_cast<Call*>(rv);
+
+         if ((!lc) || (!rc))
+            return QSortFilterProxyModel::lessThan(left, right);
+
+         const auto lcm = lc->peerContactMethod();
+         const auto rcm = rc->peerContactMethod();
+
+         // Conferences and dialing calls have no (or a temporary) ContactMethod
+         const bool hasCms = lcm && rcm
+            && lc->type() != Call::Type::CONFERENCE
+            && rc->type() != Call::Type::CONFERENCE;
+
+         switch(m_SortKey) {
+            case SortKey::CALL_DATE:
+               return lc->startTimeStamp() < rc->startTimeStamp();
+            case SortKey::CALL_NAME:
+               if (!hasCms)
+                  return m_Collator.compare(lc->formattedName(), rc->formattedName()) < 0;
+
+               return self->nameKey(lcm).compare(self->nameKey(rcm)) < 0;
+            case SortKey::CALL_COUNT:
+               if ((!lcm) || (!rcm))
+                  return QSortFilterProxyModel::lessThan(left, right);
+
+               return lcm->callCount() < rcm->callCount();
+            case SortKey::CALL_LENGTH:
+               return callDuration(lc) < callDuration(rc);
+            case SortKey::CALL_SPENT_TIME:
+               if ((!lcm) || (!rcm))
+                  return QSortFilterProxyModel::lessThan(left, right);
+
+               return lcm->totalSpentTime() < rcm->totalSpentTime();
+            default:
+               break;
+         }
+      } break;
+      case SortKey::DEFAULT:
+         break;
+   }
+
+   return QSortFilterProxyModel::lessThan(left, right);
+}
+
 ContactSortingCategoryModel::ContactSortingCategoryModel(QObject* parent) : QAbstractListModel(parent)
 {
 
@@ -119,7 +375,7 @@ ContactSortingCategoryModel::~ContactSortingCategoryModel()
 
 }
 
-static void sortContact(QSortFilterProxyModel* p, int roleIdx)
+static void sortContact(RemoveDisabledProxy* p, int roleIdx)
 {
    static auto& m = CategorizedContactModel::instance();
    switch(static_cast<CategorizedContactModel::SortedProxy::Categories>(roleIdx)) {
@@ -127,30 +383,35 @@ static void sortContact(QSortFilterProxyModel* p, int roleIdx)
          m.setSortAlphabetical(true);
          m.setDefaultCategory(QT_TRANSLATE_NOOP("CategorizedContactModel", "Empty"));
          p->setSortRole(Qt::DisplayRole);
+         p->setSortKey(RemoveDisabledProxy::SortKey::PERSON_NAME);
          m.setRole(Qt::DisplayRole);
          break;
       case CategorizedContactModel::SortedProxy::Categories::ORGANIZATION:
          m.setSortAlphabetical(false);
          m.setDefaultCategory(QT_TRANSLATE_NOOP("CategorizedContactModel", "Unknown"));
          p->setSortRole((int)Person::Role::Organization);
+         p->setSortKey(RemoveDisabledProxy::SortKey::DEFAULT);
          m.setRole((int)Person::Role::Organization);
          break;
       case CategorizedContactModel::SortedProxy::Categories::RECENTLYUSED:
          m.setSortAlphabetical(false);
          m.setDefaultCategory(QT_TRANSLATE_NOOP("CategorizedContactModel", "Never"));
          p->setSortRole((int)Person::Role::IndexedLastUsed);
+         p->setSortKey(RemoveDisabledProxy::SortKey::PERSON_LAST_USED);
          m.setRole((int)Person::Role::FormattedLastUsed);
          break;
       case CategorizedContactModel::SortedProxy::Categories::GROUP:
          m.setSortAlphabetical(false);
          m.setDefaultCategory(QT_TRANSLATE_NOOP("CategorizedContactModel", "Other"));
          p->setSortRole((int)Person::Role::Group);
+         p->setSortKey(RemoveDisabledProxy::SortKey::DEFAULT);
          m.setRole((int)Person::Role::Group);
          break;
       case CategorizedContactModel::SortedProxy::Categories::DEPARTMENT:
          m.setSortAlphabetical(false);
          m.setDefaultCategory(QT_TRANSLATE_NOOP("CategorizedContactModel", "Unknown"));
          p->setSortRole((int)Person::Role::Department);
+         p->setSortKey(RemoveDisabledProxy::SortKey::DEFAULT);
          m.setRole((int)Person::Role::Department);
          break;
       case CategorizedContactModel::SortedProxy::Categories::COUNT__:
@@ -186,29 +447,34 @@ bool ContactSortingCategoryModel::setData( const QModelIndex& index, const QVari
    return CategoryModelCommon::setData(index,value,role);
 }
 
-void sortHistory(QSortFilterProxyModel* p, int role);
-void sortHistory(QSortFilterProxyModel* p, int role)
+void sortHistory(RemoveDisabledProxy* p, int role);
+void sortHistory(RemoveDisabledProxy* p, int role)
 {
    switch (static_cast<CategorizedHistoryModel::SortedProxy::Categories>(role)) {
       case CategorizedHistoryModel::SortedProxy::Categories::DATE:
          CategorizedHistoryModel::instance().setCategoryRole(static_cast<int>(Call::Role::FuzzyDate));
          p->setSortRole(static_cast<int>(Call::Role::Date));
+         p->setSortKey(RemoveDisabledProxy::SortKey::CALL_DATE);
          break;
       case CategorizedHistoryModel::SortedProxy::Categories::NAME:
          CategorizedHistoryModel::instance().setCategoryRole(static_cast<int>(Call::Role::Name));
          p->setSortRole(Qt::DisplayRole);
+         p->setSortKey(RemoveDisabledProxy::SortKey::CALL_NAME);
          break;
       case CategorizedHistoryModel::SortedProxy::Categories::POPULARITY:
          CategorizedHistoryModel::instance().setCategoryRole(static_cast<int>(Call::Role::CallCount));
          p->setSortRole(static_cast<int>(Call::Role::CallCount));
+         p->setSortKey(RemoveDisabledProxy::SortKey::CALL_COUNT);
          break;
       case CategorizedHistoryModel::SortedProxy::Categories::LENGTH:
          CategorizedHistoryModel::instance().setCategoryRole(static_cast<int>(Call::Role::Length));
          p->setSortRole(static_cast<int>(Call::Role::Length));
+         p->setSortKey(RemoveDisabledProxy::SortKey::CALL_LENGTH);
          break;
       case CategorizedHistoryModel::SortedProxy::Categories::SPENT_TIME:
          CategorizedHistoryModel::instance().setCategoryRole(static_cast<int>(Call::Role::TotalSpentTime));
          p->setSortRole(static_cast<int>(Call::Role::TotalSpentTime));
+         p->setSortKey(RemoveDisabledProxy::SortKey::CALL_SPENT_TIME);
          break;
       case CategorizedHistoryModel::SortedProxy::Categories::COUNT__:
          break;
@@ -255,14 +521,15 @@ bool HistorySortingCategoryModel::setData( const QModelIndex& index, const QVari
 }
 
 template<typename T>
-SortingCategory::ModelTuple* createModels(QAbstractItemModel* src, int filterRole, int sortRole, std::function<void(QSortFilterProxyModel*,const QModelIndex&)> callback)
+SortingCategory::ModelTuple* createModels(QAbstractItemModel* src, int filterRole, int sortRole, RemoveDisabledProxy::SortKey sortKey, std::function<void(RemoveDisabledProxy*,const QModelIndex&)> callback)
 {
    SortingCategory::ModelTuple* ret = new SortingCategory::ModelTuple;
 
    ret->categories = new T(src);
 
-   QSortFilterProxyModel* proxy = new RemoveDisabledProxy(src);
+   RemoveDisabledProxy* proxy = new RemoveDisabledProxy(src);
    proxy->setSortRole              ( sortRole                  );
+   proxy->setSortKey               ( sortKey                   );
    proxy->setSortLocaleAware       ( true                      );
    proxy->setFilterRole            ( filterRole                );
    proxy->setSortCaseSensitivity   ( Qt::CaseInsensitive       );
@@ -280,7 +547,7 @@ SortingCategory::ModelTuple* createModels(QAbstractItemModel* src, int filterRol
 
 SortingCategory::ModelTuple* SortingCategory::getContactProxy()
 {
-   return createModels<ContactSortingCategoryModel>(&CategorizedContactModel::instance(),(int)Person::Role::Filter, Qt::DisplayRole, [](QSortFilterProxyModel* proxy,const QModelIndex& idx) {
+   return createModels<ContactSortingCategoryModel>(&CategorizedContactModel::instance(),(int)Person::Role::Filter, Qt::DisplayRole, RemoveDisabledProxy::SortKey::PERSON_NAME, [](RemoveDisabledProxy* proxy,const QModelIndex& idx) {
       if (idx.isValid()) {
          qDebug() << "Selection changed" << idx.row();
          sortContact(proxy,idx.row());
@@ -290,7 +557,7 @@ SortingCategory::ModelTuple* SortingCategory::getContactProxy()
 
 SortingCategory::ModelTuple* SortingCategory::getHistoryProxy()
 {
-   return createModels<HistorySortingCategoryModel>(&CategorizedHistoryModel::instance(),static_cast<int>(Call::Role::Filter), static_cast<int>(Call::Role::Date), [](QSortFilterProxyModel* proxy,const QModelIndex& idx) {
+   return createModels<HistorySortingCategoryModel>(&CategorizedHistoryModel::instance(),static_cast<int>(Call::Role::Filter), static_cast<int>(Call::Role::Date), RemoveDisabledProxy::SortKey::CALL_DATE, [](RemoveDisabledProxy* proxy,const QModelIndex& idx) {
      if (idx.isValid()) {
          qDebug() << "Selection changed" << idx.row();
          sortHistory(proxy,idx.row());
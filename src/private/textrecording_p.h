@@ -29,6 +29,7 @@
 #include "libcard/matrixutils.h"
 #include "media/mimemessage.h"
 #include "textrecordingcache.h"
+#include "nodepool.h"
 
 struct TextMessageNode;
 class InstantMessagingModel;
@@ -88,8 +89,14 @@ public:
 
     QList<Serializable::Group*> allGroups() const;
 
+    /// The estimated size of the recording, the messages are added to `messageBytes`
+    qint64 estimatedSize(int& messageCount, qint64& messageBytes) const;
+
     void clear();
 
+    /// Read and parse a recording file, it doesn't touch the models
+    static bool readJson(const QString& path, QJsonObject& out);
+
 Q_SIGNALS:
     void messageAdded(::TextMessageNode* m);
 
@@ -106,6 +113,8 @@ private:
  */
 struct TextMessageNode
 {
+    NODE_POOL_ALLOCATED(TextMessageNode)
+
     explicit TextMessageNode(Media::TextRecording* rec) : m_pRecording(rec) {}
 
     Media::MimeMessage*   m_pMessage      {nullptr};
@@ -21,6 +21,8 @@
 #include <QtCore/QThread>
 #include <QtCore/QDebug>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QMutex>
+#include <QtCore/QQueue>
 
 //LibStdC++
 #include <functional>
@@ -46,3 +48,70 @@ ThreadWorker::ThreadWorker(std::function<void()> f) : QObject(nullptr)
 
    t->start();
 }
+
+/// Lives in the worker thread and drains the queue
+class SerialThreadWorkerPrivate final : public QObject
+{
+   Q_OBJECT
+public:
+   QThread                       m_Thread;
+   QMutex                        m_Mutex;
+   QQueue<std::function<void()>> m_lJobs;
+   bool                          m_IsScheduled {false};
+
+public Q_SLOTS:
+   void slotDrain();
+};
+
+SerialThreadWorker::SerialThreadWorker(QObject* parent) : QObject(parent),
+   d_ptr(new SerialThreadWorkerPrivate)
+{
+   d_ptr->moveToThread(&d_ptr->m_Thread);
+   d_ptr->m_Thread.start();
+}
+
+/// Wait until the queued jobs are done
+SerialThreadWorker::~SerialThreadWorker()
+{
+   QMetaObject::invokeMethod(d_ptr, "slotDrain", Qt::BlockingQueuedConnection);
+
+   d_ptr->m_Thread.quit();
+   d_ptr->m_Thread.wait();
+
+   delete d_ptr;
+}
+
+void SerialThreadWorker::run(std::function<void()> f)
+{
+   QMutexLocker l(&d_ptr->m_Mutex);
+
+   d_ptr->m_lJobs.enqueue(f);
+
+   if (d_ptr->m_IsScheduled)
+      return;
+
+   d_ptr->m_IsScheduled = true;
+   QMetaObject::invokeMethod(d_ptr, "slotDrain", Qt::QueuedConnection);
+}
+
+void SerialThreadWorkerPrivate::slotDrain()
+{
+   while (true) {
+      std::function<void()> f;
+
+      {
+         QMutexLocker l(&m_Mutex);
+
+         if (m_lJobs.isEmpty()) {
+            m_IsScheduled = false;
+            return;
+         }
+
+         f = m_lJobs.dequeue();
+      }
+
+      f();
+   }
+}
+
+#include <threadworker.moc>
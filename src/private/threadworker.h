@@ -38,3 +38,24 @@ class ThreadWorker : public QObject
 public:
    ThreadWorker(std::function<void()> f);
 };
+
+class SerialThreadWorkerPrivate;
+
+/**
+ * A single thread running the jobs one after the other, in the order they
+ * were queued. Use this when the jobs touch the same resources (like a file)
+ * and must not be reordered.
+ */
+class SerialThreadWorker final : public QObject
+{
+   Q_OBJECT
+public:
+   explicit SerialThreadWorker(QObject* parent = nullptr);
+   virtual ~SerialThreadWorker();
+
+   void run(std::function<void()> f);
+
+private:
+   SerialThreadWorkerPrivate* d_ptr;
+   Q_DECLARE_PRIVATE(SerialThreadWorker)
+};
@@ -35,6 +35,7 @@
 #include "individual.h"
 #include "interfaces/pixmapmanipulatori.h"
 #include "personmodel.h"
+#include "tracing.h"
 
 /* https://www.ietf.org/rfc/rfc2045.txt
  * https://www.ietf.org/rfc/rfc2047.txt
@@ -149,8 +150,8 @@ struct VCardMapper final {
          break;
       }
 
-      QVariant photo = GlobalInstances::pixmapManipulator().personPhoto(fn,type);
-      c->setPhoto(photo);
+      // Decoding is expensive and most photos are never displayed
+      c->setPhoto(fn, type);
    }
 
    void addContactMethod(Person* c, const QString& key, const QByteArray& fn) {
@@ -391,6 +392,8 @@ parseFields(const QByteArray& all)
 //TODO use QStringRef
 bool VCardUtils::mapToPerson(Person* p, const QByteArray& all, QList<Account*>* accounts)
 {
+    Tracing::Span s("parsing", "VCardUtils::mapToPerson");
+
     const auto fields = parseFields(all);
 
     for (const auto& pair : qAsConst(fields)) {
@@ -460,9 +463,17 @@ Person* VCardUtils::mapToPerson(const QHash<QByteArray, QByteArray>& vCard, QLis
  */
 Person* VCardUtils::mapToPerson(const QByteArray& payload, bool purgeUntrusted)
 {
-    auto person = new Person();
+    return mapToPersonFromHash(toHashMap(payload), purgeUntrusted);
+}
 
-    const auto vCard = toHashMap(payload);
+/**
+ * Create a new Person from an already parsed vCard.
+ *
+ * @see toHashMap
+ */
+Person* VCardUtils::mapToPersonFromHash(const QHash<QByteArray, QByteArray>& vCard, bool purgeUntrusted)
+{
+    auto person = new Person();
 
     QHashIterator<QByteArray, QByteArray> it(vCard);
     while (it.hasNext()) {
@@ -86,6 +86,7 @@ public:
    static Person* mapToPerson(const QHash<QByteArray, QByteArray>& vCard, QList<Account*>* accounts = nullptr);
    static Person* mapToPersonFromReceivedProfile(ContactMethod *contactMethod, const QByteArray& payload);
    static Person* mapToPerson(const QByteArray& payload, bool purgeUntrusted = false);
+   static Person* mapToPersonFromHash(const QHash<QByteArray, QByteArray>& vCard, bool purgeUntrusted = false);
    static QHash<QByteArray, QByteArray> toHashMap(const QByteArray& content);
    static QList<QPair< QByteArray, QByteArray> > parseFields(const QByteArray& content);
 
@@ -0,0 +1,212 @@
+/****************************************************************************
+ *   Copyright (C) 2018 by Bluesystems                                      *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                    *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "videocapabilitycache.h"
+
+//Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QMutex>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTimer>
+
+//Ring
+#include "dbus/videomanager.h"
+#include "private/threadworker.h"
+
+constexpr const char    VideoCapabilityCache::FILENAME[];
+constexpr const quint32 VideoCapabilityCache::MAGIC;
+
+/// Serialize the writes, the previous refresh can still be saving
+static QMutex s_FileMutex;
+
+/// The generated devices must never replace the real ones on disk
+static int fakeDeviceCount()
+{
+   static const int count = qgetenv("LIBRINGQT_FAKE_VIDEO_DEVICES").toInt();
+   return count;
+}
+
+VideoCapabilityCache::VideoCapabilityCache()
+{
+   load();
+}
+
+VideoCapabilityCache& VideoCapabilityCache::instance()
+{
+   static auto instance = new VideoCapabilityCache();
+   return *instance;
+}
+
+QString VideoCapabilityCache::path()
+{
+   return QStandardPaths::writableLocation(QStandardPaths::DataLocation)
+      + QLatin1Char('/')
+      + FILENAME;
+}
+
+QStringList VideoCapabilityCache::devices() const
+{
+   return m_lDevices;
+}
+
+VideoCapabilityCache::Capabilities VideoCapabilityCache::capabilities(const QString& device) const
+{
+   return m_hCapabilities.value(device);
+}
+
+void VideoCapabilityCache::load()
+{
+   if (fakeDeviceCount() > 0)
+      return;
+
+   QMutexLocker l(&s_FileMutex);
+
+   QFile file(path());
+
+   if (!file.open(QIODevice::ReadOnly))
+      return;
+
+   QDataStream stream(&file);
+   stream.setVersion(QDataStream::Qt_5_9);
+
+   quint32 magic;
+   stream >> magic;
+
+   if (magic != MAGIC) {
+      qWarning() << "The video capability cache is corrupted";
+      return;
+   }
+
+   QStringList                  devices;
+   QHash<QString, Capabilities> capabilities;
+
+   stream >> devices >> capabilities;
+
+   // Better nothing than half of it, the daemon will be asked anyway
+   if (stream.status() != QDataStream::Ok) {
+      qWarning() << "The video capability cache is truncated";
+      return;
+   }
+
+   m_lDevices      = devices;
+   m_hCapabilities = capabilities;
+}
+
+void VideoCapabilityCache::write(const QStringList& devices, const QHash<QString, Capabilities>& capabilities)
+{
+   QMutexLocker l(&s_FileMutex);
+
+   QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+
+   QFile file(path());
+
+   if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      qWarning() << "Unable to save the video capability cache";
+      return;
+   }
+
+   QDataStream stream(&file);
+   stream.setVersion(QDataStream::Qt_5_9);
+
+   stream << MAGIC << devices << capabilities;
+}
+
+/// Called from the worker thread
+void VideoCapabilityCache::fetch(QStringList& devices, QHash<QString, Capabilities>& capabilities)
+{
+   const int fakeCount = fakeDeviceCount();
+
+   if (fakeCount > 0) {
+      static const QVector<QString> rates {
+         QStringLiteral("30"), QStringLiteral("25"), QStringLiteral("15")
+      };
+
+      Capabilities fake;
+      for (const char* channel : {"Camera", "Composite"}) {
+         for (const char* res : {"320x240", "640x480", "1280x720", "1920x1080"})
+            fake[channel][res] = rates;
+      }
+
+      for (int i = 0; i < fakeCount; i++) {
+         const QString id = QStringLiteral("fake%1").arg(i);
+         devices << id;
+         capabilities[id] = fake;
+      }
+
+      return;
+   }
+
+   VideoManagerInterface& interface = VideoManager::instance();
+
+   devices = interface.getDeviceList();
+
+   for (const QString& device : qAsConst(devices))
+      capabilities[device] = interface.getCapabilities(device);
+}
+
+void VideoCapabilityCache::refresh(QObject* context, const Callback& callback)
+{
+   if (m_IsRefreshing) {
+      m_NeedsRefresh = true;
+      return;
+   }
+
+   m_IsRefreshing = true;
+
+   // The interface must be created in the main thread
+   VideoManager::instance();
+
+   const QStringList                  previousDevices      = m_lDevices;
+   const QHash<QString, Capabilities> previousCapabilities = m_hCapabilities;
+
+   new ThreadWorker([this, context, callback, previousDevices, previousCapabilities]() {
+      QStringList                  devices;
+      QHash<QString, Capabilities> capabilities;
+
+      fetch(devices, capabilities);
+
+      QHash<QString, Capabilities> changed;
+
+      for (auto i = capabilities.constBegin(); i != capabilities.constEnd(); ++i) {
+         const auto prev = previousCapabilities.constFind(i.key());
+
+         if (prev == previousCapabilities.constEnd() || *prev != *i)
+            changed[i.key()] = *i;
+      }
+
+      if (fakeDeviceCount() <= 0 && (devices != previousDevices || !changed.isEmpty()))
+         write(devices, capabilities);
+
+      QTimer::singleShot(0, context, [this, context, callback, devices, capabilities, changed]() {
+         m_lDevices      = devices;
+         m_hCapabilities = capabilities;
+         m_IsRefreshing  = false;
+
+         callback(devices, changed);
+
+         // Something happened while the daemon was queried
+         if (m_NeedsRefresh) {
+            m_NeedsRefresh = false;
+            refresh(context, callback);
+         }
+      });
+   });
+}
@@ -0,0 +1,84 @@
+/****************************************************************************
+ *   Copyright (C) 2018 by Bluesystems                                      *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                    *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+
+//Ring
+#include <typedefs.h>
+
+//STD
+#include <functional>
+
+class QObject;
+
+/**
+ * Persistent cache of the video devices capabilities.
+ *
+ * Asking the daemon for every channel, resolution and rate of each device
+ * used to block the UI when a camera was plugged or the settings opened. The
+ * last known devices are now available right away and the daemon is queried
+ * in a background thread. Only the devices with different capabilities are
+ * reported, so the models can be updated in place.
+ *
+ * Set LIBRINGQT_FAKE_VIDEO_DEVICES to a number of devices to replace the
+ * daemon answers with generated ones. This allows to test large setups. In
+ * that mode, the cache file is neither read nor written.
+ *
+ * This class is not thread safe, it must be used from the main thread.
+ */
+class VideoCapabilityCache final
+{
+public:
+   using Capabilities = MapStringMapStringVectorString;
+   using Callback     = std::function<void(const QStringList&, const QHash<QString, Capabilities>&)>;
+
+   static VideoCapabilityCache& instance();
+
+   QStringList  devices     (                     ) const;
+   Capabilities capabilities(const QString& device) const;
+
+   /**
+    * Query the daemon in a background thread.
+    *
+    * The callback is invoked in the thread of `context` with the new device
+    * list and the capabilities of the new or changed devices. Calling this
+    * while a refresh is running queues another one.
+    */
+   void refresh(QObject* context, const Callback& callback);
+
+private:
+   explicit VideoCapabilityCache();
+
+   //Attributes
+   QStringList                  m_lDevices              ;
+   QHash<QString, Capabilities> m_hCapabilities         ;
+   bool                         m_IsRefreshing  {false} ;
+   bool                         m_NeedsRefresh  {false} ;
+
+   constexpr static const char    FILENAME[] = "videocapabilities.cache";
+   constexpr static const quint32 MAGIC      = 0x52564331; // RVC1
+
+   //Helpers
+   static QString path ();
+   static void    fetch(QStringList& devices, QHash<QString, Capabilities>& capabilities);
+   static void    write(const QStringList& devices, const QHash<QString, Capabilities>& capabilities);
+   void           load ();
+};
@@ -20,9 +20,13 @@
 #include <QtCore/QObject>
 #include <QtCore/QList>
 
+//Ring
+#include <typedefs.h>
+
 namespace Video {
    class Channel;
    class Device;
+   class Resolution;
 }
 
 class VideoDevicePrivate final : public QObject
@@ -47,6 +51,14 @@ public:
 
    Video::Device* q_ptr;
 
+   //Helpers
+   void setCapabilities(const MapStringMapStringVectorString& capabilities);
+   void setResolutions (Video::Channel* chan, const MapStringVectorString& resolutions);
+   void setRates       (Video::Resolution* res, const VectorString& rates);
+   static void destroy (Video::Channel* chan);
+   static void destroy (Video::Resolution* res);
+   void clear();
+
 public Q_SLOTS:
    void saveIdle();
 };
@@ -36,6 +36,8 @@
 #include <video/resolution.h>
 #include "private/videorate_p.h"
 #include "private/call_p.h"
+#include "memorystatistics.h"
+#include "tracing.h"
 
 #ifdef ENABLE_LIBWRAP
  #include "private/directrenderer.h"
@@ -61,6 +63,7 @@ public:
 
    //Helper
    void removeRenderer(Video::Renderer* r);
+   QVector<MemoryStatistics::Usage> memoryUsage() const;
 
 private:
    VideoRendererManager* q_ptr;
@@ -84,6 +87,10 @@ VideoRendererManager::VideoRendererManager():QObject(QCoreApplication::instance(
    VideoManagerInterface& interface = VideoManager::instance();
    connect( &interface , &VideoManagerInterface::startedDecoding, d_ptr.data(), &VideoRendererManagerPrivate::startedDecoding, Qt::QueuedConnection);
    connect( &interface , &VideoManagerInterface::stoppedDecoding, d_ptr.data(), &VideoRendererManagerPrivate::stoppedDecoding, Qt::QueuedConnection);
+
+   MemoryStatistics::instance().addProvider(QStringLiteral("VideoRendererManager"), this, [this]() {
+      return d_ptr->memoryUsage();
+   });
 }
 
 
@@ -104,6 +111,26 @@ int VideoRendererManager::size() const
    return d_ptr->m_hRenderers.size();
 }
 
+/**
+ * Estimate the memory used by the renderers.
+ *
+ * Each renderer holds (or maps) at least one 32bit frame.
+ */
+QVector<MemoryStatistics::Usage> VideoRendererManagerPrivate::memoryUsage() const
+{
+   qint64 bytes = 0;
+
+   for (const auto r : qAsConst(m_hRenderers)) {
+      const QSize s = r->size();
+      bytes += sizeof(Video::Renderer) + MemoryStatistics::QOBJECT_OVERHEAD
+         + static_cast<qint64>(s.width()) * s.height() * 4;
+   }
+
+   return {
+      { QStringLiteral("Renderer"), m_hRenderers.size(), bytes },
+   };
+}
+
 ///Return the call Renderer or nullptr
 Video::Renderer* VideoRendererManager::getRenderer(const Call* call) const
 {
@@ -188,6 +215,7 @@ void VideoRendererManager::setBufferSize(uint size)
 ///A video is not being rendered
 void VideoRendererManagerPrivate::startedDecoding(const QString& id, const QString& shmPath, int width, int height)
 {
+   TRACE_SCOPE("daemon", "VideoRendererManagerPrivate::startedDecoding");
    Q_UNUSED(shmPath) //When directly linked, there is no SHM
    const QSize      res = QSize(width,height);
    const QByteArray rid = id.toLatin1();
@@ -305,6 +333,7 @@ void VideoRendererManagerPrivate::removeRenderer(Video::Renderer* r)
  */
 void VideoRendererManagerPrivate::stoppedDecoding(const QString& id, const QString& shmPath)
 {
+    TRACE_SCOPE("daemon", "VideoRendererManagerPrivate::stoppedDecoding");
     Q_UNUSED(shmPath)
 
     if (!m_hRenderers.contains(id.toLatin1()) || !m_hRenderers.contains(id.toLatin1())) {
@@ -427,6 +456,7 @@ void VideoRendererManagerPrivate::removeRenderer(Video::Renderer* r)
 
 void VideoRendererManagerPrivate::stoppedDecoding(const QString& id, const QString& shmPath)
 {
+   TRACE_SCOPE("daemon", "VideoRendererManagerPrivate::stoppedDecoding");
    Q_UNUSED(shmPath)
 
    if (m_hRenderers.contains(id.toLatin1())) {
@@ -30,6 +30,8 @@
 #include "securityflaw.h"
 #include "private/securityflaw_p.h"
 #include "private/certificate_p.h"
+#include "private/accountdetails.h"
+#include "tracing.h"
 
 #include <QtAlgorithms>
 
@@ -76,6 +78,19 @@ SecurityEvaluationModelPrivate::flawSeverity = {{
    /* NOT_MISSING_AUTHORITY             */ SecurityEvaluationModel::Severity::INFORMATION     ,
 }};
 
+const TypedStateMachine< FlagPack<SecurityEvaluationModelPrivate::Input> , SecurityEvaluationModel::AccountSecurityChecks >
+SecurityEvaluationModelPrivate::ruleInputs = {{
+   /* SRTP_ENABLED                      */ Input::SRTP        | Input::PROTOCOL        ,
+   /* TLS_ENABLED                       */ Input::TLS         | Input::PROTOCOL        ,
+   /* CERTIFICATE_MATCH                 */ Input::CERTIFICATE | Input::AUTHORITY       ,
+   /* OUTGOING_SERVER_MATCH             */ Input::CERTIFICATE | Input::TLS_SERVER_NAME ,
+   /* VERIFY_INCOMING_ENABLED           */ Input::TLS_VERIFY                           ,
+   /* VERIFY_ANSWER_ENABLED             */ Input::TLS_VERIFY                           ,
+   /* REQUIRE_CERTIFICATE_ENABLED       */ Input::TLS_VERIFY                           ,
+   /* NOT_MISSING_CERTIFICATE           */ Input::CERTIFICATE                          ,
+   /* NOT_MISSING_AUTHORITY             */ Input::AUTHORITY                            ,
+}};
+
 const TypedStateMachine< SecurityEvaluationModel::SecurityLevel , Certificate::Checks > SecurityEvaluationModelPrivate::maximumCertificateSecurityLevel = {{
    /* HAS_PRIVATE_KEY                   */ SecurityEvaluationModel::SecurityLevel::NONE       ,
    /* EXPIRED                           */ SecurityEvaluationModel::SecurityLevel::MEDIUM     ,
@@ -198,12 +213,16 @@ public:
    virtual QHash<int,QByteArray> roleNames() const override;
 
    //Helpers
-   void update();
+   int update(const FlagPack<SecurityEvaluationModelPrivate::Input>& inputs);
+   SecurityEvaluationModelPrivate::Contribution contribution() const;
 
 private:
    //Attributes
    const Account* m_pAccount;
-   Matrix1D<SecurityEvaluationModel::AccountSecurityChecks, Certificate::CheckValues> m_lCachedResults;
+   TypedStateMachine<Certificate::CheckValues, SecurityEvaluationModel::AccountSecurityChecks> m_lCachedResults;
+
+   //Helpers
+   Certificate::CheckValues evaluate(SecurityEvaluationModel::AccountSecurityChecks check) const;
 };
 
 /**
@@ -283,7 +302,7 @@ static const Matrix1D<SecurityEvaluationModel::Severity, void(SecurityEvaluation
 }};
 
 SecurityEvaluationModelPrivate::SecurityEvaluationModelPrivate(Account* account, SecurityEvaluationModel* parent) :
- QObject(parent),q_ptr(parent), m_pAccount(account),m_isScheduled(false),
+ QObject(parent),q_ptr(parent), m_pAccount(account),m_isScheduled(false),m_PendingInputs(Input::NONE),
  m_CurrentSecurityLevel(SecurityEvaluationModel::SecurityLevel::NONE),m_pAccChecks(nullptr),
  m_SeverityCount{
       /* UNSUPPORTED   */ 0,
@@ -294,12 +313,11 @@ SecurityEvaluationModelPrivate::SecurityEvaluationModelPrivate(Account* account,
       /* FATAL_WARNING */ 0,
    }
 {
-   //Make sure the security level is updated if something change
-   QObject::connect(parent,&SecurityEvaluationModel::layoutChanged , this,&SecurityEvaluationModelPrivate::update);
-   QObject::connect(parent,&SecurityEvaluationModel::dataChanged   , this,&SecurityEvaluationModelPrivate::update);
-   QObject::connect(parent,&SecurityEvaluationModel::rowsInserted  , this,&SecurityEvaluationModelPrivate::update);
-   QObject::connect(parent,&SecurityEvaluationModel::rowsRemoved   , this,&SecurityEvaluationModelPrivate::update);
-   QObject::connect(parent,&SecurityEvaluationModel::modelReset    , this,&SecurityEvaluationModelPrivate::update);
+   //Only evaluate the rules depending on the changed properties
+   QObject::connect(account, &Account::propertyChanged, this, [this](Account* a, const QString& name) {
+      Q_UNUSED(a)
+      update(inputsOf(name));
+   });
 }
 
 
@@ -393,9 +411,10 @@ QVariant PrefixAndSeverityProxyModel::data(const QModelIndex& index, int role) c
  *                                                                             *
  ******************************************************************************/
 
-AccountChecksModel::AccountChecksModel(const Account* a) : QAbstractTableModel(const_cast<Account*>(a)), m_pAccount(a)
+AccountChecksModel::AccountChecksModel(const Account* a) : QAbstractTableModel(const_cast<Account*>(a)), m_pAccount(a),
+m_lCachedResults{}
 {
-   update();
+   update(SecurityEvaluationModelPrivate::Input::ALL);
 }
 
 QVariant AccountChecksModel::data( const QModelIndex& index, int role ) const
@@ -480,63 +499,92 @@ QHash<int,QByteArray> AccountChecksModel::roleNames() const
    return {};
 }
 
-//This could have been an inlined function too
-#define SET_CHECK_VALUE(check,condition) {Certificate::CheckValues c = Certificate::CheckValues::UNSUPPORTED;\
-   bool isSet = m_lCachedResults.isSet(check); if (isSet) c = m_lCachedResults[check]; m_lCachedResults.setAt( check ,\
-   condition? Certificate::CheckValues::PASSED : Certificate::CheckValues::FAILED);\
-   changed |= (!isSet) || c != m_lCachedResults[check];}
+Certificate::CheckValues AccountChecksModel::evaluate(SecurityEvaluationModel::AccountSecurityChecks check) const
+{
+   typedef SecurityEvaluationModel::AccountSecurityChecks Checks;
+
+   bool passed = false;
+
+   switch(check) {
+      case Checks::SRTP_ENABLED:
+         passed = m_pAccount->isSrtpEnabled() || m_pAccount->protocol() == Account::Protocol::RING;
+         break;
+      case Checks::TLS_ENABLED:
+         passed = m_pAccount->isTlsEnabled();
+         break;
+      case Checks::CERTIFICATE_MATCH: //TODO
+      case Checks::OUTGOING_SERVER_MATCH: //TODO
+         return Certificate::CheckValues::UNSUPPORTED;
+      case Checks::VERIFY_INCOMING_ENABLED:
+         passed = m_pAccount->isTlsVerifyServer();
+         break;
+      case Checks::VERIFY_ANSWER_ENABLED:
+         passed = m_pAccount->isTlsVerifyClient();
+         break;
+      case Checks::REQUIRE_CERTIFICATE_ENABLED:
+         passed = m_pAccount->isTlsRequireClientCertificate();
+         break;
+      case Checks::NOT_MISSING_CERTIFICATE:
+         passed = m_pAccount->tlsCertificate();
+         break;
+      case Checks::NOT_MISSING_AUTHORITY:
+         passed = m_pAccount->tlsCaListCertificate();
+         break;
+      case Checks::COUNT__:
+         Q_ASSERT(false);
+   }
+
+   return passed ? Certificate::CheckValues::PASSED : Certificate::CheckValues::FAILED;
+}
 
-void AccountChecksModel::update()
+/**
+ * Evaluate the rules depending on `inputs` and notify the changed rows.
+ *
+ * @return The number of evaluated rules
+ */
+int AccountChecksModel::update(const FlagPack<SecurityEvaluationModelPrivate::Input>& inputs)
 {
-   bool changed = false;
+   int evaluated = 0, first = -1, last = -1;
 
-   // AccountSecurityChecks::SRTP_DISABLED
-   SET_CHECK_VALUE(SecurityEvaluationModel::AccountSecurityChecks::SRTP_ENABLED                  ,
-      m_pAccount->isSrtpEnabled                () || m_pAccount->protocol() == Account::Protocol::RING
-   );
+   for (const auto check : EnumIterator<SecurityEvaluationModel::AccountSecurityChecks>()) {
+      if (!(SecurityEvaluationModelPrivate::ruleInputs[check] & inputs))
+         continue;
 
-   // AccountSecurityChecks::TLS_DISABLED
-   SET_CHECK_VALUE( SecurityEvaluationModel::AccountSecurityChecks::TLS_ENABLED                  ,
-      m_pAccount->isTlsEnabled                 ()
-   );
+      evaluated++;
 
-   // AccountSecurityChecks::CERTIFICATE_MISMATCH
-   m_lCachedResults.setAt( SecurityEvaluationModel::AccountSecurityChecks::CERTIFICATE_MATCH     ,
-      Certificate::CheckValues::UNSUPPORTED); //TODO
+      const Certificate::CheckValues value = evaluate(check);
 
-   // AccountSecurityChecks::OUTGOING_SERVER_MISMATCH
-   m_lCachedResults.setAt( SecurityEvaluationModel::AccountSecurityChecks::OUTGOING_SERVER_MATCH ,
-      Certificate::CheckValues::UNSUPPORTED); //TODO
+      if (value == m_lCachedResults[check])
+         continue;
 
-   // AccountSecurityChecks::VERIFY_INCOMING_DISABLED
-   SET_CHECK_VALUE( SecurityEvaluationModel::AccountSecurityChecks::VERIFY_INCOMING_ENABLED      ,
-      m_pAccount->isTlsVerifyServer            ()
-   );
+      m_lCachedResults[check] = value;
 
-   // AccountSecurityChecks::VERIFY_ANSWER_DISABLED
-   SET_CHECK_VALUE( SecurityEvaluationModel::AccountSecurityChecks::VERIFY_ANSWER_ENABLED        ,
-      m_pAccount->isTlsVerifyClient            ()
-   );
+      last  = static_cast<int>(check);
+      first = first == -1 ? last : first;
+   }
 
-   // AccountSecurityChecks::REQUIRE_CERTIFICATE_DISABLED
-   SET_CHECK_VALUE( SecurityEvaluationModel::AccountSecurityChecks::REQUIRE_CERTIFICATE_ENABLED  ,
-      m_pAccount->isTlsRequireClientCertificate()
-   );
+   if (first != -1)
+      emit dataChanged(index(first, 0), index(last, columnCount() - 1));
 
-   // AccountSecurityChecks::MISSING_CERTIFICATE
-   SET_CHECK_VALUE( SecurityEvaluationModel::AccountSecurityChecks::NOT_MISSING_CERTIFICATE      ,
-      m_pAccount->tlsCertificate               ()
-   );
+   return evaluated;
+}
 
-   // AccountSecurityChecks::MISSING_AUTHORITY
-   SET_CHECK_VALUE( SecurityEvaluationModel::AccountSecurityChecks::NOT_MISSING_AUTHORITY        ,
-      m_pAccount->tlsCaListCertificate         ()
-   );
+SecurityEvaluationModelPrivate::Contribution AccountChecksModel::contribution() const
+{
+   SecurityEvaluationModelPrivate::Contribution ret;
+
+   for (const auto check : EnumIterator<SecurityEvaluationModel::AccountSecurityChecks>()) {
+      if (m_lCachedResults[check] != Certificate::CheckValues::FAILED)
+         continue;
+
+      ret.counts[static_cast<int>(SecurityEvaluationModelPrivate::flawSeverity[check])]++;
+
+      const auto level = SecurityEvaluationModelPrivate::maximumSecurityLevel[check];
+      ret.level = level < ret.level ? level : ret.level;
+   }
 
-   if (changed)
-      emit dataChanged(index(0,2),index(rowCount()-1,2));
+   return ret;
 }
-#undef SET_CHECK_VALUE
 
 
 /*******************************************************************************
@@ -627,7 +675,7 @@ d_ptr(new SecurityEvaluationModelPrivate(account,this))
 
    d_ptr->m_pAccChecks = new AccountChecksModel(account);
 
-   d_ptr->update();
+   d_ptr->update(SecurityEvaluationModelPrivate::Input::ALL);
 
    setSourceModel(new CombinaisonProxyModel(pkCert ? pkCert->d_ptr->m_pSeverityProxy : nullptr, caCert ? caCert->d_ptr->m_pSeverityProxy : nullptr, d_ptr->m_pAccChecks,this));
 
@@ -658,22 +706,98 @@ QHash<int,QByteArray> SecurityEvaluationModel::roleNames() const
    return roles;
 }
 
-void SecurityEvaluationModelPrivate::update()
+void SecurityEvaluationModelPrivate::update(const FlagPack<Input>& inputs)
 {
+   m_PendingInputs |= inputs;
+
    //As this can be called multiple time, only perform the checks once per event loop cycle
-   if (!m_isScheduled) {
-      m_pAccChecks->update();
+   if (m_isScheduled || !m_PendingInputs)
+      return;
+
+   m_isScheduled = true;
+   QTimer::singleShot(0,this,&SecurityEvaluationModelPrivate::updateReal);
+}
+
+FlagPack<SecurityEvaluationModelPrivate::Input> SecurityEvaluationModelPrivate::inputsOf(const QString& property)
+{
+   typedef AccountDetails::Key Key;
+
+   switch(AccountDetails::keyOf(property)) {
+      case Key::TYPE:
+         return Input::PROTOCOL;
+      case Key::SRTP_ENABLED:
+      case Key::SRTP_KEY_EXCHANGE:
+      case Key::SRTP_RTP_FALLBACK:
+         return Input::SRTP;
+      case Key::TLS_ENABLED:
+         return Input::TLS;
+      case Key::TLS_VERIFY_SERVER:
+      case Key::TLS_VERIFY_CLIENT:
+      case Key::TLS_REQUIRE_CLIENT_CERTIFICATE:
+         return Input::TLS_VERIFY;
+      case Key::TLS_SERVER_NAME:
+         return Input::TLS_SERVER_NAME;
+      case Key::TLS_METHOD:
+      case Key::TLS_CIPHERS:
+         return Input::CIPHERS;
+      case Key::TLS_CERTIFICATE_FILE:
+      case Key::TLS_PRIVATE_KEY_FILE:
+      case Key::TLS_PASSWORD:
+         return Input::CERTIFICATE;
+      case Key::TLS_CA_LIST_FILE:
+         return Input::AUTHORITY;
+      default:
+         return Input::NONE;
+   }
+}
+
+/// Follow the certificate changes, the account doesn't notify them
+void SecurityEvaluationModelPrivate::trackCertificate(Certificate* c, Certificate*& current, QMetaObject::Connection& connection, Input input)
+{
+   if (c == current)
+      return;
 
-#if QT_VERSION >= 0x050400
-      QTimer::singleShot(0,this,&SecurityEvaluationModelPrivate::updateReal);
-      m_isScheduled = true;
-#else //Too bad for Qt < 5.3 users
-      updateReal();
-#endif
+   if (connection)
+      disconnect(connection);
 
+   current = c;
+
+   if (c) {
+      connection = connect(c, &Certificate::changed, this, [this, input]() {
+         update(input);
+      });
    }
 }
 
+/**
+ * Same as the certificate part of the model, the failed checks are counted
+ * and, unless the private key is required, limit the security level.
+ *
+ * @return The number of evaluated rules
+ */
+int SecurityEvaluationModelPrivate::evaluateCertificate(Certificate* c, Contribution& contribution)
+{
+   contribution = {};
+
+   if (!c)
+      return 0;
+
+   const bool ignoreLevel = c->requirePrivateKey();
+
+   for (const Certificate::Checks check : EnumIterator<Certificate::Checks>()) {
+      if (c->checkResult(check) != Certificate::CheckValues::FAILED)
+         continue;
+
+      contribution.counts[static_cast<int>(certificateFlawSeverity[check])]++;
+
+      const SecurityEvaluationModel::SecurityLevel level = maximumCertificateSecurityLevel[check];
+      if (level < contribution.level && !ignoreLevel)
+         contribution.level = level;
+   }
+
+   return enum_class_size<Certificate::Checks>();
+}
+
 QAbstractItemModel* SecurityEvaluationModelPrivate::getCertificateSeverityProxy(Certificate* c)
 {
    if (!c)
@@ -685,63 +809,67 @@ QAbstractItemModel* SecurityEvaluationModelPrivate::getCertificateSeverityProxy(
    return c->d_ptr->m_pSeverityProxy;
 }
 
-SecurityEvaluationModel::SecurityLevel SecurityEvaluationModelPrivate::maxSecurityLevel(QAbstractItemModel* m, int* counter)
+void SecurityEvaluationModelPrivate::updateReal()
 {
    typedef SecurityEvaluationModel::Severity      Severity     ;
    typedef SecurityEvaluationModel::SecurityLevel SecurityLevel;
 
-   SecurityLevel maxLevel = SecurityLevel::COMPLETE;
+   const FlagPack<Input> inputs = m_PendingInputs;
+   m_PendingInputs = Input::NONE;
+   m_isScheduled   = false;
 
-   for (int i=0; i < m->rowCount();i++) {
-      const auto idx = m->index(i,0);
+   //Only the rules depending on the changed inputs are evaluated again
+   int evaluated = 0;
 
-      const Severity severity = qvariant_cast<Severity>(
-         idx.data((int) SecurityEvaluationModel::Role::Severity)
-      );
-
-      //Ignore items without severity
-      const QVariant levelVariant = idx.data((int) SecurityEvaluationModel::Role::SecurityLevel );
-
-      const SecurityLevel level    = levelVariant.canConvert<SecurityLevel>() ? qvariant_cast<SecurityLevel>(
-         levelVariant
-      ) : maxLevel;
-
-      //Increment the count
-      if (counter)
-         counter[static_cast<int>(severity)]++;
+   if (const int count = m_pAccChecks->update(inputs)) {
+      evaluated += count;
+      m_AccountContribution = m_pAccChecks->contribution();
+   }
 
-      const bool forceIgnore = idx.data((int)CertificateModel::Role::requirePrivateKey).toBool();
+   if (inputs & Input::CERTIFICATE) {
+      trackCertificate(m_pAccount->tlsCertificate(), m_pCertificate, m_cCertificate, Input::CERTIFICATE);
+      evaluated += evaluateCertificate(m_pCertificate, m_CertificateContribution);
+   }
 
-      //Update the maximum level
-      maxLevel = level < maxLevel && !forceIgnore ? level : maxLevel;
+   if (inputs & Input::AUTHORITY) {
+      trackCertificate(m_pAccount->tlsCaListCertificate(), m_pAuthority, m_cAuthority, Input::AUTHORITY);
+      evaluated += evaluateCertificate(m_pAuthority, m_AuthorityContribution);
    }
 
-   return maxLevel;
-}
+   m_LastEvaluatedRules   = evaluated;
+   m_TotalEvaluatedRules += evaluated;
+   Tracing::counter("security", "SecurityEvaluationModel::evaluatedRules", evaluated);
 
-void SecurityEvaluationModelPrivate::updateReal()
-{
-   typedef SecurityEvaluationModel::Severity      Severity     ;
-   typedef SecurityEvaluationModel::SecurityLevel SecurityLevel;
+   //Aggregate the contributions
+   const Contribution* contributions[] = {
+      &m_AccountContribution, &m_CertificateContribution, &m_AuthorityContribution
+   };
 
-   int countCache[enum_class_size<SecurityEvaluationModel::Severity>()] = {};
+   SecurityLevel maxLevel = SecurityLevel::COMPLETE;
+   bool countChanged = false;
 
-   //Reset the counter
    for (const Severity s : EnumIterator<Severity>()) {
-      countCache     [(int)s] = m_SeverityCount[(int)s];
-      m_SeverityCount[(int)s] = 0                      ;
-   }
+      int count = 0;
 
-   SecurityLevel maxLevel = maxSecurityLevel(q_ptr, m_SeverityCount);
+      for (const Contribution* c : contributions)
+         count += c->counts[(int)s];
 
-   //Notify
-   for (const Severity s : EnumIterator<Severity>()) {
-      if (countCache[(int)s] != m_SeverityCount[(int)s] && m_lSignalMap[s]) {
-         (q_ptr->*m_lSignalMap[s])();
-         emit m_pAccount->changed(m_pAccount);
+      if (count != m_SeverityCount[(int)s]) {
+         m_SeverityCount[(int)s] = count;
+
+         if (m_lSignalMap[s]) {
+            (q_ptr->*m_lSignalMap[s])();
+            countChanged = true;
+         }
       }
    }
 
+   for (const Contribution* c : contributions)
+      maxLevel = c->level < maxLevel ? c->level : maxLevel;
+
+   if (countChanged)
+      emit m_pAccount->changed(m_pAccount);
+
    //Update the security level
    if (m_CurrentSecurityLevel != maxLevel) {
       m_CurrentSecurityLevel = maxLevel;
@@ -749,8 +877,6 @@ void SecurityEvaluationModelPrivate::updateReal()
       emit q_ptr->securityLevelChanged();
       emit m_pAccount->changed(m_pAccount);
    }
-
-   m_isScheduled = false;
 }
 
 QModelIndex SecurityEvaluationModel::getIndex(const SecurityFlaw* flaw)
@@ -815,4 +941,9 @@ int SecurityEvaluationModel::errorCount                   () const
 int SecurityEvaluationModel::fatalWarningCount            () const
 { return d_ptr->m_SeverityCount[ (int)Severity::FATAL_WARNING ]; }
 
+int SecurityEvaluationModel::lastEvaluatedRuleCount() const
+{ return d_ptr->m_LastEvaluatedRules; }
+qint64 SecurityEvaluationModel::evaluatedRuleCount() const
+{ return d_ptr->m_TotalEvaluatedRules; }
+
 #include <securityevaluationmodel.moc>
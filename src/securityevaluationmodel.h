@@ -145,6 +145,12 @@ public:
    int           fatalWarningCount() const;
    SecurityLevel securityLevel    () const;
 
+   /// Number of security rules evaluated after the last change
+   int           lastEvaluatedRuleCount() const;
+
+   /// Number of security rules evaluated since the model was created
+   qint64        evaluatedRuleCount    () const;
+
 Q_SIGNALS:
    void informationCountChanged ();
    void warningCountChanged     ();
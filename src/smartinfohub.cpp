@@ -20,6 +20,7 @@
 #include "private/smartInfoHub_p.h"
 #include "callmodel.h"
 #include "typedefs.h"
+#include "tracing.h"
 
 #include <dbus/videomanager.h>
 #include <dbus/callmanager.h>
@@ -59,6 +60,7 @@ void SmartInfoHub::setRefreshTime(uint32_t timeMS)
 //Retrieve information from the map and implement all the variables
 void SmartInfoHubPrivate::slotSmartInfo(const MapStringString& map)
 {
+    TRACE_SCOPE("daemon", "SmartInfoHubPrivate::slotSmartInfo");
     for(int i = 0; i < map.size(); i++){
         SmartInfoHubPrivate::m_information[map.keys().at(i)]=map[map.keys().at(i)];
     }
@@ -0,0 +1,372 @@
+/****************************************************************************
+ *   Copyright (C) 2018 by Bluesystems                                      *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                    *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#include "tracing.h"
+
+//Qt
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <QtCore/QDebug>
+
+namespace Tracing {
+
+std::atomic_bool g_IsEnabled {false};
+
+class TracingModel;
+
+/// The Chrome trace event types
+enum class EventType : char {
+    COMPLETE = 'X',
+    COUNTER  = 'C',
+    INSTANT  = 'i',
+};
+
+struct TraceEvent {
+    const char* m_pCategory;
+    const char* m_pName;
+    EventType   m_Type;
+    qint64      m_Timestamp;
+    qint64      m_Value; // Duration for the spans
+    quintptr    m_ThreadId;
+    QString     m_Argument;
+};
+
+class TracingModel final : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    enum class Role {
+        CATEGORY = Qt::UserRole + 1,
+        NAME,
+        TYPE,
+        TIMESTAMP,
+        DURATION,
+        VALUE,
+        THREAD,
+        ARGUMENT,
+    };
+
+    explicit TracingModel() : QAbstractListModel(QCoreApplication::instance()) {}
+
+    virtual QVariant data(const QModelIndex& index, int role) const override;
+    virtual int rowCount(const QModelIndex& parent = {}) const override;
+    virtual QHash<int,QByteArray> roleNames() const override;
+
+    // The events shown by the model, only accessed from the main thread
+    QVector<TraceEvent> m_lEvents;
+
+    void reset();
+
+public Q_SLOTS:
+    void sync();
+};
+
+/// The global state
+struct TracingData {
+    QMutex              m_Mutex       ;
+    QVector<TraceEvent> m_lEvents     ;
+    QElapsedTimer       m_Epoch       ;
+    int                 m_Dropped     {0};
+    bool                m_SyncPending {false};
+    TracingModel*       m_pModel      {nullptr};
+};
+
+static TracingData& data()
+{
+    static TracingData d;
+    return d;
+}
+
+static void record(TraceEvent&& e)
+{
+    auto& d = data();
+
+    QMutexLocker l(&d.m_Mutex);
+
+    if (d.m_lEvents.size() >= MAX_EVENTS) {
+        if (!d.m_Dropped++)
+            qWarning() << "The trace buffer is full, new events are dropped";
+        return;
+    }
+
+    d.m_lEvents << std::move(e);
+
+    if (d.m_pModel && !d.m_SyncPending) {
+        d.m_SyncPending = true;
+        QMetaObject::invokeMethod(d.m_pModel, "sync", Qt::QueuedConnection);
+    }
+}
+
+void setEnabled(bool enabled)
+{
+    auto& d = data();
+
+    {
+        QMutexLocker l(&d.m_Mutex);
+        if (!d.m_Epoch.isValid())
+            d.m_Epoch.start();
+    }
+
+    g_IsEnabled.store(enabled);
+}
+
+qint64 now()
+{
+    return data().m_Epoch.nsecsElapsed() / 1000;
+}
+
+Span::Span(const char* category, const char* name, const QString& argument) :
+    m_pCategory(category), m_pName(name), m_Start(isEnabled() ? now() : -1),
+    m_Argument(argument)
+{}
+
+void Span::finish()
+{
+    record({
+        m_pCategory,
+        m_pName,
+        EventType::COMPLETE,
+        m_Start,
+        now() - m_Start,
+        reinterpret_cast<quintptr>(QThread::currentThreadId()),
+        m_Argument
+    });
+}
+
+void recordCounter(const char* category, const char* name, qint64 value)
+{
+    record({
+        category,
+        name,
+        EventType::COUNTER,
+        now(),
+        value,
+        reinterpret_cast<quintptr>(QThread::currentThreadId()),
+        {}
+    });
+}
+
+void recordInstant(const char* category, const char* name)
+{
+    record({
+        category,
+        name,
+        EventType::INSTANT,
+        now(),
+        0,
+        reinterpret_cast<quintptr>(QThread::currentThreadId()),
+        {}
+    });
+}
+
+void clear()
+{
+    auto& d = data();
+
+    {
+        QMutexLocker l(&d.m_Mutex);
+        d.m_lEvents.clear();
+        d.m_Dropped = 0;
+    }
+
+    if (d.m_pModel)
+        d.m_pModel->reset();
+}
+
+QByteArray toChromeTrace()
+{
+    auto& d = data();
+
+    QVector<TraceEvent> events;
+    {
+        QMutexLocker l(&d.m_Mutex);
+        events = d.m_lEvents;
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QJsonArray array;
+
+    for (const auto& e : qAsConst(events)) {
+        QJsonObject o {
+            {QStringLiteral("cat"), QString::fromLatin1(e.m_pCategory)},
+            {QStringLiteral("name"), QString::fromLatin1(e.m_pName)},
+            {QStringLiteral("ph"), QString(QChar::fromLatin1(static_cast<char>(e.m_Type)))},
+            {QStringLiteral("ts"), e.m_Timestamp},
+            {QStringLiteral("pid"), pid},
+            {QStringLiteral("tid"), static_cast<qint64>(e.m_ThreadId)},
+        };
+
+        switch(e.m_Type) {
+            case EventType::COMPLETE:
+                o[QStringLiteral("dur")] = e.m_Value;
+                if (!e.m_Argument.isEmpty())
+                    o[QStringLiteral("args")] = QJsonObject {{QStringLiteral("arg"), e.m_Argument}};
+                break;
+            case EventType::COUNTER:
+                o[QStringLiteral("args")] = QJsonObject {{QString::fromLatin1(e.m_pName), e.m_Value}};
+                break;
+            case EventType::INSTANT:
+                o[QStringLiteral("s")] = QStringLiteral("t");
+                break;
+        }
+
+        array.append(o);
+    }
+
+    return QJsonDocument(QJsonObject {
+        {QStringLiteral("traceEvents"), array},
+        {QStringLiteral("displayTimeUnit"), QStringLiteral("ms")},
+    }).toJson(QJsonDocument::Compact);
+}
+
+bool writeChromeTrace(const QString& path)
+{
+    QSaveFile f(path);
+
+    if (!f.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write the trace to" << path;
+        return false;
+    }
+
+    f.write(toChromeTrace());
+
+    return f.commit();
+}
+
+QAbstractItemModel* model()
+{
+    auto& d = data();
+
+    if (!d.m_pModel) {
+        d.m_pModel = new TracingModel();
+        d.m_pModel->sync();
+    }
+
+    return d.m_pModel;
+}
+
+void TracingModel::sync()
+{
+    auto& d = data();
+
+    QVector<TraceEvent> added;
+
+    {
+        QMutexLocker l(&d.m_Mutex);
+        d.m_SyncPending = false;
+        added = d.m_lEvents.mid(m_lEvents.size());
+    }
+
+    if (added.isEmpty())
+        return;
+
+    beginInsertRows({}, m_lEvents.size(), m_lEvents.size() + added.size() - 1);
+    m_lEvents << added;
+    endInsertRows();
+}
+
+void TracingModel::reset()
+{
+    beginResetModel();
+    m_lEvents.clear();
+    endResetModel();
+}
+
+QVariant TracingModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_lEvents.size())
+        return {};
+
+    const auto& e = m_lEvents[index.row()];
+
+    switch(role) {
+        case Qt::DisplayRole:
+        case static_cast<int>(Role::NAME):
+            return QString::fromLatin1(e.m_pName);
+        case static_cast<int>(Role::CATEGORY):
+            return QString::fromLatin1(e.m_pCategory);
+        case static_cast<int>(Role::TYPE):
+            return QString(QChar::fromLatin1(static_cast<char>(e.m_Type)));
+        case static_cast<int>(Role::TIMESTAMP):
+            return e.m_Timestamp;
+        case static_cast<int>(Role::DURATION):
+            return e.m_Type == EventType::COMPLETE ? e.m_Value : 0;
+        case static_cast<int>(Role::VALUE):
+            return e.m_Type == EventType::COUNTER ? e.m_Value : 0;
+        case static_cast<int>(Role::THREAD):
+            return static_cast<qulonglong>(e.m_ThreadId);
+        case static_cast<int>(Role::ARGUMENT):
+            return e.m_Argument;
+    }
+
+    return {};
+}
+
+int TracingModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_lEvents.size();
+}
+
+QHash<int,QByteArray> TracingModel::roleNames() const
+{
+    static QHash<int, QByteArray> roles = QAbstractItemModel::roleNames();
+    static std::atomic_flag initRoles = ATOMIC_FLAG_INIT;
+
+    if (!initRoles.test_and_set()) {
+        roles[static_cast<int>(Role::CATEGORY )] = "category" ;
+        roles[static_cast<int>(Role::NAME     )] = "name"     ;
+        roles[static_cast<int>(Role::TYPE     )] = "type"     ;
+        roles[static_cast<int>(Role::TIMESTAMP)] = "timestamp";
+        roles[static_cast<int>(Role::DURATION )] = "duration" ;
+        roles[static_cast<int>(Role::VALUE    )] = "value"    ;
+        roles[static_cast<int>(Role::THREAD   )] = "thread"   ;
+        roles[static_cast<int>(Role::ARGUMENT )] = "argument" ;
+    }
+
+    return roles;
+}
+
+/// Enable the tracing from the environment
+static void initFromEnvironment()
+{
+    static const QString path = QString::fromLocal8Bit(qgetenv("LIBRINGQT_TRACE"));
+
+    if (path.isEmpty())
+        return;
+
+    setEnabled(true);
+
+    qAddPostRoutine([]() {
+        if (writeChromeTrace(path))
+            qDebug() << "The trace was written to" << path;
+    });
+}
+
+Q_COREAPP_STARTUP_FUNCTION(initFromEnvironment)
+
+}
+
+#include <tracing.moc>
@@ -0,0 +1,137 @@
+/****************************************************************************
+ *   Copyright (C) 2018 by Bluesystems                                      *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                    *
+ *                                                                          *
+ *   This library is free software; you can redistribute it and/or          *
+ *   modify it under the terms of the GNU Lesser General Public             *
+ *   License as published by the Free Software Foundation; either           *
+ *   version 2.1 of the License, or (at your option) any later version.     *
+ *                                                                          *
+ *   This library is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU General Public License      *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+#pragma once
+
+#include <typedefs.h>
+
+//Qt
+#include <QtCore/QString>
+class QAbstractItemModel;
+
+//STD
+#include <atomic>
+
+/**
+ * Opt-in tracing of the library hot paths.
+ *
+ * When disabled (the default), a span or a counter costs a single relaxed
+ * atomic load. When enabled, the events are recorded in memory. They can be
+ * written in the Chrome trace JSON format (it can be opened with
+ * chrome://tracing or https://ui.perfetto.dev) or browsed using model().
+ *
+ * Setting the LIBRINGQT_TRACE environment variable to a file path enables
+ * the tracing at startup and writes the trace to that file on exit. This
+ * allows to profile a deployed client without a debugger.
+ *
+ * The category and name must be string literals (or have a static
+ * lifetime), they are not copied.
+ *
+ * Usage:
+ *
+ *    void MyModel::update() {
+ *        Tracing::Span s("mymodel", "update");
+ *        [...]
+ *    }
+ *
+ * TRACE_SCOPE() does the same with a generated variable name, so it can be
+ * used more than once in the same scope.
+ */
+namespace Tracing {
+
+/// Stop recording after this many events
+static constexpr const int MAX_EVENTS = 1 << 18;
+
+extern LIB_EXPORT std::atomic_bool g_IsEnabled;
+
+inline bool isEnabled()
+{
+    return g_IsEnabled.load(std::memory_order_relaxed);
+}
+
+LIB_EXPORT void setEnabled(bool enabled);
+
+/// Time since the tracing epoch, in microseconds
+LIB_EXPORT qint64 now();
+
+/// Measure the time spent in a scope
+class LIB_EXPORT Span final
+{
+public:
+    inline explicit Span(const char* category, const char* name) :
+        m_pCategory(category), m_pName(name), m_Start(isEnabled() ? now() : -1) {}
+
+    /// `argument` is only worth it for rare events, it is built even when disabled
+    explicit Span(const char* category, const char* name, const QString& argument);
+
+    inline ~Span() {
+        if (m_Start >= 0)
+            finish();
+    }
+
+private:
+    void finish();
+
+    const char* m_pCategory;
+    const char* m_pName;
+    qint64      m_Start;
+    QString     m_Argument;
+
+    Q_DISABLE_COPY(Span)
+};
+
+LIB_EXPORT void recordCounter(const char* category, const char* name, qint64 value);
+LIB_EXPORT void recordInstant(const char* category, const char* name);
+
+/// Record a value over time (for example, the number of rows)
+inline void counter(const char* category, const char* name, qint64 value)
+{
+    if (isEnabled())
+        recordCounter(category, name, value);
+}
+
+/// Record an event without a duration
+inline void instant(const char* category, const char* name)
+{
+    if (isEnabled())
+        recordInstant(category, name);
+}
+
+/// Remove all recorded events
+LIB_EXPORT void clear();
+
+/// The recorded events as a Chrome trace JSON document
+LIB_EXPORT QByteArray toChromeTrace();
+
+LIB_EXPORT bool writeChromeTrace(const QString& path);
+
+/**
+ * The recorded events as a list model.
+ *
+ * It is updated asynchronously in the main thread. The roles are "category",
+ * "name", "type", "timestamp", "duration", "value", "thread" and "argument".
+ */
+LIB_EXPORT QAbstractItemModel* model();
+
+}
+
+#define TRACING_CONCAT_(a, b) a ## b
+#define TRACING_CONCAT(a, b) TRACING_CONCAT_(a, b)
+
+/// Measure the time spent in the current scope
+#define TRACE_SCOPE(category, name) \
+    Tracing::Span TRACING_CONCAT(_tracingSpan, __LINE__)(category, name)
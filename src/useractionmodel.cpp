@@ -81,13 +81,43 @@ public:
    static const Matrix2D< UAM::Action, SelectionState, UAM::ActionStatfulnessLevel > actionStatefulness;
 
 
+   /// One bit per action
+   typedef quint32 ActionMask;
+   static_assert(enum_class_size<UAM::Action>() <= 32, "ActionMask is too small");
+
+   static constexpr ActionMask bit(UAM::Action a) {
+      return ActionMask(1) << static_cast<int>(a);
+   }
+
+   /// The matrices above folded into one mask per state
+   struct StaticMasks {
+      ActionMask byCallState   [enum_class_size<Call::State>()               ];
+      ActionMask byAccountState[enum_class_size<Account::RegistrationState>()];
+      ActionMask bySelection   [enum_class_size<SelectionState>()            ];
+      ActionMask byProtocol    [enum_class_size<Account::Protocol>()         ];
+      ActionMask byObjectType  [enum_class_size<Ring::ObjectType>()          ];
+      ActionMask heterogenous  ;
+   };
+   static const StaticMasks& masks();
+
+   /// The state of the actions for a single selected object
+   struct ObjectMasks {
+      ActionMask available {~ActionMask(0)};
+      ActionMask checked   {0    };
+      ActionMask unchecked {0    };
+      bool       isCall    {false};
+      int        callState {-1   }; ///< Used for the labels
+   };
+
    //Helpers
-   bool updateAction         (UAM::Action action                          );
-   bool updateByCall         (UAM::Action action, const Call* c           );
-   bool updateByContactMethod(UAM::Action action, const ContactMethod* cm );
-   bool updateByAccount      (UAM::Action action, const Account* a        );
-   bool updateByPerson       (UAM::Action action, const Person* p         );
-   void updateCheckMask      (int& ret, UAM::Action action, const Call* c );
+   static ActionMask  accountMask      (const Account* a                              );
+   static ActionMask  cmCallbackMask   (const ContactMethod* cm, ActionMask relevant  );
+   static ActionMask  contactMethodMask(const ContactMethod* cm, ActionMask relevant  );
+   static ActionMask  personMask       (const Person* p, ActionMask relevant          );
+   static ObjectMasks callMasks        (const Call* c                                 );
+   ObjectMasks        objectMasks      (const QModelIndex& idx                        ) const;
+   ActionMask         updateLabels     (Call::State state                             );
+   void               refresh          (                                              );
 
    //Attributes
    Call*                                  m_pCall              ;
@@ -100,6 +130,11 @@ public:
    FlagPack<UAM::Context>                 m_fContext           ;
    QItemSelectionModel*                   m_pSelectionModel {nullptr};
    QAbstractItemModel*                    m_pSourceModel    {nullptr};
+   ActionMask                             m_ContextMask     {0};
+   bool                                   m_IsInitialized   {false};
+
+   /// The selected objects masks, until the selection or the objects change
+   QHash<QModelIndex, ObjectMasks>        m_hObjectMasks    ;
 
 private:
    UserActionModel* q_ptr;
@@ -110,6 +145,8 @@ public Q_SLOTS:
 
    //CallModel mode
    void updateActions();
+   void slotSelectionChanged(const QItemSelection& selected, const QItemSelection& deselected);
+   void slotInvalidateMasks();
 };
 
 
@@ -580,6 +617,11 @@ m_pCall(nullptr), m_pActiveModel(nullptr), m_fContext(c)
       { UAMA::REMOVE_HISTORY    , Qt::Unchecked},
       { UAMA::MARK_AS_CONSUMED  , Qt::Unchecked},
    };
+
+   for (UAM::Action action : EnumIterator<UAM::Action>()) {
+      if (actionContext[action] & m_fContext)
+         m_ContextMask |= bit(action);
+   }
 }
 
 #undef UAMA
@@ -709,294 +751,394 @@ void UserActionModelPrivate::slotStateChanged()
    emit q_ptr->actionStateChanged();
 }
 
-void UserActionModelPrivate::updateCheckMask(int& ret, UserActionModel::Action action, const Call* c)
+/**
+ * Fold the availability matrices into bitmasks.
+ *
+ * This is done once, after that checking all actions for a state is a single
+ * AND instead of one lookup per action.
+ */
+const UserActionModelPrivate::StaticMasks& UserActionModelPrivate::masks()
 {
+   static const StaticMasks m = []() {
+      StaticMasks ret {};
+
+      for (UserActionModel::Action action : EnumIterator<UserActionModel::Action>()) {
+         const ActionMask b = bit(action);
+
+         for (Call::State s : EnumIterator<Call::State>())
+            ret.byCallState[static_cast<int>(s)] |= availableActionMap[action][s] ? b : 0;
+
+         for (Account::RegistrationState s : EnumIterator<Account::RegistrationState>())
+            ret.byAccountState[static_cast<int>(s)] |= availableAccountActionMap[action][s] ? b : 0;
+
+         for (SelectionState s : EnumIterator<SelectionState>())
+            ret.bySelection[static_cast<int>(s)] |= multi_call_options[action][s] ? b : 0;
+
+         for (Account::Protocol p : EnumIterator<Account::Protocol>())
+            ret.byProtocol[static_cast<int>(p)] |= availableProtocolActions[action][p] ? b : 0;
+
+         for (Ring::ObjectType t : EnumIterator<Ring::ObjectType>())
+            ret.byObjectType[static_cast<int>(t)] |= availableObjectActions[action][t] ? b : 0;
+
+         ret.heterogenous |= heterogenous_call_options[action] ? b : 0;
+      }
+
+      return ret;
+   }();
+
+   return m;
+}
+
+UserActionModelPrivate::ActionMask UserActionModelPrivate::accountMask(const Account* a)
+{
+   if (!a)
+      return 0;
+
+   const auto& m = masks();
+
+   return m.byAccountState[static_cast<int>(a->registrationState())]
+      & m.byProtocol[static_cast<int>(a->protocol())];
+}
+
+/**
+ * Only the actions in `relevant` are checked, the others are already disabled
+ * and some callbacks are not cheap.
+ */
+UserActionModelPrivate::ActionMask UserActionModelPrivate::cmCallbackMask(const ContactMethod* cm, ActionMask relevant)
+{
+   for (UserActionModel::Action action : EnumIterator<UserActionModel::Action>()) {
+      if ((relevant & bit(action)) && cmActionAvailability[action] && !cmActionAvailability[action](cm))
+         relevant &= ~bit(action);
+   }
+
+   return relevant;
+}
+
+UserActionModelPrivate::ActionMask UserActionModelPrivate::contactMethodMask(const ContactMethod* cm, ActionMask relevant)
+{
+   // Some actions have a conditional CM
+   if (cm) {
+      Account* a = cm->account() ? cm->account() : AvailableAccountModel::instance().currentDefaultAccount();
+      relevant &= accountMask(a);
+   }
+
+   return cmCallbackMask(cm, relevant);
+}
+
+UserActionModelPrivate::ActionMask UserActionModelPrivate::personMask(const Person* p, ActionMask relevant)
+{
+   for (UserActionModel::Action action : EnumIterator<UserActionModel::Action>()) {
+      if ((relevant & bit(action)) && personActionAvailability[action]
+        && !(p && personActionAvailability[action](p)))
+         relevant &= ~bit(action);
+   }
+
+   return relevant;
+}
+
+/**
+ * The selection and context masks are not included, they are the same for
+ * every call and applied once the selection is reduced.
+ */
+UserActionModelPrivate::ObjectMasks UserActionModelPrivate::callMasks(const Call* c)
+{
+   ObjectMasks ret;
+   ret.isCall = true;
+
    //TODO c will be nullptr if the selection is a person or a contact method
    //there is still a need to update the check mask, but it is less relevant
    //so it can wait for later. This will cause some weird issues with the
    //recent model
-   if (!c)
-      return;
+   if (!c) {
+      ret.available = 0;
+      return ret;
+   }
 
-   switch(action) {
-      case UserActionModel::Action::ACCEPT          :
-         ret += 0;
-         break;
-      case UserActionModel::Action::HOLD            :
-         ret += c->state() == Call::State::HOLD? 100 : 1;
+   Account* a = c->account() ? c->account() : AvailableAccountModel::instance().currentDefaultAccount();
+
+   ret.available = masks().byCallState[static_cast<int>(c->state())] & accountMask(a);
+   ret.available = cmCallbackMask(c->peerContactMethod(), ret.available);
+
+   const auto setChecked = [&ret](UserActionModel::Action action, bool checked) {
+      (checked ? ret.checked : ret.unchecked) |= bit(action);
+   };
+
+   auto audio = c->firstMedia<Media::Audio>(Media::Media::Direction::OUT);
+   auto video = c->firstMedia<Media::Video>(Media::Media::Direction::OUT);
+
+   setChecked(UserActionModel::Action::HOLD           , c->state() == Call::State::HOLD       );
+   setChecked(UserActionModel::Action::MUTE_AUDIO     , audio && audio->state() == Media::Media::State::MUTED);
+   setChecked(UserActionModel::Action::MUTE_VIDEO     , video && video->state() == Media::Media::State::MUTED);
+   setChecked(UserActionModel::Action::SERVER_TRANSFER, c->state() == Call::State::TRANSFERRED);
+   setChecked(UserActionModel::Action::RECORD         , c->isRecording(Media::Media::Type::AUDIO,Media::Media::Direction::OUT));
+
+   ret.callState = static_cast<int>(c->state());
+
+   return ret;
+}
+
+UserActionModelPrivate::ObjectMasks UserActionModelPrivate::objectMasks(const QModelIndex& idx) const
+{
+   ObjectMasks ret;
+
+   const QVariant objTv = idx.data(static_cast<int>(Ring::Role::ObjectType));
+
+   //Be sure the model support the UAM abstraction
+   if (!objTv.canConvert<Ring::ObjectType>()) {
+      qWarning() << "Cannot determine object type";
+      return ret;
+   }
+
+   const auto objT = qvariant_cast<Ring::ObjectType>(objTv);
+
+   ret.available = masks().byObjectType[static_cast<int>(objT)];
+
+   //There is no point in doing further checks
+   if (!ret.available)
+      return ret;
+
+   const QVariant obj = idx.data(static_cast<int>(Ring::Role::Object));
+
+   switch(objT) {
+      case Ring::ObjectType::Person         :
+         ret.available = personMask(qvariant_cast<Person*>(obj), ret.available);
          break;
-      case UserActionModel::Action::MUTE_AUDIO      : {
-         auto a = c->firstMedia<Media::Audio>(Media::Media::Direction::OUT);
-         ret += a && a->state() == Media::Media::State::MUTED ? 100 : 1;
-         }
+      case Ring::ObjectType::ContactMethod  : {
+         const auto cm = qvariant_cast<ContactMethod*>(obj);
+
+         ret.available = cm ? contactMethodMask(cm, ret.available) : 0;
+
          break;
-      case UserActionModel::Action::MUTE_VIDEO      : {
-         auto v = c->firstMedia<Media::Video>(Media::Media::Direction::OUT);
-         ret += v && v->state() == Media::Media::State::MUTED ? 100 : 1;
+      }
+      case Ring::ObjectType::Call           : {
+         const auto c = qvariant_cast<Call*>(obj);
+
+         const ActionMask objectMask = ret.available;
+
+         ret = callMasks(c);
+         ret.available &= objectMask;
+
+         // Dialing (search field) calls have a new URI with every
+         // keystroke. Check is such URI match an existing one. This
+         // changes the availability of some actions. For example,
+         // the offline chat only works for Ring CM *or* SIP CM with
+         // an existing chat history.
+         if (c && c->state() == Call::State::DIALING) {
+            ret.available = contactMethodMask(
+               PhoneDirectoryModel::instance().getExistingNumberIf(
+                  c->peerContactMethod()->uri(),
+                  [](const ContactMethod* cm) -> bool { return cm->account();}
+               ), ret.available
+            );
          }
+
          break;
-      case UserActionModel::Action::SERVER_TRANSFER :
-         ret += c->state() == Call::State::TRANSFERRED? 100 : 1;
-         break;
-      case UserActionModel::Action::RECORD          :
-         ret += c->isRecording(Media::Media::Type::AUDIO,Media::Media::Direction::OUT) ? 100 : 1;
-         break;
-      case UserActionModel::Action::HANGUP          :
-         ret += 0;
-         break;
-      case UserActionModel::Action::JOIN            :
-         ret += 0;
-         break;
-      case UserActionModel::Action::ADD_NEW         :
-         ret += 0;
-         break;
-      case UserActionModel::Action::TOGGLE_VIDEO      :
-      case UserActionModel::Action::ADD_CONTACT       :
-      case UserActionModel::Action::ADD_TO_CONTACT    :
-      case UserActionModel::Action::DELETE_CONTACT    :
-      case UserActionModel::Action::EMAIL_CONTACT     :
-      case UserActionModel::Action::COPY_CONTACT      :
-      case UserActionModel::Action::BOOKMARK          :
-      case UserActionModel::Action::VIEW_CHAT_HISTORY :
-      case UserActionModel::Action::ADD_CONTACT_METHOD:
-      case UserActionModel::Action::CALL_CONTACT      :
-      case UserActionModel::Action::EDIT_CONTACT      :
-      case UserActionModel::Action::REMOVE_HISTORY    :
-      case UserActionModel::Action::MARK_AS_CONSUMED  :
-      case UserActionModel::Action::COUNT__:
+      }
+      case Ring::ObjectType::Media          : //TODO
+      case Ring::ObjectType::Certificate    : //TODO
+      case Ring::ObjectType::ContactRequest : //TODO
+      case Ring::ObjectType::Event          : //TODO
+      case Ring::ObjectType::Individual     : //TODO
+      case Ring::ObjectType::COUNT__        :
          break;
+   }
+
+   return ret;
+}
+
+///Update the labels, return the actions that were renamed
+UserActionModelPrivate::ActionMask UserActionModelPrivate::updateLabels(Call::State state)
+{
+   ActionMask changed = 0;
+
+   const auto setLabel = [this, &changed](UserActionModel::Action action, const QString& label) {
+      if (m_ActionNames[action] != label) {
+         m_ActionNames.setAt(action, label);
+         changed |= bit(action);
+      }
    };
 
    //Avoid the noise
    #pragma GCC diagnostic push
    #pragma GCC diagnostic ignored "-Wswitch-enum"
-   //Update the labels
-   switch (action) {
-      case UserActionModel::Action::ACCEPT          :
-         switch(c->state()) {
-            case Call::State::DIALING        :
-               m_ActionNames.setAt(UserActionModel::Action::ACCEPT, QObject::tr("Call"));
-               break;
-            default:
-               m_ActionNames.setAt(UserActionModel::Action::ACCEPT,  QObject::tr("Accept"));
-               break;
-         }
+   switch(state) {
+      case Call::State::DIALING        :
+         setLabel(UserActionModel::Action::ACCEPT, QObject::tr("Call"));
          break;
-      case UserActionModel::Action::HOLD            :
-         switch(c->state()) {
-            case Call::State::HOLD           :
-            case Call::State::CONFERENCE_HOLD:
-            case Call::State::TRANSF_HOLD    :
-               m_ActionNames.setAt(UserActionModel::Action::HOLD, QObject::tr("Unhold"));
-               break;
-            default:
-               m_ActionNames.setAt(UserActionModel::Action::HOLD, QObject::tr("Hold"));
-               break;
-         }
+      default:
+         setLabel(UserActionModel::Action::ACCEPT, QObject::tr("Accept"));
          break;
-      case UserActionModel::Action::HANGUP          :
-         switch(c->state()) {
-            case Call::State::DIALING        :
-            case Call::State::NEW            :
-               m_ActionNames.setAt(UserActionModel::Action::HANGUP, QObject::tr("Cancel"));
-               break;
-            case Call::State::FAILURE        :
-            case Call::State::ERROR          :
-            case Call::State::COUNT__        :
-            case Call::State::INITIALIZATION :
-            case Call::State::BUSY           :
-               m_ActionNames.setAt(UserActionModel::Action::HANGUP, QObject::tr("Remove"));
-               break;
-            default:
-               m_ActionNames.setAt(UserActionModel::Action::HANGUP, QObject::tr("Hangup"));
-               break;
-         }
+   }
+
+   switch(state) {
+      case Call::State::HOLD           :
+      case Call::State::CONFERENCE_HOLD:
+      case Call::State::TRANSF_HOLD    :
+         setLabel(UserActionModel::Action::HOLD, QObject::tr("Unhold"));
          break;
-      case UserActionModel::Action::JOIN            :
-      case UserActionModel::Action::ADD_NEW         :
-      case UserActionModel::Action::COUNT__         :
-      case UserActionModel::Action::MUTE_AUDIO      :
-      case UserActionModel::Action::MUTE_VIDEO      :
-      case UserActionModel::Action::SERVER_TRANSFER :
-      case UserActionModel::Action::RECORD          :
-      case UserActionModel::Action::TOGGLE_VIDEO      :
-      case UserActionModel::Action::ADD_CONTACT       :
-      case UserActionModel::Action::ADD_TO_CONTACT    :
-      case UserActionModel::Action::DELETE_CONTACT    :
-      case UserActionModel::Action::EMAIL_CONTACT     :
-      case UserActionModel::Action::COPY_CONTACT      :
-      case UserActionModel::Action::BOOKMARK          :
-      case UserActionModel::Action::VIEW_CHAT_HISTORY :
-      case UserActionModel::Action::ADD_CONTACT_METHOD:
-      case UserActionModel::Action::CALL_CONTACT      :
-      case UserActionModel::Action::EDIT_CONTACT      :
-      case UserActionModel::Action::REMOVE_HISTORY    :
-      case UserActionModel::Action::MARK_AS_CONSUMED  :
+      default:
+         setLabel(UserActionModel::Action::HOLD, QObject::tr("Hold"));
          break;
    }
-   #pragma GCC diagnostic pop
-}
 
-bool UserActionModelPrivate::updateByCall(UserActionModel::Action action, const Call* c)
-{
-   if (!c)
-      return false;
-   Account* a = c->account() ? c->account() : AvailableAccountModel::instance().currentDefaultAccount();
+   switch(state) {
+      case Call::State::DIALING        :
+      case Call::State::NEW            :
+         setLabel(UserActionModel::Action::HANGUP, QObject::tr("Cancel"));
+         break;
+      case Call::State::FAILURE        :
+      case Call::State::ERROR          :
+      case Call::State::COUNT__        :
+      case Call::State::INITIALIZATION :
+      case Call::State::BUSY           :
+         setLabel(UserActionModel::Action::HANGUP, QObject::tr("Remove"));
+         break;
+      default:
+         setLabel(UserActionModel::Action::HANGUP, QObject::tr("Hangup"));
+         break;
+   }
+   #pragma GCC diagnostic pop
 
-   return (
-      availableActionMap        [action] [c->state()             ] &&
-      multi_call_options        [action] [m_SelectionState       ] &&
-      actionContext             [action] & m_fContext              &&
-      updateByAccount(action, a)                                   &&
-      ((!cmActionAvailability[action]) ||
-         cmActionAvailability[action](c->peerContactMethod()))
-   );
+   return changed;
 }
 
-bool UserActionModelPrivate::updateByAccount(UserActionModel::Action action, const Account* a)
+/**
+ * Reduce the selected objects masks into the model state.
+ *
+ * The availability is the AND of every object masks. A checkable action is
+ * partially checked when it is checked for some objects and unchecked for
+ * others. Only the rows that changed are notified.
+ */
+void UserActionModelPrivate::refresh()
 {
-   if (!a)
-      return false;
-   return (
-      availableAccountActionMap [action] [a->registrationState() ] &&
-      availableProtocolActions  [action] [a->protocol()          ] //
-   );
-}
+   const auto& m = masks();
 
-bool UserActionModelPrivate::updateByContactMethod(UserActionModel::Action action, const ContactMethod* cm)
-{
-   // Some actions have a conditional CM
-   if (!cm)
-      return cmActionAvailability[action] ?
-         cmActionAvailability[action](nullptr) : true;
+   const SelectionState previousSelectionState = m_SelectionState;
 
-   Account* a = cm->account() ? cm->account() : AvailableAccountModel::instance().currentDefaultAccount();
+   ActionMask available(~ActionMask(0)), checked(0), unchecked(0);
+   int callState = -1;
 
-   return updateByAccount(action, a) && (
-      (!cmActionAvailability[action]) || cmActionAvailability[action](cm)
-   );
-}
-
-bool UserActionModelPrivate::updateByPerson(UserActionModel::Action action, const Person* p)
-{
-   return (!personActionAvailability[action]) || personActionAvailability[action](p);
-}
-
-bool UserActionModelPrivate::updateAction(UserActionModel::Action action)
-{
-   int state = 0;
    switch(m_Mode) {
-      case UserActionModelMode::CALL:
-         updateCheckMask(state,action,m_pCall);
-         m_CurrentActionsState.setAt(action,  state / 100 ? Qt::Checked : Qt::Unchecked);
+      case UserActionModelMode::CALL: {
+         const ObjectMasks o = callMasks(m_pCall);
+
+         available = o.available & m.bySelection[static_cast<int>(m_SelectionState)] & m_ContextMask;
+         checked   = o.checked;
+         unchecked = o.unchecked;
+         callState = o.callState;
 
-         return updateByCall(action, m_pCall);
+         break;
+      }
       case UserActionModelMode::GENERIC: {
-         bool ret = true;
+         auto selected = m_pSelectionModel ? m_pSelectionModel->selectedRows() : QModelIndexList();
 
          m_SelectionState = m_pSelectionModel ? (
-            m_pSelectionModel->selectedRows().size() > 1 ?
+            selected.size() > 1 ?
                SelectionState::MULTI :
                SelectionState::UNIQUE
          ) : SelectionState::NONE ;
 
-         //Aggregate and reduce the action state for each selected calls
-         if (m_pSelectionModel && (m_pSelectionModel->selectedRows().size() || m_pSelectionModel->currentIndex().isValid())) {
+         if (selected.isEmpty() && m_pSelectionModel && m_pSelectionModel->currentIndex().isValid())
+            selected << m_pSelectionModel->currentIndex();
 
-            auto selected = m_pSelectionModel->selectedRows();
+         //Aggregate and reduce the action state for each selected objects
+         if (!selected.isEmpty()) {
+            bool hasCall = false;
 
-            if (selected.isEmpty() && m_pSelectionModel->currentIndex().isValid())
-               selected << m_pSelectionModel->currentIndex();
+            for (const QModelIndex& idx : qAsConst(selected)) {
+               auto i = m_hObjectMasks.constFind(idx);
 
-            foreach (const QModelIndex& idx, selected) {
+               if (i == m_hObjectMasks.constEnd())
+                  i = m_hObjectMasks.insert(idx, objectMasks(idx));
 
-               const QVariant objTv = idx.data(static_cast<int>(Ring::Role::ObjectType));
+               available &= i->available;
+               checked   |= i->checked;
+               unchecked |= i->unchecked;
 
-               //Be sure the model support the UAM abstraction
-               if (!objTv.canConvert<Ring::ObjectType>()) {
-                  qWarning() << "Cannot determine object type";
-                  continue;
+               if (i->isCall) {
+                  hasCall   = true;
+                  callState = i->callState;
                }
+            }
 
-               const auto objT =  qvariant_cast<Ring::ObjectType>(objTv);
+            if (hasCall)
+               available &= m.bySelection[static_cast<int>(m_SelectionState)] & m_ContextMask;
 
-               ret &= availableObjectActions[action][objT];
+            //Detect if the multiple selection has mismatching item states, disable it if necessary
+            available &= (~(checked & unchecked)) | m.heterogenous;
+         }
+         else {
+            Account* a = AvailableAccountModel::instance().currentDefaultAccount();
+            available = m.bySelection[static_cast<int>(SelectionState::NONE)]
+               & (a ? m.byAccountState[static_cast<int>(a->registrationState())] : 0);
+         }
 
-               //There is no point in doing further checks
-               if (!ret) {
-                  continue;
-               }
+         break;
+      }
+   };
 
-               switch(objT) {
-                  case Ring::ObjectType::Person         : {
+   ActionMask changed = callState != -1 ? updateLabels(static_cast<Call::State>(callState)) : 0;
 
-                     const auto p = qvariant_cast<Person*>(idx.data(static_cast<int>(Ring::Role::Object)));
+   for (UserActionModel::Action action : EnumIterator<UserActionModel::Action>()) {
+      const ActionMask b = bit(action);
 
-                     ret &= updateByPerson( action, p );
+      const bool isEnabled = available & b;
 
-                     break;
-                  }
-                  case Ring::ObjectType::ContactMethod  : {
+      const Qt::CheckState checkState = (checked & unchecked & b) ?
+         Qt::PartiallyChecked : (checked & b ? Qt::Checked : Qt::Unchecked);
 
-                     const auto cm = qvariant_cast<ContactMethod*>(idx.data(static_cast<int>(Ring::Role::Object)));
+      if (m_CurrentActions[action] != isEnabled || m_CurrentActionsState[action] != checkState) {
+         m_CurrentActions[action] = isEnabled;
+         m_CurrentActionsState.setAt(action, checkState);
+         changed |= b;
+      }
+   }
 
-                     ret &= cm ? updateByContactMethod( action, cm ) : false;
+   // The flags and check state depend on the selection state
+   if ((!m_IsInitialized) || previousSelectionState != m_SelectionState)
+      changed = ~ActionMask(0);
 
-                     break;
-                  }
-                  case Ring::ObjectType::Call           : {
+   m_IsInitialized = true;
 
-                     const auto c = qvariant_cast<Call*>(idx.data(static_cast<int>(Ring::Role::Object)));
+   // Emit one range per group of contiguous changed rows
+   const int count = enum_class_size<UserActionModel::Action>();
 
-                     ret &= updateByCall( action, c );
+   for (int first = 0; first < count; first++) {
+      if (!(changed & (ActionMask(1) << first)))
+         continue;
 
-                     // Dialing (search field) calls have a new URI with every
-                     // keystroke. Check is such URI match an existing one. This
-                     // changes the availability of some actions. For example,
-                     // the offline chat only works for Ring CM *or* SIP CM with
-                     // an existing chat history.
-                     if (c->state() == Call::State::DIALING) {
-                        ret &= updateByContactMethod(
-                          action, PhoneDirectoryModel::instance().getExistingNumberIf(
-                             c->peerContactMethod()->uri(),
-                             [](const ContactMethod* cm) -> bool { return cm->account();}
-                          )
-                        );
-                     }
+      int last = first;
 
-                     updateCheckMask( state ,action, c ); //TODO abstract this out
+      while (last + 1 < count && (changed & (ActionMask(1) << (last + 1))))
+         last++;
 
-                     break;
-                  }
-                  case Ring::ObjectType::Media          : //TODO
-                  case Ring::ObjectType::Certificate    : //TODO
-                  case Ring::ObjectType::ContactRequest   : //TODO
-                  case Ring::ObjectType::Event          : //TODO
-                  case Ring::ObjectType::Individual     : //TODO
-                  case Ring::ObjectType::COUNT__        :
-                     break;
-               }
-            }
-         }
-         else {
-            Account* a = AvailableAccountModel::instance().currentDefaultAccount();
-            ret = multi_call_options[action][UserActionModelPrivate::SelectionState::NONE]
-               && (a?availableAccountActionMap[action][a->registrationState()]:false);
-         }
+      emit q_ptr->dataChanged(q_ptr->index(first, 0), q_ptr->index(last, 0));
 
-         //Detect if the multiple selection has mismatching item states, disable it if necessary
-         m_CurrentActionsState.setAt(action, (state % 100 && state / 100) ? Qt::PartiallyChecked : (state / 100 ? Qt::Checked : Qt::Unchecked));
-         return ret && (m_CurrentActionsState[action] != Qt::PartiallyChecked || heterogenous_call_options[action]);
-      }
-   };
-   return false;
+      first = last;
+   }
 }
 
+///Something changed in the objects or the accounts, evaluate everything again
 void UserActionModelPrivate::updateActions()
 {
-   for (UserActionModel::Action action : EnumIterator<UserActionModel::Action>())
-      m_CurrentActions[action] = updateAction(action);
-   emit q_ptr->dataChanged(q_ptr->index(0,0),q_ptr->index(enum_class_size<UserActionModel::Action>()-1,0));
+   m_hObjectMasks.clear();
+   refresh();
+}
+
+///Only evaluate the newly selected objects
+void UserActionModelPrivate::slotSelectionChanged(const QItemSelection& selected, const QItemSelection& deselected)
+{
+   Q_UNUSED(selected)
+
+   for (const QModelIndex& idx : deselected.indexes())
+      m_hObjectMasks.remove(idx);
+
+   refresh();
+}
+
+void UserActionModelPrivate::slotInvalidateMasks()
+{
+   m_hObjectMasks.clear();
 }
 
 uint UserActionModel::relativeIndex( UserActionModel::Action action ) const
@@ -1243,8 +1385,18 @@ bool ActiveUserActionModel::filterAcceptsRow(int source_row, const QModelIndex&
 void UserActionModel::setSelectionModel(QItemSelectionModel* sm)
 {
    d_ptr->m_pSelectionModel = sm;
-   connect(sm, &QItemSelectionModel::currentRowChanged , d_ptr.data(), &UserActionModelPrivate::updateActions);
-   connect(sm, &QItemSelectionModel::selectionChanged  , d_ptr.data(), &UserActionModelPrivate::updateActions);
+   connect(sm, &QItemSelectionModel::currentRowChanged , d_ptr.data(), &UserActionModelPrivate::refresh);
+   connect(sm, &QItemSelectionModel::selectionChanged  , d_ptr.data(), &UserActionModelPrivate::slotSelectionChanged);
+
+   // The cached masks are per index, drop them when the rows change
+   if (auto m = sm->model()) {
+      connect(m, &QAbstractItemModel::dataChanged        , d_ptr.data(), &UserActionModelPrivate::slotInvalidateMasks);
+      connect(m, &QAbstractItemModel::rowsInserted       , d_ptr.data(), &UserActionModelPrivate::slotInvalidateMasks);
+      connect(m, &QAbstractItemModel::rowsRemoved        , d_ptr.data(), &UserActionModelPrivate::slotInvalidateMasks);
+      connect(m, &QAbstractItemModel::rowsMoved          , d_ptr.data(), &UserActionModelPrivate::slotInvalidateMasks);
+      connect(m, &QAbstractItemModel::layoutChanged      , d_ptr.data(), &UserActionModelPrivate::slotInvalidateMasks);
+      connect(m, &QAbstractItemModel::modelReset         , d_ptr.data(), &UserActionModelPrivate::slotInvalidateMasks);
+   }
 
    d_ptr->updateActions();
 }
@@ -28,6 +28,7 @@ namespace Video {
    class Device;
 }
 class VideoChannelPrivate;
+class VideoDevicePrivate;
 
 namespace Video {
 
@@ -36,6 +37,7 @@ class LIB_EXPORT Channel : public QAbstractListModel
 {
    //Only Video::Device can add resolutions
    friend class Video::Device;
+   friend class ::VideoDevicePrivate;
 public:
    QString name() const;
    Video::Resolution* activeResolution();
@@ -20,6 +20,9 @@
 //Qt
 #include <QtCore/QTimer>
 
+//STD
+#include <algorithm>
+
 //Ring
 #include "../dbus/videomanager.h"
 #include "devicemodel.h"
@@ -41,57 +44,170 @@ VideoDevicePrivate::VideoDevicePrivate(Video::Device* parent) : QObject(parent),
 }
 
 ///Constructor
-Video::Device::Device(const QString &id) : QAbstractListModel(nullptr),
+Video::Device::Device(const QString &id, const MapStringMapStringVectorString& capabilities) : QAbstractListModel(nullptr),
 d_ptr(new VideoDevicePrivate(this))
 {
    d_ptr->m_DeviceId = id;
-   VideoManagerInterface& interface = VideoManager::instance();
-   MapStringMapStringVectorString cap = interface.getCapabilities(id);
-   QMapIterator<QString, MapStringVectorString> channels(cap);
-   while (channels.hasNext()) {
-      channels.next();
-
-      Video::Channel* chan = new Video::Channel(this,channels.key());
-      d_ptr->m_lChannels << chan;
-
-      QMapIterator<QString, VectorString> resolutions(channels.value());
-      while (resolutions.hasNext()) {
-         resolutions.next();
-
-         Video::Resolution* res = new Video::Resolution(resolutions.key(),chan);
-         chan->d_ptr->m_lValidResolutions << res;
-
-         foreach(const QString& rate, resolutions.value()) {
-            Video::Rate* r = new Video::Rate(res,rate);
-            if (!res->d_ptr->m_lValidRates.contains(r)) {
-                res->d_ptr->m_lValidRates << r;
-            }
-         }
+   d_ptr->setCapabilities(capabilities);
+}
+
+///Destructor
+Video::Device::~Device()
+{
+   d_ptr->clear();
+//    delete d_ptr;
+}
+
+void VideoDevicePrivate::destroy(Video::Resolution* res)
+{
+   foreach (auto rate, res->d_ptr->m_lValidRates)
+      delete rate;
+
+   delete res;
+}
+
+void VideoDevicePrivate::destroy(Video::Channel* chan)
+{
+   foreach (auto res, chan->d_ptr->m_lValidResolutions)
+      destroy(res);
+
+   delete chan;
+}
+
+void VideoDevicePrivate::clear()
+{
+   foreach (auto c, m_lChannels)
+      destroy(c);
+
+   m_lChannels.clear();
+   m_pCurrentChannel = nullptr;
+}
+
+/**
+ * Update the channels, resolutions and rates.
+ *
+ * The capabilities come from the VideoCapabilityCache, this is also called
+ * when a refresh found different ones for an existing device. The existing
+ * objects are kept, so are the selections and the views using them.
+ */
+void VideoDevicePrivate::setCapabilities(const MapStringMapStringVectorString& cap)
+{
+   for (int i = m_lChannels.size() - 1; i >= 0; i--) {
+      Video::Channel* chan = m_lChannels[i];
+
+      if (cap.contains(chan->name()))
+         continue;
+
+      q_ptr->beginRemoveRows({}, i, i);
+      m_lChannels.removeAt(i);
+
+      if (m_pCurrentChannel == chan)
+         m_pCurrentChannel = nullptr;
+
+      q_ptr->endRemoveRows();
+
+      destroy(chan);
+   }
+
+   for (auto channels = cap.constBegin(); channels != cap.constEnd(); ++channels) {
+      const auto existing = std::find_if(m_lChannels.constBegin(), m_lChannels.constEnd(),
+         [&channels](Video::Channel* c) { return c->name() == channels.key(); }
+      );
+
+      Video::Channel* chan = existing == m_lChannels.constEnd() ? nullptr : *existing;
 
-         // Sort rates in increasing order.
-         qSort(res->d_ptr->m_lValidRates.begin(),
-         res->d_ptr->m_lValidRates.end(),
-         [](Video::Rate* rateA, Video::Rate* rateB) {
-             return rateA->name().toInt() > rateB->name().toInt();
-         });
+      if (!chan) {
+         chan = new Video::Channel(q_ptr, channels.key());
+
+         q_ptr->beginInsertRows({}, m_lChannels.size(), m_lChannels.size());
+         m_lChannels << chan;
+         q_ptr->endInsertRows();
       }
+
+      setResolutions(chan, channels.value());
    }
-   Q_UNUSED(cap)
 }
 
-///Destructor
-Video::Device::~Device()
+void VideoDevicePrivate::setResolutions(Video::Channel* chan, const MapStringVectorString& resolutions)
 {
-   foreach (auto c, d_ptr->m_lChannels) {
-      foreach (auto res, c->d_ptr->m_lValidResolutions) {
-         foreach (auto rate, res->d_ptr->m_lValidRates)
-            delete rate;
-         delete res;
+   auto& list = chan->d_ptr->m_lValidResolutions;
+
+   for (int i = list.size() - 1; i >= 0; i--) {
+      Video::Resolution* res = list[i];
+
+      if (resolutions.contains(res->name()))
+         continue;
+
+      chan->beginRemoveRows({}, i, i);
+      list.removeAt(i);
+
+      if (chan->d_ptr->m_pCurrentResolution == res)
+         chan->d_ptr->m_pCurrentResolution = nullptr;
+
+      chan->endRemoveRows();
+
+      destroy(res);
+   }
+
+   for (auto i = resolutions.constBegin(); i != resolutions.constEnd(); ++i) {
+      const auto existing = std::find_if(list.constBegin(), list.constEnd(),
+         [&i](Video::Resolution* r) { return r->name() == i.key(); }
+      );
+
+      Video::Resolution* res = existing == list.constEnd() ? nullptr : *existing;
+
+      if (!res) {
+         res = new Video::Resolution(i.key(), chan);
+
+         chan->beginInsertRows({}, list.size(), list.size());
+         list << res;
+         chan->endInsertRows();
       }
-      delete c;
+
+      setRates(res, i.value());
    }
+}
 
-//    delete d_ptr;
+/// The rates are sorted from the highest to the lowest
+void VideoDevicePrivate::setRates(Video::Resolution* res, const VectorString& rates)
+{
+   auto& list = res->d_ptr->m_lValidRates;
+
+   for (int i = list.size() - 1; i >= 0; i--) {
+      Video::Rate* rate = list[i];
+
+      if (rates.contains(rate->name()))
+         continue;
+
+      res->beginRemoveRows({}, i, i);
+      list.removeAt(i);
+
+      if (res->d_ptr->m_pCurrentRate == rate)
+         res->d_ptr->m_pCurrentRate = nullptr;
+
+      res->endRemoveRows();
+
+      delete rate;
+   }
+
+   for (const QString& name : rates) {
+      const auto existing = std::find_if(list.constBegin(), list.constEnd(),
+         [&name](Video::Rate* r) { return r->name() == name; }
+      );
+
+      if (existing != list.constEnd())
+         continue;
+
+      const auto pos = std::find_if(list.constBegin(), list.constEnd(),
+         [&name](Video::Rate* r) { return r->name().toInt() < name.toInt(); }
+      );
+
+      const int row = static_cast<int>(std::distance(list.constBegin(), pos));
+
+      res->beginInsertRows({}, row, row);
+      list.insert(row, new Video::Rate(res, name));
+      res->endInsertRows();
+   }
 }
 
 QVariant Video::Device::data( const QModelIndex& index, int role) const
@@ -34,6 +34,7 @@ namespace Video {
    class Model;
    class Manager;
    class DeviceModel;
+   class DeviceModelPrivate;
    class ManagerPrivate;
 }
 
@@ -48,6 +49,7 @@ class LIB_EXPORT Device : public QAbstractListModel {
    friend class VideoRendererManager;
    friend class VideoRendererManagerPrivate;
    friend class Video::DeviceModel;
+   friend class Video::DeviceModelPrivate;
    friend class VideoDevicePrivate;
 
    //Need to access the PreferenceNames table
@@ -82,7 +84,7 @@ class LIB_EXPORT Device : public QAbstractListModel {
 
    private:
       //Constructor
-      explicit Device(const QString& id);
+      explicit Device(const QString& id, const MapStringMapStringVectorString& capabilities = {});
       virtual ~Device();
 
       QScopedPointer<VideoDevicePrivate> d_ptr;
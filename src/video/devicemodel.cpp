@@ -28,6 +28,8 @@
 #include <video/previewmanager.h>
 #include "../dbus/videomanager.h"
 #include "../private/videorenderermanager.h"
+#include "../private/videodevice_p.h"
+#include "../private/videocapabilitycache.h"
 
 namespace Video {
 class DeviceModelPrivate : public QObject
@@ -41,6 +43,10 @@ public:
    QList<Video::Device*>         m_lDevices     ;
    Video::Device*                m_pDummyDevice ;
    Video::Device*                m_pActiveDevice;
+   Video::DeviceModel*           q_ptr {nullptr};
+
+   //Helpers
+   void applyDevices(const QStringList& devices, const QHash<QString, MapStringMapStringVectorString>& changed);
 
 private Q_SLOTS:
    void idleReload();
@@ -61,6 +67,7 @@ void Video::DeviceModelPrivate::idleReload()
 Video::DeviceModel::DeviceModel() : QAbstractListModel(QCoreApplication::instance()),
 d_ptr(new Video::DeviceModelPrivate())
 {
+   d_ptr->q_ptr = this;
    reload();
    VideoManagerInterface& interface = VideoManager::instance();
    connect(&interface, SIGNAL(deviceEvent()), this, SLOT(reload()), Qt::QueuedConnection);
@@ -162,51 +169,80 @@ void Video::DeviceModel::setActive(const Video::Device* device)
    emit currentIndexChanged(idx);
 }
 
+/**
+ * Update the device list.
+ *
+ * The last known devices are used right away, the daemon is then queried in
+ * the background and only the difference is applied.
+ */
 void Video::DeviceModel::reload()
 {
-   QHash<QString,Video::Device*> devicesHash;
-   VideoManagerInterface& interface = VideoManager::instance();
-   const QStringList deviceList = interface.getDeviceList();
-   if (deviceList.size() == d_ptr->m_hDevices.size()) {
-      d_ptr->m_lDevices = d_ptr->m_hDevices.values();
+   auto& cache = VideoCapabilityCache::instance();
+
+   if (d_ptr->m_lDevices.isEmpty() && !cache.devices().isEmpty()) {
+      QHash<QString, MapStringMapStringVectorString> cached;
+
+      for (const QString& id : cache.devices())
+         cached[id] = cache.capabilities(id);
+
+      d_ptr->applyDevices(cache.devices(), cached);
    }
 
-   foreach(const QString& deviceName,deviceList) {
-      if (!d_ptr->m_hDevices[deviceName]) {
-         devicesHash[deviceName] = new Video::Device(deviceName);
-      }
-      else {
-         devicesHash[deviceName] = d_ptr->m_hDevices[deviceName];
-      }
+   cache.refresh(d_ptr.data(), [this](const QStringList& devices, const QHash<QString, MapStringMapStringVectorString>& changed) {
+      d_ptr->applyDevices(devices, changed);
+   });
+}
+
+void Video::DeviceModelPrivate::applyDevices(const QStringList& devices, const QHash<QString, MapStringMapStringVectorString>& changed)
+{
+   bool hasChanged = false;
+
+   // Remove the devices that are gone
+   for (int i = m_lDevices.size() - 1; i >= 0; i--) {
+      Video::Device* dev = m_lDevices[i];
+
+      if (devices.contains(dev->id()))
+         continue;
+
+      q_ptr->beginRemoveRows({}, i, i);
+      m_lDevices.removeAt(i);
+      m_hDevices.remove(dev->id());
+      q_ptr->endRemoveRows();
+
+      if (m_pActiveDevice == dev)
+         m_pActiveDevice = nullptr;
+
+      dev->deleteLater();
+      hasChanged = true;
    }
 
-   // remove all old devices
-   beginResetModel();
-   foreach(Video::Device* dev, d_ptr->m_hDevices) {
-      if (dev && devicesHash.key(dev).isEmpty()) {
-         dev->deleteLater();
+   // Update the existing ones and add the new ones
+   for (const QString& id : devices) {
+      if (auto dev = m_hDevices.value(id)) {
+         if (changed.contains(id))
+            dev->d_ptr->setCapabilities(changed[id]);
+         continue;
       }
-   }
-   d_ptr->m_pActiveDevice = nullptr;
-   d_ptr->m_hDevices.clear();
 
-   // add all new devices
-   d_ptr->m_hDevices = devicesHash;
-   d_ptr->m_lDevices = d_ptr->m_hDevices.values();
-   endResetModel();
+      q_ptr->beginInsertRows({}, m_lDevices.size(), m_lDevices.size());
+      auto dev = new Video::Device(id, changed.value(id));
+      m_hDevices[id] = dev;
+      m_lDevices << dev;
+      q_ptr->endInsertRows();
+
+      hasChanged = true;
+   }
 
    //Avoid a possible infinite loop by using a reload event
-   QTimer::singleShot(0,d_ptr.data(),SLOT(idleReload()));
+   if (hasChanged)
+      QTimer::singleShot(0,this,SLOT(idleReload()));
 }
 
-
 Video::Device* Video::DeviceModel::activeDevice() const
 {
    if (!d_ptr->m_pActiveDevice) {
       VideoManagerInterface& interface = VideoManager::instance();
       const QString deId = interface.getDefaultDevice();
-      if (!d_ptr->m_lDevices.size())
-         const_cast<Video::DeviceModel*>(this)->reload();
       Video::Device* dev =  d_ptr->m_hDevices[deId];
 
       //Handling null everywhere is too long, better create a dummy device and
@@ -38,6 +38,8 @@ class LIB_EXPORT DeviceModel : public QAbstractListModel {
    Q_OBJECT
    #pragma GCC diagnostic pop
 
+   friend class DeviceModelPrivate;
+
 public:
    //Private constructor, can only be called by 'Account'
    explicit DeviceModel();
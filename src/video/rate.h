@@ -26,6 +26,7 @@ namespace Video {
 }
 
 class RatePrivate;
+class VideoDevicePrivate;
 
 namespace Video {
 
@@ -34,6 +35,7 @@ class LIB_EXPORT Rate
 {
    //Can only be created by Video::Device
    friend class Video::Device;
+   friend class ::VideoDevicePrivate;
 
 public:
    QString name() const;
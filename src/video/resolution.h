@@ -28,6 +28,7 @@ namespace Video {
 }
 
 class VideoResolutionPrivate;
+class VideoDevicePrivate;
 
 namespace Video {
 
@@ -36,6 +37,7 @@ class LIB_EXPORT Resolution : public QAbstractListModel {
    Q_OBJECT
    //Only Video::Device can add validated rates
    friend class Video::Device;
+   friend class ::VideoDevicePrivate;
 public:
    //Constructor
    Resolution(const QString& size, Video::Channel* chan);